@@ -205,6 +205,8 @@ public:
    int maxReject;             // Max number of sats to reject [-1 for no limit]
    int nIter;                 // Maximum iteration count in linearized LS
    double convLimit;          // Minimum convergence criterion in estimation (meters)
+   int nThreads;              // Number of threads for RAIM [0 for one per core]
+   bool earlyRAIM;            // Stop RAIM at first combination within the limits
 
    string TropStr;            // temp used to parse --trop
 
@@ -492,6 +494,8 @@ public:
       prs.NSatsReject = C.maxReject;
       prs.MaxNIterations = C.nIter;
       prs.ConvergenceLimit = C.convLimit;
+      prs.NThreads = C.nThreads;
+      prs.EarlyTermination = C.earlyRAIM;
 
       // initialize apriori solution
       if(C.knownPos.getCoordinateSystem() != Position::Unknown)
@@ -1650,6 +1654,8 @@ void Configuration::SetDefaults(void) throw()
       maxReject = dummy.NSatsReject;
       nIter = dummy.MaxNIterations;
       convLimit = dummy.ConvergenceLimit;
+      nThreads = dummy.NThreads;
+      earlyRAIM = dummy.EarlyTermination;
    }
 
    userfmt = gpsfmt;
@@ -1926,6 +1932,10 @@ string Configuration::BuildCommandLine(void) throw()
             "Maximum iteration count in linearized LS");
    opts.Add(0, "conv", "lim", false, false, &convLimit, "",
             "Maximum convergence criterion in estimation in meters");
+   opts.Add(0, "threads", "n", false, false, &nThreads, "",
+            "Number of threads used in RAIM [0 for one per core]");
+   opts.Add(0, "early", "", false, false, &earlyRAIM, "",
+            "End RAIM at first satellite subset within the rms and slope limits");
    opts.Add(0, "Trop", "m,T,P,H", false, false, &TropStr, "",
             "Trop model <m> [one of Zero,Black,Saas,NewB,Neill,GG,GGHt,Global\n"
             "                      with optional weather T(C),P(mb),RH(%)]");
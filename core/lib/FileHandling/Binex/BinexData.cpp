@@ -1426,99 +1426,58 @@ namespace gpstk
                      const std::string&  message,
                      std::string&        crc) const
    {
+      const unsigned char *headData = (const unsigned char*)head.data();
+      const unsigned char *msgData = (const unsigned char*)message.data();
       size_t crcDataLen = head.size() + message.size();
-      size_t crcLen     = 0;
+      size_t crcLen     = getCRCLength(crcDataLen);
       unsigned long crcTmp = 0;
 
-      if (crcDataLen >= 1048576)
-      {
-            // @todo - Use 16-byte CRC (128-bit MD5 checksum)
-         crcLen  = 16;
-      }
-      else // (crcLen < 1048576)
+      switch (crcLen)
       {
-         if (syncByte & eEnhancedCRC)
-         {
-            if (crcDataLen < 128)
-            {
-                  // Use 2-byte CRC (CRC16)
-               BinUtils::CRCParam params(BinUtils::CRC16);
-               crcTmp = BinUtils::computeCRC((const unsigned char*)head.data(),
-                                             head.size(),
-                                             params);
-               params.initial = crcTmp;
-               crcTmp = BinUtils::computeCRC((const unsigned char*)message.data(),
-                                             message.size(),
-                                             params);
-               crcLen = 2;
-            }
-            else
-            {
-                  // Use 4-byte CRC (CRC32)
-               BinUtils::CRCParam params(BinUtils::CRC32);
-               crcTmp = BinUtils::computeCRC((const unsigned char*)head.data(),
-                                             head.size(),
-                                             params);
-               params.initial = crcTmp;
-               crcTmp = BinUtils::computeCRC((const unsigned char*)message.data(),
-                                             message.size(),
-                                             params);
-               crcLen = 4;
-            }
-         }
-         else // Regular CRC
-         {
-            if (crcDataLen < 128)
+         case 1:
             {
-                  // Use 1-byte checksum: 8-bit XOR of all bytes
+                  // 1-byte checksum: 8-bit XOR of all bytes
                size_t b;
-               const char *ptr;
-               ptr = head.data();
-               for (b = head.size(); b > 0 ; b--, ptr++)
+               for (b = 0; b < head.size(); b++)
                {
-                  crcTmp ^= *ptr;
+                  crcTmp ^= headData[b];
                }
-               ptr = message.data();
-               for (b = message.size(); b > 0 ; b--, ptr++)
+               for (b = 0; b < message.size(); b++)
                {
-                  crcTmp ^= *ptr;
+                  crcTmp ^= msgData[b];
                }
-               crcLen = 1;
-            }
-            else if (crcDataLen < 4096)
-            {
-                  // Use 2-byte CRC (CRC16)
-               BinUtils::CRCParam params(BinUtils::CRC16);
-               crcTmp = BinUtils::computeCRC((const unsigned char*)head.data(),
-                                             head.size(),
-                                             params);
-               params.initial = crcTmp;
-               crcTmp = BinUtils::computeCRC((const unsigned char*)message.data(),
-                                             message.size(),
-                                             params);
-               crcLen = 2;
             }
-            else
+            break;
+
+         case 2:
+               // CRC16, continued over the message from the CRC of the head
+            crcTmp = BinUtils::crc16(headData, head.size());
+            crcTmp = BinUtils::crc16(msgData, message.size(), crcTmp);
+            break;
+
+         case 4:
+               // CRC32, continued over the message from the CRC of the head
+            crcTmp = BinUtils::crc32(headData, head.size());
+            crcTmp = BinUtils::crc32(msgData, message.size(), crcTmp);
+            break;
+
+         default:
             {
-                  // Use 4-byte CRC (CRC32)
-               BinUtils::CRCParam params(BinUtils::CRC32);
-               crcTmp = BinUtils::computeCRC((const unsigned char*)head.data(),
-                                             head.size(),
-                                             params);
-               params.initial = crcTmp;
-               crcTmp = BinUtils::computeCRC((const unsigned char*)message.data(),
-                                             message.size(),
-                                             params);
-               crcLen = 4;
+                  // 16-byte MD5 checksum
+               BinUtils::MD5 md5;
+               unsigned char digest[16];
+               md5.update(headData, head.size());
+               md5.update(msgData, message.size());
+               md5.digest(digest);
+               crc.assign((const char*)digest, 16);
             }
-         } // Regular CRC
-
-            // Copy the CRC into the output
-         crc.resize(sizeof(crcTmp));
-         BinUtils::encodeVarLE(crcTmp, crc);
-         crc.resize(crcLen);
+            return;
+      }
 
-      } // (crcLen < 1048576)
+         // Copy the CRC into the output
+      crc.resize(sizeof(crcTmp));
+      BinUtils::encodeVarLE(crcTmp, crc);
+      crc.resize(crcLen);
 
    }  // BinexData::getCRC()
 
@@ -0,0 +1,391 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/**
+ * @file BinexReader.cpp
+ * Fast sequential reading of BINEX records in place.
+ */
+
+#include "BinexReader.hpp"
+
+using namespace std;
+
+namespace gpstk
+{
+   namespace
+   {
+         /** Check a head synchronization byte, as
+          * BinexData::isHeadSyncByteValid(), and get the tail
+          * synchronization byte expected for it (0 if none). */
+      bool headSyncValid(BinexData::SyncByte headSync,
+                         BinexData::SyncByte& expectedTailSync)
+      {
+         switch (headSync)
+         {
+            case 0xC2:
+            case 0xE2:
+            case 0xC8:
+            case 0xE8:
+               expectedTailSync = 0x00;
+               return true;
+            case 0xD2:
+               expectedTailSync = 0xB4;
+               return true;
+            case 0xF2:
+               expectedTailSync = 0xB0;
+               return true;
+            case 0xD8:
+               expectedTailSync = 0xE4;
+               return true;
+            case 0xF8:
+               expectedTailSync = 0xE0;
+               return true;
+            default:
+               return false;
+         }
+      }
+
+
+         /** Number of bytes of checksum for crcDataLen bytes of
+          * record ID, message length and message, as
+          * BinexData::getCRCLength(). */
+      size_t crcLength(BinexData::SyncByte syncByte, size_t crcDataLen)
+      {
+         if (crcDataLen >= 1048576)
+            return 16;
+         if (syncByte & BinexData::eEnhancedCRC)
+            return (crcDataLen < 128) ? 2 : 4;
+         if (crcDataLen < 128)
+            return 1;
+         return (crcDataLen < 4096) ? 2 : 4;
+      }
+
+
+         /** Compute the checksum of a record, as BinexData::getCRC(),
+          * where head is the record ID and message length (without
+          * the synchronization byte) and is immediately followed by
+          * the message.
+          * @param[out] crc the crcLen bytes of checksum. */
+      void computeChecksum(const unsigned char *head, size_t headLen,
+                           size_t msgLen, size_t crcLen, unsigned char *crc)
+      {
+         const unsigned char *msg = head + headLen;
+         uint32_t c = 0;
+         switch (crcLen)
+         {
+            case 1:
+               for (size_t i = 0; i < headLen + msgLen; i++)
+                  c ^= head[i];
+               break;
+            case 2:
+               c = BinUtils::crc16(head, headLen);
+               c = BinUtils::crc16(msg, msgLen, c);
+               break;
+            case 4:
+               c = BinUtils::crc32(head, headLen);
+               c = BinUtils::crc32(msg, msgLen, c);
+               break;
+            default:
+               {
+                  BinUtils::MD5 md5;
+                  md5.update(head, headLen + msgLen);
+                  md5.digest(crc);
+               }
+               return;
+         }
+            // little endian, as written by BinexData
+         for (size_t i = 0; i < crcLen; i++, c >>= 8)
+            crc[i] = (unsigned char)c;
+      }
+   }
+
+
+   // -------------------------------------------------------------------------
+   unsigned long BinexReader::Record::extractUBNXI(size_t& offset) const
+   {
+      unsigned long value = 0;
+      size_t n = 0;
+      if (offset < messageLength)
+      {
+         n = decodeUBNXI(message + offset, messageLength - offset,
+                         isLittleEndian(), value);
+      }
+      if (n == 0)
+      {
+         InvalidParameter ip("Message buffer offset invalid: " +
+                             StringUtils::asString(offset));
+         GPSTK_THROW(ip);
+      }
+      offset += n;
+      return value;
+   }
+
+
+   // -------------------------------------------------------------------------
+   void BinexReader::Record::toBinexData(BinexData& bd) const
+   {
+      size_t offset = 0;
+      bd.setRecordFlags(syncByte);
+      bd.setRecordID(recID);
+      bd.clearMessage();
+      bd.updateMessageData(offset, (const char*)message, messageLength);
+   }
+
+
+   // -------------------------------------------------------------------------
+   BinexReader::BinexReader(size_t bufferSize)
+         : buffer(bufferSize), strm(NULL), data(NULL), begin(0), end(0),
+           base(0)
+   {
+   }
+
+
+   // -------------------------------------------------------------------------
+   void BinexReader::open(const std::string& fn)
+   {
+      close();
+      file.open(fn);
+      data = (const unsigned char*)file.data();
+      end = file.size();
+   }
+
+
+   // -------------------------------------------------------------------------
+   void BinexReader::open(std::istream& s)
+   {
+      close();
+      strm = &s;
+      data = buffer.data();
+   }
+
+
+   // -------------------------------------------------------------------------
+   void BinexReader::open(const void *d, size_t len)
+   {
+      close();
+      data = (const unsigned char*)d;
+      end = len;
+   }
+
+
+   // -------------------------------------------------------------------------
+   void BinexReader::close()
+   {
+      file.close();
+      strm = NULL;
+      data = NULL;
+      begin = end = 0;
+      base = 0;
+   }
+
+
+   // -------------------------------------------------------------------------
+   bool BinexReader::fill(size_t need)
+   {
+      if (end - begin >= need)
+         return true;
+      if (strm == NULL)
+         return false;
+
+         // move the unparsed data to the start of the buffer
+      if (begin > 0)
+      {
+         memmove(&buffer[0], &buffer[begin], end - begin);
+         base += begin;
+         end -= begin;
+         begin = 0;
+      }
+      data = buffer.data();
+
+      while (end < need)
+      {
+            // Enlarge the buffer only as the data arrive, so that a
+            // corrupt message length can't allocate more than the
+            // input holds.
+         if (end == buffer.size())
+         {
+            buffer.resize(std::min(need,
+                                   std::max<size_t>(2 * buffer.size(), 4096)));
+            data = buffer.data();
+         }
+         streamsize n = 0;
+         try
+         {
+            strm->read((char*)&buffer[end], buffer.size() - end);
+            n = strm->gcount();
+         }
+         catch (std::exception&)
+         {
+               // exceptions enabled on strm; it still reports the count
+            n = strm->gcount();
+         }
+         if (n <= 0)
+         {
+            strm = NULL;   // no more input
+            return false;
+         }
+         end += n;
+      }
+      return true;
+   }
+
+
+   // -------------------------------------------------------------------------
+   bool BinexReader::next(Record& rec)
+   {
+      if (!fill(1))
+      {
+         return false;
+      }
+
+         // record ID and message length take at most 8 bytes
+      fill(9);
+      const unsigned char *p = data + begin;
+      size_t avail = end - begin;
+
+      BinexData::SyncByte syncByte = p[0], tailSync;
+      if (!headSyncValid(syncByte, tailSync))
+      {
+         begin++;
+         FFStreamError err("Invalid BINEX synchronization byte: " +
+                           StringUtils::asString((unsigned)syncByte) +
+                           " at offset " +
+                           StringUtils::asString(base + begin - 1));
+         GPSTK_THROW(err);
+      }
+      bool littleEndian = (syncByte & BinexData::eBigEndian) == 0;
+
+      unsigned long recID = 0, msgLen = 0;
+      size_t idLen = decodeUBNXI(p + 1, avail - 1, littleEndian, recID);
+      size_t lenLen = 0;
+      if (idLen)
+      {
+         lenLen = decodeUBNXI(p + 1 + idLen, avail - 1 - idLen, littleEndian,
+                              msgLen);
+      }
+      size_t headLen = idLen + lenLen;
+      size_t crcLen = crcLength(syncByte, headLen + msgLen);
+      size_t recSize = 1 + headLen + msgLen + crcLen;
+      if (tailSync)
+      {
+            // reversed total length and tail synchronization byte
+         BinexData::UBNXI revLen(recSize);
+         recSize += revLen.getSize() + 1;
+      }
+
+      if (lenLen == 0 || msgLen > BinexData::UBNXI::MAX_VALUE ||
+          !fill(recSize))
+      {
+            // The input ends before the record does, which may be
+            // because the synchronization byte was just noise, so
+            // search for a record from the next byte as for any other
+            // invalid record.
+         begin++;
+         FFStreamError err("Incomplete BINEX record at offset " +
+                           StringUtils::asString(base + begin - 1));
+         GPSTK_THROW(err);
+      }
+
+      p = data + begin;
+      unsigned char crc[16];
+      computeChecksum(p + 1, headLen, msgLen, crcLen, crc);
+      if (memcmp(crc, p + 1 + headLen + msgLen, crcLen) != 0 ||
+          (tailSync && p[recSize - 1] != tailSync))
+      {
+         begin++;
+         FFStreamError err(string(tailSync && p[recSize - 1] != tailSync
+                                  ? "BINEX head/tail synchronization byte"
+                                  " mismatch" : "Bad BINEX CRC") +
+                           " at offset " +
+                           StringUtils::asString(base + begin - 1));
+         GPSTK_THROW(err);
+      }
+
+      rec.syncByte = syncByte;
+      rec.recID = recID;
+      rec.message = p + 1 + headLen;
+      rec.messageLength = msgLen;
+      rec.position = base + begin;
+      rec.size = recSize;
+      begin += recSize;
+      return true;
+   }
+
+
+   // -------------------------------------------------------------------------
+   size_t BinexReader::decodeUBNXI(const unsigned char *p, size_t avail,
+                                   bool littleEndian, unsigned long& value)
+   {
+         // The top bit of each of the first three bytes flags that
+         // another byte follows; a fourth byte uses all 8 bits.
+      if (avail >= 1 && !(p[0] & 0x80))
+      {
+         value = p[0];
+         return 1;
+      }
+      if (avail >= 2 && !(p[1] & 0x80))
+      {
+         value = littleEndian
+            ? (p[0] & 0x7f) | ((unsigned long)p[1] << 7)
+            : ((unsigned long)(p[0] & 0x7f) << 7) | p[1];
+         return 2;
+      }
+      if (avail >= 3 && !(p[2] & 0x80))
+      {
+         value = littleEndian
+            ? (p[0] & 0x7f) | ((unsigned long)(p[1] & 0x7f) << 7) |
+              ((unsigned long)p[2] << 14)
+            : ((unsigned long)(p[0] & 0x7f) << 14) |
+              ((unsigned long)(p[1] & 0x7f) << 7) | p[2];
+         return 3;
+      }
+      if (avail >= 4)
+      {
+         value = littleEndian
+            ? (p[0] & 0x7f) | ((unsigned long)(p[1] & 0x7f) << 7) |
+              ((unsigned long)(p[2] & 0x7f) << 14) |
+              ((unsigned long)p[3] << 21)
+            : ((unsigned long)(p[0] & 0x7f) << 22) |
+              ((unsigned long)(p[1] & 0x7f) << 15) |
+              ((unsigned long)(p[2] & 0x7f) << 8) | p[3];
+         return 4;
+      }
+      return 0;
+   }
+
+} // namespace gpstk
@@ -0,0 +1,234 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/**
+ * @file BinexReader.hpp
+ * Fast sequential reading of BINEX records in place.
+ */
+
+#ifndef GPSTK_BINEXREADER_HPP
+#define GPSTK_BINEXREADER_HPP
+
+#include <algorithm>
+#include <cstring>
+#include <istream>
+#include <string>
+#include <vector>
+#include "BinexData.hpp"
+#include "MappedFile.hpp"
+#include "StringUtils.hpp"
+
+namespace gpstk
+{
+      /// @ingroup FileHandling
+      //@{
+
+      /**
+       * This class reads BINEX records from a file, a stream or a
+       * block of memory without copying them.  Input is read in
+       * large blocks into a buffer that is reused for every record
+       * (or the file is memory mapped), and each record is parsed
+       * and its CRC or MD5 checksum validated where it lies in that
+       * buffer.  The records are returned as Record objects that
+       * refer to the message bytes in the buffer, which makes this
+       * much faster than BinexData::getRecord() for high-rate data.
+       *
+       * Only records that are read forward (those starting with a
+       * head synchronization byte) are supported.
+       *
+       * @code
+       * BinexReader reader;
+       * BinexReader::Record rec;
+       * reader.open("receiver.bnx");
+       * while (reader.next(rec))
+       * {
+       *    if (rec.recID == 0x7f) ...
+       * }
+       * @endcode
+       *
+       * @sa BinexData.
+       */
+   class BinexReader
+   {
+   public:
+         /**
+          * A BINEX record parsed in place.  The message data are not
+          * copied, and remain valid only until the next call to
+          * BinexReader::next() or BinexReader::close().
+          */
+      class Record
+      {
+      public:
+         Record()
+               : syncByte(0), recID(BinexData::INVALID_RECORD_ID),
+                 message(NULL), messageLength(0), position(0), size(0)
+         {}
+
+            /// @return true if the record data are little endian.
+         bool isLittleEndian() const
+         { return (syncByte & BinexData::eBigEndian) == 0; }
+
+            /**
+             * Extracts a UBNXI from the message, as
+             * BinexData::extractMessageData(), updating offset to
+             * reference the next byte of the message.
+             * @throw InvalidParameter if the UBNXI is not within the
+             *   message.
+             */
+         unsigned long extractUBNXI(size_t& offset) const;
+
+            /**
+             * Extracts a value of sizeof(T) bytes from the message in
+             * the byte order of the record, updating offset to
+             * reference the next byte of the message.
+             * @throw InvalidParameter if the value is not within the
+             *   message.
+             */
+         template <class T>
+         void extractMessageData(size_t& offset, T& data) const
+         {
+            if (offset + sizeof(T) > messageLength)
+            {
+               InvalidParameter ip("Message buffer offset invalid: " +
+                                   StringUtils::asString(offset));
+               GPSTK_THROW(ip);
+            }
+            unsigned char bytes[sizeof(T)];
+            std::memcpy(bytes, message + offset, sizeof(T));
+            if (isLittleEndian() != BinexData::nativeLittleEndian)
+               std::reverse(bytes, bytes + sizeof(T));
+            std::memcpy(&data, bytes, sizeof(T));
+            offset += sizeof(T);
+         }
+
+            /// Copy the record into a BinexData object.
+         void toBinexData(BinexData& bd) const;
+
+         BinexData::SyncByte syncByte;  ///< Flags for endianness, CRC, etc.
+         BinexData::RecordID recID;     ///< Record ID
+         const unsigned char *message;  ///< Record message, in place
+         size_t messageLength;          ///< Number of bytes of message
+         unsigned long long position;   ///< Offset of the record in the input
+         size_t size;                   ///< Total record size in bytes
+      }; // class Record
+
+
+         /** Create a reader with no input.
+          * @param[in] bufferSize the initial size of the buffer used
+          *   when reading from a stream.  The buffer is enlarged, as
+          *   data are read, if a record doesn't fit. */
+      BinexReader(size_t bufferSize = 1048576);
+
+         /** Read records from the file \a fn, which is memory mapped.
+          * @throw FileMissingException if the file can't be opened. */
+      void open(const std::string& fn);
+
+         /** Read records from \a strm, starting at its current
+          * position.  The stream must remain open until close() or
+          * the next open(). */
+      void open(std::istream& strm);
+
+         /** Read records from \a len bytes of memory at \a data,
+          * which must remain valid until close() or the next
+          * open(). */
+      void open(const void *data, size_t len);
+
+         /// Stop reading the current input.
+      void close();
+
+         /**
+          * Parse the next record.
+          * @param[out] rec the record, which refers to data in this
+          *   reader's buffer.
+          * @return false at the end of the input.
+          * @throw FFStreamError if the record has an invalid
+          *   synchronization byte or checksum, or if the input ends
+          *   part way through the record (e.g. because a corrupt
+          *   byte looked like a synchronization byte).  In each case
+          *   the reader moves on by a single byte so that next() can
+          *   be called again to search for the following record.
+          */
+      bool next(Record& rec);
+
+         /// @return the offset in the input of the next byte to parse.
+      unsigned long long tell() const
+      { return base + begin; }
+
+         /**
+          * Decode a UBNXI from raw bytes.
+          * @param[in] p the bytes to decode.
+          * @param[in] avail the number of bytes at p.
+          * @param[in] littleEndian the byte order of the bytes.
+          * @param[out] value the decoded value.
+          * @return the number of bytes decoded, or 0 if the UBNXI
+          *   continues past avail bytes.
+          */
+      static size_t decodeUBNXI(const unsigned char *p, size_t avail,
+                                bool littleEndian, unsigned long& value);
+
+   private:
+         // Readers refer to buffers and streams, so copying is not allowed.
+      BinexReader(const BinexReader&);
+      BinexReader& operator=(const BinexReader&);
+
+         /** Make at least \a need bytes available from begin, reading
+          * more of the stream if necessary.
+          * @return false if the input ends first. */
+      bool fill(size_t need);
+
+         /// Buffer for data read from a stream.
+      std::vector<unsigned char> buffer;
+         /// Memory mapping of the input file, if any.
+      MappedFile file;
+         /// The input stream, if any.
+      std::istream *strm;
+         /// The input data: buffer, the mapped file or the caller's memory.
+      const unsigned char *data;
+         /// Offset in data of the next byte to parse.
+      size_t begin;
+         /// Offset in data of the end of the input read so far.
+      size_t end;
+         /// Offset in the input of data[0].
+      unsigned long long base;
+   }; // class BinexReader
+
+      //@}
+
+} // namespace gpstk
+
+#endif // GPSTK_BINEXREADER_HPP
@@ -0,0 +1,428 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+
+/**
+ * @file CompressedInputBuf.cpp
+ * Stream buffer decoding gzip and Compact RINEX input, or reading
+ * plain files ahead, on a background thread.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include "CompressedInputBuf.hpp"
+#include "Exception.hpp"
+#include "FFStreamError.hpp"
+
+#ifdef GPSTK_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace gpstk
+{
+      /// Size of the chunks read from raw and decoded at a time.
+   static const size_t chunkSize = 65536;
+
+
+   CompressedInputBuf::Format CompressedInputBuf ::
+   detect(std::streambuf& raw)
+   {
+      std::streampos start = raw.pubseekoff(0, std::ios::cur, std::ios::in);
+      if (start == std::streampos(std::streamoff(-1)))
+         return Plain;
+      char buf[128];
+      std::streamsize n = raw.sgetn(buf, sizeof(buf));
+      raw.pubseekpos(start, std::ios::in);
+      if ((n >= 2) && (static_cast<unsigned char>(buf[0]) == 0x1f) &&
+          (static_cast<unsigned char>(buf[1]) == 0x8b))
+      {
+         return Gzip;
+      }
+      std::string line(buf, n > 0 ? n : 0);
+      line.erase(std::min(line.find('\n'), line.size()));
+      if (CrinexDecoder::isCrinex(line))
+         return Crinex;
+      return Plain;
+   }
+
+
+   bool CompressedInputBuf ::
+   haveGzip()
+   {
+#ifdef GPSTK_HAVE_ZLIB
+      return true;
+#else
+      return false;
+#endif
+   }
+
+
+   CompressedInputBuf ::
+   CompressedInputBuf(std::streambuf& rawBuf, size_t blockSize,
+                      unsigned numBlocks)
+         : raw(rawBuf), inputFormat(detect(rawBuf)),
+           blocks(std::max(numBlocks, 2u)), finished(false),
+           stopping(false), reading(noBlock), blockPos(0),
+           filling(noBlock), sniffed(false), crinex(false)
+   {
+      for (size_t i = 0; i < blocks.size(); i++)
+      {
+         blocks[i].data.resize(std::max(blockSize, size_t(1)));
+         blocks[i].size = 0;
+         freed.push_back(i);
+      }
+      if (inputFormat == Plain)
+      {
+            // positions are file offsets when reading ahead
+         std::streampos pos = raw.pubseekoff(0, std::ios::cur,
+                                             std::ios::in);
+         if (pos != std::streampos(std::streamoff(-1)))
+            blockPos = pos;
+      }
+      worker = std::thread(&CompressedInputBuf::run, this);
+   }
+
+
+   CompressedInputBuf ::
+   ~CompressedInputBuf()
+   {
+      {
+         std::lock_guard<std::mutex> lock(blockMutex);
+         stopping = true;
+      }
+      blockFreed.notify_all();
+      if (worker.joinable())
+         worker.join();
+   }
+
+
+   bool CompressedInputBuf ::
+   failed() const
+   {
+      std::lock_guard<std::mutex> lock(blockMutex);
+      return finished && !error.empty();
+   }
+
+
+   std::string CompressedInputBuf ::
+   errorText() const
+   {
+      std::lock_guard<std::mutex> lock(blockMutex);
+      return error;
+   }
+
+
+   CompressedInputBuf::int_type CompressedInputBuf ::
+   underflow()
+   {
+      if (gptr() < egptr())
+         return traits_type::to_int_type(*gptr());
+
+      std::unique_lock<std::mutex> lock(blockMutex);
+      if (reading != noBlock)
+      {
+         blockPos += blocks[reading].size;
+         freed.push_back(reading);
+         reading = noBlock;
+         setg(nullptr, nullptr, nullptr);
+         blockFreed.notify_one();
+      }
+      blockFilled.wait(lock, [this] { return finished || !filled.empty(); });
+      if (filled.empty())
+         return traits_type::eof();
+      reading = filled.front();
+      filled.pop_front();
+      lock.unlock();
+
+      Block& b(blocks[reading]);
+      setg(&b.data[0], &b.data[0], &b.data[0] + b.size);
+      return traits_type::to_int_type(*gptr());
+   }
+
+
+   CompressedInputBuf::pos_type CompressedInputBuf ::
+   seekoff(off_type off, std::ios::seekdir dir, std::ios::openmode which)
+   {
+      if (dir == std::ios::cur)
+         off += blockPos + (gptr() - eback());
+      else if (dir != std::ios::beg)
+         return pos_type(off_type(-1));
+      return seekpos(pos_type(off), which);
+   }
+
+
+   CompressedInputBuf::pos_type CompressedInputBuf ::
+   seekpos(pos_type pos, std::ios::openmode which)
+   {
+      std::streamoff off(pos);
+      if (!(which & std::ios::in) || (off < blockPos) ||
+          (off > blockPos + (egptr() - eback())))
+      {
+         return pos_type(off_type(-1));
+      }
+      setg(eback(), eback() + (off - blockPos), egptr());
+      return pos;
+   }
+
+
+   void CompressedInputBuf ::
+   run()
+   {
+      std::string msg;
+      try
+      {
+         if (inputFormat == Gzip)
+         {
+            inflateInput();
+         }
+         else
+         {
+            std::vector<char> buf(chunkSize);
+            std::streamsize n;
+            bool more = true;
+            while (more && ((n = raw.sgetn(&buf[0], buf.size())) > 0))
+               more = consume(&buf[0], n);
+            if (more)
+               finish();
+         }
+      }
+      catch (Exception& e)
+      {
+         msg = e.getText();
+      }
+      catch (std::exception& e)
+      {
+         msg = e.what();
+      }
+      flush();
+      {
+         std::lock_guard<std::mutex> lock(blockMutex);
+         error = msg;
+         finished = true;
+      }
+      blockFilled.notify_all();
+   }
+
+
+   void CompressedInputBuf ::
+   inflateInput()
+   {
+#ifdef GPSTK_HAVE_ZLIB
+      z_stream zs;
+      std::memset(&zs, 0, sizeof(zs));
+         // 15 bit window, +32 to expect a gzip or zlib header
+      if (inflateInit2(&zs, 15+32) != Z_OK)
+      {
+         FFStreamError err("Unable to initialize gzip decoding");
+         GPSTK_THROW(err);
+      }
+      std::vector<char> in(chunkSize), out(4*chunkSize);
+      bool streamEnd = false;
+      try
+      {
+         while (true)
+         {
+            if (zs.avail_in == 0)
+            {
+               std::streamsize n = raw.sgetn(&in[0], in.size());
+               if (n <= 0)
+                  break;
+               zs.next_in = reinterpret_cast<Bytef*>(&in[0]);
+               zs.avail_in = n;
+            }
+            if (streamEnd)
+            {
+                  // another member of a multi-member file
+               inflateReset(&zs);
+               streamEnd = false;
+            }
+            zs.next_out = reinterpret_cast<Bytef*>(&out[0]);
+            zs.avail_out = out.size();
+            int rc = inflate(&zs, Z_NO_FLUSH);
+            if ((rc != Z_OK) && (rc != Z_STREAM_END) && (rc != Z_BUF_ERROR))
+            {
+               FFStreamError err(std::string("gzip data error: ") +
+                                 (zs.msg ? zs.msg : "unknown"));
+               GPSTK_THROW(err);
+            }
+            streamEnd = (rc == Z_STREAM_END);
+            if (!consume(&out[0], out.size() - zs.avail_out))
+            {
+               inflateEnd(&zs);
+               return;
+            }
+         }
+         if (!streamEnd)
+         {
+            FFStreamError err("gzip data truncated");
+            GPSTK_THROW(err);
+         }
+      }
+      catch (...)
+      {
+         inflateEnd(&zs);
+         throw;
+      }
+      inflateEnd(&zs);
+      finish();
+#else
+      FFStreamError err("gzip input is not supported by this build");
+      GPSTK_THROW(err);
+#endif
+   }
+
+
+   bool CompressedInputBuf ::
+   consume(const char *data, size_t len)
+   {
+      if (!sniffed)
+      {
+            // The first line says whether the data is Compact RINEX.
+         pending.append(data, len);
+         size_t eol = pending.find('\n');
+         if ((eol == std::string::npos) && (pending.size() < 256))
+            return true;
+         sniffed = true;
+         crinex = CrinexDecoder::isCrinex(pending.substr(0, eol));
+         if (!crinex)
+         {
+            std::string head;
+            head.swap(pending);
+            return produce(head.data(), head.size());
+         }
+         len = 0;
+      }
+      if (!crinex)
+         return produce(data, len);
+
+      pending.append(data, len);
+      size_t start = 0, eol;
+      try
+      {
+         while ((eol = pending.find('\n', start)) != std::string::npos)
+         {
+            decoder.decodeLine(pending.substr(start, eol - start), text);
+            start = eol + 1;
+         }
+      }
+      catch (...)
+      {
+            // deliver the records decoded before the error
+         produce(text.data(), text.size());
+         throw;
+      }
+      pending.erase(0, start);
+      if (text.size() < chunkSize)
+         return true;
+      bool rv = produce(text.data(), text.size());
+      text.clear();
+      return rv;
+   }
+
+
+   bool CompressedInputBuf ::
+   finish()
+   {
+      if (!sniffed)
+      {
+         sniffed = true;
+         crinex = CrinexDecoder::isCrinex(pending);
+         if (!crinex)
+            return produce(pending.data(), pending.size());
+      }
+      if (!crinex)
+         return true;
+      try
+      {
+         if (!pending.empty())
+            decoder.decodeLine(pending, text);
+      }
+      catch (...)
+      {
+         produce(text.data(), text.size());
+         throw;
+      }
+      pending.clear();
+      return produce(text.data(), text.size());
+   }
+
+
+   bool CompressedInputBuf ::
+   produce(const char *data, size_t len)
+   {
+      while (len > 0)
+      {
+         if (filling == noBlock)
+         {
+            std::unique_lock<std::mutex> lock(blockMutex);
+            blockFreed.wait(lock, [this]
+                            { return stopping || !freed.empty(); });
+            if (stopping)
+               return false;
+            filling = freed.front();
+            freed.pop_front();
+            blocks[filling].size = 0;
+         }
+            // the block being filled belongs to this thread alone
+         Block& b(blocks[filling]);
+         size_t n = std::min(len, b.data.size() - b.size);
+         std::memcpy(&b.data[b.size], data, n);
+         b.size += n;
+         data += n;
+         len -= n;
+         if (b.size == b.data.size())
+            flush();
+      }
+      return true;
+   }
+
+
+   void CompressedInputBuf ::
+   flush()
+   {
+      if ((filling == noBlock) || (blocks[filling].size == 0))
+         return;
+      {
+         std::lock_guard<std::mutex> lock(blockMutex);
+         filled.push_back(filling);
+      }
+      filling = noBlock;
+      blockFilled.notify_one();
+   }
+
+}  // End of namespace gpstk
@@ -0,0 +1,230 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+
+/**
+ * @file CompressedInputBuf.hpp
+ * Stream buffer decoding gzip and Compact RINEX input, or reading
+ * plain files ahead, on a background thread.
+ */
+
+#ifndef GPSTK_COMPRESSEDINPUTBUF_HPP
+#define GPSTK_COMPRESSEDINPUTBUF_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+#include "CrinexDecoder.hpp"
+
+namespace gpstk
+{
+      /// @ingroup FileHandling
+      //@{
+
+      /**
+       * A read-only stream buffer presenting the decoded contents of
+       * a compressed file.  The compressed bytes are taken from
+       * another stream buffer (normally the std::filebuf of an
+       * FFTextStream) by a background thread, which decodes them
+       * into a small pool of large blocks.  The reading thread
+       * parses one block while the next is filled, so decoding,
+       * disk I/O and parsing run concurrently.
+       *
+       * Input in any other format is passed through unchanged,
+       * which makes this a read-ahead buffer for plain files (see
+       * FFTextStream::enableReadAhead()).  Positions are then file
+       * offsets, so tellg() reports the same values as it would
+       * for the file itself.
+       *
+       * The following inputs are recognized:
+       * - gzip (RFC 1952), including multi-member files.  This
+       *   requires the library to be built with zlib.
+       * - Compact RINEX observation files, see CrinexDecoder.
+       * - Compact RINEX inside gzip, e.g. ".crx.gz" or ".15d.gz".
+       *
+       * Decoding errors don't interrupt the reader: the text decoded
+       * up to the error is delivered, then the buffer reports end of
+       * file and failed() returns true.
+       *
+       * Only the current read position may be queried (tellg) and
+       * only positions within the most recently delivered block may
+       * be sought to, which is enough for FFStream to back up to the
+       * start of a record that failed to parse.
+       */
+   class CompressedInputBuf : public std::streambuf
+   {
+   public:
+         /// Kinds of input distinguished by detect().
+      enum Format
+      {
+         Plain,         ///< Anything not listed below.
+         Gzip,          ///< gzip compressed data.
+         Crinex         ///< Compact RINEX text.
+      };
+
+         /** Look at the start of \a raw to determine its format,
+          * then return to the starting position.  Returns Plain if
+          * \a raw can't be repositioned. */
+      static Format detect(std::streambuf& raw);
+
+         /// Return true if this build of the library can decode gzip.
+      static bool haveGzip();
+
+         /** Start decoding the data in \a raw, which must remain
+          * valid and must not be used by anything else until this
+          * object has been destroyed.
+          * @param[in] raw the input data, read from its current
+          *   position.
+          * @param[in] blockSize the size of the blocks handed to the
+          *   reader.
+          * @param[in] numBlocks the number of blocks, at least two:
+          *   one being read and the others being filled. */
+      CompressedInputBuf(std::streambuf& raw, size_t blockSize = 1048576,
+                         unsigned numBlocks = 2);
+
+         /// Stop the decoding thread.
+      virtual ~CompressedInputBuf();
+
+         /** Return true if decoding stopped due to an error.  The
+          * error is only reported once everything decoded before it
+          * has been read. */
+      bool failed() const;
+
+         /// Return the description of the decoding error, if any.
+      std::string errorText() const;
+
+         /// Return the format of the input determined on construction.
+      Format format() const
+      { return inputFormat; }
+
+   protected:
+         /// Release the current block and take the next one.
+      virtual int_type underflow();
+
+         /// Report the decoded read position.
+      virtual pos_type seekoff(off_type off, std::ios::seekdir dir,
+                               std::ios::openmode which);
+
+         /// Return to a position within the current block.
+      virtual pos_type seekpos(pos_type pos, std::ios::openmode which);
+
+   private:
+         /// Body of the decoding thread.
+      void run();
+
+         /// Decompress the gzip data from raw.
+      void inflateInput();
+
+         /** Take decoded bytes, detect and convert Compact RINEX.
+          * @return false if the reader asked to stop. */
+      bool consume(const char *data, size_t len);
+
+         /// Decode any text left over at the end of the input.
+      bool finish();
+
+         /** Copy \a len bytes into the blocks, handing each to the
+          * reader when it is full and waiting for free blocks as
+          * needed.
+          * @return false if the reader asked to stop. */
+      bool produce(const char *data, size_t len);
+
+         /// Hand the partly filled block, if any, to the reader.
+      void flush();
+
+         /// A buffer of decoded data.
+      struct Block
+      {
+         std::vector<char> data;
+            /// Number of bytes of data in use.
+         size_t size;
+      };
+
+         /// Marks no block in reading or filling.
+      static const size_t noBlock = static_cast<size_t>(-1);
+
+         /// Input data.
+      std::streambuf& raw;
+         /// The format of raw.
+      Format inputFormat;
+
+         /// All of the buffers.
+      std::vector<Block> blocks;
+         /// Filled blocks (indices into blocks) in reading order.
+      std::deque<size_t> filled;
+         /// Blocks free for filling.
+      std::deque<size_t> freed;
+         /// Set when the decoding thread is done.
+      bool finished;
+         /// Set by the destructor to stop the decoding thread.
+      bool stopping;
+         /// Description of the error that stopped decoding.
+      std::string error;
+      mutable std::mutex blockMutex;
+      std::condition_variable blockFreed;
+      std::condition_variable blockFilled;
+
+         /// The block being read or noBlock.
+      size_t reading;
+         /// Stream position of the start of the block being read.
+      std::streamoff blockPos;
+
+         // State of the decoding thread.
+         /// The block being filled or noBlock.
+      size_t filling;
+         /// Whether the first line has been examined yet.
+      bool sniffed;
+         /// Set when the decoded data is Compact RINEX.
+      bool crinex;
+         /// Incomplete line of text carried between calls to consume().
+      std::string pending;
+         /// Decoded RINEX text waiting to be produced.
+      std::string text;
+      CrinexDecoder decoder;
+
+      std::thread worker;
+   }; // End of class 'CompressedInputBuf'
+
+      //@}
+
+}  // End of namespace gpstk
+
+#endif   // GPSTK_COMPRESSEDINPUTBUF_HPP
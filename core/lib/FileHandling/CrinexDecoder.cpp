@@ -0,0 +1,477 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+
+/**
+ * @file CrinexDecoder.cpp
+ * Convert Compact RINEX (Hatanaka) observation text back to RINEX.
+ */
+
+#include <cstdlib>
+#include "CrinexDecoder.hpp"
+#include "StringUtils.hpp"
+
+namespace gpstk
+{
+      // Throw an FFStreamError identifying the compact file line.
+   static void crxError(unsigned long lineNum, const std::string& msg)
+   {
+      FFStreamError err("CRINEX line " + StringUtils::asString(lineNum) +
+                        ": " + msg);
+      GPSTK_THROW(err);
+   }
+
+
+      // Return true if the header label of line (columns 61-80)
+      // starts with label.
+   static bool hasLabel(const std::string& line, const char *label)
+   {
+      return (line.size() > 60) &&
+         (line.compare(60, std::char_traits<char>::length(label),
+                       label) == 0);
+   }
+
+
+      // Parse a (possibly signed) integer field of the compact file.
+   static bool parseInteger(const std::string& field, size_t pos,
+                            long long& value)
+   {
+      if (pos >= field.size())
+         return false;
+      const char *begin = field.c_str() + pos;
+      char *end = nullptr;
+      value = std::strtoll(begin, &end, 10);
+      return (end != begin) && (*end == 0);
+   }
+
+
+   CrinexDecoder ::
+   CrinexDecoder()
+   {
+      reset();
+   }
+
+
+   void CrinexDecoder ::
+   reset()
+   {
+      lineCount = 0;
+      crxVersion = 0;
+      stage = CrxVersion;
+      eventLines = 0;
+      obsTypes.clear();
+      epoch.clear();
+      sats.clear();
+      satIndex = 0;
+      clock = Arc();
+      haveClock = false;
+      clockValue = 0;
+      prevSats.clear();
+      curSats.clear();
+   }
+
+
+   bool CrinexDecoder ::
+   isCrinex(const std::string& line)
+   {
+      return hasLabel(line, "CRINEX VERS   / TYPE");
+   }
+
+
+   void CrinexDecoder ::
+   decodeLine(const std::string& text, std::string& out)
+   {
+      lineCount++;
+      std::string line(text);
+      size_t crpos = line.find_last_not_of('\r');
+      line.erase(crpos == std::string::npos ? 0 : crpos+1);
+
+      switch (stage)
+      {
+         case CrxVersion:
+            if (!isCrinex(line))
+               crxError(lineCount, "not a Compact RINEX file");
+            crxVersion = static_cast<int>(
+               std::atof(line.substr(0,20).c_str()));
+            if ((crxVersion != 1) && (crxVersion != 3))
+               crxError(lineCount, "unsupported CRINEX version " +
+                        StringUtils::strip(line.substr(0,20)));
+            stage = CrxProgram;
+            break;
+         case CrxProgram:
+            if (!hasLabel(line, "CRINEX PROG / DATE"))
+               crxError(lineCount, "missing CRINEX PROG / DATE");
+            stage = Header;
+            break;
+         case Header:
+            headerLine(line, out);
+            break;
+         case Epoch:
+            epochLine(line, out);
+            break;
+         case Clock:
+            clockLine(line, out);
+            break;
+         case Data:
+            dataLine(line, out);
+            break;
+         case Event:
+            headerLine(line, out);
+            if (--eventLines <= 0)
+               stage = Epoch;
+            break;
+      }
+   }
+
+
+   void CrinexDecoder ::
+   headerLine(const std::string& line, std::string& out)
+   {
+      if (hasLabel(line, "# / TYPES OF OBSERV"))
+      {
+            // continuation lines leave the count blank
+         std::string count(StringUtils::strip(line.substr(0,6)));
+         if (!count.empty())
+            obsTypes[""] = StringUtils::asInt(count);
+      }
+      else if (hasLabel(line, "SYS / # / OBS TYPES"))
+      {
+         if (line[0] != ' ')
+         {
+            obsTypes[line.substr(0,1)] =
+               StringUtils::asInt(line.substr(3,3));
+         }
+      }
+      else if ((stage == Header) && hasLabel(line, "END OF HEADER"))
+      {
+         stage = Epoch;
+      }
+      out += line;
+      out += '\n';
+   }
+
+
+   void CrinexDecoder ::
+   epochLine(const std::string& line, std::string& out)
+   {
+      if ((crxVersion == 1) && !line.empty() && (line[0] == '&'))
+      {
+         epoch = line;
+         epoch[0] = ' ';
+      }
+      else if ((crxVersion == 3) && !line.empty() && (line[0] == '>'))
+      {
+         epoch = line;
+      }
+      else if (epoch.empty())
+      {
+         crxError(lineCount, "expected a complete epoch line");
+      }
+      else
+      {
+         repair(epoch, line);
+      }
+
+         // RINEX 2: flag in column 29, count in 30-32, satellites
+         // from 33.  RINEX 3: flag in 32, count in 33-35,
+         // satellites from 42.
+      size_t flagPos = (crxVersion == 1 ? 28 : 31);
+      size_t satPos = (crxVersion == 1 ? 32 : 41);
+      if (epoch.size() < flagPos+4)
+         crxError(lineCount, "epoch line too short");
+      char flag = epoch[flagPos];
+      int count = StringUtils::asInt(epoch.substr(flagPos+1, 3));
+
+      if ((flag >= '2') && (flag <= '5'))
+      {
+            // special event, the count is the number of records
+            // that follow, copied as they are
+         std::string head(epoch.substr(0, flagPos+4));
+         appendLine(out, head);
+         eventLines = count;
+         stage = (count > 0 ? Event : Epoch);
+         return;
+      }
+
+      sats.clear();
+      for (int i = 0; i < count; i++)
+      {
+         std::string sat(satPos+3*i < epoch.size() ?
+                         epoch.substr(satPos+3*i, 3) : std::string());
+         sat.resize(3, ' ');
+         sats.push_back(sat);
+      }
+      stage = Clock;
+   }
+
+
+   void CrinexDecoder ::
+   clockLine(const std::string& line, std::string& out)
+   {
+      if (line.empty())
+      {
+         haveClock = false;
+         clock = Arc();
+      }
+      else
+      {
+         try
+         {
+            clockValue = clock.decode(line);
+         }
+         catch (FFStreamError& e)
+         {
+            crxError(lineCount, e.getText());
+         }
+         haveClock = true;
+      }
+
+      if (crxVersion == 1)
+      {
+            // up to 12 satellites per line, the clock offset in
+            // columns 69-80 of the first
+         std::string rec(epoch.substr(0,32));
+         rec.resize(32, ' ');
+         for (size_t i = 0; (i < sats.size()) || (i == 0); i += 12)
+         {
+            if (i > 0)
+               rec.assign(32, ' ');
+            for (size_t j = i; (j < sats.size()) && (j < i+12); j++)
+               rec += sats[j];
+            if ((i == 0) && haveClock)
+            {
+               rec.resize(68, ' ');
+               appendFixed(rec, clockValue, 9, 12);
+            }
+            appendLine(out, rec);
+         }
+      }
+      else
+      {
+         std::string rec(epoch.substr(0,35));
+         if (haveClock)
+         {
+            rec.resize(41, ' ');
+            appendFixed(rec, clockValue, 12, 15);
+         }
+         appendLine(out, rec);
+      }
+
+      curSats.clear();
+      satIndex = 0;
+      if (sats.empty())
+      {
+         prevSats.swap(curSats);
+         stage = Epoch;
+      }
+      else
+      {
+         stage = Data;
+      }
+   }
+
+
+   void CrinexDecoder ::
+   dataLine(const std::string& line, std::string& out)
+   {
+      const std::string& sat(sats[satIndex]);
+      size_t ntypes = numTypes(sat);
+      SatState& state(curSats[sat]);
+      std::map<std::string, SatState>::iterator prev = prevSats.find(sat);
+      if (prev != prevSats.end())
+         state = prev->second;
+      state.arcs.resize(ntypes);
+
+         // ntypes fields separated by single blanks, then the flags.
+         // Fields missing from the end of the line are blank.
+      std::vector<long long> values(ntypes, 0);
+      std::vector<bool> present(ntypes, false);
+      size_t pos = 0;
+      for (size_t i = 0; i < ntypes; i++)
+      {
+         std::string field;
+         if (pos <= line.size())
+         {
+            size_t sep = line.find(' ', pos);
+            if (sep == std::string::npos)
+               sep = line.size();
+            field = line.substr(pos, sep-pos);
+            pos = sep+1;
+         }
+         if (field.empty())
+         {
+            state.arcs[i] = Arc();
+            continue;
+         }
+         try
+         {
+            values[i] = state.arcs[i].decode(field);
+         }
+         catch (FFStreamError& e)
+         {
+            crxError(lineCount, "satellite " + sat + ": " + e.getText());
+         }
+         present[i] = true;
+      }
+      repair(state.flags, pos <= line.size() ? line.substr(pos) :
+             std::string());
+      state.flags.resize(2*ntypes, ' ');
+
+      std::string rec;
+      if (crxVersion == 3)
+         rec = sat;
+      for (size_t i = 0; i < ntypes; i++)
+      {
+         if (present[i])
+         {
+            appendFixed(rec, values[i], 3, 14);
+            rec += state.flags[2*i];
+            rec += state.flags[2*i+1];
+         }
+         else
+         {
+            rec.append(16, ' ');
+         }
+            // RINEX 2 has five observations per line
+         if ((crxVersion == 1) && ((i % 5 == 4) || (i+1 == ntypes)))
+            appendLine(out, rec);
+      }
+      if ((crxVersion == 3) || (ntypes == 0))
+         appendLine(out, rec);
+
+      if (++satIndex == sats.size())
+      {
+         prevSats.swap(curSats);
+         curSats.clear();
+         stage = Epoch;
+      }
+   }
+
+
+   long long CrinexDecoder::Arc ::
+   decode(const std::string& field)
+   {
+      long long value;
+      if ((field.size() > 1) && (field[1] == '&'))
+      {
+         if ((field[0] < '0') || (field[0] > '0'+maxOrder) ||
+             !parseInteger(field, 2, value))
+         {
+            FFStreamError err("invalid arc initialization \"" + field +
+                              "\"");
+            GPSTK_THROW(err);
+         }
+         arcOrder = field[0] - '0';
+         order = 0;
+         u[0] = value;
+         return value;
+      }
+      if (!parseInteger(field, 0, value))
+      {
+         FFStreamError err("invalid field \"" + field + "\"");
+         GPSTK_THROW(err);
+      }
+      if (order < 0)
+      {
+         FFStreamError err("difference \"" + field +
+                           "\" without an initialized arc");
+         GPSTK_THROW(err);
+      }
+      if (order < arcOrder)
+         order++;
+      u[order] = value;
+      for (int i = order; i > 0; i--)
+         u[i-1] += u[i];
+      return u[0];
+   }
+
+
+   void CrinexDecoder ::
+   repair(std::string& text, const std::string& diff)
+   {
+      if (text.size() < diff.size())
+         text.resize(diff.size(), ' ');
+      for (size_t i = 0; i < diff.size(); i++)
+      {
+         if (diff[i] == '&')
+            text[i] = ' ';
+         else if (diff[i] != ' ')
+            text[i] = diff[i];
+      }
+   }
+
+
+   void CrinexDecoder ::
+   appendFixed(std::string& out, long long value, int decimals, int width)
+   {
+      unsigned long long mag = (value < 0 ?
+                                0ULL - static_cast<unsigned long long>(value) :
+                                static_cast<unsigned long long>(value));
+      unsigned long long scale = 1;
+      for (int i = 0; i < decimals; i++)
+         scale *= 10;
+      std::string frac(std::to_string(mag % scale));
+      std::string num((value < 0 ? "-" : "") + std::to_string(mag / scale) +
+                      "." + std::string(decimals - frac.size(), '0') + frac);
+      if (num.size() < static_cast<size_t>(width))
+         out.append(width - num.size(), ' ');
+      out += num;
+   }
+
+
+   void CrinexDecoder ::
+   appendLine(std::string& out, std::string& line)
+   {
+      size_t end = line.find_last_not_of(' ');
+      out.append(line, 0, end == std::string::npos ? 0 : end+1);
+      out += '\n';
+      line.clear();
+   }
+
+
+   size_t CrinexDecoder ::
+   numTypes(const std::string& sat) const
+   {
+      std::map<std::string, size_t>::const_iterator i =
+         obsTypes.find(crxVersion == 1 ? std::string() : sat.substr(0,1));
+      if (i == obsTypes.end())
+         crxError(lineCount, "no observation types for satellite " + sat);
+      return i->second;
+   }
+
+}  // End of namespace gpstk
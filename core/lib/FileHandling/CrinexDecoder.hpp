@@ -0,0 +1,198 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+
+/**
+ * @file CrinexDecoder.hpp
+ * Convert Compact RINEX (Hatanaka) observation text back to RINEX.
+ */
+
+#ifndef GPSTK_CRINEXDECODER_HPP
+#define GPSTK_CRINEXDECODER_HPP
+
+#include <map>
+#include <string>
+#include <vector>
+#include "FFStreamError.hpp"
+
+namespace gpstk
+{
+      /// @ingroup FileHandling
+      //@{
+
+      /**
+       * Line-by-line decoder for Compact RINEX observation files,
+       * CRINEX version 1.0 (RINEX 2 observations) and 3.0 (RINEX 3
+       * observations), as produced by Hatanaka's RNX2CRX.
+       *
+       * Each line of the compact file is given to decodeLine(),
+       * which appends the RINEX lines that can be completed to the
+       * output string.  The two CRINEX header lines are dropped, the
+       * RINEX header is copied, and the data records are rebuilt
+       * from the text-differenced epoch lines and the
+       * integer-differenced observation, clock and flag fields.
+       *
+       * The output follows the layout of CRX2RNX: observations are
+       * written as F14.3 followed by the LLI and SSI flags and
+       * trailing blanks are removed.
+       */
+   class CrinexDecoder
+   {
+   public:
+         /// Set the decoder up for the first line of a file.
+      CrinexDecoder();
+
+         /// Return the decoder to the state of a newly constructed one.
+      void reset();
+
+         /** Return true if \a line is the first line of a Compact
+          * RINEX file, i.e. its label is "CRINEX VERS   / TYPE". */
+      static bool isCrinex(const std::string& line);
+
+         /** Decode the next line of a Compact RINEX file.
+          * @param[in] line a line of the compact file without the
+          *   line terminator.
+          * @param[in,out] out the RINEX lines completed by \a line
+          *   are appended to this, each terminated by '\\n'.
+          * @throw FFStreamError if the line can't be decoded. */
+      void decodeLine(const std::string& line, std::string& out);
+
+         /** Return the CRINEX version, 1 or 3, once the first line
+          * has been decoded and zero before that. */
+      int version() const
+      { return crxVersion; }
+
+         /// The number of lines given to decodeLine() so far.
+      unsigned long lineCount;
+
+         /// The maximum order of the differences in a data arc.
+      static const int maxOrder = 9;
+
+   private:
+         /// Integer differences of one observable (or the clock).
+      struct Arc
+      {
+         Arc() : order(-1), arcOrder(0) {}
+            /** Rebuild the next value from a field of the compact
+             * file, which is either "n&value" starting a new arc of
+             * order n or a difference of the current order. */
+         long long decode(const std::string& field);
+            /// Current order, -1 if the arc has not been started.
+         int order;
+            /// Order the arc is building up to.
+         int arcOrder;
+            /// Last value (u[0]) and its differences.
+         long long u[maxOrder+1];
+      };
+
+         /// The per-satellite state carried from epoch to epoch.
+      struct SatState
+      {
+         std::vector<Arc> arcs;
+         std::string flags;
+      };
+
+      enum Stage
+      {
+         CrxVersion,    ///< expecting "CRINEX VERS   / TYPE"
+         CrxProgram,    ///< expecting "CRINEX PROG / DATE"
+         Header,        ///< copying the RINEX header
+         Epoch,         ///< expecting an epoch line
+         Clock,         ///< expecting the clock line of an epoch
+         Data,          ///< expecting the data line of a satellite
+         Event          ///< copying the special records of an event
+      };
+
+         /// Handle a line of the RINEX header.
+      void headerLine(const std::string& line, std::string& out);
+
+         /// Handle an epoch line.
+      void epochLine(const std::string& line, std::string& out);
+
+         /// Handle the receiver clock offset line and write the epoch.
+      void clockLine(const std::string& line, std::string& out);
+
+         /// Handle the data line of the next satellite in the epoch.
+      void dataLine(const std::string& line, std::string& out);
+
+         /// Apply the text difference \a diff to \a text.
+      static void repair(std::string& text, const std::string& diff);
+
+         /** Format the integer \a value scaled by 10^-\a decimals as
+          * a right justified fixed point number of \a width
+          * characters and append it to \a out. */
+      static void appendFixed(std::string& out, long long value,
+                              int decimals, int width);
+
+         /// Remove trailing blanks from \a line, append it and '\\n'.
+      static void appendLine(std::string& out, std::string& line);
+
+         /// Return the number of observation types for \a sat.
+      size_t numTypes(const std::string& sat) const;
+
+      int crxVersion;
+      Stage stage;
+         /// Number of special records still to copy for an event.
+      int eventLines;
+         /// Observation type counts by system ("" for RINEX 2).
+      std::map<std::string, size_t> obsTypes;
+         /// The reconstructed text of the last epoch line.
+      std::string epoch;
+         /// Whether the next epoch line must be a complete one.
+      bool epochReset;
+         /// Satellites of the current epoch.
+      std::vector<std::string> sats;
+         /// Index into sats of the next data line.
+      size_t satIndex;
+         /// Receiver clock offset differences.
+      Arc clock;
+         /// Whether the current epoch has a clock offset.
+      bool haveClock;
+         /// Clock offset of the current epoch.
+      long long clockValue;
+         /// State of the satellites seen in the previous epoch.
+      std::map<std::string, SatState> prevSats;
+         /// State of the satellites seen in the current epoch.
+      std::map<std::string, SatState> curSats;
+   }; // End of class 'CrinexDecoder'
+
+      //@}
+
+}  // End of namespace gpstk
+
+#endif   // GPSTK_CRINEXDECODER_HPP
@@ -55,6 +55,7 @@ namespace gpstk
    FFTextStream ::
    ~FFTextStream()
    {
+      closeDecoder();
    }
 
 
@@ -64,6 +65,7 @@ namespace gpstk
          : FFStream(fn, mode)
    {
       init();
+      openDecoder(mode);
    }
 
 
@@ -73,6 +75,7 @@ namespace gpstk
          : FFStream( fn.c_str(), mode )
    {
       init();
+      openDecoder(mode);
    }
 
 
@@ -80,8 +83,10 @@ namespace gpstk
    open( const char* fn,
          std::ios::openmode mode )
    {
+      closeDecoder();
       FFStream::open(fn, mode);
       init();
+      openDecoder(mode);
    }
 
 
@@ -93,10 +98,75 @@ namespace gpstk
    }
 
 
+   void FFTextStream ::
+   close()
+   {
+      closeDecoder();
+      FFStream::close();
+   }
+
+
    void FFTextStream ::
    init()
    {
       lineNumber = 0;
+      inputOnly = false;
+   }
+
+
+   void FFTextStream ::
+   enableReadAhead(size_t blockSize)
+   {
+      if (decoder || !inputOnly || !is_open() || !good() ||
+          !openDecoderFile())
+         return;
+      decoder.reset(new CompressedInputBuf(decoderFile, blockSize));
+      std::iostream::rdbuf(decoder.get());
+   }
+
+
+   void FFTextStream ::
+   openDecoder(std::ios::openmode mode)
+   {
+      inputOnly = ((mode & std::ios::in) && !(mode & std::ios::out));
+      if (!is_open() || !inputOnly || !openDecoderFile())
+         return;
+      if (CompressedInputBuf::detect(decoderFile) ==
+          CompressedInputBuf::Plain)
+      {
+         decoderFile.close();
+         return;
+      }
+      decoder.reset(new CompressedInputBuf(decoderFile));
+      std::iostream::rdbuf(decoder.get());
+   }
+
+
+   bool FFTextStream ::
+   openDecoderFile()
+   {
+      std::streampos pos = std::fstream::rdbuf()->pubseekoff(0, std::ios::cur,
+                                                             std::ios::in);
+      if ((pos == std::streampos(-1)) ||
+          !decoderFile.open(filename.c_str(), std::ios::in|std::ios::binary))
+         return false;
+      if (decoderFile.pubseekpos(pos, std::ios::in) != pos)
+      {
+         decoderFile.close();
+         return false;
+      }
+      return true;
+   }
+
+
+   void FFTextStream ::
+   closeDecoder()
+   {
+      if (!decoder)
+         return;
+      std::iostream::rdbuf(std::fstream::rdbuf());
+      decoder.reset();
+      decoderFile.close();
    }
 
 
@@ -151,6 +221,8 @@ namespace gpstk
    {
       try
       {
+            // getline leaves line alone if the stream is already at EOF
+         line.clear();
          std::getline(*this, line);
             // Remove CR characters left over in the buffer from windows files
          size_t crpos = line.find_last_not_of('\r');
@@ -174,6 +246,12 @@ namespace gpstk
             // catch EOF when stream exceptions are disabled
          if ((line.size() == 0) && eof())
          {
+            if (decoder && decoder->failed())
+            {
+               FFStreamError err("Decompression failed: " +
+                                 decoder->errorText());
+               GPSTK_THROW(err);
+            }
             if (expectEOF)
             {
                EndOfFile err("EOF encountered");
@@ -191,6 +269,12 @@ namespace gpstk
             // catch EOF when exceptions are enabled
          if ( (line.size() == 0) && eof())
          {
+            if (decoder && decoder->failed())
+            {
+               FFStreamError err("Decompression failed: " +
+                                 decoder->errorText());
+               GPSTK_THROW(err);
+            }
             if (expectEOF)
             {
                EndOfFile err("EOF encountered");
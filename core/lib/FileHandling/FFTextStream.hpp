@@ -44,7 +44,9 @@
 #ifndef GPSTK_FFTEXTSTREAM_HPP
 #define GPSTK_FFTEXTSTREAM_HPP
 
+#include <memory>
 #include "FFStream.hpp"
+#include "CompressedInputBuf.hpp"
 
 namespace gpstk
 {
@@ -59,6 +61,21 @@ namespace gpstk
        * update the line number - the derived class or programmer
        * needs to make sure that the reader or writer increments
        * lineNumber in these cases.
+       *
+       * Files opened for reading only are checked for gzip and
+       * Compact RINEX (Hatanaka) content.  Such files are decoded on
+       * a background thread by a CompressedInputBuf, so derived
+       * streams read .gz and .crx/.??d archives as if they were the
+       * plain text files.  See isCompressed().  Plain files may be
+       * read the same way, see enableReadAhead().
+       *
+       * The decoder reads the file through its own handle, not the
+       * std::filebuf of the stream.  Use this class's close() (or
+       * open() or the destructor), which stop the decoding thread.
+       * close() is not virtual, so std::fstream::close() (e.g.
+       * through an FFStream& or std::fstream&) closes only the
+       * stream's own handle; the decoder then keeps supplying data
+       * until the stream is reopened or destroyed.
        */
    class FFTextStream : public FFStream
    {
@@ -93,6 +110,41 @@ namespace gpstk
       virtual void open( const std::string& fn,
                          std::ios::openmode mode );
 
+         /** Stop any decompression or read-ahead and close the file.
+          * This hides std::fstream::close(); see the class notes. */
+      void close();
+
+         /** Return true if the file is being decompressed, in which
+          * case the stream can't be repositioned other than to the
+          * start of a record that failed to parse. */
+      bool isCompressed() const
+      { return decoder && (decoder->format() != CompressedInputBuf::Plain); }
+
+         /**
+          * Read the rest of the file on a background thread.  The
+          * thread fills blocks of \a blockSize bytes, double
+          * buffered, while the caller parses lines out of the
+          * previous block, so disk (or network) I/O overlaps with
+          * parsing.  lineNumber, recordNumber and tellg() are
+          * unaffected, but like a compressed file, the stream can
+          * only be repositioned within the current block.
+          *
+          * Call this after opening the file and, typically, before
+          * reading the header.  It has no effect if the file was not
+          * opened for input only, if the stream is not in a good
+          * state, or if the file is compressed (as compressed files
+          * are always decoded on a background thread).  Reading
+          * ahead stops when the stream is closed or reopened.
+          *
+          * @param[in] blockSize size in bytes of each of the two
+          *   buffers.
+          */
+      void enableReadAhead(size_t blockSize = 1048576);
+
+         /// Return true if the file is read on a background thread.
+      bool readAheadEnabled() const
+      { return decoder.get() != nullptr; }
+
          /// The internal line count. When writing, make sure
          /// to increment this.
       unsigned int lineNumber;
@@ -137,6 +189,28 @@ namespace gpstk
          /// Initialize internal data structures
       void init();
 
+         /// Decode the file if it is compressed and opened for input.
+      void openDecoder(std::ios::openmode mode);
+
+         /** Open decoderFile on the file, at the position of the
+          * stream's own std::filebuf.
+          * @return false if that fails. */
+      bool openDecoderFile();
+
+         /// Return to reading the file directly.
+      void closeDecoder();
+
+         /** The decoder's handle on the file, so the stream's
+          * std::filebuf can be closed without disturbing the
+          * decoding thread. */
+      std::filebuf decoderFile;
+
+         /// Decoder for compressed files or read-ahead buffer.
+      std::unique_ptr<CompressedInputBuf> decoder;
+
+         /// Set when the file is open for input and not output.
+      bool inputOnly;
+
    }; // End of class 'FFTextStream'
 
       //@}
@@ -0,0 +1,186 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/**
+ * @file MappedFile.cpp
+ * Read-only memory mapping of an entire file.
+ */
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "MappedFile.hpp"
+
+namespace gpstk
+{
+   MappedFile ::
+   MappedFile()
+         : addr(nullptr), length(0), isMapped(false)
+#ifdef _WIN32
+         , mapHandle(nullptr)
+#endif
+   {
+   }
+
+
+   MappedFile ::
+   MappedFile(const std::string& fn)
+         : addr(nullptr), length(0), isMapped(false)
+#ifdef _WIN32
+         , mapHandle(nullptr)
+#endif
+   {
+      open(fn);
+   }
+
+
+   MappedFile ::
+   ~MappedFile()
+   {
+      close();
+   }
+
+
+   void MappedFile ::
+   open(const std::string& fn)
+   {
+      close();
+      static const char emptyFile[] = "";
+#ifdef _WIN32
+      HANDLE fh = CreateFileA(fn.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                              NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                              NULL);
+      if (fh == INVALID_HANDLE_VALUE)
+      {
+         FileMissingException exc("File " + fn + " could not be opened.");
+         GPSTK_THROW(exc);
+      }
+      LARGE_INTEGER fsize;
+      if (!GetFileSizeEx(fh, &fsize))
+      {
+         CloseHandle(fh);
+         FileMissingException exc("File " + fn + " could not be sized.");
+         GPSTK_THROW(exc);
+      }
+      length = static_cast<size_t>(fsize.QuadPart);
+      if (length == 0)
+      {
+         CloseHandle(fh);
+         addr = emptyFile;
+         return;
+      }
+      mapHandle = CreateFileMappingA(fh, NULL, PAGE_READONLY, 0, 0, NULL);
+      CloseHandle(fh);
+      if (mapHandle == NULL)
+      {
+         length = 0;
+         FileMissingException exc("File " + fn + " could not be mapped.");
+         GPSTK_THROW(exc);
+      }
+      addr = static_cast<const char*>(
+         MapViewOfFile(mapHandle, FILE_MAP_READ, 0, 0, 0));
+      if (addr == nullptr)
+      {
+         CloseHandle(mapHandle);
+         mapHandle = nullptr;
+         length = 0;
+         FileMissingException exc("File " + fn + " could not be mapped.");
+         GPSTK_THROW(exc);
+      }
+#else
+      int fd = ::open(fn.c_str(), O_RDONLY);
+      if (fd < 0)
+      {
+         FileMissingException exc("File " + fn + " could not be opened.");
+         GPSTK_THROW(exc);
+      }
+      struct stat sb;
+      if (fstat(fd, &sb) != 0)
+      {
+         ::close(fd);
+         FileMissingException exc("File " + fn + " could not be sized.");
+         GPSTK_THROW(exc);
+      }
+      length = static_cast<size_t>(sb.st_size);
+      if (length == 0)
+      {
+         ::close(fd);
+         addr = emptyFile;
+         return;
+      }
+      void *mem = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+         // the mapping remains valid after the descriptor is closed
+      ::close(fd);
+      if (mem == MAP_FAILED)
+      {
+         length = 0;
+         FileMissingException exc("File " + fn + " could not be mapped.");
+         GPSTK_THROW(exc);
+      }
+      addr = static_cast<const char*>(mem);
+#endif
+      isMapped = true;
+   }
+
+
+   void MappedFile ::
+   close()
+   {
+      if (isMapped)
+      {
+#ifdef _WIN32
+         UnmapViewOfFile(addr);
+         CloseHandle(mapHandle);
+         mapHandle = nullptr;
+#else
+         munmap(const_cast<char*>(addr), length);
+#endif
+      }
+      addr = nullptr;
+      length = 0;
+      isMapped = false;
+   }
+
+} // namespace gpstk
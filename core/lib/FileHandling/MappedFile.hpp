@@ -0,0 +1,124 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/**
+ * @file MappedFile.hpp
+ * Read-only memory mapping of an entire file.
+ */
+
+#ifndef GPSTK_MAPPEDFILE_HPP
+#define GPSTK_MAPPEDFILE_HPP
+
+#include <string>
+#include "Exception.hpp"
+
+namespace gpstk
+{
+      /// @ingroup FileHandling
+      //@{
+
+      /**
+       * Map the contents of a file read-only into memory so that
+       * parsers can work directly on the file's bytes rather than
+       * copying them through a stream buffer.  The mapping is
+       * released when the object is destroyed or close() is called.
+       *
+       * @code
+       * MappedFile mf("data.15o");
+       * const char *bytes = mf.data();
+       * for (size_t i = 0; i < mf.size(); i++) ...
+       * @endcode
+       */
+   class MappedFile
+   {
+   public:
+         /// Create an object with no file mapped.
+      MappedFile();
+
+         /** Map the file \a fn.
+          * @param[in] fn the name of the file to map.
+          * @throw FileMissingException if the file can't be mapped.
+          */
+      MappedFile(const std::string& fn);
+
+         /// Release the mapping.
+      ~MappedFile();
+
+         /** Map the file \a fn, releasing any existing mapping first.
+          * @param[in] fn the name of the file to map.
+          * @throw FileMissingException if the file can't be mapped.
+          */
+      void open(const std::string& fn);
+
+         /// Release the mapping, if any.
+      void close();
+
+         /// @return true if a file is currently open.
+      bool isOpen() const
+      { return addr != nullptr; }
+
+         /// @return a pointer to the first byte of the file.
+      const char* data() const
+      { return addr; }
+
+         /// @return the number of bytes in the file.
+      size_t size() const
+      { return length; }
+
+   private:
+         // Mappings own OS resources, so copying is not allowed.
+      MappedFile(const MappedFile&);
+      MappedFile& operator=(const MappedFile&);
+
+         /// Start of the mapped file contents.
+      const char *addr;
+         /// Size of the file in bytes.
+      size_t length;
+         /// Set when addr refers to a mapping (empty files aren't mapped).
+      bool isMapped;
+#ifdef _WIN32
+         /// Windows file mapping object handle.
+      void *mapHandle;
+#endif
+   }; // class MappedFile
+
+      //@}
+
+} // namespace gpstk
+
+#endif // GPSTK_MAPPEDFILE_HPP
@@ -53,6 +53,24 @@ using namespace std;
 
 namespace gpstk
 {
+      /// Length of \a line once trailing blanks are removed.
+   static size_t strippedLength(const char *line, size_t len)
+   {
+      while((len > 0) && (line[len-1] == ' '))
+         len--;
+      return len;
+   }
+
+
+      /** Width of the field at \a pos of a \a len character line,
+       * clipped the same way as std::string::substr(pos, n). The
+       * caller must check that \a pos is not past the end of the line. */
+   static size_t fieldWidth(size_t len, size_t pos, size_t n)
+   {
+      return std::min(n, len - pos);
+   }
+
+
    void reallyPutRecordVer2( Rinex3ObsStream& strm,
                              const Rinex3ObsData& rod )
    {
@@ -616,6 +634,12 @@ namespace gpstk
          return;
       }
 
+      if(strm.memoryMapped && !strm.isCompressed())
+      {
+         reallyGetRecordMapped(strm);
+         return;
+      }
+
       string line;
 
          // read the first (epoch) line
@@ -629,6 +653,13 @@ namespace gpstk
          FFStreamError e("Bad epoch line: >" + line + "<");
          GPSTK_THROW(e);
       }
+         // The epoch flag and number of satellites start in columns
+         // 32 and 33.
+      if(line.size() < 32)
+      {
+         FFStreamError e("Epoch line too short: >" + line + "<");
+         GPSTK_THROW(e);
+      }
 
       epochFlag = asInt(line.substr(31,1));
       if(epochFlag < 0 || epochFlag > 6)
@@ -727,15 +758,124 @@ namespace gpstk
    } // end of reallyGetRecord()
 
 
+   void Rinex3ObsData::reallyGetRecordMapped(Rinex3ObsStream& strm)
+   {
+      size_t len;
+
+         // read the first (epoch) line
+      const char *line = strm.mappedGetLine(len, true);
+      len = strippedLength(line, len);
+
+         // Check and parse the epoch line -----------------------------------
+         // Check for epoch marker ('>') and following space.
+      if(len < 2 || line[0] != '>' || line[1] != ' ')
+      {
+         FFStreamError e("Bad epoch line: >" + string(line, len) + "<");
+         GPSTK_THROW(e);
+      }
+         // The epoch flag and number of satellites start in columns
+         // 32 and 33.
+      if(len < 32)
+      {
+         FFStreamError e("Epoch line too short: >" + string(line, len) + "<");
+         GPSTK_THROW(e);
+      }
+
+      epochFlag = asInt(line+31, fieldWidth(len, 31, 1));
+      if(epochFlag < 0 || epochFlag > 6)
+      {
+         FFStreamError e("Invalid epoch flag: " + asString(epochFlag));
+         GPSTK_THROW(e);
+      }
+
+      time = parseTime(line, len, strm.timesystem);
+
+      numSVs = asInt(line+32, fieldWidth(len, 32, 3));
+
+      if(len > 41)
+         clockOffset = asDouble(line+41, fieldWidth(len, 41, 15));
+      else
+         clockOffset = 0.0;
+
+         // Read the observations: SV ID and data ----------------------------
+      if(epochFlag == 0 || epochFlag == 1 || epochFlag == 6)
+      {
+         for(int isv = 0; isv < numSVs; isv++)
+         {
+            line = strm.mappedGetLine(len);
+            len = strippedLength(line, len);
+
+               // get the SV ID
+            RinexSatID sat;
+            try
+            {
+               sat = RinexSatID(string(line, std::min(len, size_t(3))));
+            }
+            catch (Exception& e)
+            {
+               FFStreamError ffse(e);
+               GPSTK_THROW(ffse);
+            }
+
+            string gnss(1, sat.systemChar());
+            int size = strm.header.mapObsTypes[gnss].size();
+
+               // Parse each datum in place.  Only the datum that
+               // runs past the end of a short line is copied, padded
+               // with the blanks some receivers leave off.
+            vector<RinexDatum>& data = obs[sat];
+            data.resize(size);
+            for(int i = 0; i < size; i++)
+            {
+               size_t pos = 3 + 16*i;
+               if(pos + 16 <= len)
+               {
+                  data[i].fromString(line + pos);
+               }
+               else
+               {
+                  char padded[16];
+                  std::fill(padded, padded+16, ' ');
+                  if(pos < len)
+                     std::copy(line + pos, line + len, padded);
+                  data[i].fromString(padded);
+               }
+            }
+         }
+      }
+
+         // ... or the auxiliary header information
+      else if(numSVs > 0)
+      {
+         auxHeader.clear();
+         for(int i = 0; i < numSVs; i++)
+         {
+            line = strm.mappedGetLine(len);
+            string hline(line, len);
+            StringUtils::stripTrailing(hline);
+            auxHeader.parseHeaderRecord(hline);
+         }
+      }
+   } // end of reallyGetRecordMapped()
+
+
    CommonTime Rinex3ObsData::parseTime(const string& line,
                                        const Rinex3ObsHeader& hdr,
                                        const TimeSystem& ts) const
+   {
+      return parseTime(line.c_str(), line.size(), ts);
+   }
+
+
+   CommonTime Rinex3ObsData::parseTime(const char *line, size_t len,
+                                       const TimeSystem& ts) const
    {
       try
       {
             // check if the spaces are in the right place - an easy
             // way to check if there's corruption in the file
-         if( (line[ 1] != ' ') || (line[ 6] != ' ') || (line[ 9] != ' ') ||
+         if( (len < 31) ||
+             (line[ 1] != ' ') || (line[ 6] != ' ') || (line[ 9] != ' ') ||
              (line[12] != ' ') || (line[15] != ' ') || (line[18] != ' ') ||
              (line[29] != ' ') || (line[30] != ' '))
          {
@@ -744,18 +884,18 @@ namespace gpstk
          }
 
             // if there's no time, just return a bad time
-         if(line.substr(2,27) == string(27, ' '))
+         if(strippedLength(line+2, 27) == 0)
             return CommonTime::BEGINNING_OF_TIME;
 
          int year, month, day, hour, min;
          double sec;
 
-         year  = asInt(   line.substr( 2,  4));
-         month = asInt(   line.substr( 7,  2));
-         day   = asInt(   line.substr(10,  2));
-         hour  = asInt(   line.substr(13,  2));
-         min   = asInt(   line.substr(16,  2));
-         sec   = asDouble(line.substr(19, 11));
+         year  = asInt(   line +  2,  4);
+         month = asInt(   line +  7,  2);
+         day   = asInt(   line + 10,  2);
+         hour  = asInt(   line + 13,  2);
+         min   = asInt(   line + 16,  2);
+         sec   = asDouble(line + 19, 11);
 
             // Real Rinex has epochs 'yy mm dd hr 59 60.0' surprisingly often.
          double ds = 0;
@@ -56,6 +56,7 @@
 
 namespace gpstk
 {
+   class Rinex3ObsStream;
 
       /// @ingroup FileHandling
       //@{
@@ -232,6 +233,28 @@ namespace gpstk
                             const TimeSystem& ts) const;
 
 
+         /** Construct a CommonTime from an epoch line that has not
+          * been copied out of the file.
+          *
+          * @param line The epoch line found in the RINEX record.
+          * @param len  The number of characters in \a line.
+          * @param ts   The time system of the file.
+          * @throw FFStreamError
+          */
+      CommonTime parseTime( const char *line, size_t len,
+                            const TimeSystem& ts) const;
+
+
+         /** Read a RINEX 3 record directly out of the memory-mapped
+          * file of \a strm, avoiding the per-line string copies and
+          * substr() calls of reallyGetRecord().
+          * @throw std::exception
+          * @throw StringException When a StringUtils function fails
+          * @throw FFStreamError   When a read or formatting error occurs.
+          */
+      void reallyGetRecordMapped(Rinex3ObsStream& strm);
+
+
    }; // End of class 'Rinex3ObsData'
 
       //@}
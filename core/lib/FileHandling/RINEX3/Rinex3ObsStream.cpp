@@ -41,6 +41,7 @@
  * File stream for RINEX 3 observation file data.
  */
 
+#include <cstring>
 #include "Rinex3ObsStream.hpp"
 
 namespace gpstk
@@ -81,6 +82,8 @@ namespace gpstk
          std::ios::openmode mode )
    {
       FFTextStream::open(fn, mode);
+      mappedFile.close();
+      mappedPos = 0;
    }
 
 
@@ -90,6 +93,9 @@ namespace gpstk
       headerRead = false;
       header = Rinex3ObsHeader();
       timesystem = TimeSystem::GPS;
+      memoryMapped = false;
+      mappedFile.close();
+      mappedPos = 0;
    }
 
 
@@ -116,4 +122,90 @@ namespace gpstk
       return true;
    }
 
+
+   const char* Rinex3ObsStream ::
+   mappedGetLine(size_t& len, const bool expectEOF)
+   {
+      if (!mappedFile.isOpen())
+      {
+         try
+         {
+            mappedFile.open(filename);
+         }
+         catch (Exception& exc)
+         {
+            FFStreamError err(exc);
+            GPSTK_THROW(err);
+         }
+         std::streamoff start = tellg();
+         mappedPos = (start > 0 ? static_cast<size_t>(start) : 0);
+      }
+      if (mappedPos >= mappedFile.size())
+      {
+            // Set the same state std::getline leaves at the end of
+            // the file so that "while (strm >> data)" loops end.
+         try
+         {
+            setstate(std::ios::eofbit | std::ios::failbit);
+         }
+         catch (std::exception&)
+         {
+         }
+         if (expectEOF)
+         {
+            EndOfFile err("EOF encountered");
+            GPSTK_THROW(err);
+         }
+         else
+         {
+            FFStreamError err("Unexpected EOF encountered");
+            GPSTK_THROW(err);
+         }
+      }
+      const char *line = mappedFile.data() + mappedPos;
+      size_t avail = mappedFile.size() - mappedPos;
+      const char *eol = static_cast<const char*>(std::memchr(line,'\n',avail));
+      if (eol == nullptr)
+      {
+         len = avail;
+         mappedPos = mappedFile.size();
+      }
+      else
+      {
+         len = eol - line;
+         mappedPos += len + 1;
+      }
+         // Remove CR characters left over from windows files
+      while ((len > 0) && (line[len-1] == '\r'))
+         len--;
+      for (size_t i = 0; i < len; i++)
+      {
+         if (!isprint(static_cast<unsigned char>(line[i])))
+         {
+            FFStreamError err("Non-text data in file.");
+            GPSTK_THROW(err);
+         }
+      }
+      lineNumber++;
+      return line;
+   }
+
+
+   void Rinex3ObsStream ::
+   tryFFStreamGet(FFData& rec)
+   {
+      size_t initialMappedPos = mappedPos;
+      try
+      {
+         FFTextStream::tryFFStreamGet(rec);
+      }
+      catch (...)
+      {
+         mappedPos = initialMappedPos;
+         throw;
+      }
+      if (fail() && !eof())
+         mappedPos = initialMappedPos;
+   }
+
 } // namespace gpstk
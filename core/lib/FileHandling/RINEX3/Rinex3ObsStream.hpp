@@ -50,6 +50,7 @@
 #include <string>
 
 #include "FFTextStream.hpp"
+#include "MappedFile.hpp"
 #include "Rinex3ObsHeader.hpp"
 
 namespace gpstk
@@ -112,12 +113,54 @@ namespace gpstk
          /// Time system for epochs in this file
       TimeSystem timesystem;
 
+         /** When set, data records of RINEX 3 files are parsed
+          * directly out of a read-only memory mapping of the file
+          * rather than being copied line by line through
+          * formattedGetLine().  The header is still read through the
+          * stream and the resulting Rinex3ObsData records are
+          * identical in either mode.  Set this before reading the
+          * first data record.  Has no effect on RINEX 2 files,
+          * compressed files (see isCompressed()) or when writing. */
+      bool memoryMapped;
+
          /// Check if the input stream is the kind of Rinex3ObsStream
       static bool isRinex3ObsStream(std::istream& i);
 
+         /**
+          * The memory-mapped counterpart of formattedGetLine().
+          * Returns a pointer to the next line of the mapped file
+          * without copying it.  The file is mapped on first use,
+          * starting at the current stream position, i.e. just after
+          * the header.  Trailing '\r' characters are excluded from
+          * \a len.  Also increments lineNumber.
+          * @param[out] len the number of characters in the line.
+          * @param[in] expectEOF set true if finding EOF on this read
+          *   is acceptable.
+          * @return a pointer to the first character of the line,
+          *   valid until the stream is closed or reopened.
+          * @throw EndOfFile if \a expectEOF is true and an EOF is
+          *   encountered.
+          * @throw FFStreamError if EOF is found and \a expectEOF is
+          *   false, or if the file can't be mapped.
+          */
+      const char* mappedGetLine(size_t& len, const bool expectEOF = false);
+
+   protected:
+         /** Calls FFTextStream::tryFFStreamGet and restores the
+          * memory-mapped read position when a record fails to parse.
+          * @throw FFStreamError
+          * @throw StringUtils::StringException
+          */
+      virtual void tryFFStreamGet(FFData& rec);
+
    private:
          /// Initialize internal data structures.
       void init();
+
+         /// The file contents when memoryMapped is set.
+      MappedFile mappedFile;
+         /// Offset of the next unread line in mappedFile.
+      size_t mappedPos;
    }; // class 'Rinex3ObsStream'
 
       //@}
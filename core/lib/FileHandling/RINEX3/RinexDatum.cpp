@@ -40,12 +40,20 @@
  * Defines class methods for a single RINEX datum.
  */
 
+#include <algorithm>
 #include "RinexDatum.hpp"
 #include "Exception.hpp"
 #include "StringUtils.hpp"
 
 namespace gpstk
 {
+      /// Predicate for finding the non-blank part of a field.
+   static bool notBlank(char c)
+   {
+      return c != ' ';
+   }
+
+
    RinexDatum ::
    RinexDatum()
          : data(0), lli(0), ssi(0),
@@ -65,39 +73,42 @@ namespace gpstk
    void RinexDatum ::
    fromString(const std::string& str)
    {
-      std::string tmpStr;
       GPSTK_ASSERT(str.length() == 16);
-      tmpStr = str.substr(0, 14);
-      if (tmpStr.find_last_not_of(" ") == std::string::npos)
+      fromString(str.data());
+   }
+
+
+   void RinexDatum ::
+   fromString(const char *str)
+   {
+      if (std::find_if(str, str+14, notBlank) == str+14)
       {
          data = 0.;
          dataBlank = true;
       }
       else
       {
-         data = StringUtils::asDouble(tmpStr);
+         data = StringUtils::asDouble(str, 14);
          dataBlank = false;
       }
-      tmpStr = str.substr(14, 1);
-      if (tmpStr == " ")
+      if (str[14] == ' ')
       {
          lli = 0.;
          lliBlank = true;
       }
       else
       {
-         lli = StringUtils::asInt(tmpStr);
+         lli = StringUtils::asInt(str+14, 1);
          lliBlank = false;
       }
-      tmpStr = str.substr(15, 1);
-      if (tmpStr == " ")
+      if (str[15] == ' ')
       {
          ssi = 0.;
          ssiBlank = true;
       }
       else
       {
-         ssi = StringUtils::asInt(tmpStr);
+         ssi = StringUtils::asInt(str+15, 1);
          ssiBlank = false;
       }
    }
@@ -70,6 +70,11 @@ namespace gpstk
           * @throw AssertionFailure if str.length() != 16 */
       void fromString(const std::string& str);
 
+         /** Parse a RINEX OBS datum in place, without copying it.
+          * @param[in] str pointer to a RINEX-formatted datum, which
+          *   must have 16 readable characters. */
+      void fromString(const char *str);
+
          /// Turn this datum into a RINEX OBS formatted string
       std::string asString() const;
 
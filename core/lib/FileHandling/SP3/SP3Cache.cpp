@@ -0,0 +1,259 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/**
+ * @file SP3Cache.cpp
+ * Binary cache of the data records of an SP3 file.
+ */
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include "SP3Cache.hpp"
+
+namespace gpstk
+{
+   namespace
+   {
+         /// Start of a cache file.
+      struct CacheHeader
+      {
+         char magic[8];         ///< "GPSTKSP3"
+         uint32_t version;      ///< SP3Cache::version
+         uint32_t byteOrder;    ///< byteOrderMark as written
+         uint32_t recordSize;   ///< sizeof(SP3Cache::Record)
+         uint32_t pad;          ///< unused, zero
+         uint64_t sourceSize;   ///< size of the SP3 file in bytes
+         int64_t sourceMTime;   ///< modification time of the SP3 file
+         uint64_t count;        ///< number of records
+      };
+
+      const char cacheMagic[8] = { 'G','P','S','T','K','S','P','3' };
+      const uint32_t byteOrderMark = 0x01020304;
+
+         // Record is read in place from the mapped file.
+      static_assert(sizeof(SP3Cache::Record) % 8 == 0,
+                    "SP3Cache::Record must keep 8-byte alignment");
+      static_assert(sizeof(CacheHeader) % 8 == 0,
+                    "CacheHeader must keep 8-byte alignment");
+
+      const uint8_t orbitPredBit = 0x01;
+      const uint8_t clockPredBit = 0x02;
+      const uint8_t correlationBit = 0x04;
+
+         /** Fill in the parts of hdr that identify the SP3 file.
+          * @return false if the SP3 file can't be examined. */
+      bool setSource(const std::string& source, CacheHeader& hdr)
+      {
+         struct stat sb;
+         if (stat(source.c_str(), &sb) != 0)
+            return false;
+         std::memcpy(hdr.magic, cacheMagic, sizeof(hdr.magic));
+         hdr.version = SP3Cache::version;
+         hdr.byteOrder = byteOrderMark;
+         hdr.recordSize = sizeof(SP3Cache::Record);
+         hdr.pad = 0;
+         hdr.sourceSize = sb.st_size;
+         hdr.sourceMTime = sb.st_mtime;
+         hdr.count = 0;
+         return true;
+      }
+   }
+
+
+   SP3Cache ::
+   SP3Cache()
+         : count(0), recs(nullptr)
+   {
+   }
+
+
+   bool SP3Cache ::
+   open(const std::string& fn, const std::string& source)
+   {
+      close();
+      CacheHeader expected;
+      if (!setSource(source, expected))
+         return false;
+      try
+      {
+         file.open(fn);
+      }
+      catch (Exception& e)
+      {
+         return false;
+      }
+      if (file.size() < sizeof(CacheHeader))
+      {
+         file.close();
+         return false;
+      }
+      CacheHeader hdr;
+      std::memcpy(&hdr, file.data(), sizeof(hdr));
+      if (std::memcmp(hdr.magic, expected.magic, sizeof(hdr.magic)) != 0 ||
+          hdr.version != expected.version ||
+          hdr.byteOrder != expected.byteOrder ||
+          hdr.recordSize != expected.recordSize ||
+          hdr.sourceSize != expected.sourceSize ||
+          hdr.sourceMTime != expected.sourceMTime ||
+          file.size() != sizeof(CacheHeader) + hdr.count * sizeof(Record))
+      {
+         file.close();
+         return false;
+      }
+      count = hdr.count;
+      recs = reinterpret_cast<const Record*>(file.data() + sizeof(CacheHeader));
+      return true;
+   }
+
+
+   void SP3Cache ::
+   close()
+   {
+      file.close();
+      count = 0;
+      recs = nullptr;
+   }
+
+
+   void SP3Cache ::
+   write(const std::string& fn, const std::string& source,
+         const std::vector<Record>& recs)
+   {
+      CacheHeader hdr;
+      if (!setSource(source, hdr))
+      {
+         FileMissingException exc("File " + source + " could not be found.");
+         GPSTK_THROW(exc);
+      }
+      hdr.count = recs.size();
+      std::string tmpName(fn + ".tmp");
+      {
+         std::ofstream out(tmpName.c_str(), std::ios::out | std::ios::binary);
+         out.write(reinterpret_cast<const char*>(&hdr), sizeof(hdr));
+         if (!recs.empty())
+         {
+            out.write(reinterpret_cast<const char*>(&recs[0]),
+                      recs.size() * sizeof(Record));
+         }
+         out.close();
+         if (!out)
+         {
+            std::remove(tmpName.c_str());
+            FileMissingException exc("File " + tmpName +
+                                      " could not be written.");
+            GPSTK_THROW(exc);
+         }
+      }
+#ifdef _WIN32
+         // rename doesn't replace existing files on Windows
+      std::remove(fn.c_str());
+#endif
+      if (std::rename(tmpName.c_str(), fn.c_str()) != 0)
+      {
+         std::remove(tmpName.c_str());
+         FileMissingException exc("File " + fn + " could not be written.");
+         GPSTK_THROW(exc);
+      }
+   }
+
+
+   void SP3Cache ::
+   fromData(const SP3Data& data, Record& rec)
+   {
+      long day, sod;
+      double fsod;
+      TimeSystem ts;
+      data.time.get(day, sod, fsod, ts);
+      rec.day = day;
+      rec.sod = sod;
+      rec.fsod = fsod;
+      rec.timeSystem = static_cast<int32_t>(ts);
+      for (unsigned i = 0; i < 3; i++)
+         rec.x[i] = data.x[i];
+      rec.clk = data.clk;
+      for (unsigned i = 0; i < 4; i++)
+      {
+         rec.sig[i] = data.sig[i];
+         rec.sdev[i] = data.sdev[i];
+      }
+      rec.satID = data.sat.id;
+      rec.satSys = static_cast<int32_t>(data.sat.system);
+      rec.recType = data.RecType;
+      rec.flags = ((data.orbitPredFlag ? orbitPredBit : 0) |
+                   (data.clockPredFlag ? clockPredBit : 0) |
+                   (data.correlationFlag ? correlationBit : 0));
+      rec.pad[0] = rec.pad[1] = 0;
+   }
+
+
+   void SP3Cache ::
+   toData(const Record& rec, SP3Data& data)
+   {
+      data.time.set(rec.day, rec.sod, rec.fsod,
+                    static_cast<TimeSystem>(rec.timeSystem));
+      for (unsigned i = 0; i < 3; i++)
+         data.x[i] = rec.x[i];
+      data.clk = rec.clk;
+      for (unsigned i = 0; i < 4; i++)
+      {
+         data.sig[i] = rec.sig[i];
+         data.sdev[i] = rec.sdev[i];
+      }
+      data.sat = SatID(rec.satID, static_cast<SatelliteSystem>(rec.satSys));
+      data.RecType = rec.recType;
+      data.orbitPredFlag = (rec.flags & orbitPredBit) != 0;
+      data.clockPredFlag = (rec.flags & clockPredBit) != 0;
+      data.correlationFlag = (rec.flags & correlationBit) != 0;
+   }
+
+
+   std::string SP3Cache ::
+   cacheFileName(const std::string& source, const std::string& dir)
+   {
+      if (dir.empty())
+         return source + ".cache";
+      std::string::size_type pos = source.find_last_of("/\\");
+      std::string base(pos == std::string::npos ? source
+                       : source.substr(pos + 1));
+      return dir + "/" + base + ".cache";
+   }
+
+} // namespace gpstk
@@ -0,0 +1,169 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/**
+ * @file SP3Cache.hpp
+ * Binary cache of the data records of an SP3 file.
+ */
+
+#ifndef GPSTK_SP3CACHE_HPP
+#define GPSTK_SP3CACHE_HPP
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include "MappedFile.hpp"
+#include "SP3Data.hpp"
+
+namespace gpstk
+{
+      /// @ingroup FileHandling
+      //@{
+
+      /**
+       * A binary copy of the data records of an SP3 file, so that
+       * the file can be reloaded without parsing its text again.
+       * The cache holds, in file order, one fixed-size Record for
+       * each SP3Data read from the file, containing the fields used
+       * by SP3EphemerisStore.  The file header is not cached, as it
+       * is small and is read from the SP3 file itself.
+       *
+       * A cache file starts with a header holding a format version,
+       * the byte order, the record size and the size and
+       * modification time of the SP3 file it was made from.  The
+       * cache is only used if all of these match, so a cache made
+       * by another version of this class or on another platform, or
+       * from a file that has since changed, is ignored.  The records
+       * are read in place from a memory mapping of the cache file.
+       *
+       * @code
+       * SP3Cache cache;
+       * if (cache.open(SP3Cache::cacheFileName("igs20354.sp3"),
+       *                "igs20354.sp3"))
+       * {
+       *    SP3Data data;
+       *    for (size_t i = 0; i < cache.size(); i++)
+       *       SP3Cache::toData(cache.records()[i], data);
+       * }
+       * @endcode
+       */
+   class SP3Cache
+   {
+   public:
+         /// Format version, incremented when Record changes.
+      static const uint32_t version = 1;
+
+         /// The cached contents of one SP3Data.
+      struct Record
+      {
+         int64_t day;          ///< CommonTime day of time
+         int64_t sod;          ///< CommonTime second of day of time
+         double fsod;          ///< CommonTime fractional second of time
+         double x[3];          ///< SP3Data::x
+         double clk;           ///< SP3Data::clk
+         int32_t sig[4];       ///< SP3Data::sig
+         uint32_t sdev[4];     ///< SP3Data::sdev
+         int32_t satID;        ///< SP3Data::sat id
+         int32_t satSys;       ///< SP3Data::sat system
+         int32_t timeSystem;   ///< time system of time
+         char recType;         ///< SP3Data::RecType
+         uint8_t flags;        ///< prediction and correlation flags
+         uint8_t pad[2];       ///< unused, zero
+      };
+
+         /// Create an object with no cache open.
+      SP3Cache();
+
+         /** Map the cache file \a fn, if it is up to date with
+          * respect to the SP3 file \a source.
+          * @param[in] fn the name of the cache file.
+          * @param[in] source the name of the SP3 file.
+          * @return true if the cache was opened, false if it does
+          *   not exist, is out of date or is not valid. */
+      bool open(const std::string& fn, const std::string& source);
+
+         /// Release the cache file.
+      void close();
+
+         /// @return the number of records in the open cache.
+      size_t size() const
+      { return count; }
+
+         /// @return the records of the open cache.
+      const Record* records() const
+      { return recs; }
+
+         /** Write a cache file for the SP3 file \a source.  The file
+          * is written under a temporary name and then renamed, so a
+          * partly written cache is never used.
+          * @param[in] fn the name of the cache file.
+          * @param[in] source the name of the SP3 file.
+          * @param[in] recs the records read from \a source.
+          * @throw FileMissingException if the file can't be written. */
+      static void write(const std::string& fn, const std::string& source,
+                        const std::vector<Record>& recs);
+
+         /// Copy the cached fields of \a data into \a rec.
+      static void fromData(const SP3Data& data, Record& rec);
+
+         /** Set the cached fields of \a data from \a rec.  Other
+          * fields are left unchanged. */
+      static void toData(const Record& rec, SP3Data& data);
+
+         /** Return the name of the cache file for an SP3 file.
+          * @param[in] source the name of the SP3 file.
+          * @param[in] dir the directory to keep cache files in;
+          *   empty to use the same directory as \a source.
+          * @return the cache file name. */
+      static std::string cacheFileName(const std::string& source,
+                                       const std::string& dir = "");
+
+   private:
+         /// The mapped cache file.
+      MappedFile file;
+         /// Number of records in the open cache.
+      size_t count;
+         /// Records of the open cache, within file.
+      const Record *recs;
+   }; // class SP3Cache
+
+      //@}
+
+} // namespace gpstk
+
+#endif // GPSTK_SP3CACHE_HPP
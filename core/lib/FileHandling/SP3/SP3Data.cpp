@@ -39,6 +39,7 @@
 /// @file SP3Data.cpp
 /// Encapsulate SP3 file data, including I/O
 
+#include <algorithm>
 #include "SP3Stream.hpp"
 #include "SP3Header.hpp"
 #include "SP3Data.hpp"
@@ -51,6 +52,25 @@ using namespace std;
 
 namespace gpstk
 {
+   namespace
+   {
+         // Parse the field of line at pos of length n, as
+         // asDouble(line.substr(pos,n)) does but without a copy.
+      inline double fieldDouble(const string& line, string::size_type pos,
+                                string::size_type n)
+      {
+         return asDouble(line.data() + pos, std::min(n, line.size() - pos));
+      }
+
+         // Parse the field of line at pos of length n, as
+         // asInt(line.substr(pos,n)) does but without a copy.
+      inline long fieldInt(const string& line, string::size_type pos,
+                           string::size_type n)
+      {
+         return asInt(line.data() + pos, std::min(n, line.size() - pos));
+      }
+   }
+
    void SP3Data::reallyGetRecord(FFStream& ffs)
    {
       // cast the stream to be an SP3Stream
@@ -158,12 +178,12 @@ namespace gpstk
 
             // parse the epoch line
             RecType = strm.lastLine[0];
-            int year = asInt(strm.lastLine.substr(3,4));
-            int month = asInt(strm.lastLine.substr(8,2));
-            int dom = asInt(strm.lastLine.substr(11,2));
-            int hour = asInt(strm.lastLine.substr(14,2));
-            int minute = asInt(strm.lastLine.substr(17,2));
-            double second = asInt(strm.lastLine.substr(20,10));
+            int year = fieldInt(strm.lastLine,3,4);
+            int month = fieldInt(strm.lastLine,8,2);
+            int dom = fieldInt(strm.lastLine,11,2);
+            int hour = fieldInt(strm.lastLine,14,2);
+            int minute = fieldInt(strm.lastLine,17,2);
+            double second = fieldInt(strm.lastLine,20,10);
             CivilTime t;
             try {
                t = CivilTime(year, month, dom, hour, minute, second, timeSystem);
@@ -202,10 +222,10 @@ namespace gpstk
             // parse the line
             sat = static_cast<SatID>(SP3SatID(strm.lastLine.substr(1,3)));
 
-            x[0] = asDouble(strm.lastLine.substr(4,14));             // XYZ
-            x[1] = asDouble(strm.lastLine.substr(18,14));
-            x[2] = asDouble(strm.lastLine.substr(32,14));
-            clk = asDouble(strm.lastLine.substr(46,14));             // Clock
+            x[0] = fieldDouble(strm.lastLine,4,14);             // XYZ
+            x[1] = fieldDouble(strm.lastLine,18,14);
+            x[2] = fieldDouble(strm.lastLine,32,14);
+            clk = fieldDouble(strm.lastLine,46,14);             // Clock
 
             // handle NGA extension to SP3a - the event flag
             eventFlag = false;
@@ -219,10 +239,10 @@ namespace gpstk
 
             // the rest is version c only
             if(isVerC) {
-               sig[0] = asInt(strm.lastLine.substr(61,2));           // sigma XYZ
-               sig[1] = asInt(strm.lastLine.substr(64,2));
-               sig[2] = asInt(strm.lastLine.substr(67,2));
-               sig[3] = asInt(strm.lastLine.substr(70,3));           // sigma clock
+               sig[0] = fieldInt(strm.lastLine,61,2);           // sigma XYZ
+               sig[1] = fieldInt(strm.lastLine,64,2);
+               sig[2] = fieldInt(strm.lastLine,67,2);
+               sig[3] = fieldInt(strm.lastLine,70,3);           // sigma clock
 
                if(RecType == 'P') {                                  // P flags
                   clockEventFlag = clockPredFlag
@@ -257,16 +277,16 @@ namespace gpstk
             }
 
             // parse the line
-            sdev[0] = abs(asInt(strm.lastLine.substr(4,4)));
-            sdev[1] = abs(asInt(strm.lastLine.substr(9,4)));
-            sdev[2] = abs(asInt(strm.lastLine.substr(14,4)));
-            sdev[3] = abs(asInt(strm.lastLine.substr(19,7)));
-            correlation[0] = asInt(strm.lastLine.substr(27,8));
-            correlation[1] = asInt(strm.lastLine.substr(36,8));
-            correlation[2] = asInt(strm.lastLine.substr(45,8));
-            correlation[3] = asInt(strm.lastLine.substr(54,8));
-            correlation[4] = asInt(strm.lastLine.substr(63,8));
-            correlation[5] = asInt(strm.lastLine.substr(72,8));
+            sdev[0] = abs(fieldInt(strm.lastLine,4,4));
+            sdev[1] = abs(fieldInt(strm.lastLine,9,4));
+            sdev[2] = abs(fieldInt(strm.lastLine,14,4));
+            sdev[3] = abs(fieldInt(strm.lastLine,19,7));
+            correlation[0] = fieldInt(strm.lastLine,27,8);
+            correlation[1] = fieldInt(strm.lastLine,36,8);
+            correlation[2] = fieldInt(strm.lastLine,45,8);
+            correlation[3] = fieldInt(strm.lastLine,54,8);
+            correlation[4] = fieldInt(strm.lastLine,63,8);
+            correlation[5] = fieldInt(strm.lastLine,72,8);
 
             // tell the caller that correlation data is now present
             correlationFlag = true;
@@ -0,0 +1,309 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/**
+ * @file Snapshot.cpp
+ * Compact binary snapshots of in-memory data stores.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include "Snapshot.hpp"
+
+namespace gpstk
+{
+   namespace
+   {
+         /// Start of a snapshot file.
+      struct SnapshotHeader
+      {
+         char magic[8];         ///< "GPSTKSNP"
+         uint32_t version;      ///< SnapshotWriter::version
+         uint32_t byteOrder;    ///< byteOrderMark as written
+         uint64_t size;         ///< number of bytes of data
+         uint64_t checksum;     ///< snapshotChecksum() of the data
+      };
+
+      const char snapshotMagic[8] = { 'G','P','S','T','K','S','N','P' };
+      const uint32_t byteOrderMark = 0x01020304;
+
+         /// 64-bit FNV-1a hash of n bytes at p.
+      uint64_t snapshotChecksum(const char* p, size_t n)
+      {
+         uint64_t h = 0xcbf29ce484222325ULL;
+         for (size_t i = 0; i < n; i++)
+         {
+            h ^= static_cast<unsigned char>(p[i]);
+            h *= 0x100000001b3ULL;
+         }
+         return h;
+      }
+   }
+
+
+   void SnapshotWriter ::
+   write(bool v)
+   {
+      uint8_t b = (v ? 1 : 0);
+      putBytes(&b, sizeof(b));
+   }
+
+
+   void SnapshotWriter ::
+   write(double v)
+   {
+      putBytes(&v, sizeof(v));
+   }
+
+
+   void SnapshotWriter ::
+   write(const std::string& s)
+   {
+      write(s.size());
+      putBytes(s.data(), s.size());
+   }
+
+
+   void SnapshotWriter ::
+   write(const CommonTime& t)
+   {
+      long day, sod;
+      double fsod;
+      TimeSystem ts;
+      t.get(day, sod, fsod, ts);
+      write(day);
+      write(sod);
+      write(fsod);
+      write(ts);
+   }
+
+
+   void SnapshotWriter ::
+   write(const SatID& sat)
+   {
+      write(sat.id);
+      write(sat.system);
+   }
+
+
+   void SnapshotWriter ::
+   write(const ObsID& oid)
+   {
+      write(oid.type);
+      write(oid.band);
+      write(oid.code);
+   }
+
+
+   void SnapshotWriter ::
+   write(const Triple& t)
+   {
+      for (unsigned i = 0; i < 3; i++)
+         write(t[i]);
+   }
+
+
+   void SnapshotWriter ::
+   save(const std::string& fn) const
+   {
+      SnapshotHeader hdr;
+      std::memcpy(hdr.magic, snapshotMagic, sizeof(hdr.magic));
+      hdr.version = version;
+      hdr.byteOrder = byteOrderMark;
+      hdr.size = buffer.size();
+      hdr.checksum = snapshotChecksum(buffer.data(), buffer.size());
+      std::string tmpName(fn + ".tmp");
+      {
+         std::ofstream out(tmpName.c_str(), std::ios::out | std::ios::binary);
+         out.write(reinterpret_cast<const char*>(&hdr), sizeof(hdr));
+         out.write(buffer.data(), buffer.size());
+         out.close();
+         if (!out)
+         {
+            std::remove(tmpName.c_str());
+            FileMissingException exc("File " + tmpName +
+                                      " could not be written.");
+            GPSTK_THROW(exc);
+         }
+      }
+#ifdef _WIN32
+         // rename doesn't replace existing files on Windows
+      std::remove(fn.c_str());
+#endif
+      if (std::rename(tmpName.c_str(), fn.c_str()) != 0)
+      {
+         std::remove(tmpName.c_str());
+         FileMissingException exc("File " + fn + " could not be written.");
+         GPSTK_THROW(exc);
+      }
+   }
+
+
+   SnapshotReader ::
+   SnapshotReader(const std::string& fn)
+         : file(fn), pos(nullptr), end(nullptr), fileName(fn)
+   {
+      SnapshotHeader hdr;
+      if (file.size() < sizeof(hdr))
+      {
+         InvalidRequest exc("File " + fn + " is not a snapshot.");
+         GPSTK_THROW(exc);
+      }
+      std::memcpy(&hdr, file.data(), sizeof(hdr));
+      if (std::memcmp(hdr.magic, snapshotMagic, sizeof(hdr.magic)) != 0 ||
+          hdr.byteOrder != byteOrderMark)
+      {
+         InvalidRequest exc("File " + fn + " is not a snapshot or has the"
+                            " wrong byte order.");
+         GPSTK_THROW(exc);
+      }
+      if (hdr.version != SnapshotWriter::version)
+      {
+         InvalidRequest exc("File " + fn + " has an unsupported snapshot"
+                            " version.");
+         GPSTK_THROW(exc);
+      }
+      pos = file.data() + sizeof(hdr);
+      end = file.data() + file.size();
+      if (hdr.size != static_cast<uint64_t>(end - pos) ||
+          hdr.checksum != snapshotChecksum(pos, end - pos))
+      {
+         InvalidRequest exc("File " + fn + " is truncated or corrupt.");
+         GPSTK_THROW(exc);
+      }
+   }
+
+
+   void SnapshotReader ::
+   read(bool& v)
+   {
+      uint8_t b;
+      getBytes(&b, sizeof(b));
+      v = (b != 0);
+   }
+
+
+   void SnapshotReader ::
+   read(double& v)
+   {
+      getBytes(&v, sizeof(v));
+   }
+
+
+   void SnapshotReader ::
+   read(std::string& s)
+   {
+      size_t n;
+      read(n);
+      if (n > static_cast<size_t>(end - pos))
+      {
+         InvalidRequest exc("Snapshot " + fileName + " is too short.");
+         GPSTK_THROW(exc);
+      }
+      s.assign(pos, n);
+      pos += n;
+   }
+
+
+   void SnapshotReader ::
+   read(CommonTime& t)
+   {
+      long day, sod;
+      double fsod;
+      TimeSystem ts;
+      read(day);
+      read(sod);
+      read(fsod);
+      read(ts);
+      t.set(day, sod, fsod, ts);
+   }
+
+
+   void SnapshotReader ::
+   read(SatID& sat)
+   {
+      read(sat.id);
+      read(sat.system);
+   }
+
+
+   void SnapshotReader ::
+   read(ObsID& oid)
+   {
+      read(oid.type);
+      read(oid.band);
+      read(oid.code);
+   }
+
+
+   void SnapshotReader ::
+   read(Triple& t)
+   {
+      for (unsigned i = 0; i < 3; i++)
+         read(t[i]);
+   }
+
+
+   void SnapshotReader ::
+   expect(const std::string& expected)
+   {
+      std::string s;
+      read(s);
+      if (s != expected)
+      {
+         InvalidRequest exc("Snapshot " + fileName + " holds " + s +
+                            " where " + expected + " was expected.");
+         GPSTK_THROW(exc);
+      }
+   }
+
+
+   void SnapshotReader ::
+   getBytes(void* p, size_t n)
+   {
+      if (n > static_cast<size_t>(end - pos))
+      {
+         InvalidRequest exc("Snapshot " + fileName + " is too short.");
+         GPSTK_THROW(exc);
+      }
+      std::memcpy(p, pos, n);
+      pos += n;
+   }
+
+} // namespace gpstk
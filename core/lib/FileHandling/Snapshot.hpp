@@ -0,0 +1,179 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/**
+ * @file Snapshot.hpp
+ * Compact binary snapshots of in-memory data stores.
+ */
+
+#ifndef GPSTK_SNAPSHOT_HPP
+#define GPSTK_SNAPSHOT_HPP
+
+#include <string>
+#include <type_traits>
+#include <stdint.h>
+#include "MappedFile.hpp"
+#include "CommonTime.hpp"
+#include "SatID.hpp"
+#include "ObsID.hpp"
+#include "Triple.hpp"
+
+namespace gpstk
+{
+      /// @ingroup FileHandling
+      //@{
+
+      /**
+       * Build a binary snapshot of the contents of a data store, to
+       * be written to a file and later read back with
+       * SnapshotReader, e.g. by OrbitEphStore::saveSnapshot().
+       * Values are written in sequence, without any tags, so they
+       * must be read back in the same order and as the same types.
+       * Integers and enumerations are always written as 64 bits, so
+       * that snapshots don't depend on the size of long.
+       *
+       * A snapshot file starts with a header holding a magic
+       * number, the snapshot format version, the byte order, the
+       * size of the data and a checksum of the data.
+       */
+   class SnapshotWriter
+   {
+   public:
+         /// Format version written to, and required in, the header.
+      static const uint32_t version = 1;
+
+         /// Write an integer or enumeration value.
+      template <class T>
+      void write(const T& v)
+      {
+         static_assert(std::is_integral<T>::value || std::is_enum<T>::value,
+                       "SnapshotWriter::write needs an integer or enum");
+         int64_t i = static_cast<int64_t>(v);
+         putBytes(&i, sizeof(i));
+      }
+      void write(bool v);
+      void write(double v);
+      void write(const std::string& s);
+      void write(const char* s)
+      { write(std::string(s)); }
+      void write(const CommonTime& t);
+      void write(const SatID& sat);
+      void write(const ObsID& oid);
+      void write(const Triple& t);
+
+         /** Write the snapshot to a file.  The file is written under
+          * a temporary name and then renamed, so an existing
+          * snapshot is only replaced by a complete one.
+          * @param[in] fn the name of the file.
+          * @throw FileMissingException if the file can't be written. */
+      void save(const std::string& fn) const;
+
+         /// @return the number of bytes of data written so far.
+      size_t size() const
+      { return buffer.size(); }
+
+   private:
+      void putBytes(const void* p, size_t n)
+      { buffer.append(static_cast<const char*>(p), n); }
+
+         /// The snapshot data, without the file header.
+      std::string buffer;
+   }; // class SnapshotWriter
+
+
+      /**
+       * Read back a snapshot written by SnapshotWriter, directly from
+       * a memory mapping of the file.  The header is checked when
+       * the file is opened.
+       */
+   class SnapshotReader
+   {
+   public:
+         /** Map and check the snapshot file \a fn.
+          * @throw FileMissingException if the file can't be opened.
+          * @throw InvalidRequest if the file is not a snapshot, has a
+          *   different format version or byte order, or its
+          *   checksum doesn't match. */
+      SnapshotReader(const std::string& fn);
+
+         /** Read an integer or enumeration value.
+          * @throw InvalidRequest if the snapshot data are exhausted. */
+      template <class T>
+      void read(T& v)
+      {
+         static_assert(std::is_integral<T>::value || std::is_enum<T>::value,
+                       "SnapshotReader::read needs an integer or enum");
+         int64_t i;
+         getBytes(&i, sizeof(i));
+         v = static_cast<T>(i);
+      }
+      void read(bool& v);
+      void read(double& v);
+      void read(std::string& s);
+      void read(CommonTime& t);
+      void read(SatID& sat);
+      void read(ObsID& oid);
+      void read(Triple& t);
+
+         /** Read a string and check it against an expected value,
+          * e.g. the name of the class that wrote the following data.
+          * @throw InvalidRequest if the string is not \a expected. */
+      void expect(const std::string& expected);
+
+         /// @return true if all the snapshot data have been read.
+      bool atEnd() const
+      { return pos == end; }
+
+   private:
+         /// @throw InvalidRequest if fewer than n bytes remain.
+      void getBytes(void* p, size_t n);
+
+      MappedFile file;
+         /// Next byte of data to be read, within file.
+      const char *pos;
+         /// End of the data.
+      const char *end;
+         /// Name of the file, for error messages.
+      std::string fileName;
+   }; // class SnapshotReader
+
+      //@}
+
+} // namespace gpstk
+
+#endif // GPSTK_SNAPSHOT_HPP
@@ -0,0 +1,380 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+
+/**
+ * @file PositionBatch.cpp
+ * Convert arrays of coordinates between the Cartesian (ECEF),
+ * geodetic and geocentric systems of Position.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include "PositionBatch.hpp"
+#include "Position.hpp"
+#include "GNSSconstants.hpp"
+
+namespace gpstk
+{
+      // Number of points converted at a time by the conversions with
+      // special cases; see convertCartesianToGeodetic().
+   static const std::size_t blockSize = 64;
+
+
+   PositionBatch ::
+   PositionBatch(const EllipsoidModel& ell)
+   {
+      init(ell.a(), ell.eccSquared());
+   }
+
+
+   PositionBatch ::
+   PositionBatch(double a, double e2)
+   {
+      init(a, e2);
+   }
+
+
+   void PositionBatch ::
+   init(double a, double e2)
+      throw()
+   {
+      A = a;
+      eccSq = e2;
+      e4 = e2*e2;
+      oneMe2 = 1.0-e2;
+      invA2 = 1.0/(a*a);
+      B = a*std::sqrt(oneMe2);
+   }
+
+
+      // Vermeille, H., "Direct transformation from geocentric coordinates
+      // to geodetic coordinates," Journal of Geodesy (2002) 76:451-454.
+      // Valid outside the evolute of the ellipsoid, i.e. r > 0 below,
+      // which excludes only a region within e^2*A (~43km) of the center.
+      // There is no early return, so the caller's loop has no branches;
+      // lat and ht are garbage (possibly NaN) when false is returned.
+   inline bool PositionBatch ::
+   latHeight(double p, double z, double& lat, double& ht)
+      const throw()
+   {
+      double pp = p*p*invA2;
+      double q = oneMe2*z*z*invA2;
+      double r = (pp+q-e4)/6.0;
+      double s = e4*pp*q/(4.0*r*r*r);
+      double t = std::cbrt(1.0+s+std::sqrt(s*(2.0+s)));
+      double u = r*(1.0+t+1.0/t);
+      double v = std::sqrt(u*u+e4*q);
+      double uv = u+v;
+      double w = eccSq*(uv-q)/(2.0*v);
+      double k = std::sqrt(uv+w*w)-w;
+      double D = k*p/(k+eccSq);
+      double Dz = std::sqrt(D*D+z*z);
+      lat = 2.0*std::atan2(z, D+Dz);
+      ht = (k+eccSq-1.0)/k*Dz;
+      return (r > 0.0);
+   }
+
+
+   void PositionBatch ::
+   cartesianToGeodetic(const double *xyz, double *llh, double tol)
+      const throw()
+   {
+      double x(xyz[0]), y(xyz[1]), z(xyz[2]);
+      double p = std::sqrt(x*x+y*y);
+      double lat, ht;
+      if(p < tol)
+      {
+            // pole or origin, as Position
+         llh[0] = (z > 0 ? 90.0 : -90.0);
+         llh[1] = 0;
+         llh[2] = std::fabs(z) - B;
+      }
+      else if(!latHeight(p, z, lat, ht))
+      {
+            // near the center, iterate as Position
+         Triple in(x,y,z), out;
+         Position::convertCartesianToGeodetic(in, out, A, eccSq);
+         llh[0] = out[0];
+         llh[1] = out[1];
+         llh[2] = out[2];
+      }
+      else
+      {
+         double lon = PI + std::atan2(-y,-x);
+         llh[0] = lat*RAD_TO_DEG;
+         llh[1] = lon*RAD_TO_DEG;
+         llh[2] = ht;
+      }
+   }
+
+
+   void PositionBatch ::
+   geocentricToGeodetic(const double *llr, double *llh, double tol)
+      const throw()
+   {
+      double glat(llr[0]*DEG_TO_RAD), lon(llr[1]), r(llr[2]);
+      double cl = std::cos(glat);
+      double lat, ht;
+      if(r <= tol)
+      {
+            // zero vector, as Position
+         llh[0] = llh[1] = 0.0;
+         llh[2] = -A;
+      }
+      else if(cl < 1.e-10)
+      {
+            // pole, as Position
+         llh[0] = (llr[0] < 0 ? -90.0 : 90.0);
+         llh[1] = 0.0;
+         llh[2] = r - B;
+      }
+      else if(!latHeight(r*cl, r*std::sin(glat), lat, ht))
+      {
+         Triple in(llr[0],lon,r), out;
+         Position::convertGeocentricToGeodetic(in, out, A, eccSq);
+         llh[0] = out[0];
+         llh[1] = out[1];
+         llh[2] = out[2];
+      }
+      else
+      {
+         llh[0] = lat*RAD_TO_DEG;
+         llh[1] = lon;
+         llh[2] = ht;
+      }
+   }
+
+
+      // Points are converted a block at a time into out. The loop over
+      // a block has no branches; points at the poles or near the
+      // center only set a flag, and a block with any of them is
+      // redone point by point as Position would. The input is left
+      // intact until the block is copied out, so in-place use works.
+   void PositionBatch ::
+   convertCartesianToGeodetic(const double *xyz, double *llh, std::size_t n)
+      const throw()
+   {
+      const double tol(Position::getPositionTolerance()/5);
+      double out[3*blockSize];
+      for(std::size_t i0=0; i0<n; i0+=blockSize)
+      {
+         const double *in(xyz+3*i0);
+         std::size_t m = std::min(blockSize, n-i0);
+         bool special(false);
+         for(std::size_t j=0; j<m; j++)
+         {
+            double x(in[3*j]), y(in[3*j+1]), z(in[3*j+2]);
+            double p = std::sqrt(x*x+y*y);
+            double lat, ht;
+            bool ok = latHeight(p, z, lat, ht);
+            special |= (!ok | (p < tol));
+               // = atan2(y,x) in [0,2pi), up to rounding, with no branch
+            double lon = PI + std::atan2(-y,-x);
+            out[3*j] = lat*RAD_TO_DEG;
+            out[3*j+1] = lon*RAD_TO_DEG;
+            out[3*j+2] = ht;
+         }
+         if(special)
+         {
+            for(std::size_t j=0; j<m; j++)
+               cartesianToGeodetic(in+3*j, out+3*j, tol);
+         }
+         std::copy(out, out+3*m, llh+3*i0);
+      }
+   }
+
+
+   void PositionBatch ::
+   convertGeodeticToCartesian(const double *llh, double *xyz, std::size_t n)
+      const throw()
+   {
+      for(std::size_t i=0; i<n; i++, llh+=3, xyz+=3)
+      {
+         double lat(llh[0]*DEG_TO_RAD), lon(llh[1]*DEG_TO_RAD), ht(llh[2]);
+         double slat = std::sin(lat);
+         double clat = std::cos(lat);
+         double N = A/std::sqrt(1.0-eccSq*slat*slat);
+         xyz[0] = (N+ht)*clat*std::cos(lon);
+         xyz[1] = (N+ht)*clat*std::sin(lon);
+         xyz[2] = (N*oneMe2+ht)*slat;
+      }
+   }
+
+
+      // As convertCartesianToGeodetic(), a block at a time.
+   void PositionBatch ::
+   convertCartesianToGeocentric(const double *xyz, double *llr, std::size_t n)
+      throw()
+   {
+      const double tol(Position::getPositionTolerance()/5);
+      double out[3*blockSize];
+      for(std::size_t i0=0; i0<n; i0+=blockSize)
+      {
+         const double *in(xyz+3*i0);
+         std::size_t m = std::min(blockSize, n-i0);
+         bool special(false);
+         for(std::size_t j=0; j<m; j++)
+         {
+            double x(in[3*j]), y(in[3*j+1]), z(in[3*j+2]);
+            double p = std::sqrt(x*x+y*y);
+            double r = std::sqrt(p*p+z*z);
+            special |= (p < tol);
+            out[3*j] = std::atan2(z,p)*RAD_TO_DEG;
+            out[3*j+1] = (PI + std::atan2(-y,-x))*RAD_TO_DEG;
+            out[3*j+2] = r;
+         }
+         if(special)
+         {
+               // as Position, longitude 0 on the axis, and (0,0,0)
+               // for the zero vector
+            for(std::size_t j=0; j<m; j++)
+            {
+               double *o = out+3*j;
+               if(o[2] <= tol)
+                  o[0] = o[1] = o[2] = 0.0;
+               else if(std::sqrt(in[3*j]*in[3*j]+in[3*j+1]*in[3*j+1])
+                       < tol)
+                  o[1] = 0.0;
+            }
+         }
+         std::copy(out, out+3*m, llr+3*i0);
+      }
+   }
+
+
+   void PositionBatch ::
+   convertGeocentricToCartesian(const double *llr, double *xyz, std::size_t n)
+      throw()
+   {
+      for(std::size_t i=0; i<n; i++, llr+=3, xyz+=3)
+      {
+         double lat(llr[0]*DEG_TO_RAD), lon(llr[1]*DEG_TO_RAD), r(llr[2]);
+         double rc = r*std::cos(lat);
+         xyz[0] = rc*std::cos(lon);
+         xyz[1] = rc*std::sin(lon);
+         xyz[2] = r*std::sin(lat);
+      }
+   }
+
+
+      // As convertCartesianToGeodetic(), a block at a time.
+   void PositionBatch ::
+   convertGeocentricToGeodetic(const double *llr, double *llh, std::size_t n)
+      const throw()
+   {
+      const double tol(Position::getPositionTolerance()/5);
+      double out[3*blockSize];
+      for(std::size_t i0=0; i0<n; i0+=blockSize)
+      {
+         const double *in(llr+3*i0);
+         std::size_t m = std::min(blockSize, n-i0);
+         bool special(false);
+         for(std::size_t j=0; j<m; j++)
+         {
+            double glat(in[3*j]*DEG_TO_RAD), r(in[3*j+2]);
+            double cl = std::cos(glat);
+            double lat, ht;
+            bool ok = latHeight(r*cl, r*std::sin(glat), lat, ht);
+            special |= (!ok | (r <= tol) | (cl < 1.e-10));
+            out[3*j] = lat*RAD_TO_DEG;
+            out[3*j+1] = in[3*j+1];
+            out[3*j+2] = ht;
+         }
+         if(special)
+         {
+            for(std::size_t j=0; j<m; j++)
+               geocentricToGeodetic(in+3*j, out+3*j, tol);
+         }
+         std::copy(out, out+3*m, llh+3*i0);
+      }
+   }
+
+
+      // As convertCartesianToGeodetic(), a block at a time.
+   void PositionBatch ::
+   convertGeodeticToGeocentric(const double *llh, double *llr, std::size_t n)
+      const throw()
+   {
+      const double tol(Position::getPositionTolerance()/5);
+      double out[3*blockSize];
+      for(std::size_t i0=0; i0<n; i0+=blockSize)
+      {
+         const double *in(llh+3*i0);
+         std::size_t m = std::min(blockSize, n-i0);
+         bool special(false);
+         for(std::size_t j=0; j<m; j++)
+         {
+            double lat(in[3*j]*DEG_TO_RAD), ht(in[3*j+2]);
+            double slat = std::sin(lat);
+            double clat = std::cos(lat);
+            double N = A/std::sqrt(1.0-eccSq*slat*slat);
+               // distance from the polar axis, and height above the
+               // equator
+            double p = (N+ht)*clat;
+            double z = (N*oneMe2+ht)*slat;
+            double r = std::sqrt(p*p+z*z);
+            special |= ((r <= tol) | (1-std::fabs(slat) < 1.e-10));
+            out[3*j] = std::atan2(z,p)*RAD_TO_DEG;
+            out[3*j+1] = in[3*j+1];
+            out[3*j+2] = r;
+         }
+         if(special)
+         {
+               // as Position, (0,0,0) for the zero vector, and exactly
+               // +-90 and longitude 0 at the poles
+            for(std::size_t j=0; j<m; j++)
+            {
+               double *o = out+3*j;
+               double slat = std::sin(in[3*j]*DEG_TO_RAD);
+               if(o[2] <= tol)
+               {
+                  o[0] = o[1] = o[2] = 0.0;
+               }
+               else if(1-std::fabs(slat) < 1.e-10)
+               {
+                  o[0] = (slat < 0 ? -90.0 : 90.0);
+                  o[1] = 0.0;
+               }
+            }
+         }
+         std::copy(out, out+3*m, llr+3*i0);
+      }
+   }
+
+} // namespace gpstk
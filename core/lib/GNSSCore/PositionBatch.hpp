@@ -0,0 +1,185 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+
+/**
+ * @file PositionBatch.hpp
+ * Convert arrays of coordinates between the Cartesian (ECEF),
+ * geodetic and geocentric systems of Position.
+ */
+
+#ifndef GPSTK_POSITIONBATCH_HPP
+#define GPSTK_POSITIONBATCH_HPP
+
+#include <cstddef>
+#include "EllipsoidModel.hpp"
+
+namespace gpstk
+{
+      /// @ingroup Geodetic
+      //@{
+
+      /**
+       * Batch versions of the fundamental conversions of Position
+       * (Position::convertCartesianToGeodetic() etc.), for jobs that
+       * convert many points, e.g. grids for coverage or mapping.
+       * Coordinates are stored as contiguous triples, in the order
+       * and units of Position: X,Y,Z in meters; geodetic latitude
+       * (deg N), longitude (deg E, 0 to 360) and height above the
+       * ellipsoid (meters); geocentric latitude (deg N), longitude
+       * (deg E) and radius (meters).
+       *
+       * Cartesian to geodetic uses the closed form of Vermeille
+       * (Journal of Geodesy 76, 2002), rather than the iteration of
+       * Position, so each point costs the same. The loops over the
+       * points have no data-dependent branches; points at the poles
+       * or within about 40 km of the center of the Earth are handled
+       * as in Position, in a separate pass over the (small) block of
+       * points that contains them. The result agrees with Position
+       * to within the tolerance of its iteration.
+       *
+       * Output may be the same array as input. The ellipsoid is set
+       * by the constructor; an object holds no other state and may
+       * be used from several threads. */
+   class PositionBatch
+   {
+   public:
+         /** Constructor.
+          * @param[in] ell ellipsoid model of the geodetic coordinates. */
+      PositionBatch(const EllipsoidModel& ell);
+
+         /** Constructor.
+          * @param[in] A semi-major axis of the ellipsoid in meters.
+          * @param[in] eccSq square of the eccentricity of the ellipsoid. */
+      PositionBatch(double A, double eccSq);
+
+         /// @return semi-major axis of the ellipsoid in meters.
+      double a() const throw()
+      { return A; }
+
+         /// @return square of the eccentricity of the ellipsoid.
+      double eccSquared() const throw()
+      { return eccSq; }
+
+         /** Convert Cartesian (ECEF) to geodetic coordinates.
+          * The zero vector is converted to (-90,0,-R(earth)), as in
+          * Position::convertCartesianToGeodetic().
+          * @param[in] xyz n triples X,Y,Z in meters.
+          * @param[out] llh n triples geodetic lat, lon, height.
+          * @param[in] n number of points. */
+      void convertCartesianToGeodetic(const double *xyz, double *llh,
+                                      std::size_t n) const throw();
+
+         /** Convert geodetic to Cartesian (ECEF) coordinates.
+          * @param[in] llh n triples geodetic lat, lon, height.
+          * @param[out] xyz n triples X,Y,Z in meters.
+          * @param[in] n number of points. */
+      void convertGeodeticToCartesian(const double *llh, double *xyz,
+                                      std::size_t n) const throw();
+
+         /** Convert Cartesian (ECEF) to geocentric coordinates.
+          * The zero vector is converted to (0,0,0).
+          * @param[in] xyz n triples X,Y,Z.
+          * @param[out] llr n triples geocentric lat, lon, radius.
+          * @param[in] n number of points. */
+      static void convertCartesianToGeocentric(const double *xyz, double *llr,
+                                               std::size_t n) throw();
+
+         /** Convert geocentric to Cartesian (ECEF) coordinates.
+          * @param[in] llr n triples geocentric lat, lon, radius.
+          * @param[out] xyz n triples X,Y,Z in units of radius.
+          * @param[in] n number of points. */
+      static void convertGeocentricToCartesian(const double *llr, double *xyz,
+                                               std::size_t n) throw();
+
+         /** Convert geocentric to geodetic coordinates; longitude is
+          * unchanged.
+          * @param[in] llr n triples geocentric lat, lon, radius.
+          * @param[out] llh n triples geodetic lat, lon, height.
+          * @param[in] n number of points. */
+      void convertGeocentricToGeodetic(const double *llr, double *llh,
+                                       std::size_t n) const throw();
+
+         /** Convert geodetic to geocentric coordinates; longitude is
+          * unchanged.
+          * @param[in] llh n triples geodetic lat, lon, height.
+          * @param[out] llr n triples geocentric lat, lon, radius.
+          * @param[in] n number of points. */
+      void convertGeodeticToGeocentric(const double *llh, double *llr,
+                                       std::size_t n) const throw();
+
+   private:
+         /// Compute the constants of the ellipsoid.
+      void init(double A, double eccSq) throw();
+
+         /** The closed form kernel: compute geodetic latitude
+          * (radians) and height from the distance from the polar axis
+          * p and the height above the equator z.
+          * @return false if the point is too near the center of the
+          *   Earth for the closed form, in which case lat and ht are
+          *   not meaningful. */
+      bool latHeight(double p, double z, double& lat, double& ht)
+         const throw();
+
+         /** Convert one point from Cartesian to geodetic, handling the
+          * poles and the center as Position does.
+          * @param[in] tol the distance from the axis within which a
+          *   point is taken to be at a pole. */
+      void cartesianToGeodetic(const double *xyz, double *llh, double tol)
+         const throw();
+
+         /** Convert one point from geocentric to geodetic, handling
+          * the poles and the center as Position does.
+          * @param[in] tol the radius within which a point is taken to
+          *   be the zero vector. */
+      void geocentricToGeodetic(const double *llr, double *llh, double tol)
+         const throw();
+
+      double A;         ///< semi-major axis, meters
+      double eccSq;     ///< eccentricity squared
+      double e4;        ///< eccentricity to the fourth
+      double oneMe2;    ///< 1 - eccSq
+      double invA2;     ///< 1/(A*A)
+      double B;         ///< semi-minor axis, meters
+   }; // class PositionBatch
+
+      //@}
+
+} // namespace gpstk
+
+#endif // GPSTK_POSITIONBATCH_HPP
@@ -46,6 +46,7 @@
 #include "BDSWeekSecond.hpp"
 
 #include "BDSEphemeris.hpp"
+#include "Snapshot.hpp"
 #include "GPSWeekSecond.hpp"
 #include "WGS84Ellipsoid.hpp"   
 #include "TimeString.hpp"
@@ -427,4 +428,34 @@ namespace gpstk
       return sv;
    }
 
+
+   void BDSEphemeris::writeSnapshot(SnapshotWriter& w) const
+   {
+      OrbitEph::writeSnapshot(w);
+      w.write(transmitTime);
+      w.write(HOWtime);
+      w.write(IODE);
+      w.write(IODC);
+      w.write(health);
+      w.write(accuracy);
+      w.write(Tgd13);
+      w.write(Tgd23);
+      w.write(fitDuration);
+   }
+
+
+   void BDSEphemeris::readSnapshot(SnapshotReader& r)
+   {
+      OrbitEph::readSnapshot(r);
+      r.read(transmitTime);
+      r.read(HOWtime);
+      r.read(IODE);
+      r.read(IODC);
+      r.read(health);
+      r.read(accuracy);
+      r.read(Tgd13);
+      r.read(Tgd23);
+      r.read(fitDuration);
+   }
+
 } // end namespace
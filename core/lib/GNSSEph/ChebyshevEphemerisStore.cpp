@@ -0,0 +1,626 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/// @file ChebyshevEphemerisStore.cpp
+/// Store piecewise Chebyshev series fitted to the orbits and clocks of
+/// another XvtStore, for fast evaluation.
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include "ChebyshevEphemerisStore.hpp"
+#include "BinUtils.hpp"
+#include "GNSSconstants.hpp"
+#include "StringUtils.hpp"
+#include "TimeString.hpp"
+
+using namespace std;
+
+namespace gpstk
+{
+   /** @addtogroup ephemstore */
+   //@{
+
+   // Identifies the binary file format of saveFile()/loadFile().
+   static const char chebMagic[8] = { 'G','P','S','T','K','C','H','B' };
+   static const uint32_t chebVersion = 1;
+
+   // Helpers for the binary file; all values are little-endian.
+   static void putU32(string& buf, uint32_t v)
+   {
+      char b[4];
+      BinUtils::buhtoil(b, v);
+      buf.append(b, 4);
+   }
+
+   static void putI64(string& buf, int64_t v)
+   {
+      char b[8];
+      BinUtils::buhtoisll(b, v);
+      buf.append(b, 8);
+   }
+
+   static void putD(string& buf, double v)
+   {
+      char b[8];
+      BinUtils::buhtoid(b, v);
+      buf.append(b, 8);
+   }
+
+      // read from buf at pos, advancing pos
+   static const char* take(const string& buf, size_t& pos, size_t n)
+   {
+      if(buf.size() - pos < n) {
+         Exception e("Chebyshev ephemeris file is truncated");
+         GPSTK_THROW(e);
+      }
+      pos += n;
+      return buf.data() + pos - n;
+   }
+
+   static uint32_t getU32(const string& buf, size_t& pos)
+   {
+      uint32_t v;
+      BinUtils::buitohl(take(buf, pos, 4), v);
+      return v;
+   }
+
+   static int64_t getI64(const string& buf, size_t& pos)
+   {
+      int64_t v;
+      BinUtils::buitohsll(take(buf, pos, 8), v);
+      return v;
+   }
+
+   static double getD(const string& buf, size_t& pos)
+   {
+      double v;
+      BinUtils::buitohd(take(buf, pos, 8), v);
+      return v;
+   }
+
+   // true if ref can be evaluated for sat at t
+   static bool available(const XvtStore<SatID>& ref, const SatID& sat,
+                         const CommonTime& t)
+   {
+      try { ref.getXvt(sat, t); }
+      catch(InvalidRequest&) { return false; }
+      return true;
+   }
+
+   // Bisect between offsets bad and good from t0, where ref is not and is
+   // available, to within 1 ms; return the offset on the available side.
+   static double boundary(const XvtStore<SatID>& ref, const SatID& sat,
+                          const CommonTime& t0, double bad, double good)
+   {
+      while(::fabs(good - bad) > 1.e-3) {
+         double mid(0.5*(bad + good));
+         if(available(ref, sat, t0 + mid)) good = mid;
+         else bad = mid;
+      }
+      return good;
+   }
+
+   unsigned ChebyshevEphemerisStore::fit(const XvtStore<SatID>& ref,
+                                         double segment, unsigned deg)
+   {
+      if(segment <= 0.0 || deg == 0) {
+         InvalidParameter e("Segment length and degree must be positive");
+         GPSTK_THROW(e);
+      }
+      CommonTime tbeg, tend;
+      try {
+         tbeg = ref.getInitialTime();
+         tend = ref.getFinalTime();
+      }
+      catch(InvalidRequest& e) { GPSTK_RETHROW(e); }
+
+      clear();
+      timeSystem = ref.getTimeSystem();
+      degree = deg;
+
+      unsigned nseg(0);
+      set<SatID> sats(ref.getIndexSet());
+      for(set<SatID>::const_iterator sit=sats.begin(); sit!=sats.end(); ++sit) {
+         const SatID& sat(*sit);
+         for(CommonTime t0(tbeg); t0 < tend; t0 += segment) {
+            double length(std::min(segment, tend - t0));
+            if(length < 1.e-3) break;
+            nseg += fitCovered(ref, sat, t0, length, 0);
+         }
+      }
+
+      return nseg;
+   }
+
+   unsigned ChebyshevEphemerisStore::fitCovered(const XvtStore<SatID>& ref,
+                                                const SatID& sat,
+                                                const CommonTime& t0,
+                                                double length, unsigned depth)
+   {
+      Segment seg;
+      seg.begin = t0;
+      seg.length = length;
+      if(fitSegment(ref, sat, seg)) {
+         segments[sat].push_back(seg);
+         return 1;
+      }
+
+      // a node or check point is not covered, as near the ends of the data and
+      // around gaps; find the parts that are covered at those points, with
+      // their ends to 1 ms, and fit those, looking again more finely in any
+      // that still fail. The nodes (zeros of T_N) and check points (extrema of
+      // T_N) are, in time order, the points cos(pi*i/M) for M = 2N.
+      if(depth >= 3) return 0;
+      const unsigned M(2*(degree+1));
+      vector<double> h(M+1);
+      vector<char> good(M+1);
+      for(unsigned i=0; i<=M; i++) {
+         h[i] = 0.5*(1.0 - ::cos(PI*i/M))*length;
+         good[i] = available(ref, sat, t0 + h[i]);
+      }
+      unsigned nseg(0);
+      for(unsigned i=0; i<=M; i++) {
+         if(!good[i]) continue;
+         unsigned j(i);
+         while(j < M && good[j+1]) j++;
+         double a(h[i]), b(h[j]);
+         if(i > 0) a = boundary(ref, sat, t0, h[i-1], a);
+         if(j < M) b = boundary(ref, sat, t0, h[j+1], b);
+         if(b - a >= 1.e-3)
+            nseg += fitCovered(ref, sat, t0 + a, b - a, depth+1);
+         i = j;
+      }
+      return nseg;
+   }
+
+   bool ChebyshevEphemerisStore::fitSegment(const XvtStore<SatID>& ref,
+                                            const SatID& sat, Segment& seg)
+      const
+   {
+      const unsigned N(degree+1);
+      const CommonTime& t0(seg.begin);
+
+      // sample the reference at the Chebyshev nodes
+      vector<double> f[4];
+      for(unsigned j=0; j<4; j++) f[j].resize(N);
+      for(unsigned k=0; k<N; k++) {
+         double tau = ::cos(PI*(k+0.5)/N);
+         try {
+            Xvt xvt(ref.getXvt(sat, t0 + 0.5*(tau+1.0)*seg.length));
+            f[0][k] = xvt.x[0];
+            f[1][k] = xvt.x[1];
+            f[2][k] = xvt.x[2];
+            f[3][k] = xvt.clkbias;
+         }
+         catch(InvalidRequest&) { return false; }
+      }
+
+      // coefficients c_n = (2/N) sum_k f(tau_k) cos(pi n (k+1/2)/N)
+      seg.coef.resize(4*N);
+      for(unsigned j=0; j<4; j++) {
+         for(unsigned n=0; n<N; n++) {
+            double sum(0.0);
+            for(unsigned k=0; k<N; k++)
+               sum += f[j][k] * ::cos(PI*n*(k+0.5)/N);
+            seg.coef[j*N+n] = (n == 0 ? 1.0 : 2.0) * sum / N;
+         }
+      }
+
+      // compare with the reference at the extrema of T_N, which
+      // lie between the nodes and include the segment ends; if the
+      // reference is not available at one, the segment spans a gap
+      seg.posErr = seg.velErr = seg.clkErr = 0.0;
+      for(unsigned k=0; k<=N; k++) {
+         double tau = ::cos(PI*k/N);
+         Xvt xref;
+         try { xref = ref.getXvt(sat, t0 + 0.5*(tau+1.0)*seg.length); }
+         catch(InvalidRequest&) { return false; }
+         double dp(0.0), dv(0.0), val, der;
+         for(unsigned j=0; j<3; j++) {
+            evaluate(seg, j, tau, val, der);
+            dp += (val-xref.x[j])*(val-xref.x[j]);
+            der *= 2.0/seg.length;
+            dv += (der-xref.v[j])*(der-xref.v[j]);
+         }
+         evaluate(seg, 3, tau, val, der);
+         seg.posErr = std::max(seg.posErr, ::sqrt(dp));
+         seg.velErr = std::max(seg.velErr, ::sqrt(dv));
+         seg.clkErr = std::max(seg.clkErr, ::fabs(val-xref.clkbias));
+      }
+      return true;
+   }
+
+   void ChebyshevEphemerisStore::evaluate(const Segment& seg, unsigned j,
+                                          double tau,
+                                          double& value, double& deriv) const
+   {
+      // T_n(tau) and T_n'(tau) by the three-term recurrences
+      const unsigned N(degree+1);
+      const double *c(&seg.coef[j*N]);
+      double T0(1.0), T1(tau), D0(0.0), D1(1.0);
+      value = c[0];
+      deriv = 0.0;
+      if(N > 1) {
+         value += c[1]*T1;
+         deriv += c[1]*D1;
+      }
+      for(unsigned n=2; n<N; n++) {
+         double T2(2.0*tau*T1 - T0), D2(2.0*T1 + 2.0*tau*D1 - D0);
+         value += c[n]*T2;
+         deriv += c[n]*D2;
+         T0 = T1; T1 = T2;
+         D0 = D1; D1 = D2;
+      }
+   }
+
+   const ChebyshevEphemerisStore::Segment&
+   ChebyshevEphemerisStore::findSegment(const SatID& sat, const CommonTime& t)
+      const
+   {
+      map<SatID, vector<Segment> >::const_iterator it(segments.find(sat));
+      if(it == segments.end()) {
+         InvalidRequest e("No data for satellite " + StringUtils::asString(sat));
+         GPSTK_THROW(e);
+      }
+
+      // last segment beginning at or before t
+      const vector<Segment>& segs(it->second);
+      size_t lo(0), hi(segs.size());
+      while(lo < hi) {
+         size_t mid((lo+hi)/2);
+         if(segs[mid].begin <= t) lo = mid+1;
+         else hi = mid;
+      }
+      if(lo == 0 || t - segs[lo-1].begin > segs[lo-1].length) {
+         InvalidRequest e("No data for satellite " + StringUtils::asString(sat)
+                          + " at time " + printTime(t,"%4F %10.3g"));
+         GPSTK_THROW(e);
+      }
+      return segs[lo-1];
+   }
+
+   Xvt ChebyshevEphemerisStore::getXvt(const SatID& sat, const CommonTime& t)
+      const
+   {
+      try {
+         const Segment& seg(findSegment(sat, t));
+         double tau = 2.0*(t - seg.begin)/seg.length - 1.0;
+         double scale = 2.0/seg.length;      // d(tau)/dt
+         double val, der;
+         Xvt xvt;
+         for(unsigned j=0; j<3; j++) {
+            evaluate(seg, j, tau, val, der);
+            xvt.x[j] = val;
+            xvt.v[j] = der*scale;
+         }
+         evaluate(seg, 3, tau, val, der);
+         xvt.clkbias = val;
+         xvt.clkdrift = der*scale;
+         xvt.computeRelativityCorrection();
+         xvt.health = Xvt::HealthStatus::Unused;
+         return xvt;
+      }
+      catch(InvalidRequest& e) { GPSTK_RETHROW(e); }
+   }
+
+   Xvt ChebyshevEphemerisStore::computeXvt(const SatID& sat, const CommonTime& t)
+      const throw()
+   {
+      Xvt rv;
+      rv.health = Xvt::HealthStatus::Unavailable;
+      try { rv = getXvt(sat, t); }
+      catch(...) { }
+      return rv;
+   }
+
+   Xvt::HealthStatus ChebyshevEphemerisStore::getSVHealth(const SatID& sat,
+                                                          const CommonTime& t)
+      const throw()
+   {
+      try {
+         findSegment(sat, t);
+         return Xvt::HealthStatus::Unused;
+      }
+      catch(...) { }
+      return Xvt::HealthStatus::Unavailable;
+   }
+
+   void ChebyshevEphemerisStore::saveFile(const string& filename) const
+   {
+      string buf(chebMagic, sizeof(chebMagic));
+      putU32(buf, chebVersion);
+      putU32(buf, static_cast<uint32_t>(timeSystem));
+      putU32(buf, degree);
+      putU32(buf, segments.size());
+      map<SatID, vector<Segment> >::const_iterator it;
+      for(it = segments.begin(); it != segments.end(); ++it) {
+         putU32(buf, static_cast<uint32_t>(it->first.system));
+         putU32(buf, it->first.id);
+         putU32(buf, it->second.size());
+         for(size_t i=0; i<it->second.size(); i++) {
+            const Segment& seg(it->second[i]);
+            long day, msod;
+            double fsod;
+            seg.begin.getInternal(day, msod, fsod);
+            putI64(buf, day);
+            putI64(buf, msod);
+            putD(buf, fsod);
+            putD(buf, seg.length);
+            putD(buf, seg.posErr);
+            putD(buf, seg.velErr);
+            putD(buf, seg.clkErr);
+            for(size_t k=0; k<seg.coef.size(); k++)
+               putD(buf, seg.coef[k]);
+         }
+      }
+
+      ofstream ofs(filename.c_str(), ios::out | ios::binary);
+      if(!ofs) {
+         FileMissingException e("Could not open file " + filename);
+         GPSTK_THROW(e);
+      }
+      ofs.write(buf.data(), buf.size());
+      if(!ofs) {
+         FileMissingException e("Error writing file " + filename);
+         GPSTK_THROW(e);
+      }
+   }
+
+   void ChebyshevEphemerisStore::loadFile(const string& filename)
+   {
+      ifstream ifs(filename.c_str(), ios::in | ios::binary);
+      if(!ifs) {
+         FileMissingException e("Could not open file " + filename);
+         GPSTK_THROW(e);
+      }
+      ostringstream oss;
+      oss << ifs.rdbuf();
+      const string buf(oss.str());
+
+      try {
+         size_t pos(0);
+         if(!equal(chebMagic, chebMagic+sizeof(chebMagic),
+                   take(buf, pos, sizeof(chebMagic)))) {
+            Exception e("Not a Chebyshev ephemeris file: " + filename);
+            GPSTK_THROW(e);
+         }
+         uint32_t version(getU32(buf, pos));
+         if(version != chebVersion) {
+            Exception e("Unsupported Chebyshev ephemeris file version "
+                        + StringUtils::asString(version));
+            GPSTK_THROW(e);
+         }
+
+         TimeSystem ts(static_cast<TimeSystem>(getU32(buf, pos)));
+         unsigned deg(getU32(buf, pos));
+         // bytes in one segment: time, length, errors and coefficients
+         const size_t segSize(8*(7 + 4*(size_t(deg)+1)));
+         uint32_t nsat(getU32(buf, pos));
+         map<SatID, vector<Segment> > segs;
+         for(uint32_t i=0; i<nsat; i++) {
+            SatID sat;
+            sat.system = static_cast<SatelliteSystem>(getU32(buf, pos));
+            sat.id = static_cast<int32_t>(getU32(buf, pos));
+            // check the count against what is left before allocating
+            uint32_t nseg(getU32(buf, pos));
+            if(nseg > (buf.size() - pos)/segSize) {
+               Exception e("Chebyshev ephemeris file is truncated");
+               GPSTK_THROW(e);
+            }
+            vector<Segment>& vs(segs[sat]);
+            vs.resize(nseg);
+            for(size_t k=0; k<vs.size(); k++) {
+               Segment& seg(vs[k]);
+               long day(getI64(buf, pos)), msod(getI64(buf, pos));
+               double fsod(getD(buf, pos));
+               seg.begin.setInternal(day, msod, fsod, ts);
+               seg.length = getD(buf, pos);
+               seg.posErr = getD(buf, pos);
+               seg.velErr = getD(buf, pos);
+               seg.clkErr = getD(buf, pos);
+               seg.coef.resize(4*(deg+1));
+               for(size_t n=0; n<seg.coef.size(); n++)
+                  seg.coef[n] = getD(buf, pos);
+            }
+         }
+         if(pos != buf.size()) {
+            Exception e("Unexpected data at end of Chebyshev ephemeris file");
+            GPSTK_THROW(e);
+         }
+
+         timeSystem = ts;
+         degree = deg;
+         segments.swap(segs);
+      }
+      catch(Exception& e) {
+         e.addText("Reading " + filename);
+         GPSTK_RETHROW(e);
+      }
+   }
+
+   unsigned ChebyshevEphemerisStore::numSegments() const
+   {
+      unsigned n(0);
+      map<SatID, vector<Segment> >::const_iterator it;
+      for(it = segments.begin(); it != segments.end(); ++it)
+         n += it->second.size();
+      return n;
+   }
+
+   const vector<ChebyshevEphemerisStore::Segment>&
+   ChebyshevEphemerisStore::getSegments(const SatID& sat) const
+   {
+      static const vector<Segment> none;
+      map<SatID, vector<Segment> >::const_iterator it(segments.find(sat));
+      return (it == segments.end() ? none : it->second);
+   }
+
+   double ChebyshevEphemerisStore::maxPositionError() const
+   {
+      double err(0.0);
+      map<SatID, vector<Segment> >::const_iterator it;
+      for(it = segments.begin(); it != segments.end(); ++it)
+         for(size_t i=0; i<it->second.size(); i++)
+            err = std::max(err, it->second[i].posErr);
+      return err;
+   }
+
+   double ChebyshevEphemerisStore::maxVelocityError() const
+   {
+      double err(0.0);
+      map<SatID, vector<Segment> >::const_iterator it;
+      for(it = segments.begin(); it != segments.end(); ++it)
+         for(size_t i=0; i<it->second.size(); i++)
+            err = std::max(err, it->second[i].velErr);
+      return err;
+   }
+
+   double ChebyshevEphemerisStore::maxClockError() const
+   {
+      double err(0.0);
+      map<SatID, vector<Segment> >::const_iterator it;
+      for(it = segments.begin(); it != segments.end(); ++it)
+         for(size_t i=0; i<it->second.size(); i++)
+            err = std::max(err, it->second[i].clkErr);
+      return err;
+   }
+
+   void ChebyshevEphemerisStore::dump(ostream& os, short detail) const
+   {
+      os << "Dump of ChebyshevEphemerisStore:" << endl
+         << " Degree " << degree << ", " << segments.size() << " satellites, "
+         << numSegments() << " segments" << endl;
+      if(segments.empty()) return;
+      os << " Time span " << printTime(getInitialTime(),"%4F %10.3g")
+         << " to " << printTime(getFinalTime(),"%4F %10.3g")
+         << " " << timeSystem << endl
+         << scientific << setprecision(3)
+         << " Max differences from reference: position " << maxPositionError()
+         << " m, velocity " << maxVelocityError() << " m/s, clock "
+         << maxClockError() << " s" << endl;
+      if(detail == 0) return;
+
+      map<SatID, vector<Segment> >::const_iterator it;
+      for(it = segments.begin(); it != segments.end(); ++it) {
+         for(size_t i=0; i<it->second.size(); i++) {
+            const Segment& seg(it->second[i]);
+            os << " " << it->first << " "
+               << printTime(seg.begin,"%4F %10.3g")
+               << fixed << setprecision(1) << " " << setw(7) << seg.length
+               << scientific << setprecision(3)
+               << " " << seg.posErr << " " << seg.velErr
+               << " " << seg.clkErr << endl;
+         }
+      }
+   }
+
+   void ChebyshevEphemerisStore::edit(const CommonTime& tmin,
+                                      const CommonTime& tmax)
+   {
+      map<SatID, vector<Segment> >::iterator it;
+      for(it = segments.begin(); it != segments.end(); ) {
+         vector<Segment> keep;
+         for(size_t i=0; i<it->second.size(); i++) {
+            const Segment& seg(it->second[i]);
+            if(seg.begin > tmax || seg.begin + seg.length < tmin)
+               continue;
+            keep.push_back(seg);
+         }
+         if(keep.empty())
+            segments.erase(it++);
+         else {
+            it->second.swap(keep);
+            ++it;
+         }
+      }
+   }
+
+   void ChebyshevEphemerisStore::clear()
+   {
+      segments.clear();
+      degree = 0;
+   }
+
+   CommonTime ChebyshevEphemerisStore::getInitialTime() const
+   {
+      if(segments.empty()) {
+         InvalidRequest e("ChebyshevEphemerisStore is empty");
+         GPSTK_THROW(e);
+      }
+      CommonTime t(CommonTime::END_OF_TIME);
+      t.setTimeSystem(timeSystem);
+      map<SatID, vector<Segment> >::const_iterator it;
+      for(it = segments.begin(); it != segments.end(); ++it)
+         if(it->second.front().begin < t)
+            t = it->second.front().begin;
+      return t;
+   }
+
+   CommonTime ChebyshevEphemerisStore::getFinalTime() const
+   {
+      if(segments.empty()) {
+         InvalidRequest e("ChebyshevEphemerisStore is empty");
+         GPSTK_THROW(e);
+      }
+      CommonTime t(CommonTime::BEGINNING_OF_TIME);
+      t.setTimeSystem(timeSystem);
+      map<SatID, vector<Segment> >::const_iterator it;
+      for(it = segments.begin(); it != segments.end(); ++it) {
+         CommonTime tend(it->second.back().begin + it->second.back().length);
+         if(tend > t)
+            t = tend;
+      }
+      return t;
+   }
+
+   set<SatID> ChebyshevEphemerisStore::getIndexSet() const
+   {
+      set<SatID> sats;
+      map<SatID, vector<Segment> >::const_iterator it;
+      for(it = segments.begin(); it != segments.end(); ++it)
+         sats.insert(it->first);
+      return sats;
+   }
+
+   //@}
+
+} // namespace gpstk
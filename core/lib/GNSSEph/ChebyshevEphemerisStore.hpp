@@ -0,0 +1,229 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/** @file ChebyshevEphemerisStore.hpp
+ * Store piecewise Chebyshev series fitted to the orbits and clocks of
+ * another XvtStore, usually an SP3EphemerisStore, for fast evaluation. */
+
+#ifndef GPSTK_CHEBYSHEVEPHEMERISSTORE_HPP
+#define GPSTK_CHEBYSHEVEPHEMERISSTORE_HPP
+
+#include <iostream>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "Exception.hpp"
+#include "CommonTime.hpp"
+#include "SatID.hpp"
+#include "XvtStore.hpp"
+
+namespace gpstk
+{
+      /// @ingroup ephemstore
+      //@{
+
+      /** Piecewise Chebyshev series for satellite position and clock
+       * bias, fitted to a reference XvtStore.
+       *
+       * Interpolating an SP3EphemerisStore means Lagrange
+       * interpolation over interpOrder table points for the position
+       * and again for the clock, for every query.  fit() instead
+       * samples the reference once, at the Chebyshev nodes of
+       * consecutive segments of each satellite's data, and getXvt()
+       * then evaluates a short series.  Velocity and clock drift are
+       * the derivatives of the position and clock series.
+       *
+       * While fitting, each segment is compared with the reference
+       * at points between the nodes; the largest differences are
+       * kept and reported by maxPositionError(), maxVelocityError()
+       * and maxClockError().  Where the reference cannot be
+       * evaluated at all the nodes and check points of a segment, as
+       * near the ends of its data and around gaps, the segment is
+       * shortened or split to the times the reference does cover, to
+       * within 1 ms, so the coverage of the reference is kept and its
+       * gaps become gaps here.
+       *
+       * The fitted series can be saved to and loaded from a compact
+       * binary file (saveFile(), loadFile()), so the fit need only be
+       * done once for a set of SP3 files.
+       * @note Health is not available; getXvt() returns health Unused. */
+   class ChebyshevEphemerisStore : public XvtStore<SatID>
+   {
+   public:
+         /// Series for one satellite over one time segment.
+      struct Segment
+      {
+         CommonTime begin;       ///< start of the segment
+         double length;          ///< length of the segment (s)
+         double posErr;          ///< max position difference from reference (m)
+         double velErr;          ///< max velocity difference from reference (m/s)
+         double clkErr;          ///< max clock difference from reference (s)
+            /// coefficients for X, Y, Z (m) and clock bias (s), in that order
+         std::vector<double> coef;
+      };
+
+      ChebyshevEphemerisStore()
+            : timeSystem(TimeSystem::Any), degree(0)
+      { onlyHealthy = false; }
+
+      virtual ~ChebyshevEphemerisStore()
+      {}
+
+         /** Replace the contents of this store with series fitted to
+          * ref.  Segments start at ref.getInitialTime() and cover
+          * ref.getFinalTime(); the last one may be shorter, as may
+          * those at the ends of the data or at gaps, which are
+          * reduced to the part that ref covers.
+          * @param[in] ref the reference store
+          * @param[in] segment the length of each segment (s)
+          * @param[in] deg the degree of the series
+          * @return the number of segments fitted
+          * @throw InvalidParameter if segment or deg is not positive
+          * @throw InvalidRequest if ref is empty */
+      unsigned fit(const XvtStore<SatID>& ref, double segment = 3600.,
+                   unsigned deg = 12);
+
+         /** Write the series to a binary file.
+          * @throw FileMissingException if the file cannot be opened */
+      void saveFile(const std::string& filename) const;
+
+         /** Replace the contents of this store with series read from
+          * a file written by saveFile().
+          * @throw FileMissingException if the file cannot be opened
+          * @throw Exception if the file is not in the expected format */
+      void loadFile(const std::string& filename);
+
+         /// Degree of the series, 0 if empty.
+      unsigned getDegree() const
+      { return degree; }
+
+         /// Total number of segments, all satellites.
+      unsigned numSegments() const;
+
+         /// Return the segments for sat, empty if sat is not present.
+      const std::vector<Segment>& getSegments(const SatID& sat) const;
+
+         /// Largest position difference from the reference over all segments (m).
+      double maxPositionError() const;
+
+         /// Largest velocity difference from the reference over all segments (m/s).
+      double maxVelocityError() const;
+
+         /// Largest clock difference from the reference over all segments (s).
+      double maxClockError() const;
+
+         // XvtStore interface
+
+         /** Returns the position, velocity, and clock offset of sat
+          * in ECEF coordinates (meters) at time t.
+          * @throw InvalidRequest if no segment of sat covers t */
+      virtual Xvt getXvt(const SatID& sat, const CommonTime& t) const;
+
+         /** As getXvt(), but never throws; health is Unavailable if
+          * the result could not be computed. */
+      virtual Xvt computeXvt(const SatID& sat, const CommonTime& t) const
+         throw();
+
+         /// Unused if sat is covered at t, otherwise Unavailable.
+      virtual Xvt::HealthStatus getSVHealth(const SatID& sat,
+                                            const CommonTime& t) const throw();
+
+         /// Dump a summary (detail 0) or every segment (detail 1).
+      virtual void dump(std::ostream& s = std::cout, short detail = 0) const;
+
+         /// Remove segments that lie entirely outside [tmin,tmax].
+      virtual void edit(const CommonTime& tmin,
+                        const CommonTime& tmax = CommonTime::END_OF_TIME);
+
+      virtual void clear();
+
+      virtual TimeSystem getTimeSystem() const
+      { return timeSystem; }
+
+         /// @throw InvalidRequest if the store is empty
+      virtual CommonTime getInitialTime() const;
+
+         /// @throw InvalidRequest if the store is empty
+      virtual CommonTime getFinalTime() const;
+
+      virtual bool hasVelocity() const
+      { return true; }
+
+      virtual bool isPresent(const SatID& sat) const
+      { return segments.find(sat) != segments.end(); }
+
+      virtual std::set<SatID> getIndexSet() const;
+
+   private:
+         /** Fit the series of seg, whose begin and length are set,
+          * to ref, and record the differences from ref.
+          * @return false if ref cannot be evaluated at every node and
+          *   at every point where the differences are checked */
+      bool fitSegment(const XvtStore<SatID>& ref, const SatID& sat,
+                      Segment& seg) const;
+
+         /** Fit a segment of sat from t0, or, where ref does not
+          * cover all of it, segments to the parts it does cover at
+          * the nodes and check points, searching at most three levels
+          * of finer grids for them.
+          * @return the number of segments added */
+      unsigned fitCovered(const XvtStore<SatID>& ref, const SatID& sat,
+                          const CommonTime& t0, double length,
+                          unsigned depth);
+
+         /** Find the segment of sat covering t.
+          * @throw InvalidRequest if there is none */
+      const Segment& findSegment(const SatID& sat, const CommonTime& t) const;
+
+         /** Evaluate series j (0-3) of seg at tau in [-1,1], and its
+          * derivative with respect to tau. */
+      void evaluate(const Segment& seg, unsigned j, double tau,
+                    double& value, double& deriv) const;
+
+      TimeSystem timeSystem;        ///< time system of the reference
+      unsigned degree;              ///< degree of every series
+      std::map<SatID, std::vector<Segment> > segments;  ///< per satellite, by time
+   }; // end class ChebyshevEphemerisStore
+
+      //@}
+
+} // namespace gpstk
+
+#endif // GPSTK_CHEBYSHEVEPHEMERISSTORE_HPP
@@ -44,6 +44,7 @@
 #include <cstdlib>
 #include <iostream>
 #include <cmath>
+#include <algorithm>
 #include "EngNav.hpp"
 #include "GNSSconstants.hpp"
 
@@ -732,6 +733,66 @@ namespace gpstk
          ((sf[9] & 0x0000003f) == computeParity(sf[9], sf[8], knownUpright));
    }
 
+   namespace
+   {
+         /// Return the XOR of all the bits of x.
+      inline uint32_t parity32(uint32_t x)
+      {
+         x ^= x >> 16;
+         x ^= x >> 8;
+         x ^= x >> 4;
+         x ^= x >> 2;
+         x ^= x >> 1;
+         return x & 1;
+      }
+   }
+
+
+   void EngNav :: checkParity(const uint32_t *const sfs[], size_t count,
+                              bool ok[], bool knownUpright)
+   {
+         // same masks as computeParity()
+      const uint32_t b0 = 0x3B1F3480, b1 = 0x1D8F9A40, b2 = 0x2EC7CD00,
+         b3 = 0x1763E680, b4 = 0x2BB1F340, b5 = 0x0B7A89C0;
+      const uint32_t invert = (knownUpright ? 0 : 0xffffffff);
+      const size_t block = 16;
+      uint32_t w[10][block];
+      uint32_t bad[block];
+      for (size_t base = 0; base < count; base += block)
+      {
+         size_t n = std::min(block, count - base);
+            // transpose the subframes so that each loop below works
+            // on the same word of a whole block of subframes
+         for (size_t j = 0; j < block; j++)
+         {
+            for (unsigned k = 0; k < 10; k++)
+               w[k][j] = (j < n ? sfs[base+j][k] : 0);
+            bad[j] = 0;
+         }
+         for (unsigned k = 0; k < 10; k++)
+         {
+            for (size_t j = 0; j < block; j++)
+            {
+               uint32_t prev = (k == 0 ? 0 : w[k-1][j]);
+               uint32_t D29 = (prev >> 1) & 1;
+               uint32_t D30 = prev & 1;
+               uint32_t d = w[k][j] ^ ((0 - D30) & invert);
+               uint32_t D =
+                  ((D29 ^ parity32(b0 & d)) << 5) |
+                  ((D30 ^ parity32(b1 & d)) << 4) |
+                  ((D29 ^ parity32(b2 & d)) << 3) |
+                  ((D30 ^ parity32(b3 & d)) << 2) |
+                  ((D30 ^ parity32(b4 & d)) << 1) |
+                  (D29 ^ parity32(b5 & d));
+               bad[j] |= D ^ (w[k][j] & 0x3f);
+            }
+         }
+         for (size_t j = 0; j < n; j++)
+            ok[base+j] = (bad[j] == 0);
+      }
+   }
+
+
    void EngNav :: convertQuant(const uint32_t input[10],
                                double output[60],
                                DecodeQuant *p)
@@ -124,6 +124,21 @@ namespace gpstk
       static bool checkParity(const uint32_t input[10], bool knownUpright=true);
       static bool checkParity(const std::vector<uint32_t>& v, bool knownUpright=true);
 
+         /**
+          * Perform a parity check on many navigation message
+          * subframes.  The result is the same as calling
+          * checkParity() on each subframe, but the subframes are
+          * checked in blocks, a word at a time, in branch-free loops
+          * that the compiler can vectorize.
+          * @param[in] sfs Pointers to the subframes of 10 words each.
+          * @param[in] count The number of subframes.
+          * @param[out] ok ok[i] is set to true if the parity check of
+          *   sfs[i] is successful.
+          * @param[in] knownUpright As for checkParity().
+          */
+      static void checkParity(const uint32_t *const sfs[], size_t count,
+                              bool ok[], bool knownUpright=true);
+
 
          /// This is the old routine only left around for compatibility
       static bool subframeParity(const long input[10]);
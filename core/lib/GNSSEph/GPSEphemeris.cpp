@@ -48,6 +48,7 @@
 #include "TimeString.hpp"
 
 #include "GPSEphemeris.hpp"
+#include "Snapshot.hpp"
 
 using namespace std;
 
@@ -263,4 +264,40 @@ namespace gpstk
       return 0; // never reached
    }
 
+
+   void GPSEphemeris::writeSnapshot(SnapshotWriter& w) const
+   {
+      OrbitEph::writeSnapshot(w);
+      w.write(transmitTime);
+      w.write(HOWtime);
+      w.write(IODE);
+      w.write(IODC);
+      w.write(health);
+      w.write(accuracyFlag);
+      w.write(accuracy);
+      w.write(Tgd);
+      w.write(codeflags);
+      w.write(L2Pdata);
+      w.write(fitDuration);
+      w.write(fitint);
+   }
+
+
+   void GPSEphemeris::readSnapshot(SnapshotReader& r)
+   {
+      OrbitEph::readSnapshot(r);
+      r.read(transmitTime);
+      r.read(HOWtime);
+      r.read(IODE);
+      r.read(IODC);
+      r.read(health);
+      r.read(accuracyFlag);
+      r.read(accuracy);
+      r.read(Tgd);
+      r.read(codeflags);
+      r.read(L2Pdata);
+      r.read(fitDuration);
+      r.read(fitint);
+   }
+
 } // end namespace
@@ -119,6 +119,13 @@ namespace gpstk
          fitDuration = getFitInterval(IODC, fitintFlag);
       }
 
+         /// Write the data members to a snapshot.
+      virtual void writeSnapshot(SnapshotWriter& w) const;
+
+         /** Read the data members back from a snapshot.
+          * @throw InvalidRequest if the snapshot is too short. */
+      virtual void readSnapshot(SnapshotReader& r);
+
          // member data
       CommonTime transmitTime;   ///< Time of transmission
       long HOWtime;              ///< Time (seconds-of-week) of handover word (txmit)
@@ -48,6 +48,7 @@
 #include "GALWeekSecond.hpp"
 
 #include "GalEphemeris.hpp"
+#include "Snapshot.hpp"
 
 using namespace std;
 
@@ -198,4 +199,32 @@ namespace gpstk
       return Xvt::Unknown;
    }
 
+
+   void GalEphemeris::writeSnapshot(SnapshotWriter& w) const
+   {
+      OrbitEph::writeSnapshot(w);
+      w.write(transmitTime);
+      w.write(HOWtime);
+      w.write(IODnav);
+      w.write(accuracy);
+      w.write(Tgda);
+      w.write(Tgdb);
+      w.write(datasources);
+      w.write(fitDuration);
+   }
+
+
+   void GalEphemeris::readSnapshot(SnapshotReader& r)
+   {
+      OrbitEph::readSnapshot(r);
+      r.read(transmitTime);
+      r.read(HOWtime);
+      r.read(IODnav);
+      r.read(accuracy);
+      r.read(Tgda);
+      r.read(Tgdb);
+      r.read(datasources);
+      r.read(fitDuration);
+   }
+
 } // end namespace
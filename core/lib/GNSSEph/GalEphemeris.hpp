@@ -104,6 +104,13 @@ namespace gpstk
          /// @throw Invalid Request if the required data has not been stored.
       virtual void dumpBody(std::ostream& os = std::cout) const;
 
+         /// Write the data members to a snapshot.
+      virtual void writeSnapshot(SnapshotWriter& w) const;
+
+         /** Read the data members back from a snapshot.
+          * @throw InvalidRequest if the snapshot is too short. */
+      virtual void readSnapshot(SnapshotReader& r);
+
          // member data
       CommonTime transmitTime;   ///< Time of transmission
       long HOWtime;              ///< Time (seconds-of-week) of handover word (txmit)
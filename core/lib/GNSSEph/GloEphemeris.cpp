@@ -42,6 +42,7 @@
 #include <iomanip>
 #include "GloEphemeris.hpp"
 #include "TimeString.hpp"
+#include "Snapshot.hpp"
 
 namespace gpstk
 {
@@ -150,20 +151,47 @@ namespace gpstk
 
       double tolerance( 1e-9 );
       bool done( false );
+
+         // Continue from the last checkpoint of this integration, if any,
+         // that does not go past epoch.
+      IntegrationCache::Checkpoint cp;
+      std::vector<IntegrationCache::Checkpoint> newPoints;
+      unsigned known( rkCache.find(*this, rkStep, epoch, cp) );
+      unsigned nsteps( known*IntegrationCache::STRIDE );
+      if ( known > 0 )
+      {
+         workEpoch = cp.workEpoch;
+         numSeconds = cp.numSeconds;
+         for( int j = 0; j < 6; ++j )
+            initialState(j) = cp.state[j];
+         s = s0 + we*( numSeconds );
+         cs = std::cos(s);
+         ss = std::sin(s);
+         if ( std::fabs(epoch - workEpoch ) < tolerance )
+            done = true;
+      }
+
       while (!done)
       {
 
             // If we are about to overstep, change the stepsize appropriately
             // to hit our target final time.
+         bool wholeStep( true );
          if( rkStep > 0.0 )
          {
             if( (workEpoch + rkStep) > epoch )
+            {
                rkStep = (epoch - workEpoch);
+               wholeStep = false;
+            }
          }
          else
          {
             if ( (workEpoch + rkStep) < epoch )
+            {
                rkStep = (epoch - workEpoch);
+               wholeStep = false;
+            }
          }
 
          numSeconds += rkStep;
@@ -199,8 +227,21 @@ namespace gpstk
          if ( std::fabs(epoch - workEpoch ) < tolerance )
             done = true;
 
+            // Save a checkpoint after every STRIDE whole steps
+         if ( wholeStep && ++nsteps % IntegrationCache::STRIDE == 0 )
+         {
+            cp.workEpoch = workEpoch;
+            cp.numSeconds = numSeconds;
+            for( int j = 0; j < 6; ++j )
+               cp.state[j] = initialState(j);
+            newPoints.push_back(cp);
+         }
+
       }  // End of 'while (!done)...'
 
+      if ( !newPoints.empty() )
+         rkCache.extend(*this, rkStep, known, newPoints);
+
 
       px = initialState(0);
       py = initialState(2);
@@ -230,6 +271,82 @@ namespace gpstk
    }  // End of method 'GloEphemeris::svXvt(const CommonTime& t)'
 
 
+   const unsigned GloEphemeris::IntegrationCache::STRIDE;
+
+
+   unsigned GloEphemeris::IntegrationCache::find( const GloEphemeris& eph,
+                                                  double rkStep,
+                                                  const CommonTime& epoch,
+                                                  Checkpoint& cp )
+   {
+      std::lock_guard<std::mutex> lock(mtx);
+      check(eph);
+      const std::vector<Checkpoint>& points( rkStep > 0.0 ? forward
+                                                          : backward );
+
+         // number of checkpoints not beyond epoch
+      unsigned lo(0), hi(points.size());
+      while ( lo < hi )
+      {
+         unsigned mid( (lo+hi)/2 );
+         if ( rkStep > 0.0 ? points[mid].workEpoch <= epoch
+                           : points[mid].workEpoch >= epoch )
+            lo = mid+1;
+         else
+            hi = mid;
+      }
+      if ( lo > 0 )
+         cp = points[lo-1];
+      return lo;
+
+   }  // End of method 'GloEphemeris::IntegrationCache::find()'
+
+
+   void GloEphemeris::IntegrationCache::extend( const GloEphemeris& eph,
+                                                double rkStep,
+                                                unsigned known,
+                                                const std::vector<Checkpoint>&
+                                                newPoints )
+   {
+      std::lock_guard<std::mutex> lock(mtx);
+      check(eph);
+      std::vector<Checkpoint>& points( rkStep > 0.0 ? forward : backward );
+
+         // The checkpoints may have been cleared, or extended by another
+         // thread, since find()
+      if ( points.size() < known )
+         return;
+      for ( size_t i = points.size() - known; i < newPoints.size(); i++ )
+         points.push_back(newPoints[i]);
+
+   }  // End of method 'GloEphemeris::IntegrationCache::extend()'
+
+
+   void GloEphemeris::IntegrationCache::clear()
+   {
+      std::lock_guard<std::mutex> lock(mtx);
+      forward.clear();
+      backward.clear();
+   }
+
+
+   void GloEphemeris::IntegrationCache::check( const GloEphemeris& eph )
+   {
+      if ( (forward.empty() && backward.empty()) ||
+           !(ephTime == eph.ephTime) || !(x == eph.x) || !(v == eph.v) ||
+           !(a == eph.a) || step != eph.step )
+      {
+         forward.clear();
+         backward.clear();
+         ephTime = eph.ephTime;
+         x = eph.x;
+         v = eph.v;
+         a = eph.a;
+         step = eph.step;
+      }
+   }
+
+
       // Get the epoch time for this ephemeris
    CommonTime GloEphemeris::getEphemerisEpoch() const
    {
@@ -401,6 +518,53 @@ namespace gpstk
    }  // End of method 'GloEphemeris::setRecord()'
 
 
+      // Write the ephemeris to a snapshot.
+   void GloEphemeris::writeSnapshot(SnapshotWriter& w) const
+   {
+      w.write(x);
+      w.write(v);
+      w.write(clkbias);
+      w.write(clkdrift);
+      w.write(relcorr);
+      w.write(frame);
+      w.write(Xvt::health);
+      w.write(satSys);
+      w.write(PRNID);
+      w.write(ephTime);
+      w.write(a);
+      w.write(MFtime);
+      w.write(health);
+      w.write(freqNum);
+      w.write(ageOfInfo);
+      w.write(valid);
+      w.write(step);
+   }  // End of method 'GloEphemeris::writeSnapshot()'
+
+
+      // Read the ephemeris back from a snapshot.
+   void GloEphemeris::readSnapshot(SnapshotReader& r)
+   {
+      r.read(x);
+      r.read(v);
+      r.read(clkbias);
+      r.read(clkdrift);
+      r.read(relcorr);
+      r.read(frame);
+      r.read(Xvt::health);
+      r.read(satSys);
+      r.read(PRNID);
+      r.read(ephTime);
+      r.read(a);
+      r.read(MFtime);
+      r.read(health);
+      r.read(freqNum);
+      r.read(ageOfInfo);
+      r.read(valid);
+      r.read(step);
+      rkCache.clear();
+   }  // End of method 'GloEphemeris::readSnapshot()'
+
+
       // Compute true sidereal time  (in hours) at Greenwich at 0 hours UT.
    double GloEphemeris::getSidTime( const CommonTime& time ) const
    {
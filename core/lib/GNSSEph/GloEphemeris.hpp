@@ -43,6 +43,8 @@
 #define GPSTK_GLOEPHEMERIS_HPP
 
 #include <iostream>
+#include <mutex>
+#include <vector>
 #include "Triple.hpp"
 #include "Xvt.hpp"
 #include "CommonTime.hpp"
@@ -56,6 +58,9 @@ namespace gpstk
       /// @ingroup GNSSEph
       //@{
 
+   class SnapshotWriter;
+   class SnapshotReader;
+
       /**
        * Ephemeris information for a single GLONASS satellite.  This class
        * encapsulates the ephemeris navigation message and provides functions
@@ -222,6 +227,16 @@ namespace gpstk
                                double ageofinfo,
                                double rkStep = 1.0 );
 
+         /** Write the ephemeris to a snapshot (see
+          * GloEphemerisStore::saveSnapshot()).  The integration
+          * checkpoints are not included. */
+      void writeSnapshot(SnapshotWriter& w) const;
+
+         /** Read the ephemeris back from a snapshot written by
+          * writeSnapshot().
+          * @throw InvalidRequest if the snapshot is too short. */
+      void readSnapshot(SnapshotReader& r);
+
 
    protected:
 
@@ -247,6 +262,65 @@ namespace gpstk
       double step;
 
 
+         /** Checkpoints of the Runge-Kutta integration from ephTime,
+          * kept so that svXvt() can continue from the nearest one
+          * instead of integrating from ephTime on every call.  The
+          * integration always takes the same steps from ephTime, so
+          * results are identical either way.  Checkpoints are taken
+          * every STRIDE whole steps, in each direction from ephTime,
+          * and are discarded when the ephemeris data change.  Copies
+          * start empty. */
+      class IntegrationCache
+      {
+      public:
+            /// Number of integration steps between checkpoints.
+         static const unsigned STRIDE = 32;
+
+            /// Integration state after a whole number of steps.
+         struct Checkpoint
+         {
+            CommonTime workEpoch;   ///< time of the state
+            double numSeconds;      ///< seconds of day at workEpoch
+            double state[6];        ///< inertial position and velocity
+         };
+
+         IntegrationCache() {}
+         IntegrationCache(const IntegrationCache&) {}
+         IntegrationCache& operator=(const IntegrationCache&)
+         { clear(); return *this; }
+
+            /** Find the last checkpoint not beyond epoch in the
+             * direction of rkStep.
+             * @param[in] eph the ephemeris being integrated
+             * @param[out] cp the checkpoint, if found
+             * @return the number of checkpoints in that direction up to
+             *   and including cp (0 if none is usable) */
+         unsigned find(const GloEphemeris& eph, double rkStep,
+                       const CommonTime& epoch, Checkpoint& cp);
+
+            /** Add checkpoints newPoints, numbered from known+1, in the
+             * direction of rkStep. */
+         void extend(const GloEphemeris& eph, double rkStep, unsigned known,
+                     const std::vector<Checkpoint>& newPoints);
+
+         void clear();
+
+      private:
+            /// Clear the checkpoints unless they were computed from eph.
+         void check(const GloEphemeris& eph);
+
+         std::mutex mtx;
+            // the ephemeris data the checkpoints were computed from
+         CommonTime ephTime;
+         Triple x, v, a;
+         double step;
+            /// checkpoints after STRIDE*(i+1) steps forward / backward
+         std::vector<Checkpoint> forward, backward;
+      };
+
+         /// Checkpoints of the orbit integration in svXvtOverrideFit().
+      mutable IntegrationCache rkCache;
+
          /// Compute true sidereal time (in hours) at Greenwich at 0 hours UT.
       double getSidTime( const CommonTime& time ) const;
 
@@ -43,6 +43,7 @@
 
 #include "GloEphemerisStore.hpp"
 #include "TimeString.hpp"
+#include "Snapshot.hpp"
 
 using namespace std;
 
@@ -157,7 +158,8 @@ namespace gpstk
       }
 
          // We now have the proper reference data record. Let's use it
-      GloEphemeris data( i->second );
+         // (not a copy, so its integration checkpoints are kept)
+      const GloEphemeris& data( i->second );
 
          // Compute the satellite position, velocity and clock offset
       sv = data.svXvt( epoch );
@@ -231,7 +233,8 @@ namespace gpstk
          }
 
             // We now have the proper reference data record. Let's use it
-         GloEphemeris data(i->second);
+            // (not a copy, so its integration checkpoints are kept)
+         const GloEphemeris& data(i->second);
 
             // Compute the satellite position, velocity and clock offset
          rv = data.svXvt(epoch);
@@ -310,7 +313,8 @@ namespace gpstk
          }
 
             // We now have the proper reference data record. Let's use it
-         GloEphemeris data(i->second);
+            // (not a copy, so its integration checkpoints are kept)
+         const GloEphemeris& data(i->second);
          rv = (data.getHealth() == 0 ? Xvt::HealthStatus::Healthy
                : Xvt::HealthStatus::Unhealthy);
       }
@@ -647,4 +651,83 @@ namespace gpstk
    }
 
 
+      // Write the entire store to a snapshot file.
+   void GloEphemerisStore::saveSnapshot(const std::string& fn) const
+   {
+      SnapshotWriter w;
+      writeSnapshot(w);
+      w.save(fn);
+   }
+
+
+      // Replace the store with the contents of a snapshot file.
+   void GloEphemerisStore::loadSnapshot(const std::string& fn)
+   {
+      SnapshotReader r(fn);
+      try
+      {
+         readSnapshot(r);
+         if (!r.atEnd())
+         {
+            InvalidRequest ir("Unexpected data at end of snapshot " + fn);
+            GPSTK_THROW(ir);
+         }
+      }
+      catch (Exception& e)
+      {
+         clear();
+         GPSTK_RETHROW(e);
+      }
+   }
+
+
+   void GloEphemerisStore::writeSnapshot(SnapshotWriter& w) const
+   {
+      w.write("GloEphemerisStore");
+      w.write(onlyHealthy);
+      w.write(step);
+      w.write(initialTime);
+      w.write(finalTime);
+      w.write(pe.size());
+      for (GloEphMap::const_iterator it = pe.begin(); it != pe.end(); ++it)
+      {
+         w.write(it->first);
+         w.write(it->second.size());
+         for (TimeGloMap::const_iterator tgmIter = it->second.begin();
+              tgmIter != it->second.end(); ++tgmIter)
+         {
+            w.write(tgmIter->first);
+            tgmIter->second.writeSnapshot(w);
+         }
+      }
+   }
+
+
+   void GloEphemerisStore::readSnapshot(SnapshotReader& r)
+   {
+      clear();
+      r.expect("GloEphemerisStore");
+      r.read(onlyHealthy);
+      r.read(step);
+      r.read(initialTime);
+      r.read(finalTime);
+
+      size_t nsat, neph;
+      SatID sat;
+      CommonTime key;
+      r.read(nsat);
+      for (size_t i = 0; i < nsat; i++)
+      {
+         r.read(sat);
+         r.read(neph);
+         TimeGloMap& tgm = pe[sat];
+         for (size_t j = 0; j < neph; j++)
+         {
+            r.read(key);
+            tgm[key].readSnapshot(r);
+         }
+      }
+   }
+
+
 }  // End of namespace gpstk
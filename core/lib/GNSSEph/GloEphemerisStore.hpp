@@ -283,6 +283,30 @@ namespace gpstk
 
       virtual std::set<gpstk::SatID> getIndexSet() const; 
 
+         /** Write the entire contents of the store to a binary
+          * snapshot file that can be restored with loadSnapshot().
+          * @param[in] fn the name of the snapshot file.
+          * @throw FileMissingException if the file can't be written. */
+      void saveSnapshot(const std::string& fn) const;
+
+         /** Replace the contents of the store with those of a
+          * snapshot file written by saveSnapshot().
+          * @param[in] fn the name of the snapshot file.
+          * @throw FileMissingException if the file can't be opened.
+          * @throw InvalidRequest if the file is not a valid snapshot
+          *   of a GloEphemerisStore.  The store is unchanged if the file can't
+          *   be opened or fails its checksum, and is left empty if
+          *   its contents can't be restored. */
+      void loadSnapshot(const std::string& fn);
+
+         /// Write the store to a snapshot.
+      void writeSnapshot(SnapshotWriter& w) const;
+
+         /** Read the store back from a snapshot written by
+          * writeSnapshot(), replacing the current contents.
+          * @throw InvalidRequest if the snapshot is not valid. */
+      void readSnapshot(SnapshotReader& r);
+
    private:
 
          /// The map of SVs and Xvt's
@@ -47,6 +47,7 @@
 /// Galileo, and BeiDou, with RINEX Navigation input, among others.
 
 #include "OrbitEph.hpp"
+#include "Snapshot.hpp"
 #include "MathBase.hpp"
 #include "GNSSconstants.hpp"
 #include "CivilTime.hpp"
@@ -536,6 +537,70 @@ namespace gpstk
    }
 */
 
+   void OrbitEph::writeSnapshot(SnapshotWriter& sw) const
+   {
+      sw.write(dataLoadedFlag);
+      sw.write(satID);
+      sw.write(obsID);
+      sw.write(ctToe);
+      sw.write(ctToc);
+      sw.write(af0);
+      sw.write(af1);
+      sw.write(af2);
+      sw.write(M0);
+      sw.write(dn);
+      sw.write(ecc);
+      sw.write(A);
+      sw.write(OMEGA0);
+      sw.write(i0);
+      sw.write(w);
+      sw.write(OMEGAdot);
+      sw.write(idot);
+      sw.write(dndot);
+      sw.write(Adot);
+      sw.write(Cuc);
+      sw.write(Cus);
+      sw.write(Crc);
+      sw.write(Crs);
+      sw.write(Cic);
+      sw.write(Cis);
+      sw.write(beginValid);
+      sw.write(endValid);
+   }
+
+
+   void OrbitEph::readSnapshot(SnapshotReader& r)
+   {
+      r.read(dataLoadedFlag);
+      r.read(satID);
+      r.read(obsID);
+      r.read(ctToe);
+      r.read(ctToc);
+      r.read(af0);
+      r.read(af1);
+      r.read(af2);
+      r.read(M0);
+      r.read(dn);
+      r.read(ecc);
+      r.read(A);
+      r.read(OMEGA0);
+      r.read(i0);
+      r.read(w);
+      r.read(OMEGAdot);
+      r.read(idot);
+      r.read(dndot);
+      r.read(Adot);
+      r.read(Cuc);
+      r.read(Cus);
+      r.read(Crc);
+      r.read(Crs);
+      r.read(Cic);
+      r.read(Cis);
+      r.read(beginValid);
+      r.read(endValid);
+   }
+
+
    // Output object to stream
    ostream& operator<<(ostream& os, const OrbitEph& eph)
    {
@@ -66,6 +66,9 @@ namespace gpstk
       /// @ingroup GNSSEph
       //@{
 
+   class SnapshotWriter;
+   class SnapshotReader;
+
    class OrbitEph
    {
    public:
@@ -175,6 +178,19 @@ namespace gpstk
          dumpBody(os);
       }
 
+         /** Write the data members to a snapshot (see
+          * OrbitEphStore::saveSnapshot()).
+          * @note this must be both overridden and called by derived
+          *   classes that add data members. */
+      virtual void writeSnapshot(SnapshotWriter& sw) const;
+
+         /** Read the data members back from a snapshot written by
+          * writeSnapshot().
+          * @note this must be both overridden and called by derived
+          *   classes that add data members.
+          * @throw InvalidRequest if the snapshot is too short. */
+      virtual void readSnapshot(SnapshotReader& r);
+
          /** Define this OrbitEph by converting the given RINEX
           * navigation data.
           * @note this will be both overridden and called by the
@@ -0,0 +1,287 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/// @file OrbitEphBatch.cpp Evaluate the broadcast Kepler orbits of many
+/// OrbitEph objects in blocks of lanes.
+
+#include <cmath>
+
+#include "OrbitEphBatch.hpp"
+#include "MathBase.hpp"
+#include "GNSSconstants.hpp"
+#include "GPSWeekSecond.hpp"
+#include "GPSEllipsoid.hpp"
+#include "CGCS2000Ellipsoid.hpp"
+#include "StringUtils.hpp"
+
+using namespace std;
+
+namespace gpstk
+{
+   const unsigned OrbitEphBatch::BLOCK;
+   const unsigned OrbitEphBatch::KEPLER_ITERATIONS;
+
+   OrbitEphBatch::OrbitEphBatch()
+   { }
+
+   void OrbitEphBatch::clear()
+   {
+      params.clear();
+      ctToe.clear();
+      ctToc.clear();
+   }
+
+   unsigned OrbitEphBatch::add(const OrbitEph& eph)
+   {
+      if(!eph.dataLoadedFlag)
+         GPSTK_THROW(InvalidRequest("Data not loaded"));
+
+         // same test as BDSEphemeris::svXvt()
+      if(eph.satID.system == SatelliteSystem::BeiDou &&
+         (eph.i0*180./PI) <= 7.0)
+      {
+         InvalidParameter e("BeiDou GEO orbit is not supported, satellite "
+                            + StringUtils::asString(eph.satID));
+         GPSTK_THROW(e);
+      }
+
+      Params p;
+      p.M0 = eph.M0;
+      p.dn = eph.dn;
+      p.dndot = eph.dndot;
+      p.ecc = eph.ecc;
+      p.A = eph.A;
+      p.Adot = eph.Adot;
+      p.OMEGA0 = eph.OMEGA0;
+      p.i0 = eph.i0;
+      p.w = eph.w;
+      p.OMEGAdot = eph.OMEGAdot;
+      p.idot = eph.idot;
+      p.Cuc = eph.Cuc;
+      p.Cus = eph.Cus;
+      p.Crc = eph.Crc;
+      p.Crs = eph.Crs;
+      p.Cic = eph.Cic;
+      p.Cis = eph.Cis;
+      p.af0 = eph.af0;
+      p.af1 = eph.af1;
+      p.af2 = eph.af2;
+      p.ToeSOW = GPSWeekSecond(eph.ctToe).sow;   // SOW is time-system-independent
+      p.sqrtA = SQRT(eph.A);
+         // as in OrbitEph::svRelativity()
+      if(eph.satID.system == SatelliteSystem::BeiDou)
+         p.sqrtgmRel = SQRT(CGCS2000Ellipsoid().gm());
+      else
+         p.sqrtgmRel = SQRT(GPSEllipsoid().gm());
+
+      params.push_back(p);
+      ctToe.push_back(eph.ctToe);
+      ctToc.push_back(eph.ctToc);
+      return params.size()-1;
+   }
+
+   void OrbitEphBatch::evaluate(const vector<unsigned>& index,
+                                const vector<CommonTime>& times,
+                                vector<Xvt>& xvts) const
+   {
+      if(index.size() != times.size())
+         GPSTK_THROW(InvalidParameter("index and times differ in size"));
+      for(size_t i=0; i<index.size(); i++) {
+         if(index[i] >= params.size()) {
+            InvalidParameter e("Orbit index out of range: "
+                               + StringUtils::asString(index[i]));
+            GPSTK_THROW(e);
+         }
+      }
+
+      xvts.resize(index.size());
+      for(size_t i=0; i<index.size(); i += BLOCK) {
+         unsigned n = (index.size()-i < BLOCK ? index.size()-i : BLOCK);
+         evaluateBlock(&index[i], &times[i], false, n, &xvts[i]);
+      }
+   }
+
+   void OrbitEphBatch::evaluate(const CommonTime& t, vector<Xvt>& xvts) const
+   {
+      unsigned index[BLOCK];
+      xvts.resize(params.size());
+      for(size_t i=0; i<params.size(); i += BLOCK) {
+         unsigned n = (params.size()-i < BLOCK ? params.size()-i : BLOCK);
+         for(unsigned k=0; k<n; k++)
+            index[k] = i+k;
+         evaluateBlock(index, &t, true, n, &xvts[i]);
+      }
+   }
+
+   // The computation follows OrbitEph::svXvt() step by step; each step is a
+   // loop over all BLOCK lanes of packed arrays.  Lanes beyond n repeat the
+   // first request and their results are discarded.
+   void OrbitEphBatch::evaluateBlock(const unsigned *index,
+                                     const CommonTime *times,
+                                     bool oneTime, unsigned n, Xvt *xvts) const
+   {
+      static const GPSEllipsoid ell;
+      const double sqrtgm = SQRT(ell.gm());
+      const double omegaE = ell.angVelocity();
+      const double twoPI = 2.0e0 * PI;
+      const unsigned L = BLOCK;
+      unsigned k;
+
+         // gather the parameters and elapsed times into lanes
+      double elapte[L], elaptc[L];
+      double M0[L], dn[L], dndot[L], ecc[L], A[L], Adot[L], sqrtA[L];
+      double OMEGA0[L], i0[L], w[L], OMEGAdot[L], idot[L], ToeSOW[L];
+      double Cuc[L], Cus[L], Crc[L], Crs[L], Cic[L], Cis[L];
+      double af0[L], af1[L], af2[L], sqrtgmRel[L];
+      for(k=0; k<L; k++) {
+         unsigned j = (k < n ? k : 0);
+         const CommonTime& t(oneTime ? times[0] : times[j]);
+         const Params& p(params[index[j]]);
+         elapte[k] = t - ctToe[index[j]];
+         elaptc[k] = t - ctToc[index[j]];
+         M0[k] = p.M0; dn[k] = p.dn; dndot[k] = p.dndot;
+         ecc[k] = p.ecc; A[k] = p.A; Adot[k] = p.Adot; sqrtA[k] = p.sqrtA;
+         OMEGA0[k] = p.OMEGA0; i0[k] = p.i0; w[k] = p.w;
+         OMEGAdot[k] = p.OMEGAdot; idot[k] = p.idot; ToeSOW[k] = p.ToeSOW;
+         Cuc[k] = p.Cuc; Cus[k] = p.Cus; Crc[k] = p.Crc;
+         Crs[k] = p.Crs; Cic[k] = p.Cic; Cis[k] = p.Cis;
+         af0[k] = p.af0; af1[k] = p.af1; af2[k] = p.af2;
+         sqrtgmRel[k] = p.sqrtgmRel;
+      }
+
+         // mean motion and mean anomaly
+      double Ak[L], amm[L], meana[L], ea[L];
+      for(k=0; k<L; k++) {
+         Ak[k] = A[k] + Adot[k] * elapte[k];
+         amm[k] = sqrtgm / (A[k]*sqrtA[k]) + dn[k] + 0.5*dndot[k]*elapte[k];
+         meana[k] = fmod(M0[k] + elapte[k] * amm[k], twoPI);
+         ea[k] = meana[k] + ecc[k] * ::sin(meana[k]);
+      }
+
+         // Kepler's equation, fixed number of Newton iterations
+      for(unsigned iter=0; iter<KEPLER_ITERATIONS; iter++) {
+         for(k=0; k<L; k++) {
+            double F = meana[k] - (ea[k] - ecc[k] * ::sin(ea[k]));
+            double G = 1.0 - ecc[k] * ::cos(ea[k]);
+            ea[k] += F/G;
+         }
+      }
+
+         // true anomaly, harmonic corrections, radius, inclination, node
+      double sinea[L], G[L], q[L], c2al[L], s2al[L];
+      double U[L], R[L], AINC[L], ANLON[L];
+      for(k=0; k<L; k++) {
+         double cosea = ::cos(ea[k]);
+         sinea[k] = ::sin(ea[k]);
+         q[k] = SQRT(1.0e0 - ecc[k]*ecc[k]);
+         G[k] = 1.0e0 - ecc[k] * cosea;
+         double alat = ::atan2(q[k] * sinea[k], cosea - ecc[k]) + w[k];
+         c2al[k] = ::cos(2.0e0 * alat);
+         s2al[k] = ::sin(2.0e0 * alat);
+         U[k] = alat + c2al[k] * Cuc[k] + s2al[k] * Cus[k];
+         R[k] = Ak[k]*G[k] + c2al[k] * Crc[k] + s2al[k] * Crs[k];
+         AINC[k] = i0[k] + idot[k] * elapte[k] + c2al[k] * Cic[k] + s2al[k] * Cis[k];
+         ANLON[k] = OMEGA0[k] + (OMEGAdot[k] - omegaE) * elapte[k]
+                    - omegaE * ToeSOW[k];
+      }
+
+         // earth fixed position and velocity
+      double x[L], y[L], z[L], vx[L], vy[L], vz[L];
+      for(k=0; k<L; k++) {
+         double cosu = ::cos(U[k]), sinu = ::sin(U[k]);
+         double can = ::cos(ANLON[k]), san = ::sin(ANLON[k]);
+         double cinc = ::cos(AINC[k]), sinc = ::sin(AINC[k]);
+         double xip = R[k] * cosu;
+         double yip = R[k] * sinu;
+         x[k] = xip*can - yip*cinc*san;
+         y[k] = xip*san + yip*cinc*can;
+         z[k] = yip*sinc;
+
+         double dek = amm[k] / G[k];
+         double dlk = amm[k] * q[k] / (G[k]*G[k]);
+         double div = idot[k] - 2.0e0 * dlk * (Cic[k]*s2al[k] - Cis[k]*c2al[k]);
+         double domk = OMEGAdot[k] - omegaE;
+         double duv = dlk*(1.e0 + 2.e0 * (Cus[k]*c2al[k] - Cuc[k]*s2al[k]));
+         double drv = Ak[k] * ecc[k] * dek * sinea[k]
+                    - 2.e0 * dlk * (Crc[k]*s2al[k] - Crs[k]*c2al[k])
+                    + Adot[k] * G[k];
+         double dxp = drv*cosu - R[k]*sinu*duv;
+         double dyp = drv*sinu + R[k]*cosu*duv;
+         vx[k] = dxp*can - xip*san*domk - dyp*cinc*san
+                 + yip*(sinc*san*div - cinc*can*domk);
+         vy[k] = dxp*san + xip*can*domk + dyp*cinc*can
+                 - yip*(sinc*can*div + cinc*san*domk);
+         vz[k] = dyp*sinc + yip*cinc*div;
+      }
+
+         // clock and relativity.  OrbitEph::svRelativity() solves Kepler's
+         // equation again, with the mean motion of its own ellipsoid and
+         // without dndot; starting from ea, two Newton steps reproduce it.
+      double clkbias[L], clkdrift[L], relcorr[L];
+      for(k=0; k<L; k++) {
+         clkbias[k] = af0[k] + elaptc[k] * (af1[k] + elaptc[k] * af2[k]);
+         clkdrift[k] = af1[k] + elaptc[k] * af2[k];
+         double dmean = ((sqrtgmRel[k]-sqrtgm) / (A[k]*sqrtA[k])
+                         - 0.5*dndot[k]*elapte[k]) * elapte[k];
+         double eaRel = ea[k];
+         for(unsigned iter=0; iter<2; iter++) {
+            double F = meana[k] + dmean - (eaRel - ecc[k] * ::sin(eaRel));
+            double G = 1.0 - ecc[k] * ::cos(eaRel);
+            eaRel += F/G;
+         }
+         relcorr[k] = REL_CONST * ecc[k] * SQRT(Ak[k]) * ::sin(eaRel);
+      }
+
+         // scatter the results
+      for(k=0; k<n; k++) {
+         Xvt& sv(xvts[k]);
+         sv.x[0] = x[k];
+         sv.x[1] = y[k];
+         sv.x[2] = z[k];
+         sv.v[0] = vx[k];
+         sv.v[1] = vy[k];
+         sv.v[2] = vz[k];
+         sv.clkbias = clkbias[k];
+         sv.clkdrift = clkdrift[k];
+         sv.relcorr = relcorr[k];
+         sv.frame = ReferenceFrame::WGS84;
+         sv.health = Xvt::HealthStatus::Uninitialized;
+      }
+   }
+
+} // namespace gpstk
@@ -0,0 +1,143 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/** @file OrbitEphBatch.hpp Evaluate the broadcast Kepler orbits of
+ * many OrbitEph objects (GPS, Galileo, BeiDou MEO/IGSO, QZSS) in
+ * blocks of lanes, for coverage and visibility computations that
+ * need very many satellite positions. */
+
+#ifndef GPSTK_ORBITEPHBATCH_HPP
+#define GPSTK_ORBITEPHBATCH_HPP
+
+#include <vector>
+#include "Exception.hpp"
+#include "CommonTime.hpp"
+#include "Xvt.hpp"
+#include "OrbitEph.hpp"
+
+namespace gpstk
+{
+      /// @ingroup GNSSEph
+      //@{
+
+      /** A packed copy of the orbit and clock parameters of a set of
+       * OrbitEph, evaluated BLOCK (satellite, time) pairs at a time.
+       *
+       * Each step of the computation in OrbitEph::svXvt() is done
+       * for all lanes of a block in a loop with no branches, so that
+       * the compiler can map the lanes onto vector registers (4
+       * doubles with AVX2, 8 with AVX-512) when the library is built
+       * with the corresponding instruction set; otherwise the same
+       * code runs as scalar loops.  Kepler's equation is solved with
+       * a fixed number of Newton iterations rather than iterating to
+       * a tolerance.
+       *
+       * Results agree with OrbitEph::svXvt() to well under a
+       * millimetre in position.
+       * @note BeiDou GEO orbits, which BDSEphemeris::svXvt() handles
+       *   separately, are not supported. */
+   class OrbitEphBatch
+   {
+   public:
+         /// Number of lanes evaluated together.
+      static const unsigned BLOCK = 8;
+
+         /// Number of Newton iterations in the Kepler solution.
+      static const unsigned KEPLER_ITERATIONS = 8;
+
+      OrbitEphBatch();
+
+         /// Remove all orbits.
+      void clear();
+
+         /** Add a copy of the parameters of eph.
+          * @return the index of the orbit, for evaluate()
+          * @throw InvalidRequest if eph has no data loaded
+          * @throw InvalidParameter if eph is a BeiDou GEO orbit */
+      unsigned add(const OrbitEph& eph);
+
+         /// Return the number of orbits.
+      unsigned size() const
+      { return params.size(); }
+
+         /** Compute the Xvt of orbit index[i] at times[i] for each i.
+          * @param[in] index orbit indexes as returned by add()
+          * @param[in] times the time for each orbit
+          * @param[out] xvts the results, resized to index.size()
+          * @throw InvalidParameter if index and times differ in size
+          *   or an index is out of range
+          * @throw InvalidRequest if a time is in a time system
+          *   incompatible with the orbit's */
+      void evaluate(const std::vector<unsigned>& index,
+                    const std::vector<CommonTime>& times,
+                    std::vector<Xvt>& xvts) const;
+
+         /** Compute the Xvt of every orbit at time t.
+          * @param[in] t the time of interest
+          * @param[out] xvts the results, in the order added
+          * @throw InvalidRequest if t is in a time system
+          *   incompatible with an orbit's */
+      void evaluate(const CommonTime& t, std::vector<Xvt>& xvts) const;
+
+         /// The orbit and clock parameters of one OrbitEph.
+      struct Params
+      {
+         double M0, dn, dndot, ecc, A, Adot, OMEGA0, i0, w, OMEGAdot, idot;
+         double Cuc, Cus, Crc, Crs, Cic, Cis;
+         double af0, af1, af2;
+         double ToeSOW;          ///< Toe seconds of week
+         double sqrtA;           ///< square root of A
+         double sqrtgmRel;       ///< sqrt(GM) used for relativity
+      };
+
+   private:
+         /** Evaluate the n <= BLOCK requests (index[i], times[i]);
+          * if oneTime, times[0] is used for all of them. */
+      void evaluateBlock(const unsigned *index, const CommonTime *times,
+                         bool oneTime, unsigned n, Xvt *xvts) const;
+
+      std::vector<Params> params;       ///< packed orbit parameters
+      std::vector<CommonTime> ctToe;    ///< Ephemeris epoch of each orbit
+      std::vector<CommonTime> ctToc;    ///< Clock epoch of each orbit
+   }; // end class OrbitEphBatch
+
+      //@}
+
+} // namespace gpstk
+
+#endif // GPSTK_ORBITEPHBATCH_HPP
@@ -55,12 +55,28 @@
 #include "RinexSatID.hpp"  // for dump
 
 #include "OrbitEphStore.hpp"
+#include "GPSEphemeris.hpp"
+#include "GalEphemeris.hpp"
+#include "BDSEphemeris.hpp"
+#include "QZSEphemeris.hpp"
+#include "Snapshot.hpp"
 
 using namespace std;
 using namespace gpstk::StringUtils;
 
 namespace gpstk
 {
+      // Selection of the OrbitEph for time t from a satellite's table, given
+      // table.lower_bound(t); used by find{User,Near}OrbitEph() and getXvts().
+   static const OrbitEph* selectUserOrbitEph(
+      const OrbitEphStore::TimeOrbitEphTable& table,
+      OrbitEphStore::TimeOrbitEphTable::const_iterator it,
+      const CommonTime& t);
+   static const OrbitEph* selectNearOrbitEph(
+      const OrbitEphStore::TimeOrbitEphTable& table,
+      OrbitEphStore::TimeOrbitEphTable::const_iterator itNext,
+      const CommonTime& t);
+
    Xvt OrbitEphStore::getXvt(const SatID& sat, const CommonTime& t) const
    {
       try
@@ -92,6 +108,77 @@ namespace gpstk
    }
 
 
+   unsigned OrbitEphStore::getXvts(const vector<SatID>& ids,
+                                   const vector<CommonTime>& times,
+                                   vector<Xvt>& xvts,
+                                   vector<bool>& valid) const
+   {
+      checkXvtsRequest(ids, times, xvts, valid);
+
+         // Where the last search of each satellite's table ended.
+         // it is table.lower_bound(t) for every t with
+         // prior(it)->first < t <= it->first, so the search is
+         // skipped for all such times.
+      struct SearchHint
+      {
+         const TimeOrbitEphTable *table;
+         TimeOrbitEphTable::const_iterator it;
+      };
+      map<SatID, SearchHint> hints;
+
+      unsigned nvalid = 0;
+      for (size_t i = 0; i < ids.size(); i++)
+      {
+         const SatID& sat = ids[i];
+         const CommonTime& t = times[i];
+         try
+         {
+            map<SatID, SearchHint>::iterator hit = hints.find(sat);
+            if (hit == hints.end())
+            {
+               SatTableMap::const_iterator sit = satTables.find(sat);
+               SearchHint hint;
+               hint.table = (sit == satTables.end() || sit->second.empty()
+                             ? NULL : &sit->second);
+               if (hint.table)
+                  hint.it = hint.table->lower_bound(t);
+               hit = hints.insert(make_pair(sat, hint)).first;
+            }
+            SearchHint& hint = hit->second;
+            if (!hint.table)
+               continue;
+
+            const TimeOrbitEphTable& table = *hint.table;
+            TimeOrbitEphTable::const_iterator prior = hint.it;
+            if ((hint.it != table.end() && hint.it->first < t) ||
+                (hint.it != table.begin() && !((--prior)->first < t)))
+            {
+               hint.it = table.lower_bound(t);
+            }
+
+               // the rest follows getXvt()
+            const OrbitEph *eph =
+               (strictMethod ? selectUserOrbitEph(table, hint.it, t)
+                : selectNearOrbitEph(table, hint.it, t));
+            if (!eph || (onlyHealthy && !eph->isHealthy()))
+               continue;
+
+            Xvt sv = eph->svXvt(t);
+            sv.health = (eph->isHealthy() ? Xvt::HealthStatus::Healthy
+                         : Xvt::HealthStatus::Unhealthy);
+            xvts[i] = sv;
+            valid[i] = true;
+            nvalid++;
+         }
+         catch (InvalidRequest&)
+         {
+               // getXvt() would throw; leave this one invalid
+         }
+      }
+      return nvalid;
+   }
+
+
    Xvt OrbitEphStore::computeXvt(const SatID& sat, const CommonTime& t) const
       throw()
    {
@@ -437,54 +524,42 @@ namespace gpstk
    // The goal of this routine is to find the set of orbital elements that would have
    // been used by a receiver in real-time. That is to say, the most recently
    // broadcast elements (assuming receiver has visibility to the given satellite).
+   // @param[in] table the satellite's map of orbital elements, not empty
+   // @param[in] it table.lower_bound(t)
+   // @param[in] t the time of interest
    // @return a pointer to the desired OrbitEph, or NULL if no OrbitEph found.
-   const OrbitEph* OrbitEphStore::findUserOrbitEph(const SatID& sat,
-                                                   const CommonTime& t) const
+   static const OrbitEph* selectUserOrbitEph(
+      const OrbitEphStore::TimeOrbitEphTable& table,
+      OrbitEphStore::TimeOrbitEphTable::const_iterator it,
+      const CommonTime& t)
    {
-      // Is this satellite found in the table?
-      if(satTables.find(sat) == satTables.end())
-         return NULL;
-      // Define reference to the relevant map of orbital elements
-      const TimeOrbitEphTable& table = getTimeOrbitEphMap(sat);
-
       // The map is ordered by beginning times of validity, which
       // is another way of saying "earliest transmit time".  A call
       // to table.lower_bound(t) will return the element of the map
       // with a key "just beyond t" assuming the t is NOT a direct match for any key.
 
-      if (table.empty())
-         return NULL;
-
-      TimeOrbitEphTable::const_iterator it = table.find(t);
-      if(it == table.end()) {                   // not a direct match
-         it = table.lower_bound(t);
-
-         // Tricky case here.  If the key is beyond the last key in the table,
-         // lower_bound() will return table.end(). However, this doesn't entirely
-         // settle the matter. It is theoretically possible that the final
-         // item in the table may have an effectivity that "stretches" far enough
-         // to cover time t. Therefore, if it==table.end() we need to check
-         // the period of validity of the final element in the table against time t.
-         if(it == table.end()) {
-            TimeOrbitEphTable::const_reverse_iterator rit = table.rbegin();
-            if(rit->second->isValid(t))         // Last element in map works
-            {
-               return rit->second;
-            }
-
-            // have nothing
-            //string mess = "Time is beyond table for satellite " + asString(sat)
-            //   + " for time " + printTime(t,fmt);
-            //InvalidRequest e(mess);
-            //GPSTK_THROW(e);
-            return NULL;
+      // Tricky case here.  If the key is beyond the last key in the table,
+      // lower_bound() will return table.end(). However, this doesn't entirely
+      // settle the matter. It is theoretically possible that the final
+      // item in the table may have an effectivity that "stretches" far enough
+      // to cover time t. Therefore, if it==table.end() we need to check
+      // the period of validity of the final element in the table against time t.
+      if(it == table.end()) {
+         OrbitEphStore::TimeOrbitEphTable::const_reverse_iterator rit =
+            table.rbegin();
+         if(rit->second->isValid(t))         // Last element in map works
+         {
+            return rit->second;
          }
-      }  // end if not a direct match
 
-      // Found a direct match. should probably use the PRIOR set
+         // have nothing
+         return NULL;
+      }
+
+      // If this is a direct match, should probably use the PRIOR set
       // since it takes ~30 seconds from beginning of transmission to complete
       // reception.
-      // If lower_bound( ) was called, it points to the element after the time t,
+      // Otherwise it points to the element after the time t,
       // So either way, it points ONE BEYOND the element we want.
       // The exception is if it is pointing to table.begin( ),
       // then all of the elements in the map are too late.
@@ -493,10 +568,6 @@ namespace gpstk
          {
             return it->second;
          }
-         //string mess = "Time is before table for satellite " + asString(sat)
-         //      + " for time " + printTime(t,fmt);
-         //InvalidRequest e(mess);
-         //GPSTK_THROW(e);
          return NULL;
       }
 
@@ -512,36 +583,27 @@ namespace gpstk
       }
       it--;
       if(!(it->second->isValid(t))) {
-         //// there is a "hole" in the middle of a map.
-         //string mess = "No orbital elements found for satellite " + asString(sat)
-         //   + " at time " + printTime(t,fmt);
-         //InvalidRequest e(mess);
-         //GPSTK_THROW(e);
+         // there is a "hole" in the middle of a map.
          return NULL;
       }
 
       return it->second;
 
-   }  // end OrbitEph* OrbitEphStore::findUserOrbitEph
+   }  // end selectUserOrbitEph
 
 
    //---------------------------------------------------------------------------------
-   const OrbitEph* OrbitEphStore::findNearOrbitEph(const SatID& sat,
-                                                   const CommonTime& t) const
+   // Choose the OrbitEph with Toe nearest t, see findNearOrbitEph().
+   // @param[in] table the satellite's map of orbital elements, not empty
+   // @param[in] itNext table.lower_bound(t)
+   // @param[in] t the time of interest
+   // @return a pointer to the desired OrbitEph, or NULL if no OrbitEph found.
+   static const OrbitEph* selectNearOrbitEph(
+      const OrbitEphStore::TimeOrbitEphTable& table,
+      OrbitEphStore::TimeOrbitEphTable::const_iterator itNext,
+      const CommonTime& t)
    {
-        // Check for any OrbitEph for this SV
-      if(satTables.find(sat) == satTables.end())
-         return NULL;
-
-      // No OrbitEph in store for requested sat time
-      // Define reference to the relevant map of orbital elements
-      const TimeOrbitEphTable& table = getTimeOrbitEphMap(sat);
-
-      if (table.empty())
-         return NULL;
-
-      TimeOrbitEphTable::const_iterator itNext = table.find(t);
-      if(itNext != table.end())               // exact match
+      if(itNext != table.end() && !(t < itNext->first))   // exact match
          return itNext->second;
 
       // Three cases:
@@ -549,8 +611,7 @@ namespace gpstk
       // 2. t is before all OrbitEph in the store
       // 3. t is after all OrbitEph in the store
 
-      // lower_bound returns the first element with key >= t
-      itNext = table.lower_bound(t);
+      // itNext is the first element with key >= t
       if(itNext == table.begin())             // Test for case 2
       {
             // Verify the first item in the table has a fit interval that
@@ -566,7 +627,8 @@ namespace gpstk
        // Test for case 3
       if(itNext == table.end()) 
       {
-         TimeOrbitEphTable::const_reverse_iterator rit = table.rbegin();
+         OrbitEphStore::TimeOrbitEphTable::const_reverse_iterator rit =
+            table.rbegin();
             // Verify the last item in the table has a fit interval that
             // covers the time of interest.   If not, then there are no
             // data sets available that cover the time of interest, so return
@@ -579,7 +641,7 @@ namespace gpstk
 
       // case 1: it is not the beginning, so safe to decrement
       CommonTime nextTOE = itNext->second->ctToe;
-      TimeOrbitEphTable::const_iterator itPrior = itNext;
+      OrbitEphStore::TimeOrbitEphTable::const_iterator itPrior = itNext;
       itPrior--;
       CommonTime lastTOE = itPrior->second->ctToe;
       double diffToNext = nextTOE - t;
@@ -587,8 +649,8 @@ namespace gpstk
 
          // Determine which is closer to Toe and assign temporary
          // pointers accordingly.  
-      TimeOrbitEphTable::const_iterator itSelect;
-      TimeOrbitEphTable::const_iterator itUnSelect;
+      OrbitEphStore::TimeOrbitEphTable::const_iterator itSelect;
+      OrbitEphStore::TimeOrbitEphTable::const_iterator itUnSelect;
       if(diffToNext > diffFromLast)
       {
          itSelect = itPrior;
@@ -614,6 +676,35 @@ namespace gpstk
       return NULL;
    }
 
+
+   //---------------------------------------------------------------------------------
+   // @return a pointer to the desired OrbitEph, or NULL if no OrbitEph found.
+   const OrbitEph* OrbitEphStore::findUserOrbitEph(const SatID& sat,
+                                                   const CommonTime& t) const
+   {
+      // Is this satellite found in the table?
+      SatTableMap::const_iterator sit = satTables.find(sat);
+      if(sit == satTables.end() || sit->second.empty())
+         return NULL;
+
+      const TimeOrbitEphTable& table = sit->second;
+      return selectUserOrbitEph(table, table.lower_bound(t), t);
+   }
+
+
+   //---------------------------------------------------------------------------------
+   const OrbitEph* OrbitEphStore::findNearOrbitEph(const SatID& sat,
+                                                   const CommonTime& t) const
+   {
+        // Check for any OrbitEph for this SV
+      SatTableMap::const_iterator sit = satTables.find(sat);
+      if(sit == satTables.end() || sit->second.empty())
+         return NULL;
+
+      const TimeOrbitEphTable& table = sit->second;
+      return selectNearOrbitEph(table, table.lower_bound(t), t);
+   }
+
    //---------------------------------------------------------------------------------
    // Add all ephemerides to an existing list<OrbitEph>.
    // If SatID sat is given, limit selections to sat's satellite system, plus if
@@ -668,4 +759,104 @@ namespace gpstk
       return retSet;
    }
 
+   //---------------------------------------------------------------------------------
+   void OrbitEphStore::saveSnapshot(const string& fn) const
+   {
+      SnapshotWriter w;
+      writeSnapshot(w);
+      w.save(fn);
+   }
+
+   //---------------------------------------------------------------------------------
+   void OrbitEphStore::loadSnapshot(const string& fn)
+   {
+      SnapshotReader r(fn);
+      try
+      {
+         readSnapshot(r);
+         if(!r.atEnd())
+         {
+            InvalidRequest ir("Unexpected data at end of snapshot " + fn);
+            GPSTK_THROW(ir);
+         }
+      }
+      catch(Exception& e)
+      {
+         clear();
+         GPSTK_RETHROW(e);
+      }
+   }
+
+   //---------------------------------------------------------------------------------
+      // Create an empty OrbitEph of the class named by getName(), for
+      // restoring a snapshot.
+   static OrbitEph* newOrbitEph(const string& name)
+   {
+      if(name == "GPSEphemeris") return new GPSEphemeris();
+      if(name == "GalEphemeris") return new GalEphemeris();
+      if(name == "BDSEphemeris") return new BDSEphemeris();
+      if(name == "QZSEphemeris") return new QZSEphemeris();
+      if(name == "OrbitEph") return new OrbitEph();
+      InvalidRequest ir("Unknown ephemeris class in snapshot: " + name);
+      GPSTK_THROW(ir);
+   }
+
+   //---------------------------------------------------------------------------------
+   void OrbitEphStore::writeSnapshot(SnapshotWriter& w) const
+   {
+      w.write(getName());
+      w.write(timeSystem);
+      w.write(strictMethod);
+      w.write(onlyHealthy);
+      w.write(initialTime);
+      w.write(finalTime);
+      w.write(satTables.size());
+      for(SatTableMap::const_iterator it = satTables.begin();
+          it != satTables.end(); it++)
+      {
+         w.write(it->first);
+         w.write(it->second.size());
+         for(TimeOrbitEphTable::const_iterator jt = it->second.begin();
+             jt != it->second.end(); jt++)
+         {
+            w.write(jt->first);
+            w.write(jt->second->getName());
+            jt->second->writeSnapshot(w);
+         }
+      }
+   }
+
+   //---------------------------------------------------------------------------------
+   void OrbitEphStore::readSnapshot(SnapshotReader& r)
+   {
+      clear();
+      r.expect(getName());
+      r.read(timeSystem);
+      r.read(strictMethod);
+      r.read(onlyHealthy);
+      r.read(initialTime);
+      r.read(finalTime);
+
+      size_t nsat, neph;
+      SatID sat;
+      CommonTime key;
+      string name;
+      r.read(nsat);
+      for(size_t i = 0; i < nsat; i++)
+      {
+         r.read(sat);
+         r.read(neph);
+         TimeOrbitEphTable& toet = satTables[sat];
+         for(size_t j = 0; j < neph; j++)
+         {
+            r.read(key);
+            r.read(name);
+            OrbitEph *eph = newOrbitEph(name);
+               // insert first so that clear() deletes it on error
+            toet[key] = eph;
+            eph->readSnapshot(r);
+         }
+      }
+   }
+
 } // namespace
@@ -105,6 +105,26 @@ namespace gpstk
           *   there are no orbit elements at time t. */
       virtual Xvt getXvt(const SatID& id, const CommonTime& t) const;
 
+         /** Compute the Xvt for each of a list of (satellite, time)
+          * requests, with the same results as getXvt().  The search
+          * of each satellite's table is reused from one request to
+          * the next whenever the time falls between the same pair of
+          * ephemerides, so grouping requests by satellite is cheaper
+          * than calling getXvt() for each.
+          * @note The ephemeris selection is that of
+          *   OrbitEphStore::findUserOrbitEph() and findNearOrbitEph();
+          *   classes that override those should override this too.
+          * @param[in] ids satellite SatIDs
+          * @param[in] times the time to look up for each satellite
+          * @param[out] xvts the Xvt for each request
+          * @param[out] valid true where the Xvt could be computed
+          * @return the number of requests that succeeded
+          * @throw InvalidParameter if ids and times differ in size */
+      virtual unsigned getXvts(const std::vector<SatID>& ids,
+                               const std::vector<CommonTime>& times,
+                               std::vector<Xvt>& xvts,
+                               std::vector<bool>& valid) const;
+
          /** Compute the position, velocity and clock offset of the
           * indicated object in ECEF coordinates (meters) at the
           * indicated time.
@@ -326,6 +346,37 @@ namespace gpstk
       virtual int addToList(std::list<OrbitEph*>& v,
                             SatID sat=SatID(-1,SatelliteSystem::Unknown)) const;
 
+         /** Write the entire contents of the store, including the
+          * time limits and search settings, to a binary snapshot
+          * file that can be restored with loadSnapshot() much faster
+          * than the original navigation files can be read.
+          * @param[in] fn the name of the snapshot file.
+          * @throw FileMissingException if the file can't be written. */
+      void saveSnapshot(const std::string& fn) const;
+
+         /** Replace the contents of the store with those of a
+          * snapshot file written by saveSnapshot() on a store of the
+          * same class.
+          * @param[in] fn the name of the snapshot file.
+          * @throw FileMissingException if the file can't be opened.
+          * @throw InvalidRequest if the file is not a valid snapshot
+          *   of this class of store.  The store is unchanged if the file can't
+          *   be opened or fails its checksum, and is left empty if
+          *   its contents can't be restored. */
+      void loadSnapshot(const std::string& fn);
+
+         /** Write the store to a snapshot.
+          * @note derived classes that add data members should
+          *   override this and call it first. */
+      virtual void writeSnapshot(SnapshotWriter& w) const;
+
+         /** Read the store back from a snapshot written by
+          * writeSnapshot(), replacing the current contents.
+          * @note derived classes that add data members should
+          *   override this and call it first.
+          * @throw InvalidRequest if the snapshot is not valid. */
+      virtual void readSnapshot(SnapshotReader& r);
+
          /// use findNearOrbitEph() in getXvt()
          // MUST be done prior to starting to load nav data sets.
       bool SearchNear(void)
@@ -43,6 +43,7 @@
 #include <math.h>
 #include <iostream>
 #include <iomanip>
+#include <algorithm>
 
 #include "PackedNavBits.hpp"
 #include "GPSWeekSecond.hpp"
@@ -55,11 +56,12 @@ namespace gpstk
 {
    using namespace std;
    PackedNavBits::PackedNavBits()
-                 : transmitTime(CommonTime::BEGINNING_OF_TIME),
-                   parityStatus(psUnknown),
-                   bits(900),
-                   bits_used(0),
+                 : parityStatus(psUnknown),
                    rxID(""),
+                   transmitTime(CommonTime::BEGINNING_OF_TIME),
+                   bits(numWords(900)),
+                   bits_size(900),
+                   bits_used(0),
                    xMitCoerced(false)
    {
       transmitTime.setTimeSystem(TimeSystem::GPS);
@@ -67,10 +69,11 @@ namespace gpstk
    PackedNavBits::PackedNavBits(const SatID& satSysArg, 
                                 const ObsID& obsIDArg,
                                 const CommonTime& transmitTimeArg)
-                                : bits(900),
-                                  parityStatus(psUnknown),
-                                  bits_used(0),
+                                : parityStatus(psUnknown),
                                   rxID(""),
+                                  bits(numWords(900)),
+                                  bits_size(900),
+                                  bits_used(0),
                                   xMitCoerced(false)
    {
       satSys = satSysArg;
@@ -83,10 +86,11 @@ namespace gpstk
                                 const ObsID& obsIDArg,
                                 const std::string rxString,
                                 const CommonTime& transmitTimeArg)
-                                : bits(900),
-                                  parityStatus(psUnknown),
-                                  bits_used(0),
+                                : parityStatus(psUnknown),
                                   rxID(""),
+                                  bits(numWords(900)),
+                                  bits_size(900),
+                                  bits_used(0),
                                   xMitCoerced(false)
    {
       satSys = satSysArg;
@@ -101,10 +105,11 @@ namespace gpstk
                                 const NavID& navIDArg,
                                 const std::string rxString,
                                 const CommonTime& transmitTimeArg)
-                                : bits(900),
-                                  parityStatus(psUnknown),
-                                  bits_used(0),
+                                : parityStatus(psUnknown),
                                   rxID(""),
+                                  bits(numWords(900)),
+                                  bits_size(900),
+                                  bits_used(0),
                                   xMitCoerced(false)
    {
       satSys = satSysArg;
@@ -124,12 +129,11 @@ namespace gpstk
       rxID   = right.rxID;
       transmitTime = right.transmitTime;
       bits_used = right.bits_used;
-      bits.resize(bits_used);
+      bits.assign(right.bits.begin(),
+                  right.bits.begin() + std::min(numWords(bits_used),
+                                                right.bits.size()));
+      resizeBits(bits_used);
       parityStatus = right.parityStatus;
-      for (int i=0;i<bits_used;i++)
-      {
-         bits[i] = right.bits[i];
-      }
       xMitCoerced = right.xMitCoerced;
    }
  
@@ -188,6 +192,7 @@ namespace gpstk
    void PackedNavBits::clearBits()
    {
       bits.clear();
+      bits_size = 0;
       bits_used = 0;
    }
 
@@ -225,20 +230,30 @@ namespace gpstk
    uint64_t PackedNavBits::asUint64_t(const int startBit, 
                                       const int numBits ) const
    {
-      uint64_t temp = 0L;       // Set up a temporary variable with a known size
-                                // It needs to be AT LEAST 33 bits.
       size_t stop = startBit + numBits;
-      if (stop>bits.size())
+      if (stop>bits_size)
       {
          InvalidParameter exc("Requested bits not present.");
          GPSTK_THROW(exc);
       }
-      for (size_t i=startBit; i<stop; ++i)
+      if (numBits<=0)
+         return 0;
+         // Only the last 64 bits of a longer field fit in the result.
+      size_t start = startBit;
+      int num = numBits;
+      if (num>64)
       {
-         temp <<= 1;
-         if (bits[i]) temp++;
+         start += num - 64;
+         num = 64;
       }
-      return( temp ); 
+         // Shift the field to the top of a word, taking the remainder
+         // from the next word if it straddles the boundary.
+      size_t ndx = start >> 6;
+      unsigned offset = start & 63;
+      uint64_t temp = bits[ndx] << offset;
+      if (offset + num > 64)
+         temp |= bits[ndx+1] >> (64 - offset);
+      return( temp >> (64 - num) ); 
    }
 
    unsigned long PackedNavBits::asUnsignedLong(const int startBit, 
@@ -265,7 +280,7 @@ namespace gpstk
       
          // Convert to double and scale
       double dval = (double) uint;
-      dval *= pow(static_cast<double>(2), power2);
+      dval = ldexp(dval, power2);
       return( dval );
    }
 
@@ -276,7 +291,7 @@ namespace gpstk
 
          // Convert to double and scale
       double dval = (double) s;
-      dval *= pow(static_cast<double>(2), power2);
+      dval = ldexp(dval, power2);
       return( dval );
    }
 
@@ -315,7 +330,7 @@ namespace gpstk
       
          // Convert to double and scale
       double dval = (double) smag;
-      dval *= pow(static_cast<double>(2), power2);
+      dval = ldexp(dval, power2);
       return( dval );
    }
                              
@@ -416,7 +431,7 @@ namespace gpstk
       
          // Convert to double and scale
       double dval = (double) ulong;
-      dval *= pow(static_cast<double>(2), power2);
+      dval = ldexp(dval, power2);
       return( dval );
    }
 
@@ -441,7 +456,7 @@ namespace gpstk
 
          // Convert to double and scale
       double dval = (double) s;
-      dval *= pow(static_cast<double>(2), power2);
+      dval = ldexp(dval, power2);
       return( dval );
    }
 
@@ -457,7 +472,7 @@ namespace gpstk
 
    bool PackedNavBits::asBool( const unsigned bitNum) const
    {
-      return bits[bitNum]; 
+      return getBit(bitNum); 
    }
 
 
@@ -592,32 +607,68 @@ namespace gpstk
    {
       int old_bits_used = bits_used;
       bits_used += right.bits_used;
-      bits.resize(bits_used);
+      resizeBits(bits_used);
       
-      for (int i=0;i<right.bits_used;i++)
+      for (int i=0;i<right.bits_used;i+=64)
       {
-         bits[i+old_bits_used] = right.bits[i];
+         int num = std::min(64, right.bits_used - i);
+         setBits(right.asUint64_t(i, num), old_bits_used + i, num);
       }
    }
 
    void PackedNavBits::addUint64_t( const uint64_t value, const int numBits )
    {
-      size_t ndx = bits_used;
-      uint64_t mask = 0x0000000000000001L;
-      mask <<= (numBits-1);
+      if (bits_used + numBits > bits_size)
+         resizeBits(bits_used + numBits);
+      setBits(value, bits_used, numBits);
+      bits_used += numBits;
+   }
 
-      for (int i=0; i<numBits; ++i)
+   void PackedNavBits::setBits( const uint64_t value, const size_t startBit,
+                                const int numBits )
+   {
+      if (numBits<=0)
+         return;
+         // Left justify the field and its mask, then split them
+         // across (at most) two words.
+      uint64_t mask = ~uint64_t(0) << (64 - numBits);
+      uint64_t field = (value << (64 - numBits)) & mask;
+      size_t ndx = startBit >> 6;
+      unsigned offset = startBit & 63;
+      bits[ndx] = (bits[ndx] & ~(mask >> offset)) | (field >> offset);
+      if (offset + numBits > 64)
       {
-         bits[ndx] = false;
-         if (value & mask) 
-         {
-             //set the bits to true
-            bits[ndx] = true;
-         }
-         mask>>= 1;
-         ndx++;
+         unsigned shift = 64 - offset;
+         bits[ndx+1] = (bits[ndx+1] & ~(mask << shift)) | (field << shift);
       }
-      bits_used += numBits;
+   }
+
+   void PackedNavBits::resizeBits(size_t numBits)
+   {
+      bits.resize(numWords(numBits), 0);
+      if (numBits & 63)
+         bits.back() &= ~uint64_t(0) << (64 - (numBits & 63));
+      bits_size = numBits;
+   }
+
+   std::vector<bool> PackedNavBits::getBits() const
+   {
+      std::vector<bool> rv(bits_size);
+      for (size_t i=0; i<bits_size; i++)
+         rv[i] = getBit(i);
+      return rv;
+   }
+
+   size_t PackedNavBits::hashBits() const
+   {
+         // FNV-1a over the words
+      uint64_t hash = 14695981039346656037ULL ^ bits_size;
+      for (size_t i=0; i<bits.size(); i++)
+      {
+         hash ^= bits[i];
+         hash *= 1099511628211ULL;
+      }
+      return size_t(hash ^ (hash >> 32));
    }
 
    //--------------------------------------------------------------------------
@@ -627,9 +678,8 @@ namespace gpstk
    // in which left has a FALSE whereas right has a TRUE starting at the 
    // lowest index and scanning to the maximum index.
    //
-   // NOTE: This is one of the cases in which the PackedNavBits implementation 
-   // is probably not the fastest.  Since we are scanning a bit array rather 
-   // than testing a series of unsigned ints.
+   // Since the bits are packed most significant first and the unused
+   // bits are zero, this is the same as comparing the words in order.
    bool PackedNavBits::operator<(const PackedNavBits& right) const
    {
          // If the two objects don't have the same number of bits,
@@ -637,22 +687,17 @@ namespace gpstk
          // happen.  In the context of NavFilter, data SHOULD be
          // from the same system, therefore, the same length should 
          // always be true.
-      if (bits.size()!=right.bits.size())
+      if (bits_size!=right.bits_size)
       {
-         if (bits.size()<right.bits.size()) return true;
+         if (bits_size<right.bits_size) return true;
          return false;
       }
 
-      for (int i=0;i<bits.size();i++)
+      for (size_t i=0;i<bits.size();i++)
       {
-         if (bits[i]==false && right.bits[i]==true)
-         //if (bits[i]<right.bits[i])
-         {
-            return true;
-         }
-         if (bits[i]==true && right.bits[i]==false)
+         if (bits[i]!=right.bits[i])
          {
-            return false;
+            return bits[i]<right.bits[i];
          }
       }
       return false;
@@ -660,20 +705,12 @@ namespace gpstk
 
    void PackedNavBits::invert( )
    {
-         // Each bit is either 1 or 0.
-         // Starting with 1 and subtracting the 
-         // current value will yield the inverse
-         //   
-         //  Input    Equation     Result
-         //    1       1 - 1          0
-         //    0       1 - 0          1
-         //
-         // This accomplishes the purpose without incurring
-         // the cost of a conditional statement.
-      for (int i=0;i<bits.size();i++)
+      for (size_t i=0;i<bits.size();i++)
       {
-         bits[i] = 1 - bits[i];
+         bits[i] = ~bits[i];
       }
+         // clear the unused bits again
+      resizeBits(bits_size);
    } 
 
       /**
@@ -697,9 +734,10 @@ namespace gpstk
       short finalBit = endBit;
       if (finalBit==-1) finalBit = bits_used - 1;
 
-      for (short i=startBit; i<=finalBit; i++)
+      for (int i=startBit; i<=finalBit; i+=64)
       {
-         bits[i] = src.bits[i];
+         int num = std::min(64, finalBit - i + 1);
+         setBits(src.asUint64_t(i, num), i, num);
       }
    }
 
@@ -729,20 +767,7 @@ namespace gpstk
          GPSTK_THROW(exc);
       }
 
-      size_t ndx = startBit;
-      uint64_t mask = 0x0000000000000001L; 
-
-      mask <<= (numBits-1);
-      for (int i=0; i<numBits; i++)
-      {
-         bits[ndx] = false;
-         if (out & mask)
-         {
-            bits[ndx] = true;
-         }
-         mask >>= 1;
-         ndx++;
-      }
+      setBits(out, startBit, numBits);
    }
 
 
@@ -757,7 +782,7 @@ namespace gpstk
    //--------------------------------------------------------------------------
    void PackedNavBits::trimsize()
    {
-      bits.resize(bits_used);
+      resizeBits(bits_used);
    }
 
    //--------------------------------------------------------------------------
@@ -820,10 +845,10 @@ namespace gpstk
       int numBitInWord = 0;
       int word_count   = 0;
       uint32_t word    = 0;
-      for(size_t i = 0; i < bits.size(); ++i)
+      for(size_t i = 0; i < bits_size; ++i)
       {
          word <<= 1;
-         if (bits[i]) word++;
+         if (getBit(i)) word++;
        
          numBitInWord++;
          if (numBitInWord >= 32)
@@ -859,10 +884,10 @@ namespace gpstk
       int bit_count    = 0; 
       int word_count   = 0;
       uint32_t word    = 0;
-      for(size_t i = 0; i < bits.size(); ++i)
+      for(size_t i = 0; i < bits_size; ++i)
       {
          word <<= 1;
-         if (bits[i]) word++;
+         if (getBit(i)) word++;
        
          numBitInWord++;
          if (numBitInWord >= numBitsPerWord)
@@ -876,7 +901,7 @@ namespace gpstk
             //but ONLY if there are more bits left to put on the next line.
             if (word_count>0 && 
                 word_count % rollover == 0 &&
-                (i+1) < bits.size()) s << endl;        
+                (i+1) < bits_size) s << endl;        
          }
       }
          // Need to check if there is a partial word in the buffer
@@ -886,7 +911,7 @@ namespace gpstk
          s << delimiter << " 0x" << setw(8) << setfill('0') << hex << word << dec << setfill(' ');
       }
       s.flags(oldFlags);      // Reset whatever conditions pertained on entry
-      return(bits.size()); 
+      return(bits_size); 
    }
 
    bool PackedNavBits::operator==(const PackedNavBits& right) const
@@ -939,19 +964,28 @@ namespace gpstk
    {
          // If the two objects don't have the same number of bits,
          // don't even try to compare them. 
-      if (bits.size()!=right.bits.size()) return false; 
+      if (bits_size!=right.bits_size) return false; 
+      if (bits_size==0) return true;
 
       short startBit = startBitA;
       short endBit = endBitA; 
          // Check for nonsense arguments
       if (endBit==-1 ||
-          endBit>=int(bits.size())) endBit = bits.size()-1;
+          endBit>=int(bits_size)) endBit = bits_size-1;
       if (startBit<0) startBit=0;
-      if (startBit>=int(bits.size())) startBit = bits.size()-1;
-
-      for (int i=startBit;i<=endBit;i++)
+      if (startBit>=int(bits_size)) startBit = bits_size-1;
+      if (endBit<startBit) return true;
+
+         // Compare a word at a time, masking the partial words at
+         // either end of the range.
+      size_t first = startBit >> 6;
+      size_t last = endBit >> 6;
+      for (size_t i=first;i<=last;i++)
       {
-         if (bits[i]!=right.bits[i])
+         uint64_t diff = bits[i] ^ right.bits[i];
+         if (i==first) diff &= ~uint64_t(0) >> (startBit & 63);
+         if (i==last) diff &= ~uint64_t(0) << (63 - (endBit & 63));
+         if (diff)
          {
             return false;
          }
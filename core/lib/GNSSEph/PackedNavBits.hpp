@@ -436,7 +436,23 @@ namespace gpstk
       void setXmitCoerced(bool tf=true) {xMitCoerced=tf;}
       bool isXmitCoerced() const {return xMitCoerced;}
 
-      const std::vector<bool>& getBits() const
+         /** Return the bits as a vector of bool.  The bits are stored
+          * packed into words, so this builds a new vector. */
+      std::vector<bool> getBits() const;
+
+         /** Return a hash of the bits (but not the metadata), computed
+          * a word at a time.  Objects whose bits all match (i.e.
+          * matchBits() over the full range of bits) have the same
+          * hash, so it may be used to bin messages before comparing
+          * them.  A match over a partial range of bits says nothing
+          * about the hashes. */
+      size_t hashBits() const;
+
+         /** Return the packed bits, 64 per word, the first bit in the
+          * most significant bit of the first word, e.g. for
+          * computing a CRC over the whole message with
+          * BinUtils::crc24qBits(). */
+      const std::vector<uint64_t>& getWords() const
       { return bits; }
 
          /** Indicate the status of parity/CRC checking.  Must be
@@ -450,13 +466,36 @@ namespace gpstk
       NavID navID;             /**< Defines the navigation message tracked */ 
       std::string rxID;        /**< Defines the receiver that collected the data */
       CommonTime transmitTime; /**< Time nav message is transmitted */
-      std::vector<bool> bits;  /**< Holds the packed data */
+         /** Holds the packed data, 64 bits per word, the first bit
+          * in the most significant bit of the first word.  Bits
+          * beyond bits_size are always zero, so that words may be
+          * compared and hashed directly. */
+      std::vector<uint64_t> bits;
+      size_t bits_size;        /**< Number of bits allocated in bits */
       int bits_used;
       
       bool xMitCoerced;        /**< Used to indicate that the transmit
                                   time is NOT directly derived from
                                   the SOW in the message */
 
+         /// Number of words needed to hold numBits bits.
+      static size_t numWords(size_t numBits)
+      { return (numBits + 63) >> 6; }
+
+         /// Return bit i, without range checking.
+      bool getBit(size_t i) const
+      { return (bits[i >> 6] >> (63 - (i & 63))) & 1; }
+
+         /** Change the number of bits allocated, zeroing any new bits
+          * and the unused bits of the last word. */
+      void resizeBits(size_t numBits);
+
+         /** Overwrite numBits (at most 64) bits starting at startBit
+          * with the least significant bits of value, without range
+          * checking. */
+      void setBits(const uint64_t value, const size_t startBit,
+                   const int numBits);
+
          /** Unpack the bits
           * @throw InvalidParameter
           */
@@ -97,94 +97,187 @@ namespace gpstk
    {
       try {
          bool isExact;
-         int i;
-         PositionRecord rec;
-         DataTableIterator it1, it2, kt;        // cf. TabularSatStore.hpp
+         DataTableIterator it1, it2;            // cf. TabularSatStore.hpp
 
          isExact = getTableInterval(sat, ttag, Nhalf, it1, it2, haveVelocity);
-         if(isExact && haveVelocity) {
-            rec = it1->second;
-            return rec;
-         }
+         if(isExact && haveVelocity)
+            return it1->second;
 
          // pull data out of the data table
-         size_t n,Nlow(Nhalf-1),Nhi(Nhalf),Nmatch(Nhalf);
-         CommonTime ttag0(it1->first);
-         vector<double> times,P[3],V[3],A[3],sigP[3],sigV[3],sigA[3];
+         InterpWindow win;
+         loadWindow(it1, it2, win);
+         return interpolate(win, ttag, isExact);
+      }
+      catch(InvalidRequest& e) { GPSTK_RETHROW(e); }
+   }
 
-         kt = it1; n=0;
-         while(1) {
-            // find index matching ttag
-            if(isExact && ABS(kt->first - ttag) < 1.e-8)
-               Nmatch = n;
-            times.push_back(kt->first - ttag0);          // sec
-            for(i=0; i<3; i++) {
-               P[i].push_back(kt->second.Pos[i]);
-               V[i].push_back(kt->second.Vel[i]);
-               A[i].push_back(kt->second.Acc[i]);
-               sigP[i].push_back(kt->second.sigPos[i]);
-               sigV[i].push_back(kt->second.sigVel[i]);
-               sigA[i].push_back(kt->second.sigAcc[i]);
+   // Return values for a list of (satellite, time) requests; the data pulled out
+   // of the table is kept for each satellite and reused, without searching the
+   // table again, while the requests fall in the same interval.
+   // @return the number of requests that succeeded.
+   // @throw InvalidParameter if sats and ttags differ in size
+   unsigned PositionSatStore::getValues(const vector<SatID>& sats,
+                                        const vector<CommonTime>& ttags,
+                                        vector<PositionRecord>& recs,
+                                        vector<bool>& valid) const
+   {
+      if(sats.size() != ttags.size()) {
+         InvalidParameter e("getValues: sats and ttags differ in size");
+         GPSTK_THROW(e);
+      }
+      recs.assign(sats.size(), PositionRecord());
+      valid.assign(sats.size(), false);
+
+      map<SatID, InterpWindow> windows;
+      unsigned nvalid(0);
+      for(size_t i=0; i<sats.size(); i++) {
+         try {
+            map<SatID, InterpWindow>::iterator wit = windows.find(sats[i]);
+
+            // strictly between the middle entries of the last interval: it is
+            // what getTableInterval() would return, and the time is not exact
+            if(wit != windows.end() && wit->second.centered &&
+               wit->second.lo->first < ttags[i] && ttags[i] < wit->second.hi->first)
+            {
+               recs[i] = interpolate(wit->second, ttags[i], false);
+               valid[i] = true;
+               nvalid++;
+               continue;
             }
-            if(kt == it2) break;
-            ++kt;
-            ++n;
-         };
 
-         if(isExact && Nmatch == (int)(Nhalf-1)) { Nlow++; Nhi++; }
-
-         // Lagrange interpolation
-         rec.sigAcc = rec.Acc = Triple(0,0,0);        // default
-         double dt(ttag-ttag0), err;           // dt in seconds
-         if(haveVelocity) {
-            for(i=0; i<3; i++) {
-               // interpolate the positions
-               rec.Pos[i] = LagrangeInterpolation(times,P[i],dt,err);
-               if(haveAcceleration) {
-                  // interpolate velocities and acclerations
-                  rec.Vel[i] = LagrangeInterpolation(times,V[i],dt,err);
-                  rec.Acc[i] = LagrangeInterpolation(times,A[i],dt,err);
+            bool isExact;
+            DataTableIterator it1, it2;
+            isExact = getTableInterval(sats[i], ttags[i], Nhalf, it1, it2,
+                                       haveVelocity);
+            if(isExact && haveVelocity)
+               recs[i] = it1->second;
+            else {
+               if(wit == windows.end()) {
+                  wit = windows.insert(make_pair(sats[i], InterpWindow())).first;
+                  loadWindow(it1, it2, wit->second);
                }
-               else {
-                  // interpolate velocities(dm/s) to get V and A
-                  LagrangeInterpolation(times,V[i],dt,rec.Vel[i],rec.Acc[i]);
-                  rec.Acc[i] *= 0.1;      // dm/s/s -> m/s/s
+               else if(wit->second.it1 != it1 || wit->second.it2 != it2)
+                  loadWindow(it1, it2, wit->second);
+               InterpWindow& win(wit->second);
+               win.centered = !isExact;
+               if(win.centered) {
+                  win.lo = it1;
+                  for(unsigned k=1; k<Nhalf; k++) ++win.lo;
+                  ++(win.hi = win.lo);
                }
+               recs[i] = interpolate(win, ttags[i], isExact);
+            }
+            valid[i] = true;
+            nvalid++;
+         }
+         catch(InvalidRequest&) { }
+      }
+      return nvalid;
+   }
 
-               if(isExact) {
-                  rec.sigPos[i] = sigP[i][Nmatch];
-                  rec.sigVel[i] = sigV[i][Nmatch];
-                  if(haveAcceleration) rec.sigAcc[i] = sigA[i][Nmatch];
-               }
-               else {
-                  // TD is this sigma related to 'err' in the Lagrange call?
-                  rec.sigPos[i] = RSS(sigP[i][Nhi],sigP[i][Nlow]);
-                  rec.sigVel[i] = RSS(sigV[i][Nhi],sigV[i][Nlow]);
-                  if(haveAcceleration)
-                     rec.sigAcc[i] = RSS(sigA[i][Nhi],sigA[i][Nlow]);
-               }
-               // else Acc=sig_Acc=0   // TD can we do better?
+   void PositionSatStore::loadWindow(const DataTableIterator& it1,
+                                     const DataTableIterator& it2,
+                                     InterpWindow& win) const
+   {
+      int i;
+      win.it1 = it1;
+      win.it2 = it2;
+      win.ttag0 = it1->first;
+      win.times.clear();
+      for(i=0; i<3; i++) {
+         win.P[i].clear(); win.V[i].clear(); win.A[i].clear();
+         win.sigP[i].clear(); win.sigV[i].clear(); win.sigA[i].clear();
+      }
+
+      DataTableIterator kt(it1);
+      while(1) {
+         win.times.push_back(kt->first - win.ttag0);    // sec
+         for(i=0; i<3; i++) {
+            win.P[i].push_back(kt->second.Pos[i]);
+            win.V[i].push_back(kt->second.Vel[i]);
+            win.A[i].push_back(kt->second.Acc[i]);
+            win.sigP[i].push_back(kt->second.sigPos[i]);
+            win.sigV[i].push_back(kt->second.sigVel[i]);
+            win.sigA[i].push_back(kt->second.sigAcc[i]);
+         }
+         if(kt == it2) break;
+         ++kt;
+      };
+   }
+
+   PositionRecord PositionSatStore::interpolate(const InterpWindow& win,
+                                                const CommonTime& ttag,
+                                                bool isExact) const
+   {
+      int i;
+      PositionRecord rec;
+      const vector<double>& times(win.times);
+      const vector<double> *P(win.P), *V(win.V), *A(win.A);
+      const vector<double> *sigP(win.sigP), *sigV(win.sigV), *sigA(win.sigA);
+
+      size_t n,Nlow(Nhalf-1),Nhi(Nhalf),Nmatch(Nhalf);
+      if(isExact) {
+         // find index matching ttag
+         DataTableIterator kt(win.it1);
+         for(n=0; ; ++kt, ++n) {
+            if(ABS(kt->first - ttag) < 1.e-8)
+               Nmatch = n;
+            if(kt == win.it2) break;
+         }
+      }
+
+      if(isExact && Nmatch == (int)(Nhalf-1)) { Nlow++; Nhi++; }
+
+      // Lagrange interpolation
+      rec.sigAcc = rec.Acc = Triple(0,0,0);        // default
+      double dt(ttag-win.ttag0), err;       // dt in seconds
+      if(haveVelocity) {
+         for(i=0; i<3; i++) {
+            // interpolate the positions
+            rec.Pos[i] = LagrangeInterpolation(times,P[i],dt,err);
+            if(haveAcceleration) {
+               // interpolate velocities and acclerations
+               rec.Vel[i] = LagrangeInterpolation(times,V[i],dt,err);
+               rec.Acc[i] = LagrangeInterpolation(times,A[i],dt,err);
+            }
+            else {
+               // interpolate velocities(dm/s) to get V and A
+               LagrangeInterpolation(times,V[i],dt,rec.Vel[i],rec.Acc[i]);
+               rec.Acc[i] *= 0.1;      // dm/s/s -> m/s/s
+            }
+
+            if(isExact) {
+               rec.sigPos[i] = sigP[i][Nmatch];
+               rec.sigVel[i] = sigV[i][Nmatch];
+               if(haveAcceleration) rec.sigAcc[i] = sigA[i][Nmatch];
             }
+            else {
+               // TD is this sigma related to 'err' in the Lagrange call?
+               rec.sigPos[i] = RSS(sigP[i][Nhi],sigP[i][Nlow]);
+               rec.sigVel[i] = RSS(sigV[i][Nhi],sigV[i][Nlow]);
+               if(haveAcceleration)
+                  rec.sigAcc[i] = RSS(sigA[i][Nhi],sigA[i][Nlow]);
+            }
+            // else Acc=sig_Acc=0   // TD can we do better?
          }
-         else {               // no V data - must interpolate position to get velocity
-            for(i=0; i<3; i++) {
-               // interpolate positions(km) to get P and V
-               LagrangeInterpolation(times,P[i],dt,rec.Pos[i],rec.Vel[i]);
-               rec.Vel[i] *= 10000.;         // km/sec -> dm/sec
-
-               if(isExact) {
-                  rec.sigPos[i] = sigP[i][Nmatch];
-               }
-               else {
-                  rec.sigPos[i] = RSS(sigP[i][Nhi],sigP[i][Nlow]);
-               }
-               // TD
-               rec.sigVel[i] = 0.0;
+      }
+      else {               // no V data - must interpolate position to get velocity
+         for(i=0; i<3; i++) {
+            // interpolate positions(km) to get P and V
+            LagrangeInterpolation(times,P[i],dt,rec.Pos[i],rec.Vel[i]);
+            rec.Vel[i] *= 10000.;         // km/sec -> dm/sec
+
+            if(isExact) {
+               rec.sigPos[i] = sigP[i][Nmatch];
             }
+            else {
+               rec.sigPos[i] = RSS(sigP[i][Nhi],sigP[i][Nlow]);
+            }
+            // TD
+            rec.sigVel[i] = 0.0;
          }
-         return rec;
       }
-      catch(InvalidRequest& e) { GPSTK_RETHROW(e); }
+      return rec;
    }
 
    // Return the position for the given satellite at the given time
@@ -45,6 +45,7 @@
 #define GPSTK_POSITION_SAT_STORE_INCLUDE
 
 #include <map>
+#include <vector>
 #include <iostream>
 
 #include "TabularSatStore.hpp"
@@ -119,6 +120,28 @@ namespace gpstk
          /// Store half the interpolation order, for convenience
       unsigned int Nhalf;
 
+         /** The data pulled out of the table for one interpolation
+          * interval [it1,it2], with times relative to ttag0.  If
+          * centered, the interval was found for a time strictly
+          * between the middle entries lo and hi, and getTableInterval()
+          * returns the same interval for every such time. */
+      struct InterpWindow
+      {
+         DataTableIterator it1, it2, lo, hi;
+         bool centered;
+         CommonTime ttag0;
+         std::vector<double> times, P[3], V[3], A[3], sigP[3], sigV[3], sigA[3];
+      };
+
+         /// Fill win with the data in the table interval [it1,it2].
+      void loadWindow(const DataTableIterator& it1, const DataTableIterator& it2,
+                      InterpWindow& win) const;
+
+         /// Interpolate the data in win to ttag; isExact as returned
+         /// by getTableInterval().
+      PositionRecord interpolate(const InterpWindow& win, const CommonTime& ttag,
+                                 bool isExact) const;
+
          // member functions
    public:
 
@@ -154,6 +177,23 @@ namespace gpstk
           *     maxInterval */
       PositionRecord getValue(const SatID& sat, const CommonTime& ttag) const;
 
+         /** Return values for a list of (satellite, time) requests,
+          * each the same as getValue() would return.  The data pulled
+          * from the table for interpolation is kept for each
+          * satellite and reused by later requests that fall in the
+          * same table interval.
+          * @param[in] sats the SatIDs of the satellites of interest
+          * @param[in] ttags the time of interest for each satellite
+          * @param[out] recs the value for each request
+          * @param[out] valid false where getValue() would throw
+          *   InvalidRequest, and recs is undefined
+          * @return the number of requests that succeeded
+          * @throw InvalidParameter if sats and ttags differ in size */
+      unsigned getValues(const std::vector<SatID>& sats,
+                         const std::vector<CommonTime>& ttags,
+                         std::vector<PositionRecord>& recs,
+                         std::vector<bool>& valid) const;
+
          /** Return the position for the given satellite at the given time
           * @param[in] sat the SatID of the satellite of interest
           * @param[in] ttag the time (CommonTime) of interest
@@ -47,6 +47,7 @@
 #include "TimeString.hpp"
 
 #include "QZSEphemeris.hpp"
+#include "Snapshot.hpp"
 
 using namespace std;
 
@@ -160,4 +161,38 @@ namespace gpstk
       catch(Exception& e) { GPSTK_RETHROW(e); }
    }
 
+
+   void QZSEphemeris::writeSnapshot(SnapshotWriter& w) const
+   {
+      OrbitEph::writeSnapshot(w);
+      w.write(transmitTime);
+      w.write(HOWtime);
+      w.write(IODE);
+      w.write(IODC);
+      w.write(health);
+      w.write(accuracy);
+      w.write(Tgd);
+      w.write(codeflags);
+      w.write(L2Pdata);
+      w.write(fitDuration);
+      w.write(fitint);
+   }
+
+
+   void QZSEphemeris::readSnapshot(SnapshotReader& r)
+   {
+      OrbitEph::readSnapshot(r);
+      r.read(transmitTime);
+      r.read(HOWtime);
+      r.read(IODE);
+      r.read(IODC);
+      r.read(health);
+      r.read(accuracy);
+      r.read(Tgd);
+      r.read(codeflags);
+      r.read(L2Pdata);
+      r.read(fitDuration);
+      r.read(fitint);
+   }
+
 } // end namespace
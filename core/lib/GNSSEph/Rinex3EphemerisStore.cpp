@@ -48,6 +48,7 @@
 #include "GalEphemeris.hpp"
 #include "BDSEphemeris.hpp"
 #include "QZSEphemeris.hpp"
+#include "Snapshot.hpp"
 
 using namespace std;
 
@@ -565,6 +566,190 @@ namespace gpstk
       catch(InvalidRequest& ir) { GPSTK_RETHROW(ir); }
    }
 
+   // Snapshot helpers for the header types, which know nothing of
+   // snapshots themselves.
+   static void writeCorr(SnapshotWriter& w, const TimeSystemCorrection& tsc)
+   {
+      w.write(tsc.type);
+      w.write(tsc.frTS);
+      w.write(tsc.toTS);
+      w.write(tsc.A0);
+      w.write(tsc.A1);
+      w.write(tsc.refWeek);
+      w.write(tsc.refSOW);
+      w.write(tsc.refYr);
+      w.write(tsc.refMon);
+      w.write(tsc.refDay);
+      w.write(tsc.geoProvider);
+      w.write(tsc.geoUTCid);
+   }
+
+   static void readCorr(SnapshotReader& r, TimeSystemCorrection& tsc)
+   {
+      r.read(tsc.type);
+      r.read(tsc.frTS);
+      r.read(tsc.toTS);
+      r.read(tsc.A0);
+      r.read(tsc.A1);
+      r.read(tsc.refWeek);
+      r.read(tsc.refSOW);
+      r.read(tsc.refYr);
+      r.read(tsc.refMon);
+      r.read(tsc.refDay);
+      r.read(tsc.geoProvider);
+      r.read(tsc.geoUTCid);
+   }
+
+   static void writeCorrMap(SnapshotWriter& w,
+                            const map<string, TimeSystemCorrection>& tcm)
+   {
+      w.write(tcm.size());
+      map<string, TimeSystemCorrection>::const_iterator it;
+      for(it = tcm.begin(); it != tcm.end(); ++it) {
+         w.write(it->first);
+         writeCorr(w, it->second);
+      }
+   }
+
+   static void readCorrMap(SnapshotReader& r,
+                           map<string, TimeSystemCorrection>& tcm)
+   {
+      size_t n;
+      string key;
+      tcm.clear();
+      r.read(n);
+      for(size_t i = 0; i < n; i++) {
+         r.read(key);
+         readCorr(r, tcm[key]);
+      }
+   }
+
+   static void writeHeader(SnapshotWriter& w, const Rinex3NavHeader& hdr)
+   {
+      w.write(hdr.valid);
+      w.write(hdr.version);
+      w.write(hdr.fileType);
+      w.write(hdr.fileSys);
+      w.write(hdr.fileSysSat);
+      w.write(hdr.fileProgram);
+      w.write(hdr.fileAgency);
+      w.write(hdr.date);
+      w.write(hdr.commentList.size());
+      for(size_t i = 0; i < hdr.commentList.size(); i++)
+         w.write(hdr.commentList[i]);
+      writeCorrMap(w, hdr.mapTimeCorr);
+      w.write(hdr.mapIonoCorr.size());
+      map<string, IonoCorr>::const_iterator it;
+      for(it = hdr.mapIonoCorr.begin(); it != hdr.mapIonoCorr.end(); ++it) {
+         w.write(it->first);
+         w.write(it->second.type);
+         for(int j = 0; j < 4; j++) {
+            const FormattedDouble& fd(it->second.param[j]);
+            w.write(fd.val);
+            w.write(fd.leadChar);
+            w.write(fd.mantissaLen);
+            w.write(fd.exponentLen);
+            w.write(fd.totalLen);
+            w.write(fd.exponentChar);
+            w.write(fd.leadSign);
+            w.write(fd.alignment);
+         }
+      }
+      w.write(hdr.leapSeconds);
+      w.write(hdr.leapDelta);
+      w.write(hdr.leapWeek);
+      w.write(hdr.leapDay);
+   }
+
+   static void readHeader(SnapshotReader& r, Rinex3NavHeader& hdr)
+   {
+      size_t n;
+      string key;
+      r.read(hdr.valid);
+      r.read(hdr.version);
+      r.read(hdr.fileType);
+      r.read(hdr.fileSys);
+      r.read(hdr.fileSysSat);
+      r.read(hdr.fileProgram);
+      r.read(hdr.fileAgency);
+      r.read(hdr.date);
+      r.read(n);
+      hdr.commentList.resize(n);
+      for(size_t i = 0; i < n; i++)
+         r.read(hdr.commentList[i]);
+      readCorrMap(r, hdr.mapTimeCorr);
+      r.read(n);
+      hdr.mapIonoCorr.clear();
+      for(size_t i = 0; i < n; i++) {
+         r.read(key);
+         IonoCorr& ic(hdr.mapIonoCorr[key]);
+         r.read(ic.type);
+         for(int j = 0; j < 4; j++) {
+            FormattedDouble& fd(ic.param[j]);
+            r.read(fd.val);
+            r.read(fd.leadChar);
+            r.read(fd.mantissaLen);
+            r.read(fd.exponentLen);
+            r.read(fd.totalLen);
+            r.read(fd.exponentChar);
+            r.read(fd.leadSign);
+            r.read(fd.alignment);
+         }
+      }
+      r.read(hdr.leapSeconds);
+      r.read(hdr.leapDelta);
+      r.read(hdr.leapWeek);
+      r.read(hdr.leapDay);
+   }
+
+   // Write the store to a snapshot file.
+   void Rinex3EphemerisStore::saveSnapshot(const string& fn) const
+   {
+      SnapshotWriter w;
+      w.write("Rinex3EphemerisStore");
+      vector<string> names(NavFiles.getFileNames());
+      w.write(names.size());
+      for(size_t i = 0; i < names.size(); i++) {
+         w.write(names[i]);
+         writeHeader(w, NavFiles.getHeader(names[i]));
+      }
+      writeCorrMap(w, mapTimeCorr);
+      ORBstore.writeSnapshot(w);
+      GLOstore.writeSnapshot(w);
+      w.save(fn);
+   }
+
+   // Replace the store with the contents of a snapshot file.
+   void Rinex3EphemerisStore::loadSnapshot(const string& fn)
+   {
+      SnapshotReader r(fn);
+      clear();
+      try {
+         size_t n;
+         string name;
+         r.expect("Rinex3EphemerisStore");
+         r.read(n);
+         for(size_t i = 0; i < n; i++) {
+            Rinex3NavHeader hdr;
+            r.read(name);
+            readHeader(r, hdr);
+            NavFiles.addFile(name, hdr);
+         }
+         readCorrMap(r, mapTimeCorr);
+         ORBstore.readSnapshot(r);
+         GLOstore.readSnapshot(r);
+         if(!r.atEnd()) {
+            InvalidRequest ir("Unexpected data at end of snapshot " + fn);
+            GPSTK_THROW(ir);
+         }
+      }
+      catch(Exception& e) {
+         clear();
+         mapTimeCorr.clear();
+         GPSTK_RETHROW(e);
+      }
+   }
+
    // use to access the data records in the store in bulk
    int Rinex3EphemerisStore::addToList(list<Rinex3NavData>& theList, SatID sysSat)
       const
@@ -270,6 +270,24 @@ namespace gpstk
       int loadFile(const std::string& filename, bool dump=false,
                    std::ostream& s=std::cout);
 
+         /** Write the entire contents of the store, including the
+          * file headers and time system corrections, to a binary
+          * snapshot file.  Restoring it with loadSnapshot() is much
+          * faster than reading the navigation files again.
+          * @param[in] fn the name of the snapshot file.
+          * @throw FileMissingException if the file can't be written. */
+      void saveSnapshot(const std::string& fn) const;
+
+         /** Replace the contents of the store with those of a
+          * snapshot file written by saveSnapshot().
+          * @param[in] fn the name of the snapshot file.
+          * @throw FileMissingException if the file can't be opened.
+          * @throw InvalidRequest if the file is not a valid snapshot
+          *   of a Rinex3EphemerisStore.  The store is unchanged if the file can't
+          *   be opened or fails its checksum, and is left empty if
+          *   its contents can't be restored. */
+      void loadSnapshot(const std::string& fn);
+
          /** use to access the data records in the store in bulk Add
           * all Rinex3NavData in this store to the given list. If sat
           * is defined, (its default is (-1,mixed)), then add only
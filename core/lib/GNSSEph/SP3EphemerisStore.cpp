@@ -54,6 +54,7 @@
 #include "SP3Stream.hpp"
 #include "SP3Header.hpp"
 #include "SP3Data.hpp"
+#include "SP3Cache.hpp"
 
 #include "Rinex3ClockStream.hpp"
 #include "Rinex3ClockHeader.hpp"
@@ -90,28 +91,58 @@ namespace gpstk
       try { crec = clkStore.getValue(sat,ttag); }
       catch(InvalidRequest& e) { GPSTK_RETHROW(e); }
 
-      try {
-         Xvt retXvt;
-         retXvt.health = Xvt::HealthStatus::Unavailable;
-         for(int i=0; i<3; i++) {
-            retXvt.x[i] = prec.Pos[i] * 1000.0;    // km -> m
-            retXvt.v[i] = prec.Vel[i] * 0.1;       // dm/s -> m/s
-         }
-         if(useSP3clock) {                            // SP3
-            retXvt.clkbias = crec.bias * 1.e-6;       // microsec -> sec
-            retXvt.clkdrift = crec.drift * 1.e-6;     // microsec/sec -> sec/sec
-         }
-         else {                                       // RINEX clock
-            retXvt.clkbias = crec.bias;               // sec
-            retXvt.clkdrift = crec.drift;             // sec/sec
+      try { return makeXvt(prec, crec); }
+      catch(InvalidRequest& e) { GPSTK_RETHROW(e); }
+   }
+
+
+   unsigned SP3EphemerisStore::getXvts(const vector<SatID>& sats,
+                                       const vector<CommonTime>& ttags,
+                                       vector<Xvt>& xvts,
+                                       vector<bool>& valid) const
+   {
+      checkXvtsRequest(sats, ttags, xvts, valid);
+
+      vector<PositionRecord> precs;
+      vector<bool> pvalid;
+      posStore.getValues(sats, ttags, precs, pvalid);
+
+      unsigned nvalid(0);
+      for(size_t i=0; i<sats.size(); i++) {
+         if(!pvalid[i]) continue;
+         try {
+            xvts[i] = makeXvt(precs[i], clkStore.getValue(sats[i],ttags[i]));
+            valid[i] = true;
+            nvalid++;
          }
+         catch(InvalidRequest&) { }
+      }
+      return nvalid;
+   }
 
-            // compute relativity correction, in seconds
-         retXvt.computeRelativityCorrection();
-         retXvt.health = Xvt::HealthStatus::Unused;
-         return retXvt;
+
+   Xvt SP3EphemerisStore::makeXvt(const PositionRecord& prec,
+                                  const ClockRecord& crec) const
+   {
+      Xvt retXvt;
+      retXvt.health = Xvt::HealthStatus::Unavailable;
+      for(int i=0; i<3; i++) {
+         retXvt.x[i] = prec.Pos[i] * 1000.0;    // km -> m
+         retXvt.v[i] = prec.Vel[i] * 0.1;       // dm/s -> m/s
       }
-      catch(InvalidRequest& e) { GPSTK_RETHROW(e); }
+      if(useSP3clock) {                            // SP3
+         retXvt.clkbias = crec.bias * 1.e-6;       // microsec -> sec
+         retXvt.clkdrift = crec.drift * 1.e-6;     // microsec/sec -> sec/sec
+      }
+      else {                                       // RINEX clock
+         retXvt.clkbias = crec.bias;               // sec
+         retXvt.clkdrift = crec.drift;             // sec/sec
+      }
+
+         // compute relativity correction, in seconds
+      retXvt.computeRelativityCorrection();
+      retXvt.health = Xvt::HealthStatus::Unused;
+      return retXvt;
    }
 
 
@@ -374,12 +405,24 @@ namespace gpstk
             crec.accel = crec.sig_accel = 0.0;
          }
 
+            // data records come either from the cache or from the file
+         SP3Cache cache;
+         std::string cacheName;
+         bool fromCache = false;
+         size_t cacheIndex = 0;
+         vector<SP3Cache::Record> cacheRecs;
+         if(useCacheFlag)
+         {
+            cacheName = SP3Cache::cacheFileName(filename, cacheDir);
+            fromCache = cache.open(cacheName, filename);
+         }
+
          try
          {
             haveP = haveV = haveEP = haveEV = predP = predC = false;
             goNext = true;
 
-            while(strm >> data)
+            while(fromCache ? cacheIndex < cache.size() : bool(strm >> data))
             {
                   //cout << "Read data " << data.RecType
                   //<< " at " << printTime(data.time,"%Y %m %d %H %M %S") << endl;
@@ -389,8 +432,20 @@ namespace gpstk
                   // repeated, the current records are output, then the loop
                   // returns to start filling the records again.
                   //strm.dumpState();
-               if (strm.eof())
-                  break;
+               if(fromCache)
+               {
+                  SP3Cache::toData(cache.records()[cacheIndex++], data);
+               }
+               else
+               {
+                  if (strm.eof())
+                     break;
+                  if(useCacheFlag)
+                  {
+                     cacheRecs.push_back(SP3Cache::Record());
+                     SP3Cache::fromData(data, cacheRecs.back());
+                  }
+               }
                
                while(1)
                {
@@ -591,6 +646,18 @@ namespace gpstk
             // close
          strm.close();
 
+         if(useCacheFlag && !fromCache)
+         {
+            try
+            {
+               SP3Cache::write(cacheName, filename, cacheRecs);
+            }
+            catch(Exception& e)
+            {
+                  // the data were loaded, so just do without the cache
+            }
+         }
+
       }
       catch (Exception& e)
       {
@@ -123,6 +123,14 @@ namespace gpstk
           * from RINEX clock files. */
       bool rejectPredClockFlag;
 
+         /** Flag to read and write binary caches of SP3 files (see
+          * enableCache()), default false. */
+      bool useCacheFlag;
+
+         /** Directory for SP3 cache files, or empty to keep each
+          * cache alongside its SP3 file. */
+      std::string cacheDir;
+
          // member functions
 
          /** Private utility routine used by the loadFile and
@@ -135,6 +143,11 @@ namespace gpstk
          */
       void loadSP3Store(const std::string& filename, bool fillClockStore);
 
+         /** Private utility routine used by getXvt() and getXvts().
+          * Combine position and clock records into an Xvt, with
+          * units converted to meters and seconds. */
+      Xvt makeXvt(const PositionRecord& prec, const ClockRecord& crec) const;
+
    public:
 
          /// Default constructor
@@ -143,7 +156,8 @@ namespace gpstk
          rejectBadPosFlag(true),
          rejectBadClockFlag(true),
          rejectPredPosFlag(false),
-         rejectPredClockFlag(false)
+         rejectPredClockFlag(false),
+         useCacheFlag(false)
       { }
 
          /// Destructor
@@ -162,6 +176,22 @@ namespace gpstk
           *    information as to why the request failed. */
       virtual Xvt getXvt(const SatID& sat, const CommonTime& ttag) const;
 
+         /** Compute the Xvt for each of a list of (satellite, time)
+          * requests, with the same results as getXvt().  Requests
+          * for a satellite in the same interval of the position table
+          * share the data pulled from the table for interpolation
+          * (see PositionSatStore::getValues()).
+          * @param[in] sats the satellites of interest
+          * @param[in] ttags the time to look up for each satellite
+          * @param[out] xvts the Xvt for each request
+          * @param[out] valid true where the Xvt could be computed
+          * @return the number of requests that succeeded
+          * @throw InvalidParameter if sats and ttags differ in size */
+      virtual unsigned getXvts(const std::vector<SatID>& sats,
+                               const std::vector<CommonTime>& ttags,
+                               std::vector<Xvt>& xvts,
+                               std::vector<bool>& valid) const;
+
          /** Compute the position, velocity and clock offset of the
           * indicated object in ECEF coordinates (meters) at the
           * indicated time.
@@ -491,6 +521,20 @@ namespace gpstk
       void setClockLinearInterp(void) throw()
       { clkStore.setLinearInterp(); }
 
+         /** Freeze the position and clock tables for faster lookups,
+          * typically once all the files are loaded; results are
+          * unchanged.  cf. TabularSatStore::freeze() */
+      void freeze(void)
+      { posStore.freeze(); clkStore.freeze(); }
+
+         /// Undo freeze().
+      void thaw(void) throw()
+      { posStore.thaw(); clkStore.thaw(); }
+
+         /// Is the store frozen?  cf. freeze()
+      bool isFrozen(void) const throw()
+      { return posStore.isFrozen(); }
+
 
          /** Get a list (std::vector) of SatIDs present in both clock
           * and position stores */
@@ -727,6 +771,24 @@ namespace gpstk
       void rejectPredClocks(const bool flag)
       { rejectPredClockFlag = flag; }
 
+         /** Keep a binary cache (SP3Cache) of the data records of
+          * each SP3 file loaded.  When a cache that is up to date
+          * with its SP3 file exists, the data are loaded from the
+          * cache instead of being parsed from the file; otherwise
+          * the file is parsed and the cache (re)written.  The SP3
+          * header is always read from the SP3 file.  Failure to
+          * write a cache is not an error.
+          * @param[in] dir the directory in which to keep cache
+          *   files, or empty to keep each one alongside its SP3
+          *   file.  SP3 files loaded from different directories
+          *   should not have the same name if dir is given. */
+      void enableCache(const std::string& dir = std::string())
+      { useCacheFlag = true; cacheDir = dir; }
+
+         /// Stop using SP3 cache files.
+      void disableCache()
+      { useCacheFlag = false; }
+
 
          /// Is gap checking for position on?
       bool isPosDataGapCheck(void) throw()
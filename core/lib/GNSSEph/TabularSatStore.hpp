@@ -45,6 +45,10 @@
 #define GPSTK_TABULAR_SAT_STORE_INCLUDE
 
 #include <map>
+#include <algorithm>
+#include <vector>
+#include <memory>
+#include <mutex>
 #include <iostream>
 #include <cmath>
 
@@ -54,6 +58,7 @@
 #include "TimeString.hpp"
 #include "Xvt.hpp"
 #include "CivilTime.hpp"
+#include "TimeKey.hpp"
 //#include "logstream.hpp"      // TEMP
 
 namespace gpstk
@@ -130,6 +135,285 @@ namespace gpstk
 
       typedef typename DataTable::const_iterator DataTableIterator;
 
+         /** Flat copy of the time index of one satellite's DataTable,
+          * used for lookups when the store is frozen: the sorted
+          * times in a contiguous array, with their TimeKeys for
+          * searching, parallel to iterators to the records. */
+      struct FlatTable
+      {
+         std::vector<CommonTime> times;
+         std::vector<TimeKey> keys;
+         std::vector<DataTableIterator> iters;
+            /// time step (seconds) if the times are uniformly spaced, else 0
+         double step;
+      };
+
+         /** FlatTables of all the satellites.  freeze() builds them
+          * all, and they are then only read, so lookups need no lock.
+          * A table that has had records added since (detected by a
+          * change in size), or that is missing, as in a copy, is
+          * rebuilt lazily in a second cache, under a mutex, so that
+          * const lookups can still be made from several threads.
+          * Copies are always empty, since the iterators belong to the
+          * original tables. */
+      class FlatIndex
+      {
+      public:
+         FlatIndex() {}
+         FlatIndex(const FlatIndex&) {}
+         FlatIndex& operator=(const FlatIndex&)
+         { clear(); return *this; }
+
+            /// Remove all the FlatTables.
+         void clear()
+         {
+            index.clear();
+            std::lock_guard<std::mutex> lock(mtx);
+            lazyIndex.clear();
+         }
+
+            /** Build the FlatTables of all the satellites.  Must not
+             * be called while lookups are being made.
+             * @param[in] tables the DataTables of all the satellites */
+         void buildAll(const std::map<SatID, DataTable>& tables)
+         {
+            clear();
+            typename std::map<SatID, DataTable>::const_iterator it;
+            for(it = tables.begin(); it != tables.end(); ++it)
+               index[it->first] = build(it->second);
+         }
+
+            /** Get the FlatTable for a satellite, building it if it
+             * does not exist or is out of date.
+             * @param[in] sat satellite of interest
+             * @param[in] dtable the DataTable for sat
+             * @param[out] hold keeps a lazily built FlatTable alive
+             *   while it is used
+             * @return the FlatTable, valid while the index is not
+             *   changed, or while hold is kept */
+         const FlatTable* get(const SatID& sat, const DataTable& dtable,
+                              std::shared_ptr<const FlatTable>& hold)
+         {
+            typename std::map<SatID, std::shared_ptr<const FlatTable> >
+               ::const_iterator it(index.find(sat));
+            if(it != index.end() && it->second->times.size() == dtable.size())
+               return it->second.get();
+
+            std::lock_guard<std::mutex> lock(mtx);
+            std::shared_ptr<const FlatTable>& ft(lazyIndex[sat]);
+            if(!ft || ft->times.size() != dtable.size())
+               ft = build(dtable);
+            hold = ft;
+            return hold.get();
+         }
+
+      private:
+            /// Build a FlatTable from a DataTable.
+         static std::shared_ptr<const FlatTable> build(const DataTable& dtable)
+         {
+            std::shared_ptr<FlatTable> ft(new FlatTable);
+            ft->times.reserve(dtable.size());
+            ft->keys.reserve(dtable.size());
+            ft->iters.reserve(dtable.size());
+            for(DataTableIterator it = dtable.begin(); it != dtable.end(); ++it)
+            {
+               ft->times.push_back(it->first);
+               ft->keys.push_back(TimeKey(it->first));
+               ft->iters.push_back(it);
+            }
+            ft->step = 0.0;
+            if(ft->times.size() > 1)
+            {
+               double step(ft->times[1] - ft->times[0]);
+               for(size_t i = 2; step > 0.0 && i < ft->times.size(); i++)
+               {
+                  if(::fabs((ft->times[i] - ft->times[i-1]) - step) > 1.e-6)
+                     step = 0.0;
+               }
+               ft->step = step;
+            }
+            return ft;
+         }
+
+            /// built by buildAll(), read without locking
+         std::map<SatID, std::shared_ptr<const FlatTable> > index;
+            /// built by get(), under mtx
+         std::map<SatID, std::shared_ptr<const FlatTable> > lazyIndex;
+         std::mutex mtx;
+      };
+
+         /// If true, lookups use the flat index (cf. freeze()).
+      bool frozen;
+
+         /// Flat time index of the tables, used when frozen.
+      mutable FlatIndex flatIndex;
+
+         /** Position (in the sense of std::lower_bound) of ttag in
+          * the times of a FlatTable.  Computed directly for uniformly
+          * spaced times, else by binary search of the TimeKeys. */
+      static size_t flatLowerBound(const FlatTable& ft, const CommonTime& ttag)
+      {
+         const std::vector<CommonTime>& times(ft.times);
+         size_t n(times.size());
+            // (compare first, so that mismatched time systems throw
+            // just as they do in the std::map)
+         if(!(times[0] < ttag))
+            return 0;
+
+            // guess, then correct for rounding of the step or the key
+         size_t lb;
+         if(ft.step > 0.0)
+         {
+            double d((ttag - times[0]) / ft.step);
+            lb = (d >= double(n) ? n : size_t(d));
+         }
+         else
+         {
+            lb = std::lower_bound(ft.keys.begin(), ft.keys.end(),
+                                  TimeKey(ttag)) - ft.keys.begin();
+         }
+         while(lb > 0 && !(times[lb-1] < ttag))
+            lb--;
+         while(lb < n && times[lb] < ttag)
+            lb++;
+         return lb;
+      }
+
+         /// time tag of a table entry, as an iterator of either kind
+      static const CommonTime& timeOf(DataTableIterator it)
+      { return it->first; }
+      static const CommonTime& timeOf(
+         typename std::vector<CommonTime>::const_iterator it)
+      { return *it; }
+
+         /** The part of getTableInterval() after the lookup of ttag,
+          * for either a DataTable or a FlatTable, given the first
+          * element not less than ttag.
+          * @param[in] begin,end the range of the table
+          * @param[in] lb the first element with time >= ttag
+          * @param[in] exactMatch true if lb matches ttag exactly
+          * @param[out] it1,it2 the interval */
+      template <class Iter>
+      void expandTableInterval(const SatID& sat,
+                               const CommonTime& ttag,
+                               const int& nhalf,
+                               const Iter& begin,
+                               const Iter& end,
+                               const Iter& lb,
+                               bool exactMatch,
+                               Iter& it1,
+                               Iter& it2)
+         const
+      {
+         static const char *fmt=
+            " at time %F/%.3g %4Y/%02m/%02d %2H:%02M:%.3f %P";
+
+         it1 = it2 = lb;
+         if (it1 == end)
+         {
+            InvalidRequest e("No data in time range for satellite " +
+                             gpstk::StringUtils::asString(sat) +
+                             printTime(ttag,fmt));
+            GPSTK_THROW(e);
+         }
+
+            // ttag is <= first time in table
+         if(it1 == begin)
+         {
+               // at table begin but its an exact match && an
+               // interval of only 2
+            if(exactMatch && nhalf==1)
+            {
+               ++(it2 = it1);
+               return;
+            }
+            InvalidRequest e("Inadequate data before(1) requested time for"
+                             " satellite " +
+                             gpstk::StringUtils::asString(sat) +
+                             printTime(ttag,fmt));
+            GPSTK_THROW(e);
+         }
+
+            // move it1 down by one
+         if(--it1 == begin)
+         {
+               // if an interval of only 2
+            if(nhalf==1)
+            {
+               ++(it2 = it1);
+               return;
+            }
+            InvalidRequest e("Inadequate data before(2) requested time for"
+                             " satellite " +
+                             gpstk::StringUtils::asString(sat) +
+                             printTime(ttag,fmt));
+            GPSTK_THROW(e);
+         }
+
+            //LOG(INFO) << "OK, have interval " << printTime(timeOf(it1),"%F/%g") <<
+            //" <= " <<printTime(ttag,"%F/%g")<< " < " <<printTime(timeOf(it2),"%F/%g");
+
+            // now have timeOf(it1) <= ttag < timeOf(it2) and it2 ==
+            // it1+1 check for gap between these two table entries
+            // surrounding ttag
+         if(checkDataGap && (timeOf(it2)-timeOf(it1)) > gapInterval)
+         {
+            InvalidRequest e("Gap at interpolation time for satellite " +
+                             gpstk::StringUtils::asString(sat) +
+                             printTime(ttag,fmt));
+            GPSTK_THROW(e);
+         }
+
+            // now expand the interval to include 2*nhalf timesteps
+         for(int k=0; k<nhalf-1; k++)
+         {
+            bool last(k==nhalf-2); // true only on the last iteration
+               // move left by one; if require full interval && out
+               // of room on left, fail
+            if(--it1 == begin && !last)
+            {
+               InvalidRequest
+                  e("Inadequate data before(3) requested time for"
+                    " satellite " + gpstk::StringUtils::asString(sat) +
+                    printTime(ttag,fmt));
+               GPSTK_THROW(e);
+            }
+               //LOG(INFO) << k << " expand left " << printTime(timeOf(it1),"%F/%g");
+
+            if(++it2 == end)
+            {
+               if(exactMatch && last && it1 != begin)
+               {
+                     // exact match && at end of interval && with
+                     // room to move down
+
+                     // move interval down by one
+                  it2--;
+                  it1--;
+               }
+               else
+               {
+                  InvalidRequest
+                     e("Inadequate data after(2) requested time for"
+                       " satellite " + gpstk::StringUtils::asString(sat) +
+                       printTime(ttag,fmt));
+                  GPSTK_THROW(e);
+               }
+            }
+               //LOG(INFO) << k << " expand right " << printTime(timeOf(it2),"%F/%g");
+         }
+
+            // check that the interval is not too large
+         if(checkInterval && (timeOf(it2) - timeOf(it1)) > maxInterval)
+         {
+            InvalidRequest e("Interpolation interval too large for"
+                             " satellite " +
+                             gpstk::StringUtils::asString(sat) +
+                             printTime(ttag,fmt));
+            GPSTK_THROW(e);
+         }
+      }
+
          // member functions
    public:
          /// Default constructor
@@ -137,7 +421,8 @@ namespace gpstk
       : storeTimeSystem(TimeSystem::Any),
          havePosition(false), haveVelocity(false),
          haveClockBias(false), haveClockDrift(false),
-         checkDataGap(false), checkInterval(false)
+         checkDataGap(false), checkInterval(false),
+         frozen(false)
       {}
          /// Destructor
       virtual ~TabularSatStore() {}
@@ -245,6 +530,28 @@ namespace gpstk
                GPSTK_THROW(e);
             }
 
+               // find the timetag in the flat index of this table
+            if(frozen)
+            {
+               std::shared_ptr<const FlatTable> hold;
+               const FlatTable *ft(flatIndex.get(sat,dtable,hold));
+               size_t lb(flatLowerBound(*ft, ttag));
+               bool exactMatch(lb < ft->times.size() &&
+                               !(ttag < ft->times[lb]));
+               if(exactMatch && exactReturn)
+               {
+                  it1 = ft->iters[lb];
+                  return true;
+               }
+               typename std::vector<CommonTime>::const_iterator
+                  fit1, fit2, fbeg(ft->times.begin());
+               expandTableInterval(sat, ttag, nhalf, fbeg, ft->times.end(),
+                                   fbeg+lb, exactMatch, fit1, fit2);
+               it1 = ft->iters[fit1-fbeg];
+               it2 = ft->iters[fit2-fbeg];
+               return exactMatch;
+            }
+
                // find the timetag in this table
 
                /** @note throw here if time systems do not match and
@@ -260,110 +567,10 @@ namespace gpstk
                return true;
 
                // lower_bound points to the first element with key >= ttag
-            it1 = it2 = dtable.lower_bound(ttag);
-            if (it1 == dtable.end())
-            {
-               InvalidRequest e("No data in time range for satellite " +
-                                gpstk::StringUtils::asString(sat) +
-                                printTime(ttag,fmt));
-               GPSTK_THROW(e);
-            }
-
-               // ttag is <= first time in table
-            if(it1 == dtable.begin())
-            {
-                  // at table begin but its an exact match && an
-                  // interval of only 2
-               if(exactMatch && nhalf==1)
-               {
-                  ++(it2 = it1);
-                  return exactMatch;
-               }
-               InvalidRequest e("Inadequate data before(1) requested time for"
-                                " satellite " +
-                                gpstk::StringUtils::asString(sat) +
-                                printTime(ttag,fmt));
-               GPSTK_THROW(e);
-            }
-
-               // move it1 down by one
-            if(--it1 == dtable.begin())
-            {
-                  // if an interval of only 2
-               if(nhalf==1)
-               {
-                  ++(it2 = it1);
-                  return exactMatch;
-               }
-               InvalidRequest e("Inadequate data before(2) requested time for"
-                                " satellite " +
-                                gpstk::StringUtils::asString(sat) +
-                                printTime(ttag,fmt));
-               GPSTK_THROW(e);
-            }
-
-               //LOG(INFO) << "OK, have interval " << printTime(it1->first,"%F/%g") <<
-               //" <= " <<printTime(ttag,"%F/%g")<< " < " <<printTime(it2->first,"%F/%g");
-
-               // now have it1->first <= ttag < it2->first and it2 ==
-               // it1+1 check for gap between these two table entries
-               // surrounding ttag
-            if(checkDataGap && (it2->first-it1->first) > gapInterval)
-            {
-               InvalidRequest e("Gap at interpolation time for satellite " +
-                                gpstk::StringUtils::asString(sat) +
-                                printTime(ttag,fmt));
-               GPSTK_THROW(e);
-            }
-
-               // now expand the interval to include 2*nhalf timesteps
-            for(int k=0; k<nhalf-1; k++)
-            {
-               bool last(k==nhalf-2); // true only on the last iteration
-                  // move left by one; if require full interval && out
-                  // of room on left, fail
-               if(--it1 == dtable.begin() && !last)
-               {
-                  InvalidRequest
-                     e("Inadequate data before(3) requested time for"
-                       " satellite " + gpstk::StringUtils::asString(sat) +
-                       printTime(ttag,fmt));
-                  GPSTK_THROW(e);
-               }
-                  //LOG(INFO) << k << " expand left " << printTime(it1->first,"%F/%g");
-
-               if(++it2 == dtable.end())
-               {
-                  if(exactMatch && last && it1 != dtable.begin())
-                  {
-                        // exact match && at end of interval && with
-                        // room to move down
-
-                        // move interval down by one
-                     it2--;
-                     it1--;
-                  }
-                  else
-                  {
-                     InvalidRequest
-                        e("Inadequate data after(2) requested time for"
-                          " satellite " + gpstk::StringUtils::asString(sat) +
-                          printTime(ttag,fmt));
-                     GPSTK_THROW(e);
-                  }
-               }
-                  //LOG(INFO) << k << " expand right " << printTime(it2->first,"%F/%g");
-            }
-
-               // check that the interval is not too large
-            if(checkInterval && (it2->first - it1->first) > maxInterval)
-            {
-               InvalidRequest e("Interpolation interval too large for"
-                                " satellite " +
-                                gpstk::StringUtils::asString(sat) +
-                                printTime(ttag,fmt));
-               GPSTK_THROW(e);
-            }
+            DataTableIterator lb(dtable.lower_bound(ttag));
+            DataTableIterator beg(dtable.begin()), end(dtable.end());
+            expandTableInterval(sat, ttag, nhalf, beg, end, lb, exactMatch,
+                                it1, it2);
 
             return exactMatch;
          }
@@ -673,6 +880,10 @@ namespace gpstk
             if(jt != dtab.begin() && --jt != dtab.begin())
                dtab.erase(dtab.begin(),jt);
          }
+         if(frozen)
+            flatIndex.buildAll(tables);
+         else
+            flatIndex.clear();
       }
 
          // remaining functions are not virtual
@@ -684,8 +895,36 @@ namespace gpstk
          for(satit=tables.begin(); satit!=tables.end(); ++satit)
             satit->second.clear();
          tables.clear();
+         flatIndex.clear();
       }
 
+         /** Freeze the store for fast lookups.  Interpolation
+          * intervals (getTableInterval()) are then found in a flat,
+          * contiguous copy of each satellite's time tags, by binary
+          * search, or by direct computation when the times are
+          * uniformly spaced, as is usual for SP3 data, rather than by
+          * searching and stepping through the std::map.  The results
+          * are identical.  The flat index of every satellite is built
+          * here, and lookups then read it without locking, so several
+          * threads may use the store at once.  A satellite that has
+          * records added later, and every satellite in a copy of the
+          * store, falls back to an index built on its next lookup and
+          * shared under a lock; call freeze() again after loading
+          * more data to avoid this.
+          * @note Derived classes that remove records from the tables
+          * other than through edit() or clear() must call
+          * flatIndex.clear(), or freeze() again. */
+      void freeze()
+      { frozen = true; flatIndex.buildAll(tables); }
+
+         /// Return to lookups in the std::map tables.
+      void thaw() throw()
+      { frozen = false; flatIndex.clear(); }
+
+         /// Is the store frozen?  cf. freeze()
+      bool isFrozen() const throw()
+      { return frozen; }
+
          /// Return true if the given SatID is present in the store
       virtual bool isPresent(const SatID& sat) const throw()
       { return (tables.find(sat) != tables.end()); }
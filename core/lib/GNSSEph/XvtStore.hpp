@@ -47,6 +47,7 @@
 
 #include <iostream>
 #include <set>
+#include <vector>
 
 #include "Exception.hpp"
 #include "CommonTime.hpp"
@@ -77,6 +78,42 @@ namespace gpstk
          ///    information as to why the request failed.
       virtual Xvt getXvt(const IndexType& id, const CommonTime& t) const = 0;
 
+         /** Compute the Xvt for each of a list of (id, time)
+          * requests.  The result for each request is the same as
+          * calling getXvt(ids[i], times[i]), except that a request
+          * for which getXvt() would throw InvalidRequest is flagged
+          * in valid[] instead.  Derived classes may override this to
+          * share the work of locating the data among the requests,
+          * e.g. when the same object is requested at nearby times.
+          * @param[in] ids the identifiers of the objects
+          * @param[in] times the times to look up, one for each id
+          * @param[out] xvts the Xvt for each request, resized to
+          *   match ids; failed requests have health Unavailable
+          * @param[out] valid true where the Xvt could be computed
+          * @return the number of requests that succeeded
+          * @throw InvalidParameter if ids and times differ in size */
+      virtual unsigned getXvts(const std::vector<IndexType>& ids,
+                               const std::vector<CommonTime>& times,
+                               std::vector<Xvt>& xvts,
+                               std::vector<bool>& valid) const
+      {
+         checkXvtsRequest(ids, times, xvts, valid);
+         unsigned nvalid = 0;
+         for (size_t i = 0; i < ids.size(); i++)
+         {
+            try
+            {
+               xvts[i] = getXvt(ids[i], times[i]);
+               valid[i] = true;
+               nvalid++;
+            }
+            catch (InvalidRequest&)
+            {
+            }
+         }
+         return nvalid;
+      }
+
          /** Compute the position, velocity and clock offset of the
           * indicated object in ECEF coordinates (meters) at the
           * indicated time.
@@ -156,6 +193,27 @@ namespace gpstk
       void setOnlyHealthyFlag(bool flag)
       { onlyHealthy = flag; }
 
+
+   protected:
+         /** Check the sizes of the arguments to getXvts() and
+          * initialize the outputs to "no result".
+          * @throw InvalidParameter if ids and times differ in size */
+      static void checkXvtsRequest(const std::vector<IndexType>& ids,
+                                   const std::vector<CommonTime>& times,
+                                   std::vector<Xvt>& xvts,
+                                   std::vector<bool>& valid)
+      {
+         if (ids.size() != times.size())
+         {
+            InvalidParameter exc("getXvts: ids and times differ in size");
+            GPSTK_THROW(exc);
+         }
+         Xvt none;
+         none.health = Xvt::HealthStatus::Unavailable;
+         xvts.assign(ids.size(), none);
+         valid.assign(ids.size(), false);
+      }
+
    }; // end class XvtStore
 
       //@}
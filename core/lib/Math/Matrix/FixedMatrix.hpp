@@ -0,0 +1,465 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/**
+ * @file FixedMatrix.hpp
+ * Vector and Matrix with dimensions fixed at compile time, and solvers
+ * for the normal equations of small least squares problems.
+ */
+
+#ifndef GPSTK_FIXEDMATRIX_HPP
+#define GPSTK_FIXEDMATRIX_HPP
+
+#include <limits>
+#include "Matrix.hpp"
+
+namespace gpstk
+{
+      /// @ingroup MathGroup
+      //@{
+
+      /**
+       * A Vector of N elements held in the object itself, so it never
+       * allocates memory.  It may be used wherever a ConstVectorBase
+       * or RefVectorBase is expected, and copied to and from Vector.
+       * Elements are not initialized by the default constructor.
+       */
+   template <class T, size_t N>
+   class FixedVector : public RefVectorBase<T, FixedVector<T,N> >
+   {
+   public:
+         /// STL value type
+      typedef T value_type;
+         /// STL iterator type
+      typedef T* iterator;
+         /// STL const iterator type
+      typedef const T* const_iterator;
+
+         /// Default constructor; elements are not initialized.
+      FixedVector()
+      {}
+         /// Constructor setting all elements to defaultValue.
+      explicit FixedVector(const T defaultValue)
+      { this->assignFrom(defaultValue); }
+         /** Copy constructor from a ConstVectorBase of size N.
+          * @throw VectorException if the sizes differ. */
+      template <class E>
+      FixedVector(const ConstVectorBase<T, E>& r)
+      { *this = r; }
+
+         /** Assign from a ConstVectorBase of size N.
+          * @throw VectorException if the sizes differ. */
+      template <class E>
+      FixedVector& operator=(const ConstVectorBase<T, E>& r)
+      {
+         if(r.size() != N)
+         {
+            VectorException e("FixedVector assigned from Vector of wrong size");
+            GPSTK_THROW(e);
+         }
+         return this->assignFrom(r);
+      }
+         /// Set all elements to x.
+      FixedVector& operator=(const T x)
+      { return this->assignFrom(x); }
+
+         /// STL begin
+      iterator begin() { return v; }
+         /// STL const begin
+      const_iterator begin() const { return v; }
+         /// STL end
+      iterator end() { return v + N; }
+         /// STL const end
+      const_iterator end() const { return v + N; }
+
+         /// Non-const operator []
+      T& operator[] (size_t i)
+      { return v[i]; }
+         /// Const operator []
+      T operator[] (size_t i) const
+      { return v[i]; }
+         /// Non-const operator ()
+      T& operator() (size_t i)
+      { return v[i]; }
+         /// Const operator ()
+      T operator() (size_t i) const
+      { return v[i]; }
+
+         /// STL size
+      size_t size() const { return N; }
+
+   private:
+      T v[N];
+   };
+
+      /**
+       * A Matrix of R rows and C columns held in the object itself, in
+       * row-major order, so it never allocates memory.  It may be used
+       * wherever a ConstMatrixBase or RefMatrixBase is expected, and
+       * copied to and from Matrix.  Elements are not initialized by the
+       * default constructor.
+       */
+   template <class T, size_t R, size_t C>
+   class FixedMatrix : public RefMatrixBase<T, FixedMatrix<T,R,C> >
+   {
+   public:
+         /// Default constructor; elements are not initialized.
+      FixedMatrix()
+      {}
+         /// Constructor setting all elements to defaultValue.
+      explicit FixedMatrix(const T defaultValue)
+      { this->assignFrom(defaultValue); }
+         /** Copy constructor from a ConstMatrixBase of dimension R by C.
+          * @throw MatrixException if the dimensions differ. */
+      template <class BaseClass>
+      FixedMatrix(const ConstMatrixBase<T, BaseClass>& mat)
+      { *this = mat; }
+
+         /** Assign from a ConstMatrixBase of dimension R by C.
+          * @throw MatrixException if the dimensions differ. */
+      template <class BaseClass>
+      FixedMatrix& operator=(const ConstMatrixBase<T, BaseClass>& mat)
+      {
+         if(mat.rows() != R || mat.cols() != C)
+         {
+            MatrixException e("FixedMatrix assigned from Matrix of wrong size");
+            GPSTK_THROW(e);
+         }
+         for(size_t i=0; i<R; i++)
+            for(size_t j=0; j<C; j++)
+               v[i*C+j] = mat(i,j);
+         return *this;
+      }
+         /// Set all elements to x.
+      FixedMatrix& operator=(const T x)
+      { return this->assignFrom(x); }
+
+         /// The number of elements in the matrix.
+      size_t size() const { return R*C; }
+         /// The number of columns in the matrix.
+      size_t cols() const { return C; }
+         /// The number of rows in the matrix.
+      size_t rows() const { return R; }
+         /// Non-const matrix operator(row,col)
+      T& operator() (size_t rowNum, size_t colNum)
+      { return v[rowNum*C + colNum]; }
+         /// Const matrix operator(row,col)
+      T operator() (size_t rowNum, size_t colNum) const
+      { return v[rowNum*C + colNum]; }
+
+   private:
+      T v[R*C];
+   };
+
+      /// Product of fixed matrices.
+   template <class T, size_t R, size_t K, size_t C>
+   inline FixedMatrix<T,R,C> operator*(const FixedMatrix<T,R,K>& l,
+                                       const FixedMatrix<T,K,C>& r)
+   {
+      FixedMatrix<T,R,C> toReturn(T(0));
+      for(size_t i=0; i<R; i++)
+         for(size_t k=0; k<K; k++)
+            for(size_t j=0; j<C; j++)
+               toReturn(i,j) += l(i,k) * r(k,j);
+      return toReturn;
+   }
+
+      /// Product of a fixed matrix and a fixed vector.
+   template <class T, size_t R, size_t C>
+   inline FixedVector<T,R> operator*(const FixedMatrix<T,R,C>& m,
+                                     const FixedVector<T,C>& v)
+   {
+      FixedVector<T,R> toReturn(T(0));
+      for(size_t i=0; i<R; i++)
+         for(size_t j=0; j<C; j++)
+            toReturn(i) += m(i,j) * v(j);
+      return toReturn;
+   }
+
+      /// Transpose of a fixed matrix.
+   template <class T, size_t R, size_t C>
+   inline FixedMatrix<T,C,R> transpose(const FixedMatrix<T,R,C>& m)
+   {
+      FixedMatrix<T,C,R> toReturn;
+      for(size_t i=0; i<R; i++)
+         for(size_t j=0; j<C; j++)
+            toReturn(j,i) = m(i,j);
+      return toReturn;
+   }
+
+      /**
+       * Cholesky decomposition M = L*transpose(L) of a symmetric,
+       * positive definite N by N matrix, such as the information
+       * matrix of a least squares problem with N unknowns.  Unlike
+       * class Cholesky, only L is computed and nothing is allocated.
+       * Only the lower triangle of M is used.
+       *
+       * @code
+       * FixedMatrix<double,4,4> Info;  // = transpose(P)*P
+       * FixedVector<double,4> b;       // = transpose(P)*data
+       * FixedCholesky<double,4> Ch;
+       * Ch(Info);
+       * Ch.backSub(b);                 // b is now the solution
+       * FixedMatrix<double,4,4> Cov(Ch.inverse());
+       * @endcode
+       */
+   template <class T, size_t N>
+   class FixedCholesky
+   {
+   public:
+      FixedCholesky() {}
+
+         /** Compute L.
+          * @throw SingularMatrixException if m is not positive definite
+          */
+      void operator() (const FixedMatrix<T,N,N>& m)
+      {
+         if(!factor(m)) {
+            SingularMatrixException e("FixedCholesky fails - eigenvalue <= 0");
+            GPSTK_THROW(e);
+         }
+      }
+
+         /** Compute L, without throwing.
+          * @return false if m is not positive definite; L is then
+          *   not valid. */
+      bool factor(const FixedMatrix<T,N,N>& m)
+      {
+         size_t i,j,k;
+         T d;
+         for(j=0; j<N; j++) {
+            d = m(j,j);
+            for(k=0; k<j; k++) d -= L(j,k)*L(j,k);
+            if(!(d > T(0))) return false;       // also catches NaN
+            L(j,j) = SQRT(d);
+            d = T(1)/L(j,j);
+            for(i=j+1; i<N; i++) {
+               T s(m(i,j));
+               for(k=0; k<j; k++) s -= L(i,k)*L(j,k);
+               L(i,j) = s*d;
+               L(j,i) = T(0);
+            }
+         }
+         return true;
+      }
+
+         /** Solve A*x=b where A = L*transpose(L); x is returned as b. */
+      void backSub(FixedVector<T,N>& b) const
+      {
+         size_t i,j;
+         for(i=0; i<N; i++) {
+            for(j=0; j<i; j++) b(i) -= L(i,j)*b(j);
+            b(i) /= L(i,i);
+         }
+         for(i=N; i-- > 0; ) {
+            for(j=i+1; j<N; j++) b(i) -= L(j,i)*b(j);
+            b(i) /= L(i,i);
+         }
+      }
+
+         /// @return the inverse of A = L*transpose(L).
+      FixedMatrix<T,N,N> inverse() const
+      {
+         size_t i,j,k;
+            // Linv = inverse of L, lower triangular
+         FixedMatrix<T,N,N> Linv(T(0)), toReturn;
+         for(j=0; j<N; j++) {
+            Linv(j,j) = T(1)/L(j,j);
+            for(i=j+1; i<N; i++) {
+               T s(0);
+               for(k=j; k<i; k++) s -= L(i,k)*Linv(k,j);
+               Linv(i,j) = s/L(i,i);
+            }
+         }
+            // inverse(A) = transpose(Linv)*Linv
+         for(i=0; i<N; i++) {
+            for(j=0; j<=i; j++) {
+               T s(0);
+               for(k=i; k<N; k++) s += Linv(k,i)*Linv(k,j);
+               toReturn(i,j) = toReturn(j,i) = s;
+            }
+         }
+         return toReturn;
+      }
+
+         /// Lower triangular Cholesky decomposition
+      FixedMatrix<T,N,N> L;
+
+   }; // end class FixedCholesky
+
+      /**
+       * Singular value decomposition M = V*diag(S)*transpose(V) of a
+       * symmetric N by N matrix, computed with cyclic Jacobi rotations
+       * so nothing is allocated.  For a symmetric matrix the singular
+       * values are the magnitudes of the elements of S (the
+       * eigenvalues), which may be negative only through roundoff when
+       * M is positive semi-definite.  Only the lower triangle of M is
+       * used.
+       *
+       * @code
+       * FixedMatrix<double,4,4> Info;  // = transpose(P)*P, maybe singular
+       * FixedSymSVD<double,4> svd;
+       * svd(Info);
+       * FixedMatrix<double,4,4> Cov(svd.inverse());   // like inverseSVD()
+       * @endcode
+       */
+   template <class T, size_t N>
+   class FixedSymSVD
+   {
+   public:
+      FixedSymSVD() {}
+
+         /** Compute S and V.  Sweeps stop when the off-diagonal
+          * elements are negligible, or after 50 sweeps. */
+      void operator() (const FixedMatrix<T,N,N>& m)
+      {
+         size_t i,j,k,sweep;
+         const T eps(std::numeric_limits<T>::epsilon());
+         FixedMatrix<T,N,N> A;
+         for(i=0; i<N; i++) {
+            for(j=0; j<=i; j++) A(i,j) = A(j,i) = m(i,j);
+            for(j=0; j<N; j++) V(i,j) = (i == j ? T(1) : T(0));
+         }
+
+         for(sweep=0; sweep<50; sweep++) {
+            bool rotated(false);
+            for(i=0; i<N; i++) {
+               for(j=i+1; j<N; j++) {
+                  const T aij(A(i,j));
+                     // negligible compared to both diagonal elements
+                  if(ABS(aij) <= eps*SQRT(ABS(A(i,i)*A(j,j)))) {
+                     A(i,j) = A(j,i) = T(0);
+                     continue;
+                  }
+                  rotated = true;
+                     // rotation that zeroes A(i,j); t = tan(angle)
+                  const T theta((A(j,j)-A(i,i))/(T(2)*aij));
+                  T t(T(1)/(ABS(theta) + SQRT(theta*theta + T(1))));
+                  if(theta < T(0)) t = -t;
+                  const T c(T(1)/SQRT(t*t + T(1))), s(t*c);
+                  for(k=0; k<N; k++) {          // A = A*J
+                     const T aki(A(k,i)), akj(A(k,j));
+                     A(k,i) = c*aki - s*akj;
+                     A(k,j) = s*aki + c*akj;
+                  }
+                  for(k=0; k<N; k++) {          // A = JT*A
+                     const T aik(A(i,k)), ajk(A(j,k));
+                     A(i,k) = c*aik - s*ajk;
+                     A(j,k) = s*aik + c*ajk;
+                  }
+                  for(k=0; k<N; k++) {          // V = V*J
+                     const T vki(V(k,i)), vkj(V(k,j));
+                     V(k,i) = c*vki - s*vkj;
+                     V(k,j) = s*vki + c*vkj;
+                  }
+               }
+            }
+            if(!rotated) break;
+         }
+
+         for(i=0; i<N; i++) S(i) = A(i,i);
+      }
+
+         /** @return the inverse of M, editing the singular values
+          * smaller than tol times the largest, as inverseSVD() does.
+          * @throw MatrixException if M is the zero matrix. */
+      FixedMatrix<T,N,N> inverse(const T tol=T(1.e-8)) const
+      {
+         size_t i,j,k;
+         T big(0);
+         for(k=0; k<N; k++) if(ABS(S(k)) > big) big = ABS(S(k));
+         if(big == T(0)) {
+            MatrixException e("Input is the zero matrix");
+            GPSTK_THROW(e);
+         }
+         FixedMatrix<T,N,N> toReturn(T(0));
+         for(k=0; k<N; k++) {
+            if(ABS(S(k)) < tol*big) continue;
+            const T w(T(1)/S(k));
+            for(i=0; i<N; i++)
+               for(j=0; j<=i; j++)
+                  toReturn(i,j) += V(i,k)*w*V(j,k);
+         }
+         for(i=0; i<N; i++)
+            for(j=i+1; j<N; j++)
+               toReturn(i,j) = toReturn(j,i);
+         return toReturn;
+      }
+
+         /// Eigenvalues; the singular values are their magnitudes
+      FixedVector<T,N> S;
+         /// Eigenvectors, in the columns
+      FixedMatrix<T,N,N> V;
+
+   }; // end class FixedSymSVD
+
+      /**
+       * Invert a symmetric, positive semi-definite N by N matrix, such
+       * as the information matrix of a least squares problem, without
+       * allocating.  FixedCholesky is used unless m is not positive
+       * definite, or a Cholesky pivot is smaller than tol times the
+       * largest (so m is nearly singular); FixedSymSVD is used then,
+       * and singular values smaller than tol times the largest are
+       * edited as in inverseSVD().  Only the lower triangle of m is
+       * used.
+       * @throw MatrixException if m is the zero matrix.
+       */
+   template <class T, size_t N>
+   inline FixedMatrix<T,N,N> inverseSymmetric(const FixedMatrix<T,N,N>& m,
+                                              const T tol=T(1.e-8))
+   {
+      FixedCholesky<T,N> Ch;
+      if(Ch.factor(m)) {
+         T small(Ch.L(0,0)), big(Ch.L(0,0));
+         for(size_t i=1; i<N; i++) {
+            if(Ch.L(i,i) < small) small = Ch.L(i,i);
+            if(Ch.L(i,i) > big) big = Ch.L(i,i);
+         }
+         if(small*small >= tol*big*big)             // pivots are L(i,i)^2
+            return Ch.inverse();
+      }
+      FixedSymSVD<T,N> svd;
+      svd(m);
+      return svd.inverse(tol);
+   }
+
+      //@}
+
+}  // namespace
+
+#endif
@@ -36,6 +36,8 @@
 //
 //==============================================================================
 
+#include <memory>
+#include <vector>
 #include "LNavParityFilter.hpp"
 #include "LNavFilterData.hpp"
 #include "EngNav.hpp"
@@ -52,12 +54,21 @@ namespace gpstk
    validate(NavMsgList& msgBitsIn, NavMsgList& msgBitsOut)
    {
       NavMsgList::iterator i;
-         // check parity of each subframe and put the valid ones in
-         // the output
+         // check parity of all the subframes at once
+      std::vector<const uint32_t*> sfs;
+      sfs.reserve(msgBitsIn.size());
       for (i = msgBitsIn.begin(); i != msgBitsIn.end(); i++)
       {
          LNavFilterData *fd = dynamic_cast<LNavFilterData*>(*i);
-         if (EngNav::checkParity(fd->sf))
+         sfs.push_back(fd->sf);
+      }
+      std::unique_ptr<bool[]> ok(new bool[sfs.size()]);
+      EngNav::checkParity(sfs.data(), sfs.size(), ok.get());
+         // put the valid ones in the output
+      size_t idx = 0;
+      for (i = msgBitsIn.begin(); i != msgBitsIn.end(); i++, idx++)
+      {
+         if (ok[idx])
             accept(*i, msgBitsOut);
          else
             reject(*i);
@@ -56,21 +56,38 @@ namespace gpstk
    NavFilter::NavMsgList NavFilterMgr ::
    validate(NavFilterKey* msgBits)
    {
-      NavFilter::NavMsgList rv, newrv;
+      NavFilter::NavMsgList rv;
       rv.push_back(msgBits);
+      cascade(rv);
+      return rv;
+   }
+
+
+   NavFilter::NavMsgList NavFilterMgr ::
+   validate(const NavFilter::NavMsgList& msgs)
+   {
+      NavFilter::NavMsgList rv(msgs);
+      cascade(rv);
+      return rv;
+   }
+
+
+   void NavFilterMgr ::
+   cascade(NavFilter::NavMsgList& msgs)
+   {
+      NavFilter::NavMsgList newrv;
       rejected.clear();
       for (FilterList::iterator i = filters.begin(); i != filters.end(); i++)
       {
-         if (rv.empty())
+         if (msgs.empty())
             break;
          (*i)->rejected.clear();
          newrv.clear();
-         (*i)->validate(rv, newrv);
+         (*i)->validate(msgs, newrv);
          if (!(*i)->rejected.empty())
             rejected.insert(*i);
-         rv = newrv;
+         msgs.swap(newrv);
       }
-      return rv;
    }
 
 
@@ -97,22 +114,18 @@ namespace gpstk
             fliNxt = fliCur;
             fliNxt++;
                // cascade the data through the end.
-            rv1 = rv2;
+            rv1.swap(rv2);
             while ((fliNxt != filters.end()) && !rv1.empty())
             {
                (*fliNxt)->rejected.clear();
                rv2.clear();
                (*fliNxt)->validate(rv1, rv2);
-               rv1 = rv2;
+               rv1.swap(rv2);
                fliNxt++;
             }
                // If the filter cascade got some data that passed all
                // filters, add it to the final return value.
-            if (!rv1.empty())
-            {
-               std::copy(rv1.begin(), rv1.end(),
-                         std::back_insert_iterator<NavFilter::NavMsgList>(rv));
-            }
+            rv.splice(rv.end(), rv1);
          }
       }
       return rv;
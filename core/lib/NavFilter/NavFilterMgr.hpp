@@ -64,6 +64,8 @@ namespace gpstk
        * instantiated and added to the manager using
        * NavFilterMgr::addFilter().  Data is processed and returned
        * using NavFilterMgr::validate().
+       * ShardedNavFilterMgr does the same on several threads, for
+       * large numbers of receivers and signals.
        *
        * Data is added to the NavFilterMgr using child classes of
        * NavFilterKey.  These child classes will have data members
@@ -100,6 +102,12 @@ namespace gpstk
        *      created dynamically on the heap and freed as the data is
        *      either rejected or accepted.  This approach is most
        *      useful when using filters of depth 2 and larger.
+       *   3. Allocating the NavFilterKey child class objects from a
+       *      NavMsgArena, which keeps the storage of messages for
+       *      reuse as they are returned to it, individually or in
+       *      bulk after finalize().  This avoids a heap allocation
+       *      per message, and is most useful when filtering large
+       *      volumes of data, e.g. from many receivers.
        *
        * @see NavFilterMgr for a list of examples.
        *
@@ -201,6 +209,16 @@ namespace gpstk
           *   configured filters. */
       NavFilter::NavMsgList validate(NavFilterKey* msgBits);
 
+         /** Validate a group of navigation messages, e.g. all the
+          * messages for one epoch.  This is equivalent to calling
+          * validate() for each message in turn, except that the
+          * NavFilter::rejected lists and the rejected set hold the
+          * rejections for the whole group.
+          * @param[in] msgs The navigation messages to validate/filter.
+          * @return Any messages that have successfully passed all
+          *   configured filters. */
+      NavFilter::NavMsgList validate(const NavFilter::NavMsgList& msgs);
+
          /** Flush the stored data for all known filters.  This method
           * should be called by the user after all data has been added
           * to the filter manager via validate().
@@ -233,6 +251,11 @@ namespace gpstk
       FilterSet rejected;
 
    private:
+         /** Pass messages through all the filters, updating rejected.
+          * @param[in,out] msgs The messages to filter on input, and
+          *   those passing all the filters on output. */
+      void cascade(NavFilter::NavMsgList& msgs);
+
          /// The collection of navigation message filters to apply.
       FilterList filters;
    };
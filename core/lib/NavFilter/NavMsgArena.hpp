@@ -0,0 +1,210 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+#ifndef NAVMSGARENA_HPP
+#define NAVMSGARENA_HPP
+
+#include <vector>
+#include <memory>
+#include <type_traits>
+#include "NavFilterKey.hpp"
+
+namespace gpstk
+{
+      /// @ingroup NavFilter
+      //@{
+
+      /** Pooled storage for the navigation messages given to
+       * NavFilterMgr, as an alternative to allocating each message
+       * on the heap (see @ref NavFilterStore).  Messages are
+       * allocated from blocks of storage that are kept for reuse, so
+       * once the arena has grown to the size of the data in flight,
+       * no further memory is allocated or freed.
+       *
+       * Messages that have left the filters, i.e. those returned by
+       * NavFilterMgr::validate() or NavFilterMgr::finalize() and
+       * those in the NavFilter::rejected lists, may be returned to
+       * the arena individually using deallocate() once the
+       * application is done with them.  Alternatively, all the
+       * messages may be released in bulk using release(), e.g. after
+       * processing the results of NavFilterMgr::finalize().
+       *
+       * \code{.cpp}
+       * struct MyNavData : public gpstk::LNavFilterData
+       * {
+       *    MyNavData() { sf = words; }
+       *    uint32_t words[10];
+       * };
+       * gpstk::NavFilterMgr mgr;
+       * mgr.addFilter(...);
+       * gpstk::NavMsgArena<MyNavData> arena;
+       * while (...)
+       * {
+       *    MyNavData *fd = arena.allocate();
+       *    ...
+       *    gpstk::NavFilter::NavMsgList l = mgr.validate(fd);
+       *    ...
+       *    for (each message in l and in the filters' rejected lists)
+       *       arena.deallocate(message);
+       * }
+       * gpstk::NavFilter::NavMsgList l = mgr.finalize();
+       * ...
+       * arena.release();
+       * \endcode
+       *
+       * @warning Messages must not be used after they have been
+       *   deallocated or released, and must not be deleted by the
+       *   user.  Messages still held by a filter must not be
+       *   deallocated or released.
+       * @param FilterData The type of the messages, a NavFilterKey
+       *   child class. */
+   template <class FilterData>
+   class NavMsgArena
+   {
+   public:
+         /** Initialize an empty arena.
+          * @param[in] block The number of messages allocated at a
+          *   time when the arena needs to grow. */
+      NavMsgArena(size_t block = 256)
+            : blockSize(block < 1 ? 1 : block), numLive(0)
+      {}
+
+         /// Destroy all the messages.
+      ~NavMsgArena()
+      { release(); }
+
+         /// Get a new, default-constructed message.
+      FilterData* allocate()
+      {
+         if (freeList.empty())
+            grow();
+         Slot *slot = freeList.back();
+         FilterData *rv = new(&slot->data) FilterData();
+         freeList.pop_back();
+         slot->live = true;
+         numLive++;
+         return rv;
+      }
+
+         /** Return a message to the arena.
+          * @param[in] msg A message obtained from allocate() of this
+          *   arena that has not already been deallocated. */
+      void deallocate(NavFilterKey* msg)
+      {
+         FilterData *fd = static_cast<FilterData*>(msg);
+         Slot *slot = reinterpret_cast<Slot*>(fd);
+         fd->~FilterData();
+         slot->live = false;
+         numLive--;
+         freeList.push_back(slot);
+      }
+
+         /** Return all the messages to the arena at once, keeping
+          * the storage for reuse. */
+      void release()
+      {
+         freeList.clear();
+         freeList.reserve(capacity());
+         for (size_t b = blocks.size(); b > 0; b--)
+         {
+            Slot *block = blocks[b-1].get();
+            for (size_t i = blockSize; i > 0; i--)
+            {
+               Slot& slot(block[i-1]);
+               if (slot.live)
+               {
+                  reinterpret_cast<FilterData*>(&slot.data)->~FilterData();
+                  slot.live = false;
+               }
+               freeList.push_back(&slot);
+            }
+         }
+         numLive = 0;
+      }
+
+         /// Return the number of messages currently allocated.
+      size_t size() const
+      { return numLive; }
+
+         /** Return the number of messages that can be allocated
+          * without growing the arena. */
+      size_t capacity() const
+      { return blocks.size() * blockSize; }
+
+   private:
+         /** Storage for one message, which must be the first member
+          * so that a message pointer is also a Slot pointer. */
+      struct Slot
+      {
+         typename std::aligned_storage<
+            sizeof(FilterData), alignof(FilterData)>::type data;
+         bool live;
+      };
+
+         // Copying would leave two owners of the same messages.
+      NavMsgArena(const NavMsgArena&) = delete;
+      NavMsgArena& operator=(const NavMsgArena&) = delete;
+
+         /// Add a block of blockSize messages to the free list.
+      void grow()
+      {
+         blocks.push_back(std::unique_ptr<Slot[]>(new Slot[blockSize]));
+         Slot *block = blocks.back().get();
+         freeList.reserve(freeList.size() + blockSize);
+            // in reverse so that messages are allocated in address order
+         for (size_t i = blockSize; i > 0; i--)
+         {
+            block[i-1].live = false;
+            freeList.push_back(&block[i-1]);
+         }
+      }
+
+         /// Number of messages per block.
+      size_t blockSize;
+         /// Number of messages currently allocated.
+      size_t numLive;
+         /// The blocks of storage for messages.
+      std::vector<std::unique_ptr<Slot[]> > blocks;
+         /// Storage not in use by any message.
+      std::vector<Slot*> freeList;
+   };
+
+      //@}
+}
+
+#endif // NAVMSGARENA_HPP
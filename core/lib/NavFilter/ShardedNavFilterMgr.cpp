@@ -0,0 +1,285 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+#include <algorithm>
+#include "ShardedNavFilterMgr.hpp"
+#include "ThreadPool.hpp"
+
+namespace gpstk
+{
+   ShardedNavFilterMgr ::
+   ShardedNavFilterMgr(const FilterChainFactory& factoryArg,
+                       const ShardKeyFunc& keyFuncArg)
+         : factory(factoryArg), keyFunc(keyFuncArg), nThreads(1)
+   {
+   }
+
+
+   ShardedNavFilterMgr ::
+   ~ShardedNavFilterMgr()
+   {
+      for (ShardMap::iterator i = shards.begin(); i != shards.end(); i++)
+      {
+         delete i->second;
+      }
+   }
+
+
+   void ShardedNavFilterMgr ::
+   addCrossFilter(NavFilter* filt)
+   {
+      crossMgr.addFilter(filt);
+      crossFilters.push_back(filt);
+   }
+
+
+   void ShardedNavFilterMgr ::
+   setThreads(unsigned nthreads)
+   {
+      nThreads = (nthreads == 0 ? ThreadPool::defaultThreads() : nthreads);
+      if (pool && pool->size() != nThreads)
+         pool.reset();
+   }
+
+
+   NavFilter::NavMsgList ShardedNavFilterMgr ::
+   validate(const NavFilter::NavMsgList& msgs)
+   {
+      rejected.clear();
+         // split the messages into shards, making new shards as needed
+      std::vector<Shard*> active;
+      SeqMap seq;
+      size_t count = 0;
+      NavFilter::NavMsgList::const_iterator nmli;
+      for (nmli = msgs.begin(); nmli != msgs.end(); nmli++)
+      {
+         seq[*nmli] = ++count;
+         uint64_t key = keyFunc(*nmli);
+         ShardMap::iterator smi = shards.find(key);
+         if (smi == shards.end())
+         {
+            Shard *shard = new Shard;
+            smi = shards.insert(ShardMap::value_type(key, shard)).first;
+            shard->filters = factory();
+            for (size_t i = 0; i < shard->filters.size(); i++)
+               shard->mgr.addFilter(shard->filters[i].get());
+         }
+         Shard *shard = smi->second;
+         if (shard->input.empty())
+            active.push_back(shard);
+         shard->input.push_back(*nmli);
+      }
+
+      forShards(active,
+                [](Shard* shard)
+                {
+                   shard->output = shard->mgr.validate(shard->input);
+                   shard->input.clear();
+                });
+
+      NavFilter::NavMsgList merged;
+      merge(active, seq, merged);
+      for (size_t i = 0; i < active.size(); i++)
+         addRejected(active[i]->mgr);
+      NavFilter::NavMsgList rv(crossMgr.validate(merged));
+      addRejected(crossMgr);
+      return rv;
+   }
+
+
+   NavFilter::NavMsgList ShardedNavFilterMgr ::
+   finalize()
+   {
+      rejected.clear();
+      std::vector<Shard*> active;
+      for (ShardMap::iterator i = shards.begin(); i != shards.end(); i++)
+         active.push_back(i->second);
+      forShards(active,
+                [](Shard* shard)
+                {
+                   finalizeFilters(shard->filters, shard->output,
+                                   shard->rejected);
+                });
+
+      NavFilter::NavMsgList merged;
+      merge(active, SeqMap(), merged);
+      for (size_t i = 0; i < active.size(); i++)
+         rejected.splice(rejected.end(), active[i]->rejected);
+         // collect the cross-source rejections now, as finalizing
+         // clears the filters' rejected lists
+      NavFilter::NavMsgList rv(crossMgr.validate(merged));
+      addRejected(crossMgr);
+      finalizeFilters(crossFilters, rv, rejected);
+      return rv;
+   }
+
+
+   unsigned ShardedNavFilterMgr ::
+   processingDepth() const
+   {
+         // all shards have the same filters, so use any one of them
+      unsigned rv = crossMgr.processingDepth();
+      if (!shards.empty())
+         rv += shards.begin()->second->mgr.processingDepth() - 1;
+      return rv;
+   }
+
+
+   uint64_t ShardedNavFilterMgr ::
+   shardBySat(const NavFilterKey* msg)
+   {
+      return msg->prn;
+   }
+
+
+   uint64_t ShardedNavFilterMgr ::
+   shardBySignal(const NavFilterKey* msg)
+   {
+      return (uint64_t(msg->prn) << 32) |
+         (uint64_t(msg->carrier) << 16) | uint64_t(msg->code);
+   }
+
+
+   void ShardedNavFilterMgr ::
+   forShards(const std::vector<Shard*>& active,
+             const std::function<void(Shard*)>& func)
+   {
+      if (nThreads <= 1 || active.size() < 2)
+      {
+         for (size_t i = 0; i < active.size(); i++)
+            func(active[i]);
+         return;
+      }
+      if (!pool)
+         pool.reset(new ThreadPool(nThreads));
+         // one task per thread, each taking every nThreads'th shard
+      unsigned ntasks = std::min<size_t>(nThreads, active.size());
+      std::vector<std::future<void> > results;
+      for (unsigned t = 0; t < ntasks; t++)
+      {
+         results.push_back(pool->submit(
+                              [&active, &func, t, ntasks]()
+                              {
+                                 for (size_t i = t; i < active.size();
+                                      i += ntasks)
+                                 {
+                                    func(active[i]);
+                                 }
+                              }));
+      }
+         // wait for all of them before letting any exception escape
+      for (unsigned t = 0; t < ntasks; t++)
+         results[t].wait();
+      for (unsigned t = 0; t < ntasks; t++)
+         results[t].get();
+   }
+
+
+   void ShardedNavFilterMgr ::
+   merge(const std::vector<Shard*>& active,
+         const SeqMap& seq,
+         NavFilter::NavMsgList& merged)
+   {
+      typedef std::pair<size_t, NavFilterKey*> SeqMsg;
+      std::vector<SeqMsg> all;
+      for (size_t i = 0; i < active.size(); i++)
+      {
+         NavFilter::NavMsgList& out(active[i]->output);
+         for (NavFilter::NavMsgList::iterator nmli = out.begin();
+              nmli != out.end(); nmli++)
+         {
+            SeqMap::const_iterator si = seq.find(*nmli);
+            all.push_back(SeqMsg(si == seq.end() ? 0 : si->second, *nmli));
+         }
+         out.clear();
+      }
+      std::stable_sort(all.begin(), all.end(),
+                       [](const SeqMsg& l, const SeqMsg& r)
+                       {
+                          if (l.second->timeStamp != r.second->timeStamp)
+                             return l.second->timeStamp < r.second->timeStamp;
+                          return l.first < r.first;
+                       });
+      for (size_t i = 0; i < all.size(); i++)
+         merged.push_back(all[i].second);
+   }
+
+
+   void ShardedNavFilterMgr ::
+   addRejected(const NavFilterMgr& mgr)
+   {
+      NavFilterMgr::FilterSet::const_iterator fsi;
+      for (fsi = mgr.rejected.begin(); fsi != mgr.rejected.end(); fsi++)
+      {
+         rejected.insert(rejected.end(), (*fsi)->rejected.begin(),
+                         (*fsi)->rejected.end());
+      }
+   }
+
+
+   template <class FilterPtrs>
+   void ShardedNavFilterMgr ::
+   finalizeFilters(const FilterPtrs& filters,
+                   NavFilter::NavMsgList& accepted,
+                   NavFilter::NavMsgList& rejectedMsgs)
+   {
+      NavFilter::NavMsgList rv1, rv2;
+      for (size_t cur = 0; cur < filters.size(); cur++)
+      {
+         filters[cur]->rejected.clear();
+         rv1.clear();
+         filters[cur]->finalize(rv1);
+         rejectedMsgs.insert(rejectedMsgs.end(),
+                             filters[cur]->rejected.begin(),
+                             filters[cur]->rejected.end());
+            // cascade the flushed data through the remaining filters
+         for (size_t nxt = cur+1; nxt < filters.size() && !rv1.empty();
+              nxt++)
+         {
+            filters[nxt]->rejected.clear();
+            rv2.clear();
+            filters[nxt]->validate(rv1, rv2);
+            rejectedMsgs.insert(rejectedMsgs.end(),
+                                filters[nxt]->rejected.begin(),
+                                filters[nxt]->rejected.end());
+            rv1.swap(rv2);
+         }
+         accepted.splice(accepted.end(), rv1);
+      }
+   }
+}
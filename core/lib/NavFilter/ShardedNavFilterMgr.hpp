@@ -0,0 +1,235 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+#ifndef SHARDEDNAVFILTERMGR_HPP
+#define SHARDEDNAVFILTERMGR_HPP
+
+#include <map>
+#include <unordered_map>
+#include <memory>
+#include <vector>
+#include <functional>
+#include "NavFilterMgr.hpp"
+
+namespace gpstk
+{
+   class ThreadPool;
+
+      /// @ingroup NavFilter
+      //@{
+
+      /** Filter navigation messages on several threads.  Messages
+       * are split into shards by a shard key (by default the PRN,
+       * carrier and code, see shardBySignal()), and each shard is
+       * given its own chain of filters and its own NavFilterMgr.  The
+       * shards of a group of messages are filtered concurrently, then
+       * the messages passing them are merged in time order and
+       * passed through a single chain of cross-source filters (e.g.
+       * LNavCrossSourceFilter), which therefore sees all the
+       * messages for a given time.
+       *
+       * Since each shard needs its own instances of the filters, the
+       * per-shard filters are made by a user-supplied factory the
+       * first time a shard key is seen:
+       *
+       * \code{.cpp}
+       * gpstk::ShardedNavFilterMgr mgr(
+       *    []()
+       *    {
+       *       gpstk::ShardedNavFilterMgr::FilterChain rv;
+       *       rv.push_back(std::make_shared<gpstk::LNavParityFilter>());
+       *       rv.push_back(std::make_shared<gpstk::LNavTLMHOWFilter>());
+       *       return rv;
+       *    });
+       * gpstk::LNavCrossSourceFilter filtVote;
+       * mgr.addCrossFilter(&filtVote);
+       * mgr.setThreads(0);
+       * while (...)
+       * {
+       *       // all the messages for one epoch
+       *    gpstk::NavFilter::NavMsgList epoch = ...;
+       *    gpstk::NavFilter::NavMsgList l = mgr.validate(epoch);
+       * }
+       * gpstk::NavFilter::NavMsgList l = mgr.finalize();
+       * \endcode
+       *
+       * The per-shard filters should have a processing depth of 0
+       * (e.g. parity, cook, TLM/HOW, empty and sanity filters), so
+       * that every message of a group leaves its shard in the same
+       * call; otherwise the cross-source filters may see the
+       * messages for one time in more than one call.  Given groups
+       * in time order, the output is then the same as that of a
+       * NavFilterMgr with the shard filters followed by the
+       * cross-source filters, in the same order.
+       *
+       * The per-shard filters must not share state with each other;
+       * messages are only ever handled by one thread at a time.
+       */
+   class ShardedNavFilterMgr
+   {
+   public:
+         /// The filters for one shard, in order of application.
+      typedef std::vector<std::shared_ptr<NavFilter> > FilterChain;
+         /// Makes a new chain of filters for a shard.
+      typedef std::function<FilterChain()> FilterChainFactory;
+         /// Computes the shard key of a message.
+      typedef std::function<uint64_t(const NavFilterKey*)> ShardKeyFunc;
+
+         /** Initialize with no shards.
+          * @param[in] factory Makes the filters of each new shard.
+          * @param[in] keyFunc Assigns messages to shards. */
+      ShardedNavFilterMgr(const FilterChainFactory& factory,
+                          const ShardKeyFunc& keyFunc = shardBySignal);
+
+      ~ShardedNavFilterMgr();
+
+         /** Add a filter to be applied to the merged output of the
+          * shards, e.g. a cross-source voting filter.
+          * @param[in] filt The filter to be added. */
+      void addCrossFilter(NavFilter* filt);
+
+         /** Set the number of threads used to filter shards.
+          * @param[in] nthreads The number of threads; 0 means one
+          *   per hardware core, and 1 filters all the shards in the
+          *   calling thread. */
+      void setThreads(unsigned nthreads);
+
+         /** Validate a group of navigation messages, typically all
+          * those for one epoch.  Shards are filtered concurrently.
+          * @param[in] msgs The navigation messages to validate/filter.
+          * @return Messages that have passed the shard and
+          *   cross-source filters, in time order. */
+      NavFilter::NavMsgList validate(const NavFilter::NavMsgList& msgs);
+
+         /** Flush the stored data for all shards and cross-source
+          * filters.
+          * @return The remaining messages successfully passing the
+          *   filters. */
+      NavFilter::NavMsgList finalize();
+
+         /** Gets the effective buffer size in epochs required for
+          * maintaining subframe data (cf.
+          * NavFilterMgr::processingDepth()). */
+      unsigned processingDepth() const;
+
+         /// Return the number of shards created so far.
+      size_t numShards() const
+      { return shards.size(); }
+
+         /// Shard key using only the PRN.
+      static uint64_t shardBySat(const NavFilterKey* msg);
+
+         /// Shard key using the PRN, carrier and code.
+      static uint64_t shardBySignal(const NavFilterKey* msg);
+
+         /** The messages rejected by the shard and cross-source
+          * filters in the most recent validate() or finalize() call.
+          * Unlike NavFilterMgr::rejected, this holds the messages
+          * themselves, since finalize() clears the filters' own
+          * rejected lists as it flushes each filter in turn. */
+      NavFilter::NavMsgList rejected;
+
+   private:
+         /// Filters and pending messages of one shard.
+      struct Shard
+      {
+         FilterChain filters;
+         NavFilterMgr mgr;
+            /// messages for the current call to validate()
+         NavFilter::NavMsgList input;
+            /// messages that passed the shard filters
+         NavFilter::NavMsgList output;
+            /// messages rejected by the shard filters in finalize()
+         NavFilter::NavMsgList rejected;
+      };
+      typedef std::map<uint64_t, Shard*> ShardMap;
+         /// Position of each message in the input to validate().
+      typedef std::unordered_map<NavFilterKey*, size_t> SeqMap;
+
+         // Not copyable.
+      ShardedNavFilterMgr(const ShardedNavFilterMgr&);
+      ShardedNavFilterMgr& operator=(const ShardedNavFilterMgr&);
+
+         /** Run func on each of the given shards, concurrently if
+          * more than one thread is in use. */
+      void forShards(const std::vector<Shard*>& active,
+                     const std::function<void(Shard*)>& func);
+
+         /** Merge the shard outputs in time order, with messages in
+          * the order given by seq for equal times, and clear them.
+          * @param[in] active The shards to merge.
+          * @param[in] seq Order of messages within a time; messages
+          *   not in seq come first.
+          * @param[out] merged The merged messages. */
+      static void merge(const std::vector<Shard*>& active,
+                        const SeqMap& seq,
+                        NavFilter::NavMsgList& merged);
+
+         /// Add the messages rejected by the filters of mgr to rejected.
+      void addRejected(const NavFilterMgr& mgr);
+
+         /** Flush each filter in turn and pass its output through the
+          * filters after it, as NavFilterMgr::finalize() does, but
+          * keep the messages rejected along the way.
+          * @param[in] filters The filters, in order of application.
+          * @param[in,out] accepted Messages passing all the filters
+          *   are appended here.
+          * @param[in,out] rejectedMsgs Rejected messages are
+          *   appended here. */
+      template <class FilterPtrs>
+      static void finalizeFilters(const FilterPtrs& filters,
+                                  NavFilter::NavMsgList& accepted,
+                                  NavFilter::NavMsgList& rejectedMsgs);
+
+      FilterChainFactory factory;
+      ShardKeyFunc keyFunc;
+      ShardMap shards;
+         /// Filters applied to the merged output of the shards.
+      NavFilterMgr crossMgr;
+         /// The same filters as crossMgr, for finalizeFilters().
+      std::vector<NavFilter*> crossFilters;
+         /// Number of threads, 1 for none.
+      unsigned nThreads;
+         /// Worker threads, created when first needed.
+      std::shared_ptr<ThreadPool> pool;
+   };
+
+      //@}
+}
+
+#endif // SHARDEDNAVFILTERMGR_HPP
@@ -42,10 +42,15 @@
 
 #include "MathBase.hpp"
 #include "PRSolution.hpp"
+#include "FixedMatrix.hpp"
 #include "GPSEllipsoid.hpp"
+#include "WGS84Ellipsoid.hpp"
+#include "PositionBatch.hpp"
 #include "Combinations.hpp"
 #include "TimeString.hpp"
 #include "logstream.hpp"
+#include "ThreadPool.hpp"
+#include <atomic>
 
 using namespace std;
 using namespace gpstk;
@@ -58,6 +63,53 @@ namespace gpstk
 
    ostream& operator<<(ostream& os, const WtdAveStats& was)
       { was.dump(os,was.getMessage()); return os;}
+
+   // -------------------------------------------------------------------------
+   // Solve the normal equations of the linearized problem, given partials P and
+   // weighted partials PW (= inverse measurement covariance * P), for
+   // Cov = inverse(PT*PW) and dX = Cov*PWT*Resid, where D is the number of
+   // unknowns. Nothing is allocated: the information matrix is formed in fixed
+   // storage and inverted with inverseSymmetric(), which uses Cholesky, or a
+   // fixed size SVD when the matrix is rank deficient (eg. the clock of a system
+   // with no data) so that small singular values are edited as in inverseSVD().
+   // @throw MatrixException
+   template <size_t D>
+   static void normalSolve(const Matrix<double>& P, const Matrix<double>& PW,
+                           const Vector<double>& Resid,
+                           Matrix<double>& Cov, Vector<double>& dX)
+   {
+      size_t i,j,n;
+      FixedMatrix<double,D,D> Info(0.0);
+      FixedVector<double,D> b(0.0);
+      for(n=0; n<P.rows(); n++) {
+         for(i=0; i<D; i++) {
+            const double pw(PW(n,i));
+            if(pw == 0.0) continue;               // eg. clock of another system
+            b(i) += pw*Resid(n);
+            for(j=0; j<=i; j++) Info(i,j) += pw*P(n,j);
+         }
+      }
+
+      FixedMatrix<double,D,D> C(inverseSymmetric(Info));
+      for(i=0; i<D; i++) {
+         double sum(0.0);
+         for(j=0; j<D; j++) {
+            Cov(i,j) = C(i,j);
+            sum += C(i,j)*b(j);
+         }
+         dX(i) = sum;
+      }
+   }
+
+   // the same, for more than 8 unknowns
+   static void normalSolve(const Matrix<double>& P, const Matrix<double>& PW,
+                           const Vector<double>& Resid,
+                           Matrix<double>& Cov, Vector<double>& dX)
+   {
+      Matrix<double> PWT(transpose(PW));
+      Cov = inverseSVD(PWT * P);
+      dX = Cov * (PWT * Resid);
+   }
  
    // -------------------------------------------------------------------------
    // Prepare for the autonomous solution by computing direction cosines,
@@ -202,8 +254,9 @@ namespace gpstk
 
       int iret(0),k,n;
       size_t i, j;
-      double rho,wt,svxyz[3];
+      double rho,wt,svxyz[3],rxyz[3],llh[3];
       GPSEllipsoid ellip;
+      const PositionBatch geodetic((WGS84Ellipsoid()));    // as Position R
 
       Valid = false;
 
@@ -258,11 +311,15 @@ namespace gpstk
          }
 
          // -----------------------------------------------------------
-         // define for computation
+         // define for computation; nothing is allocated in the iteration loop
          Vector<double> CRange(Nsvs),dX(dim);
-         Matrix<double> P(Nsvs,dim,0.0),PT,G(dim,Nsvs),PG(Nsvs,Nsvs),Rotation;
+         Matrix<double> P(Nsvs,dim,0.0),WP;
          Triple dirCos;
-         Xvt SV,RX;
+         Position R,S;
+
+         // weighted partials, WP = iMC * P; without weights PW is just P
+         if(invMC.rows() > 0) WP = Matrix<double>(Nsvs,dim);
+         const Matrix<double>& PW(invMC.rows() > 0 ? WP : P);
 
          Solution.resize(dim);
          Covariance.resize(dim,dim);
@@ -296,9 +353,6 @@ namespace gpstk
          do {
             TropFlag = false;       // true means the trop corr was NOT applied
 
-            // current estimate of position solution
-            RX.x = Triple(Solution(0),Solution(1),Solution(2));
-
             // loop over satellites, computing partials matrix
             for(n=0,i=0; i<Sats.size(); i++) {
                // ignore marked satellites
@@ -334,19 +388,30 @@ namespace gpstk
 
                // correct for troposphere and PCOs (but not on the first iteration)
                if(n_iterate > 0) {
-                  SV.x = Triple(svxyz[0],svxyz[1],svxyz[2]);
-                  Position R,S;
-                  R.setECEF(RX.x[0],RX.x[1],RX.x[2]);
-                  S.setECEF(SV.x[0],SV.x[1],SV.x[2]);
+                  R.setECEF(Solution(0),Solution(1),Solution(2));
+                  S.setECEF(svxyz[0],svxyz[1],svxyz[2]);
+
+                  // height of R, and (the sign of) the elevation of S seen from
+                  // R, as R.getHeight() and R.elevation(S) compute them but
+                  // without the Triple temporaries, which allocate
+                  double up(0.0);
+                  for(k=0; k<3; k++) rxyz[k] = Solution(k);
+                  geodetic.convertCartesianToGeodetic(rxyz, llh, 1);
+                  for(k=0; k<3; k++) up += (svxyz[k]-rxyz[k])*rxyz[k];
 
                   // trop
-                  double tc(R.getHeight());  // tc is a dummy here
+                  double tc(llh[2]);         // tc is a dummy here
                   // must test R for reasonableness to avoid corrupting TropModel
                   // Global model sets the upper limit
-                  if(R.elevation(S) < 0.0 || tc > 44247. || tc < -1000.0) {
+                  if(up < 0.0 || tc > 44247. || tc < -1000.0) {
                      tc = 0.0;
                      TropFlag = true;        // true means failed to apply trop corr
                   }
+                  else if(pTropLock) {
+                     // TropModel is not thread safe; see RAIMStage()
+                     lock_guard<mutex> lock(*pTropLock);
+                     tc = pTropModel->correction(R,S,T);
+                  }
                   else
                      tc = pTropModel->correction(R,S,T);    // pTropModel not const
 
@@ -390,35 +455,37 @@ namespace gpstk
                << fixed << setprecision(3) << Resids;
 
             // ------------------------------------------------------
-            // compute information matrix (inverse covariance) and generalized inverse
-            PT = transpose(P);
-
-            // weight matrix = measurement covariance inverse
-            if(invMC.rows() > 0) Covariance = PT * iMC * P;
-            else                 Covariance = PT * P;
+            // weight the partials
+            if(invMC.rows() > 0) {
+               for(n=0; n<Nsvs; n++) {
+                  for(j=0; j<dim; j++) {
+                     double sum(0.0);
+                     for(k=0; k<Nsvs; k++) sum += iMC(n,k)*P(k,j);
+                     WP(n,j) = sum;
+                  }
+               }
+            }
 
-            // invert using SVD
+            // ------------------------------------------------------
+            // solve the normal equations for the covariance and the update
             try {
-               Covariance = inverseSVD(Covariance);
+               switch(dim) {
+                  case 4: normalSolve<4>(P, PW, Resids, Covariance, dX); break;
+                  case 5: normalSolve<5>(P, PW, Resids, Covariance, dX); break;
+                  case 6: normalSolve<6>(P, PW, Resids, Covariance, dX); break;
+                  case 7: normalSolve<7>(P, PW, Resids, Covariance, dX); break;
+                  case 8: normalSolve<8>(P, PW, Resids, Covariance, dX); break;
+                  default: normalSolve(P, PW, Resids, Covariance, dX); break;
+               }
             }
             catch(SingularMatrixException& sme) { return -2; }
             LOG(DEBUG) << "InvCov (" << Covariance.rows() << "x" << Covariance.cols()
                << ")\n" << fixed << setprecision(4) << Covariance;
 
-            // generalized inverse
-            if(invMC.rows() > 0) G = Covariance * PT * iMC;
-            else                 G = Covariance * PT;
-
-            // PG is used for Slope computation
-            PG = P * G;
-            LOG(DEBUG) << "PG (" << PG.rows() << "x" << PG.cols()
-               << ")\n" << fixed << setprecision(4) << PG;
-
             n_iterate++;                        // increment number iterations
 
             // ------------------------------------------------------
-            // compute solution
-            dX = G * Resids;
+            // update solution
             LOG(DEBUG) << "Computed dX(" << dX.size() << ")";
             Solution += dX;
 
@@ -446,12 +513,21 @@ namespace gpstk
          if(iret == 0) for(j=0,i=0; i<Sats.size(); i++) {
             if(Sats[i].id <= 0) continue;
 
+            // G = Covariance*transpose(PW) is the generalized inverse; only its
+            // column j, and element (j,j) of PG = P*G, are needed
+            double GG(0.0),PG(0.0);
+            for(size_t kk=0; kk<dim; kk++) {
+               double g(0.0);
+               for(size_t l=0; l<dim; l++) g += Covariance(kk,l)*PW(j,l);
+               GG += g*g;
+               PG += P(j,kk)*g;
+            }
+
             // NB when one (few) sats have their own clock, PG(j,j) = 1 (nearly 1)
             // and slope is inf (large)
-            if(::fabs(1.0-PG(j,j)) < 1.e-8) continue;
+            if(::fabs(1.0-PG) < 1.e-8) continue;
 
-            for(int k=0; k<dim; k++) Slopes(j) += G(k,j)*G(k,j); // TD dim=4 here?
-            Slopes(j) = SQRT(Slopes(j)*double(n-dim)/(1.0-PG(j,j)));
+            Slopes(j) = SQRT(GG*double(n-dim)/(1.0-PG));
             if(Slopes(j) > MaxSlope) MaxSlope = Slopes(j);
             j++;
          }
@@ -528,6 +604,11 @@ namespace gpstk
          vector<SatID> BestSats,SaveSats;
          Matrix<double> SVP,BestCov,BestInvMCov,BestPartials;
          vector<SatelliteSystem> BestGNSS;
+         // stages evaluated by RAIMStage() save only the rejected combination;
+         // the solution is recomputed from it after the loop.
+         // BestRejects/LastRejects are indexes into GoodIndexes.
+         bool parallel,parBest(false),parLast(false);
+         vector<int> BestRejects,LastRejects;
 
          // initialize
          Valid = false;
@@ -592,12 +673,45 @@ namespace gpstk
          // stage is the number of satellites to reject.
          int stage(0);
 
+         // use threads for the stages with more than one combination
+         parallel = (NThreads != 1 && LOGlevel < ConfigureLOG::Level("DEBUG"));
+
          do {
             // compute all the combinations of N satellites taken stage at a time
             Combinations Combo(N,stage);
 
+            if(parallel && stage > 0 && stage < N) {
+               vector<int> Rejects,Irets;
+               vector<double> RMSs,SLs;
+               RAIMStage(Tr, SaveSats, GoodIndexes, stage, SVP, invMC, pTropModel,
+                         Rejects, Irets, RMSs, SLs);
+
+               // go through the results in order, just as the loop below does
+               for(i=0; i<Irets.size(); i++) {
+                  iret = Irets[i];
+                  parLast = true;
+                  LastRejects.assign(Rejects.begin()+i*stage,
+                                     Rejects.begin()+(i+1)*stage);
+                  if(iret <= 0 && iret > BestIret) BestIret = iret;
+                  if(iret == -1 || iret == -2) continue;
+                  if(iret == -3 || iret == -4) break;
+
+                  bool accept(EarlyTermination && RMSs[i] < RMSLimit
+                                               && SLs[i] <= SlopeLimit);
+                  if(BestRMS < 0.0 || RMSs[i] < BestRMS || accept) {
+                     BestRMS = RMSs[i];
+                     BestSL = SLs[i];
+                     BestIret = iret;
+                     BestRejects = LastRejects;
+                     parBest = true;
+                  }
+                  if(accept) break;
+               }
+            }
+
             // compute a solution for each combination of marked satellites
-            do {
+            else do {
+               parLast = false;
                // Mark the satellites for this combination
                Sats = SaveSats;
                for(i=0; i<GoodIndexes.size(); i++)
@@ -660,8 +774,11 @@ namespace gpstk
                      //(Solution-memory.APSolution));
 
                // deal with the results of SimplePRSolution()
-               // save 'best' solution for later
-               if(BestRMS < 0.0 || RMSResidual < BestRMS) {
+               // save 'best' solution for later; with EarlyTermination, a
+               // combination within the limits is the solution.
+               bool accept(EarlyTermination && RMSResidual < RMSLimit
+                                            && MaxSlope <= SlopeLimit);
+               if(BestRMS < 0.0 || RMSResidual < BestRMS || accept) {
                   BestRMS = RMSResidual;
                   BestSol = Solution;
                   BestSats = SatelliteIDs;
@@ -675,11 +792,14 @@ namespace gpstk
                   BestPFR = PreFitResidual;
                   BestTropFlag = TropFlag;
                   BestIret = iret;
+                  parBest = false;
                }
 
                if(stage==0 && RMSResidual < RMSLimit)
                   break;
 
+               if(accept) break;
+
             } while(Combo.Next() != -1);  // get the next combinations and repeat
 
             // end of the stage
@@ -710,6 +830,35 @@ namespace gpstk
 
          } while(1);    // end loop over stages
 
+         // ----------------------------------------------------------------
+         // recompute a solution found by RAIMStage(): the best one if it will be
+         // copied out, else the last one tried, as the serial loop left it.
+         if((iret >= 0 && parBest) || (iret < 0 && parLast)) {
+            const vector<int>& Rejects(iret >= 0 ? BestRejects : LastRejects);
+            Sats = SaveSats;
+            for(i=0; i<Rejects.size(); i++)
+               Sats[GoodIndexes[Rejects[i]]].id
+                                       = -::abs(Sats[GoodIndexes[Rejects[i]]].id);
+            int jret = SimplePRSolution(Tr, Sats, SVP, invMC, pTropModel,
+                                 MaxNIterations, ConvergenceLimit, Resids, Slopes);
+            if(iret >= 0) {
+               if(jret != BestIret) {
+                  Exception e("RAIM solution could not be reproduced");
+                  GPSTK_THROW(e);
+               }
+               BestSol = Solution;
+               BestSats = SatelliteIDs;
+               BestGNSS = dataGNSS;
+               BestConv = Convergence;
+               BestNIter = NIterations;
+               BestCov = Covariance;
+               BestInvMCov = invMeasCov;
+               BestPartials = Partials;
+               BestPFR = PreFitResidual;
+               BestTropFlag = TropFlag;
+            }
+         }
+
          // ----------------------------------------------------------------
          // copy out the best solution
          if(iret >= 0) {
@@ -802,6 +951,88 @@ namespace gpstk
    }  // end PRSolution::RAIMCompute()
 
 
+   // -------------------------------------------------------------------------
+   // Evaluate all the combinations of one RAIM stage using the thread pool.
+   void PRSolution::RAIMStage(const CommonTime& Tr,
+                              const vector<SatID>& Sats,
+                              const vector<int>& GoodIndexes,
+                              const int stage,
+                              const Matrix<double>& SVP,
+                              const Matrix<double>& invMC,
+                              TropModel *pTropModel,
+                              vector<int>& Rejects,
+                              vector<int>& Iret,
+                              vector<double>& RMS,
+                              vector<double>& Slope)
+   {
+      int j;
+      unsigned int nthreads(NThreads > 0 ? NThreads : ThreadPool::defaultThreads());
+      if(!pool || pool->size() != nthreads)
+         pool.reset(new ThreadPool(nthreads));
+
+      // list the combinations, in order, so each can be found by its index
+      Combinations Combo(GoodIndexes.size(),stage);
+      Rejects.clear();
+      do {
+         for(j=0; j<stage; j++)
+            Rejects.push_back(Combo.Selection(j));
+      } while(Combo.Next() != -1);
+
+      const size_t ncombo(Rejects.size()/stage);
+      Iret = vector<int>(ncombo,-5);
+      RMS = vector<double>(ncombo,0.0);
+      Slope = vector<double>(ncombo,0.0);
+
+      // Each thread takes the next combination in order. Once a combination
+      // ends the stage (as in RAIMCompute()), later ones need not be tried,
+      // but all earlier ones must be, so the caller sees the serial result.
+      atomic<size_t> next(0),stop(ncombo);
+      mutex tropLock;
+
+      auto work = [&]() {
+         // per-thread copy, holding the solution and its matrices
+         PRSolution prs(*this);
+         prs.pool.reset();
+         prs.pTropLock = &tropLock;
+         vector<SatID> sats;
+         Vector<double> resids,slopes;
+
+         size_t k,s;
+         while((k = next++) < stop) {
+            sats = Sats;
+            for(int m=0; m<stage; m++) {
+               const int ii(GoodIndexes[Rejects[k*stage+m]]);
+               sats[ii].id = -::abs(sats[ii].id);
+            }
+
+            int iret = prs.SimplePRSolution(Tr, sats, SVP, invMC, pTropModel,
+                           MaxNIterations, ConvergenceLimit, resids, slopes);
+            Iret[k] = iret;
+            RMS[k] = prs.RMSResidual;
+            Slope[k] = prs.MaxSlope;
+
+            if(iret == -3 || iret == -4 ||
+               (EarlyTermination && iret == 0 && prs.RMSResidual < RMSLimit
+                                 && prs.MaxSlope <= SlopeLimit))
+            {
+               s = stop;
+               while(k < s && !stop.compare_exchange_weak(s,k)) ;
+            }
+         }
+      };
+
+      vector< future<void> > results;
+      for(unsigned int t=0; t<nthreads; t++)
+         results.push_back(pool->submit(work));
+      // wait for all, then rethrow the first exception, if any
+      for(unsigned int t=0; t<nthreads; t++)
+         results[t].wait();
+      for(unsigned int t=0; t<nthreads; t++)
+         results[t].get();
+
+   }  // end PRSolution::RAIMStage()
+
+
    // -------------------------------------------------------------------------
    int PRSolution::DOPCompute(void)
    {
@@ -45,12 +45,15 @@
 
 #include <vector>
 #include <ostream>
+#include <memory>
+#include <mutex>
 #include "stl_helpers.hpp"
 #include "GNSSconstants.hpp"
 #include "CommonTime.hpp"
 #include "RinexSatID.hpp"
 #include "Stats.hpp"
 #include "Matrix.hpp"
+#include "FixedMatrix.hpp"
 #include "Namelist.hpp"
 #include "XvtStore.hpp"
 #include "TropModel.hpp"
@@ -60,6 +63,8 @@ namespace gpstk
    /** @defgroup GPSsolutions GPS solution algorithms and Tropospheric models */
    //@{
 
+   class ThreadPool;
+
    /// Class WtdAveStats encapsulates statistics on the PR solution and residuals
    /// for a time series of data.
    class WtdAveStats {
@@ -70,8 +75,12 @@ namespace gpstk
       std::string msg;
       std::string lab[3];
       Stats<double> S[3];
-      Matrix<double> sumInfo;
-      Vector<double> sumInfoState,Sbias;
+      FixedMatrix<double,3,3> sumInfo;
+      FixedVector<double,3> sumInfoState,Sbias;
+
+      // inverse of sumInfo
+      FixedMatrix<double,3,3> invInfo(void) const
+         { return inverseSymmetric(sumInfo); }
 
    public:
 
@@ -90,21 +99,32 @@ namespace gpstk
 
       Vector<double> getSol(void) const
       {
-         return (getCov()*sumInfoState + Sbias);
+         if(N == 0) return Vector<double>();
+         FixedVector<double,3> Sol(invInfo()*sumInfoState);
+         Sol += Sbias;
+         return Vector<double>(Sol);
       }
 
-      Matrix<double> getCov(void) const { return inverseSVD(sumInfo); }
+      Matrix<double> getCov(void) const
+      {
+         if(N == 0) return Matrix<double>();
+         return Matrix<double>(invInfo());
+      }
 
-      Matrix<double> getInfo(void) const { return sumInfo; }
+      Matrix<double> getInfo(void) const
+      {
+         if(N == 0) return Matrix<double>();
+         return sumInfo;
+      }
 
       int getN(void) const { return N; }
 
       void reset(void)
       {
          N = 0;
-         sumInfo = Matrix<double>();
-         sumInfoState = Vector<double>();
-         Sbias = Vector<double>(3);
+         sumInfo = 0.0;
+         sumInfoState = 0.0;
+         Sbias = 0.0;
          S[0].Reset();
          S[1].Reset();
          S[2].Reset();
@@ -121,17 +141,16 @@ namespace gpstk
             }
 
             // NB do NOT include clock(s); this can ruin the position average
-            Vector<double> Sol3(Sol);
-            Sol3.resize(3);               // assumes position states come first
-            Sol3 = Sol3 - Sbias;
-            Matrix<double> Cov3(Cov,0,0,3,3);
+            // assumes position states come first
+            FixedVector<double,3> Sol3;
+            FixedMatrix<double,3,3> Cov3;
+            for(unsigned int i=0; i<3; i++) {
+               Sol3(i) = Sol(i) - Sbias(i);
+               for(unsigned int j=0; j<3; j++) Cov3(i,j) = Cov(i,j);
+            }
 
             // information matrix (position only)
-            Matrix<double> Info(inverseSVD(Cov3));
-            if(N == 0) {                  // first call: dimension and set to zero
-               sumInfo = Matrix<double>(3,3,0.0);
-               sumInfoState = Vector<double>(3,0.0);
-            }
+            FixedMatrix<double,3,3> Info(inverseSymmetric(Cov3));
 
             // add to the total information
             sumInfo += Info;
@@ -171,9 +190,8 @@ namespace gpstk
                   << std::endl;
 
                os << "Weighted average " << msg << std::endl;
-               Matrix<double> Cov(inverseSVD(sumInfo));
-               Vector<double> Sol(Cov * sumInfoState + Sbias);
-               os << std::setw(14) << std::setprecision(4) << Sol << "    " << N;
+               os << std::setw(14) << std::setprecision(4) << getSol()
+                  << "    " << N;
             }
             else os << " No data!";
          }
@@ -220,10 +238,13 @@ namespace gpstk
                       NSatsReject(-1),
                       MaxNIterations(10),
                       ConvergenceLimit(3.e-7),
+                      NThreads(1),
+                      EarlyTermination(false),
                       hasMemory(true),
                       fixedAPriori(false),
                       nsol(0), ndata(0), APV(0.0),
-                      Valid(false)
+                      Valid(false),
+                      pTropLock(0)
          {
             was.reset();
             APSolution = Vector<double>(4,0.0);
@@ -254,6 +275,21 @@ namespace gpstk
       /// solution exceeds this.
       double ConvergenceLimit;
 
+      /// Number of threads used by RAIMCompute() to evaluate the combinations of
+      /// satellites at each stage that rejects one or more satellites. If this = 1
+      /// (the default) they are evaluated in the calling thread; if 0, one thread
+      /// per hardware core is used. The returned solution does not depend on this.
+      /// With more than one thread, calls to the TropModel are serialized, and
+      /// DEBUG logging forces the serial algorithm.
+      int NThreads;
+
+      /// If true, a RAIM stage ends at the first combination of satellites (in the
+      /// order generated by class Combinations) that converges with RMS residual
+      /// below RMSLimit and slope no larger than SlopeLimit, and that combination
+      /// becomes the solution even if a later one has a smaller RMS residual.
+      /// If false (the default) every combination in the stage is tried.
+      bool EarlyTermination;
+
       /// vector<SatelliteSystem> containing the satellite systems allowed
       /// in the solution. **This vector MUST be defined before computing solutions.**
       /// It is used to determine which clock biases are included in the solution,
@@ -640,6 +676,32 @@ namespace gpstk
       /// empty vector used to detect default
       static const Vector<double> PRSNullVector;
 
+      /// Evaluate every combination of stage satellites rejected from the
+      /// satellites Sats[GoodIndexes[.]], using the pool threads; used by
+      /// RAIMCompute(). Each combination is stored in Rejects as stage indexes
+      /// into GoodIndexes, and Iret, RMS and Slope receive the return value, RMS
+      /// residual and max slope of each. Combinations following one that ends the
+      /// stage (see RAIMCompute()) may be skipped; their Iret is left at -5.
+      void RAIMStage(const CommonTime& Tr,
+                     const std::vector<SatID>& Sats,
+                     const std::vector<int>& GoodIndexes,
+                     const int stage,
+                     const Matrix<double>& SVP,
+                     const Matrix<double>& invMC,
+                     TropModel *pTropModel,
+                     std::vector<int>& Rejects,
+                     std::vector<int>& Iret,
+                     std::vector<double>& RMS,
+                     std::vector<double>& Slope);
+
+      /// threads used by RAIMStage(); created when first needed, and shared by
+      /// copies of this object.
+      std::shared_ptr<ThreadPool> pool;
+
+      /// if not null, lock held around calls to the TropModel in
+      /// SimplePRSolution(); set in the copies used by RAIMStage().
+      std::mutex *pTropLock;
+
    }; // end class PRSolution
 
    //@}
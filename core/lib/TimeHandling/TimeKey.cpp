@@ -0,0 +1,82 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/**
+ * @file TimeKey.cpp
+ * A compact integer key for CommonTime, for fast ordering and hashing.
+ */
+
+#include "TimeKey.hpp"
+
+namespace gpstk
+{
+      // GPS epoch: MJD 44244
+   const long TimeKey::EPOCH_JDAY = GPS_EPOCH_MJD + MJD_JDAY;
+   const int64_t TimeKey::NS_PER_DAY = 86400000000000LL;
+   const int64_t TimeKey::NS_PER_MS = 1000000LL;
+      // whole days of nanoseconds that fit in int64_t, leaving room for
+      // the time of day
+   const long TimeKey::minDay = -106751L;
+   const long TimeKey::maxDay =  106750L;
+
+
+   CommonTime TimeKey ::
+   toCommonTime() const
+   {
+      long day(ns / NS_PER_DAY);
+      int64_t rem(ns % NS_PER_DAY);
+      if(rem < 0)
+      {
+         rem += NS_PER_DAY;
+         day--;
+      }
+      CommonTime rv;
+      rv.setInternal(day + EPOCH_JDAY, long(rem / NS_PER_MS),
+                     double(rem % NS_PER_MS) * 1.e-9, sys);
+      return rv;
+   }
+
+
+   std::ostream& operator<<(std::ostream& s, const TimeKey& tk)
+   {
+      s << tk.nanoseconds() << " " << gpstk::StringUtils::asString(
+         tk.getTimeSystem());
+      return s;
+   }
+
+} // namespace gpstk
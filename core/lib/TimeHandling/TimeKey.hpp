@@ -0,0 +1,179 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/**
+ * @file TimeKey.hpp
+ * A compact integer key for CommonTime, for fast ordering and hashing.
+ */
+
+#ifndef GPSTK_TIMEKEY_HPP
+#define GPSTK_TIMEKEY_HPP
+
+#include <map>
+#include <set>
+#include <functional>
+#include <ostream>
+#include <stdint.h>
+
+#include "CommonTime.hpp"
+
+namespace gpstk
+{
+      /// @ingroup TimeHandling
+      //@{
+
+      /**
+       * An integer representation of a CommonTime: the signed 64-bit
+       * count of nanoseconds since the GPS epoch (Jan. 6, 1980), plus
+       * the time system.  Comparing two TimeKeys is one or two integer
+       * comparisons, with no exceptions, so TimeKey is a cheap key for
+       * ordered and hashed containers of epochs.
+       *
+       * The order is total: keys are ordered by time, then by time
+       * system.  Unlike CommonTime, keys in different time systems
+       * (including TimeSystem::Any) are never equal and never throw
+       * when compared.
+       *
+       * Times are rounded to the nearest nanosecond, so CommonTimes
+       * closer together than that may have the same key.  The range
+       * is about 292 years either side of the GPS epoch; times outside
+       * it, including CommonTime::BEGINNING_OF_TIME and
+       * CommonTime::END_OF_TIME, are clamped to the first and last
+       * keys, which preserves their order.
+       */
+   class TimeKey
+   {
+   public:
+         /// 'julian day' of the GPS epoch, the zero of the key.
+      static const long EPOCH_JDAY;
+         /// Nanoseconds per day.
+      static const int64_t NS_PER_DAY;
+         /// Nanoseconds per millisecond.
+      static const int64_t NS_PER_MS;
+
+         /// Key of the GPS epoch in time system Unknown.
+      TimeKey()
+            : ns(0), sys(TimeSystem::Unknown)
+      {}
+
+         /// Key from a nanosecond count and time system.
+      TimeKey(int64_t nanoseconds, TimeSystem ts)
+            : ns(nanoseconds), sys(ts)
+      {}
+
+         /// Key of a CommonTime.
+      explicit TimeKey(const CommonTime& ct)
+      {
+         long day, msod;
+         double fsod;
+         ct.getInternal(day, msod, fsod, sys);
+         day -= EPOCH_JDAY;
+         if(day < minDay)
+            ns = INT64_MIN;
+         else if(day > maxDay)
+            ns = INT64_MAX;
+         else
+            ns = int64_t(day) * NS_PER_DAY + int64_t(msod) * NS_PER_MS
+               + int64_t(fsod * 1.e9 + 0.5);
+      }
+
+         /// @return the CommonTime of this key.
+      CommonTime toCommonTime() const;
+
+         /// @return nanoseconds since the GPS epoch.
+      int64_t nanoseconds() const
+      { return ns; }
+
+         /// @return the time system.
+      TimeSystem getTimeSystem() const
+      { return sys; }
+
+         /// @return the difference in seconds; time systems are ignored.
+      double operator-(const TimeKey& right) const
+      { return double(ns - right.ns) * 1.e-9; }
+
+      bool operator==(const TimeKey& right) const
+      { return ns == right.ns && sys == right.sys; }
+      bool operator!=(const TimeKey& right) const
+      { return !operator==(right); }
+      bool operator<(const TimeKey& right) const
+      { return ns < right.ns || (ns == right.ns && sys < right.sys); }
+      bool operator>(const TimeKey& right) const
+      { return right < *this; }
+      bool operator<=(const TimeKey& right) const
+      { return !(right < *this); }
+      bool operator>=(const TimeKey& right) const
+      { return !(*this < right); }
+
+   private:
+         /// range of days (relative to EPOCH_JDAY) that fit in the key.
+      static const long minDay, maxDay;
+
+      int64_t ns;
+      TimeSystem sys;
+   };
+
+      /// Print the key as nanoseconds and time system.
+   std::ostream& operator<<(std::ostream& s, const TimeKey& tk);
+
+      /// A std::map of epochs using TimeKey.
+   template <class T>
+   using TimeKeyMap = std::map<TimeKey, T>;
+
+      /// A std::set of epochs using TimeKey.
+   typedef std::set<TimeKey> TimeKeySet;
+
+      //@}
+
+} // namespace gpstk
+
+namespace std
+{
+      /// Hash of a TimeKey, for exact epoch lookup in unordered containers.
+   template <>
+   struct hash<gpstk::TimeKey>
+   {
+      size_t operator()(const gpstk::TimeKey& tk) const
+      {
+         return hash<int64_t>()(tk.nanoseconds()) ^
+            (size_t(tk.getTimeSystem()) * size_t(0x9e3779b97f4a7c15ULL));
+      }
+   };
+}
+
+#endif // GPSTK_TIMEKEY_HPP
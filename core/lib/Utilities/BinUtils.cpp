@@ -70,5 +70,288 @@ namespace gpstk
 
       // CRC-32: 32 26 23 22 16 12 11 10 8 7 5 4 2 +1
       // 0000 0100 1100 0001 0001 1101 1011 0101 : 04c11db5
+
+
+      namespace
+      {
+            /** Look-up tables for CRC-24Q.  table[k][b] is the CRC of
+             * the byte b followed by k zero bytes, so that the CRC of
+             * eight bytes is the XOR of eight table entries. */
+         struct CRC24QTables
+         {
+            CRC24QTables();
+            uint32_t table[8][256];
+         };
+
+
+         CRC24QTables :: CRC24QTables()
+         {
+            for (unsigned b = 0; b < 256; b++)
+            {
+               uint32_t crc = b << 16;
+               for (unsigned bit = 0; bit < 8; bit++)
+               {
+                  crc = (crc & 0x800000) ? ((crc << 1) ^ 0x864cfb) : (crc << 1);
+               }
+               table[0][b] = crc & 0xffffff;
+            }
+            for (unsigned k = 1; k < 8; k++)
+            {
+               for (unsigned b = 0; b < 256; b++)
+               {
+                  uint32_t prev = table[k-1][b];
+                  table[k][b] = ((prev << 8) & 0xffffff) ^ table[0][prev >> 16];
+               }
+            }
+         }
+
+
+         const CRC24QTables& crc24qTables()
+         {
+            static const CRC24QTables tables;
+            return tables;
+         }
+
+
+            /** Look-up tables for the reflected CRC-16 and CRC-32,
+             * with table32[k][b] holding the CRC-32 of the byte b
+             * followed by k zero bytes. */
+         struct CRCTables
+         {
+            CRCTables();
+            uint16_t table16[256];
+            uint32_t table32[8][256];
+         };
+
+
+         CRCTables :: CRCTables()
+         {
+            for (unsigned b = 0; b < 256; b++)
+            {
+               uint32_t c16 = b, c32 = b;
+               for (unsigned bit = 0; bit < 8; bit++)
+               {
+                  c16 = (c16 & 1) ? ((c16 >> 1) ^ 0xa001) : (c16 >> 1);
+                  c32 = (c32 & 1) ? ((c32 >> 1) ^ 0xedb88320) : (c32 >> 1);
+               }
+               table16[b] = c16;
+               table32[0][b] = c32;
+            }
+            for (unsigned k = 1; k < 8; k++)
+            {
+               for (unsigned b = 0; b < 256; b++)
+               {
+                  uint32_t prev = table32[k-1][b];
+                  table32[k][b] = (prev >> 8) ^ table32[0][prev & 0xff];
+               }
+            }
+         }
+
+
+         const CRCTables& crcTables()
+         {
+            static const CRCTables tables;
+            return tables;
+         }
+
+
+            /// Update crc with the eight bytes of w, most significant first.
+         inline uint32_t crc24qWord(const CRC24QTables& t, uint32_t crc,
+                                    uint64_t w)
+         {
+            uint32_t x = crc ^ (uint32_t)(w >> 40);
+            return
+               t.table[7][(x >> 16) & 0xff] ^
+               t.table[6][(x >> 8) & 0xff] ^
+               t.table[5][x & 0xff] ^
+               t.table[4][(w >> 32) & 0xff] ^
+               t.table[3][(w >> 24) & 0xff] ^
+               t.table[2][(w >> 16) & 0xff] ^
+               t.table[1][(w >> 8) & 0xff] ^
+               t.table[0][w & 0xff];
+         }
+
+
+            /// Update crc with one byte.
+         inline uint32_t crc24qByte(const CRC24QTables& t, uint32_t crc,
+                                    uint8_t b)
+         {
+            return ((crc << 8) & 0xffffff) ^ t.table[0][((crc >> 16) ^ b) & 0xff];
+         }
+      }
+
+
+      uint32_t crc24q(const unsigned char *data, size_t len, uint32_t crc)
+      {
+         const CRC24QTables& t(crc24qTables());
+         crc &= 0xffffff;
+         for (; len >= 8; len -= 8, data += 8)
+         {
+            uint64_t w = 0;
+            for (unsigned i = 0; i < 8; i++)
+               w = (w << 8) | data[i];
+            crc = crc24qWord(t, crc, w);
+         }
+         for (; len > 0; len--)
+            crc = crc24qByte(t, crc, *data++);
+         return crc;
+      }
+
+
+      uint32_t crc24qBits(const uint64_t *words, size_t numBits, uint32_t crc)
+      {
+         const CRC24QTables& t(crc24qTables());
+         crc &= 0xffffff;
+         for (; numBits >= 64; numBits -= 64)
+            crc = crc24qWord(t, crc, *words++);
+         if (numBits == 0)
+            return crc;
+            // remaining whole bytes, then bits, of the last word
+         uint64_t w = *words;
+         for (; numBits >= 8; numBits -= 8, w <<= 8)
+            crc = crc24qByte(t, crc, (uint8_t)(w >> 56));
+         for (; numBits > 0; numBits--, w <<= 1)
+         {
+            crc ^= (uint32_t)(w >> 63) << 23;
+            crc = (crc & 0x800000) ? ((crc << 1) ^ 0x864cfb) : (crc << 1);
+            crc &= 0xffffff;
+         }
+         return crc;
+      }
+
+
+      uint32_t crc16(const unsigned char *data, size_t len, uint32_t initial)
+      {
+         const CRCTables& t(crcTables());
+            // the reflected register of the equivalent direct algorithm
+         uint32_t crc = reflect(initial & 0xffff, 16);
+         for (; len > 0; len--)
+            crc = (crc >> 8) ^ t.table16[(crc ^ *data++) & 0xff];
+         return crc;
+      }
+
+
+      uint32_t crc32(const unsigned char *data, size_t len, uint32_t initial)
+      {
+         const CRCTables& t(crcTables());
+         uint32_t crc = reflect(initial, 32);
+         for (; len >= 8; len -= 8, data += 8)
+         {
+            uint32_t one = crc ^ (data[0] | (data[1] << 8) | (data[2] << 16) |
+                                  ((uint32_t)data[3] << 24));
+            uint32_t two = data[4] | (data[5] << 8) | (data[6] << 16) |
+               ((uint32_t)data[7] << 24);
+            crc = t.table32[7][one & 0xff] ^
+               t.table32[6][(one >> 8) & 0xff] ^
+               t.table32[5][(one >> 16) & 0xff] ^
+               t.table32[4][one >> 24] ^
+               t.table32[3][two & 0xff] ^
+               t.table32[2][(two >> 8) & 0xff] ^
+               t.table32[1][(two >> 16) & 0xff] ^
+               t.table32[0][two >> 24];
+         }
+         for (; len > 0; len--)
+            crc = (crc >> 8) ^ t.table32[0][(crc ^ *data++) & 0xff];
+         return crc ^ 0xffffffff;
+      }
+
+
+      MD5 :: MD5()
+            : count(0)
+      {
+         state[0] = 0x67452301;
+         state[1] = 0xefcdab89;
+         state[2] = 0x98badcfe;
+         state[3] = 0x10325476;
+      }
+
+
+      void MD5 :: update(const unsigned char *data, size_t len)
+      {
+         size_t used = count & 63;
+         count += len;
+         if (used)
+         {
+            size_t n = std::min(len, 64 - used);
+            std::memcpy(buf + used, data, n);
+            data += n;
+            len -= n;
+            if (used + n < 64)
+               return;
+            block(buf);
+         }
+         for (; len >= 64; len -= 64, data += 64)
+            block(data);
+         std::memcpy(buf, data, len);
+      }
+
+
+      void MD5 :: digest(unsigned char out[16])
+      {
+         uint64_t bits = count << 3;
+         unsigned char pad[72] = { 0x80 };
+         size_t padLen = ((count & 63) < 56 ? 56 : 120) - (count & 63);
+         for (unsigned i = 0; i < 8; i++)
+            pad[padLen + i] = (unsigned char)(bits >> (8 * i));
+         update(pad, padLen + 8);
+         for (unsigned i = 0; i < 16; i++)
+            out[i] = (unsigned char)(state[i >> 2] >> (8 * (i & 3)));
+         *this = MD5();
+      }
+
+
+      void MD5 :: block(const unsigned char *p)
+      {
+            // sines and shifts of RFC 1321
+         static const uint32_t K[64] =
+         {
+            0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee,
+            0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+            0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be,
+            0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+            0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa,
+            0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+            0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed,
+            0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+            0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c,
+            0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+            0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05,
+            0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+            0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039,
+            0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+            0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1,
+            0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391
+         };
+         static const unsigned S[16] =
+         { 7, 12, 17, 22, 5, 9, 14, 20, 4, 11, 16, 23, 6, 10, 15, 21 };
+
+         uint32_t m[16];
+         for (unsigned i = 0; i < 16; i++, p += 4)
+            m[i] = p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+
+         uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+         for (unsigned i = 0; i < 64; i++)
+         {
+            uint32_t f;
+            unsigned g;
+            switch (i >> 4)
+            {
+               case 0:  f = (b & c) | (~b & d); g = i;               break;
+               case 1:  f = (d & b) | (~d & c); g = (5 * i + 1) & 15; break;
+               case 2:  f = b ^ c ^ d;          g = (3 * i + 5) & 15; break;
+               default: f = c ^ (b | ~d);       g = (7 * i) & 15;     break;
+            }
+            unsigned sh = S[((i >> 4) << 2) | (i & 3)];
+            f += a + K[i] + m[g];
+            a = d;
+            d = c;
+            c = b;
+            b += (f << sh) | (f >> (32 - sh));
+         }
+         state[0] += a;
+         state[1] += b;
+         state[2] += c;
+         state[3] += d;
+      }
    }
 }
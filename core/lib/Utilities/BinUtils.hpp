@@ -322,6 +322,86 @@ namespace gpstk
                                  unsigned long len,
                                  const CRCParam& params);
 
+         /**
+          * Compute the CRC-24Q used by GPS CNAV and RTCM 3
+          * (polynomial 0x864cfb, initial value 0, no reflection, no
+          * final XOR) using look-up tables, eight bytes at a time
+          * ("slicing-by-8").
+          * @param[in] data data to process CRC on.
+          * @param[in] len length of data to process (in bytes).
+          * @param[in] crc the CRC of any preceding data.
+          * @return the CRC value
+          */
+      uint32_t crc24q(const unsigned char *data, size_t len, uint32_t crc = 0);
+
+         /**
+          * Compute the CRC-24Q, as crc24q(), over a bit string that
+          * is not necessarily a whole number of bytes.
+          * @param[in] words the bits to process, the first bit being
+          *   the most significant bit of words[0].
+          * @param[in] numBits the number of bits to process.
+          * @param[in] crc the CRC of any preceding data.
+          * @return the CRC value; 0 when the data ends in a valid
+          *   CRC-24Q parity field.
+          */
+      uint32_t crc24qBits(const uint64_t *words, size_t numBits,
+                          uint32_t crc = 0);
+
+         /**
+          * Compute the CRC-16 using a look-up table.  The result is
+          * the same as that of computeCRC() with the parameters of
+          * CRC16, except for the initial value.
+          * @param[in] data data to process CRC on.
+          * @param[in] len length of data to process (in bytes).
+          * @param[in] initial the initial value, as CRCParam::initial.
+          * @return the CRC value
+          */
+      uint32_t crc16(const unsigned char *data, size_t len,
+                     uint32_t initial = 0);
+
+         /**
+          * Compute the CRC-32 using look-up tables, eight bytes at a
+          * time ("slicing-by-8").  The result is the same as that of
+          * computeCRC() with the parameters of CRC32, except for the
+          * initial value.
+          * @param[in] data data to process CRC on.
+          * @param[in] len length of data to process (in bytes).
+          * @param[in] initial the initial value, as CRCParam::initial.
+          * @return the CRC value
+          */
+      uint32_t crc32(const unsigned char *data, size_t len,
+                     uint32_t initial = 0xffffffff);
+
+         /**
+          * Compute the MD5 message digest (RFC 1321) of data that may
+          * be supplied in pieces, e.g. for the checksum of large
+          * BINEX records.
+          */
+      class MD5
+      {
+      public:
+            /// Prepare for a new message.
+         MD5();
+
+            /** Add data to the message.
+             * @param[in] data the data to add.
+             * @param[in] len length of data (in bytes). */
+         void update(const unsigned char *data, size_t len);
+
+            /** Finish the message and get its digest.  The object is
+             * then ready for a new message.
+             * @param[out] out the 16 byte digest. */
+         void digest(unsigned char out[16]);
+
+      private:
+            /// Process one 64 byte block of the message.
+         void block(const unsigned char *p);
+
+         uint32_t state[4];        ///< Digest of the blocks so far.
+         uint64_t count;           ///< Number of bytes added so far.
+         unsigned char buf[64];    ///< Bytes of an incomplete block.
+      };
+
          /**
           * Calculate an Exclusive-OR Checksum on the string \a str.
           * @param[in] str The encoded data for which the checksum is
@@ -41,6 +41,7 @@
  * Implementation of GPSTK string utility functions.
  */
 
+#include <algorithm>
 #include "StringUtils.hpp"
 
 /* The DEBUG_COL macro is used to help debug issues with column
@@ -280,5 +281,98 @@ namespace gpstk
          }
          return rv;
       }
+
+
+      double asDouble(const char *s, std::string::size_type n)
+      {
+            // Powers of ten that are exactly representable as a double.
+         static const double exactPow10[] =
+         {
+            1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+            1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15
+         };
+         std::string::size_type i = 0;
+         while ((i < n) && isspace(static_cast<unsigned char>(s[i])))
+            i++;
+         bool negative = false;
+         if ((i < n) && ((s[i] == '-') || (s[i] == '+')))
+         {
+            negative = (s[i] == '-');
+            i++;
+         }
+         unsigned long long mantissa = 0;
+         unsigned digits = 0, fracDigits = 0;
+         bool decimal = false;
+         for (; i < n; i++)
+         {
+            if ((s[i] >= '0') && (s[i] <= '9'))
+            {
+               if (++digits > 15)
+                  break;
+               mantissa = mantissa * 10 + (s[i] - '0');
+               if (decimal)
+                  fracDigits++;
+            }
+            else if ((s[i] == '.') && !decimal)
+            {
+               decimal = true;
+            }
+            else
+            {
+               break;
+            }
+         }
+            // The integer mantissa and the power of ten are both
+            // exact, so a single division yields the correctly
+            // rounded result, which is what strtod produces.
+         if ((digits > 0) && (digits <= 15) && ((i == n) || (s[i] == ' ')))
+         {
+            double rv = static_cast<double>(mantissa) / exactPow10[fracDigits];
+            return negative ? -rv : rv;
+         }
+         char buf[64];
+         if (n < sizeof(buf))
+         {
+            std::copy(s, s+n, buf);
+            buf[n] = 0;
+            return strtod(buf, 0);
+         }
+         return asDouble(std::string(s, n));
+      }
+
+
+      long asInt(const char *s, std::string::size_type n)
+      {
+         std::string::size_type i = 0;
+         while ((i < n) && isspace(static_cast<unsigned char>(s[i])))
+            i++;
+         bool negative = false;
+         if ((i < n) && ((s[i] == '-') || (s[i] == '+')))
+         {
+            negative = (s[i] == '-');
+            i++;
+         }
+         long rv = 0;
+            // nine digits always fit in a long, more are left to
+            // strtol so that overflow is handled identically.
+         for (unsigned digits = 0; i < n; i++, digits++)
+         {
+            if ((s[i] < '0') || (s[i] > '9'))
+               return negative ? -rv : rv;
+            if (digits == 9)
+               break;
+            rv = rv * 10 + (s[i] - '0');
+         }
+         if (i == n)
+            return negative ? -rv : rv;
+         char buf[64];
+         if (n < sizeof(buf))
+         {
+            std::copy(s, s+n, buf);
+            buf[n] = 0;
+            return strtol(buf, 0, 10);
+         }
+         return asInt(std::string(s, n));
+      }
    } // namespace StringUtils
 } // namespace gpstk
@@ -713,6 +713,29 @@ namespace gpstk
       inline long asInt(const std::string& s)
       { return strtol(s.c_str(), 0, 10); }
 
+         /**
+          * Convert a fixed-width text field to a double precision
+          * floating point number without allocating memory.  The
+          * result is identical to asDouble(std::string(s,n)).
+          * Plain decimal fields such as those found in RINEX are
+          * converted directly, anything else (exponents, more than 15
+          * significant digits) is handed to strtod via a stack buffer.
+          * @param s pointer to the first character of the field.
+          * @param n width of the field in characters.
+          * @return double representation of the field.
+          */
+      double asDouble(const char *s, std::string::size_type n);
+
+         /**
+          * Convert a fixed-width text field to an integer without
+          * allocating memory.  The result is identical to
+          * asInt(std::string(s,n)).
+          * @param s pointer to the first character of the field.
+          * @param n width of the field in characters.
+          * @return long integer representation of the field.
+          */
+      long asInt(const char *s, std::string::size_type n);
+
          /**
           * Convert a string to an unsigned integer.
           * @param s string containing a number.
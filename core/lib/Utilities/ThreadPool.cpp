@@ -0,0 +1,101 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/**
+ * @file ThreadPool.cpp
+ * A fixed-size pool of worker threads executing queued tasks.
+ */
+
+#include "ThreadPool.hpp"
+
+namespace gpstk
+{
+   ThreadPool ::
+   ThreadPool(unsigned nthreads)
+         : stopping(false)
+   {
+      if (nthreads == 0)
+         nthreads = defaultThreads();
+      workers.reserve(nthreads);
+      for (unsigned i = 0; i < nthreads; i++)
+         workers.push_back(std::thread(&ThreadPool::work, this));
+   }
+
+
+   ThreadPool ::
+   ~ThreadPool()
+   {
+      {
+         std::lock_guard<std::mutex> lock(mtx);
+         stopping = true;
+      }
+      cv.notify_all();
+      for (unsigned i = 0; i < workers.size(); i++)
+         workers[i].join();
+   }
+
+
+   unsigned ThreadPool ::
+   defaultThreads()
+   {
+      unsigned rv = std::thread::hardware_concurrency();
+      return (rv == 0 ? 1 : rv);
+   }
+
+
+   void ThreadPool ::
+   work()
+   {
+      while (true)
+      {
+         std::function<void()> task;
+         {
+            std::unique_lock<std::mutex> lock(mtx);
+            while (!stopping && queue.empty())
+               cv.wait(lock);
+            if (queue.empty())
+               return; // stopping, and nothing left to do
+            task = queue.front();
+            queue.pop_front();
+         }
+            // exceptions are captured by the packaged_task
+         task();
+      }
+   }
+
+} // namespace gpstk
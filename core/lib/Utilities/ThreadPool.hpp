@@ -0,0 +1,127 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/**
+ * @file ThreadPool.hpp
+ * A fixed-size pool of worker threads executing queued tasks.
+ */
+
+#ifndef GPSTK_THREADPOOL_HPP
+#define GPSTK_THREADPOOL_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace gpstk
+{
+      /**
+       * A fixed set of worker threads taking tasks from a single
+       * FIFO queue.  Tasks are submitted as callables returning a
+       * value (or void); the result, or any exception thrown by the
+       * task, is delivered through the returned std::future.
+       *
+       * The pool does not impose any ordering on the completion of
+       * tasks.  Callers that need deterministic results should keep
+       * the futures in submission order and collect them in that
+       * order.
+       *
+       * The destructor finishes all queued tasks before joining the
+       * workers.
+       */
+   class ThreadPool
+   {
+   public:
+         /** Start the worker threads.
+          * @param[in] nthreads the number of workers.  Zero selects
+          *   defaultThreads(). */
+      explicit ThreadPool(unsigned nthreads = 0);
+
+         /// Complete any queued tasks and join the worker threads.
+      ~ThreadPool();
+
+         /** Queue a task for execution.
+          * @param[in] task a callable taking no arguments.
+          * @return a future holding the result of \a task. */
+      template <class F>
+      std::future<typename std::result_of<F()>::type> submit(F task)
+      {
+         typedef typename std::result_of<F()>::type R;
+         std::shared_ptr< std::packaged_task<R()> > pt(
+            new std::packaged_task<R()>(task));
+         std::future<R> rv(pt->get_future());
+         {
+            std::lock_guard<std::mutex> lock(mtx);
+            queue.push_back([pt]() { (*pt)(); });
+         }
+         cv.notify_one();
+         return rv;
+      }
+
+         /// @return the number of worker threads.
+      unsigned size() const
+      { return workers.size(); }
+
+         /** @return the number of concurrent threads supported by
+          * the hardware, or 1 if that can't be determined. */
+      static unsigned defaultThreads();
+
+   private:
+         /// Worker thread main loop.
+      void work();
+
+         /// Not copyable.
+      ThreadPool(const ThreadPool&);
+      ThreadPool& operator=(const ThreadPool&);
+
+      std::vector<std::thread> workers;
+      std::deque< std::function<void()> > queue;
+      std::mutex mtx;
+      std::condition_variable cv;
+         /// Set by the destructor to tell the workers to exit.
+      bool stopping;
+   }; // class ThreadPool
+
+} // namespace gpstk
+
+#endif // GPSTK_THREADPOOL_HPP
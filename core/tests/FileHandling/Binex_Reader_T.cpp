@@ -0,0 +1,392 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+#include <fstream>
+#include <sstream>
+#include "BinexReader.hpp"
+#include "BinexStream.hpp"
+#include "TestUtil.hpp"
+
+using namespace std;
+using namespace gpstk;
+
+class BinexReader_T
+{
+public:
+   BinexReader_T()
+   {
+      tempFileName = getPathTestTemp() + getFileSep() +
+         "test_output_binex_reader.binex";
+      createRecs();
+   }
+
+      /// Read the records back through each kind of input.
+   unsigned readTest()
+   {
+      TUDEF("BinexReader", "next");
+      try
+      {
+         {
+            ofstream ofs(tempFileName.c_str(), ios::out | ios::binary);
+            ofs.write(encoded.data(), encoded.size());
+         }
+         BinexReader reader(64);  // small, to exercise refilling
+         istringstream iss(encoded);
+         reader.open(iss);
+         TUASSERTE(unsigned, 0, checkRecords(reader, testFramework));
+
+         TUCSM("open(memory)");
+         reader.open(encoded.data(), encoded.size());
+         TUASSERTE(unsigned, 0, checkRecords(reader, testFramework));
+
+         TUCSM("open(file)");
+         reader.open(tempFileName);
+         TUASSERTE(unsigned, 0, checkRecords(reader, testFramework));
+         reader.close();
+
+            // stream with exceptions enabled, as BinexData uses
+         BinexStream bs(tempFileName.c_str());
+         bs.exceptions(ios::failbit);
+         BinexReader reader2;
+         reader2.open(bs);
+         TUASSERTE(unsigned, 0, checkRecords(reader2, testFramework));
+      }
+      catch (Exception& e)
+      {
+         cerr << e << endl;
+         TUFAIL("Unexpected exception");
+      }
+      TURETURN();
+   }
+
+
+      /// Check that BinexData reads what it writes with an MD5 checksum.
+   unsigned md5Test()
+   {
+      TUDEF("BinexData", "getRecord");
+      try
+      {
+         TUASSERT(records.back().getMessageLength() >= 1048576);
+         ostringstream oss;
+         records.back().putRecord(oss);
+         TUASSERTE(size_t, records.back().getRecordSize(), oss.str().size());
+         istringstream iss(oss.str());
+         BinexData rec;
+         rec.getRecord(iss);
+         TUASSERT(rec == records.back());
+         TUASSERT(iss.peek() == EOF);
+
+            // a bad digest is detected
+         string bad(oss.str());
+         bad[bad.size() - 3] ^= 1;
+         istringstream badss(bad);
+         TUTHROW(rec.getRecord(badss));
+         TUCSM("next");
+         BinexReader reader;
+         reader.open(bad.data(), bad.size());
+         BinexReader::Record r;
+         TUTHROW(reader.next(r));
+      }
+      catch (Exception& e)
+      {
+         cerr << e << endl;
+         TUFAIL("Unexpected exception");
+      }
+      TURETURN();
+   }
+
+
+      /// Check the handling of damaged input.
+   unsigned errorTest()
+   {
+      TUDEF("BinexReader", "next");
+      BinexReader reader;
+      BinexReader::Record rec;
+
+         // skip bytes that aren't records
+      string junk("\x00\x01\x02", 3);
+      string input(junk + encoded);
+      reader.open(input.data(), input.size());
+      unsigned nerr = 0;
+      bool got = false;
+      while (!got && nerr < 10)
+      {
+         try
+         {
+            got = reader.next(rec);
+         }
+         catch (FFStreamError&)
+         {
+            nerr++;
+         }
+      }
+      TUASSERTE(unsigned, junk.size(), nerr);
+      TUASSERT(got);
+      TUASSERTE(unsigned long long, junk.size(), rec.position);
+      TUASSERTE(unsigned long, records[0].getRecordID(), rec.recID);
+
+         // a damaged CRC or message
+      string bad(encoded);
+      size_t second = records[0].getRecordSize();
+      bad[second + records[1].getRecordSize() - 1] ^= 0x40;
+      reader.open(bad.data(), bad.size());
+      TUASSERT(reader.next(rec));
+      TUTHROW(reader.next(rec));
+      TUASSERTE(unsigned long long, second + 1, reader.tell());
+
+         // a record cut short; the rest of it is searched for records
+      string cut(encoded, 0, second + records[1].getRecordSize() - 2);
+      reader.open(cut.data(), cut.size());
+      TUASSERT(reader.next(rec));
+      TUTHROW(reader.next(rec));
+      TUASSERTE(unsigned long long, second + 1, reader.tell());
+      got = true;
+      for (nerr = 0; got && nerr < cut.size(); )
+      {
+         try
+         {
+            got = reader.next(rec);
+         }
+         catch (FFStreamError&)
+         {
+            nerr++;
+         }
+      }
+      TUASSERT(!got);
+      TUASSERTE(unsigned long long, cut.size(), reader.tell());
+      TURETURN();
+   }
+
+
+      /** Check that a corrupt byte that looks like a synchronization
+       * byte, with a huge message length, doesn't lose the records
+       * after it. */
+   unsigned resyncTest()
+   {
+      TUDEF("BinexReader", "next");
+         // head sync, record ID 1, message length 2^29-1
+      string junk("\xc2\x01\xff\xff\xff\xff", 6);
+      string input(junk + encoded);
+      {
+         ofstream ofs(tempFileName.c_str(), ios::out | ios::binary);
+         ofs.write(input.data(), input.size());
+      }
+      for (unsigned src = 0; src < 3; src++)
+      {
+         BinexReader reader(64);
+         istringstream iss(input);
+         if (src == 0)
+         {
+            reader.open(iss);
+         }
+         else if (src == 1)
+         {
+            TUCSM("next(memory)");
+            reader.open(input.data(), input.size());
+         }
+         else
+         {
+            TUCSM("next(file)");
+            reader.open(tempFileName);
+         }
+         BinexReader::Record rec;
+         unsigned nerr = 0, nrec = 0;
+         bool got = true;
+         while (got && nerr < 100)
+         {
+            try
+            {
+               got = reader.next(rec);
+               if (got && nrec++ == 0)
+               {
+                  TUASSERTE(unsigned long long, junk.size(), rec.position);
+               }
+            }
+            catch (FFStreamError&)
+            {
+               nerr++;
+            }
+         }
+         TUASSERTE(unsigned, junk.size(), nerr);
+         TUASSERTE(unsigned, records.size(), nrec);
+         TUASSERTE(unsigned long long, input.size(), reader.tell());
+      }
+      TURETURN();
+   }
+
+
+      /// Decode the fields of a message in place.
+   unsigned extractTest()
+   {
+      TUDEF("BinexReader", "extractUBNXI");
+      try
+      {
+         for (int big = 0; big < 2; big++)
+         {
+            BinexData bd(0x7e);
+            bd.setRecordFlags(big ? BinexData::eBigEndian : 0);
+            size_t offset = 0;
+            unsigned long vals[] = { 5, 300, 70000, 5000000 };
+            for (unsigned i = 0; i < 4; i++)
+               bd.updateMessageData(offset, BinexData::UBNXI(vals[i]));
+            int32_t l = -123456;
+            int16_t s = 4321;
+            bd.updateMessageData(offset, l, sizeof(l));
+            bd.updateMessageData(offset, s, sizeof(s));
+            ostringstream oss;
+            bd.putRecord(oss);
+            string enc(oss.str());
+
+            BinexReader reader;
+            BinexReader::Record rec;
+            reader.open(enc.data(), enc.size());
+            TUASSERT(reader.next(rec));
+            TUASSERTE(bool, !big, rec.isLittleEndian());
+            offset = 0;
+            for (unsigned i = 0; i < 4; i++)
+               TUASSERTE(unsigned long, vals[i], rec.extractUBNXI(offset));
+            int32_t l2 = 0;
+            int16_t s2 = 0;
+            rec.extractMessageData(offset, l2);
+            rec.extractMessageData(offset, s2);
+            TUASSERTE(int32_t, l, l2);
+            TUASSERTE(int16_t, s, s2);
+            TUASSERTE(size_t, rec.messageLength, offset);
+            TUTHROW(rec.extractMessageData(offset, s2));
+            TUTHROW(rec.extractUBNXI(offset));
+         }
+      }
+      catch (Exception& e)
+      {
+         cerr << e << endl;
+         TUFAIL("Unexpected exception");
+      }
+      TURETURN();
+   }
+
+private:
+      /// Make records with every checksum size and both byte orders.
+   void createRecs()
+   {
+      BinexData::SyncByte flags[] =
+      {
+         BinexData::eBigEndian,
+         0,
+         BinexData::eBigEndian | BinexData::eEnhancedCRC,
+         BinexData::eEnhancedCRC,
+         BinexData::eReverseReadable,
+         BinexData::eReverseReadable | BinexData::eEnhancedCRC |
+            BinexData::eBigEndian
+      };
+      size_t lengths[] = { 0, 3, 100, 200, 3000, 5000 };
+      BinexData::RecordID ids[] = { 0, 0x7f, 200, 20000, 3000000 };
+      uint32_t x = 0x2468ace1;
+      unsigned n = 0;
+      for (unsigned f = 0; f < 6; f++)
+      {
+         for (unsigned l = 0; l < 6; l++, n++)
+         {
+            string msg(lengths[l], 0);
+            for (size_t i = 0; i < msg.size(); i++)
+            {
+               x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+               msg[i] = x;
+            }
+            BinexData rec(ids[n % 5]);
+            rec.setRecordFlags(flags[f]);
+            size_t offset = 0;
+            rec.updateMessageData(offset, msg, msg.size());
+            records.push_back(rec);
+         }
+      }
+         // large enough for an MD5 checksum
+      BinexData big(1);
+      size_t offset = 0;
+      big.updateMessageData(offset, string(1048576, 'x'), 1048576);
+      records.push_back(big);
+
+      ostringstream oss;
+      for (size_t i = 0; i < records.size(); i++)
+         records[i].putRecord(oss);
+      encoded = oss.str();
+   }
+
+
+      /// @return the number of records not read back correctly.
+   unsigned checkRecords(BinexReader& reader, TestUtil& testFramework)
+   {
+      unsigned nbad = 0;
+      unsigned long long pos = 0;
+      BinexReader::Record rec;
+      for (size_t i = 0; i < records.size(); i++)
+      {
+         if (!reader.next(rec))
+            return nbad + records.size() - i;
+         BinexData bd;
+         rec.toBinexData(bd);
+         if (!(bd == records[i]) || rec.position != pos ||
+             rec.size != records[i].getRecordSize())
+            nbad++;
+         pos += rec.size;
+      }
+      if (reader.next(rec))
+         nbad++;
+      TUASSERTE(unsigned long long, encoded.size(), reader.tell());
+      return nbad;
+   }
+
+   vector<BinexData> records;
+   string encoded;
+   string tempFileName;
+};
+
+
+int main(int argc, char *argv[])
+{
+   unsigned errorTotal = 0;
+   BinexReader_T testClass;
+
+   errorTotal += testClass.readTest();
+   errorTotal += testClass.md5Test();
+   errorTotal += testClass.errorTest();
+   errorTotal += testClass.resyncTest();
+   errorTotal += testClass.extractTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+   return errorTotal;
+}
@@ -0,0 +1,374 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+
+#include <fstream>
+#include <iterator>
+#include "CompressedInputBuf.hpp"
+#include "CrinexDecoder.hpp"
+#include "FFTextStream.hpp"
+#include "Rinex3ObsStream.hpp"
+#include "Rinex3ObsHeader.hpp"
+#include "Rinex3ObsData.hpp"
+#include "SP3Stream.hpp"
+#include "SP3Header.hpp"
+#include "SP3Data.hpp"
+#include "TestUtil.hpp"
+
+using namespace std;
+using namespace gpstk;
+
+class CompressedInput_T
+{
+public:
+   CompressedInput_T()
+   {
+      dataDir = getPathData() + getFileSep();
+      tempDir = getPathTestTemp() + getFileSep();
+   }
+
+      /// Compact RINEX 1.0 and 3.0 files decode to the same records.
+   unsigned crinexTest()
+   {
+      TUDEF("FFTextStream", "open(CRINEX)");
+      compareObs(testFramework,
+                 dataDir + "test_input_rinex2_obs_RinexObsFile.06o",
+                 dataDir + "test_input_rinex2_obs_RinexObsFile.06d");
+      compareObs(testFramework,
+                 dataDir + "test_input_rinex3_obs_RinexObsFile.15o",
+                 dataDir + "test_input_rinex3_obs_RinexObsFile.15d");
+      TUCSM("isCompressed");
+      Rinex3ObsStream plain(dataDir +
+                            "test_input_rinex3_obs_RinexObsFile.15o");
+      Rinex3ObsStream crx(dataDir + "test_input_rinex3_obs_RinexObsFile.15d");
+      TUASSERT(!plain.isCompressed());
+      TUASSERT(crx.isCompressed());
+         // opening for output must not try to decode anything
+      FFTextStream out((tempDir + "test_output_compressed.txt").c_str(),
+                       ios::out);
+      TUASSERT(!out.isCompressed());
+      TURETURN();
+   }
+
+      /// gzip files, plain text and Compact RINEX inside.
+   unsigned gzipTest()
+   {
+      TUDEF("FFTextStream", "open(gzip)");
+      if (!CompressedInputBuf::haveGzip())
+      {
+         FFTextStream strm(dataDir + "test_input_SP3c_mgex5.sp3.gz");
+         string line;
+         TUTHROW(strm.formattedGetLine(line));
+         TURETURN();
+      }
+      compareLines(testFramework, dataDir + "test_input_SP3c_mgex5.sp3",
+                   dataDir + "test_input_SP3c_mgex5.sp3.gz");
+      compareObs(testFramework,
+                 dataDir + "test_input_rinex3_obs_RinexObsFile.15o",
+                 dataDir + "test_input_rinex3_obs_RinexObsFile.15d.gz");
+
+      TUCSM("SP3Stream");
+      SP3Stream plain((dataDir + "test_input_SP3c_mgex5.sp3").c_str());
+      SP3Stream gz((dataDir + "test_input_SP3c_mgex5.sp3.gz").c_str());
+      SP3Header hdr, gzhdr;
+      SP3Data rec, gzrec;
+      plain >> hdr;
+      gz >> gzhdr;
+      TUASSERTE(size_t, hdr.satList.size(), gzhdr.satList.size());
+      unsigned records = 0;
+      while (plain >> rec)
+      {
+         TUASSERT(static_cast<bool>(gz >> gzrec));
+         if (!gz)
+            break;
+         records++;
+         TUASSERTE(char, rec.RecType, gzrec.RecType);
+         TUASSERTE(CommonTime, rec.time, gzrec.time);
+         if (rec.RecType != '*')
+         {
+            TUASSERTE(SatID, rec.sat, gzrec.sat);
+            TUASSERTE(double, rec.x[0], gzrec.x[0]);
+            TUASSERTE(double, rec.clk, gzrec.clk);
+         }
+      }
+      TUASSERT(records > 0);
+      TUASSERT(!(gz >> gzrec));
+      TURETURN();
+   }
+
+      /** Closing through std::fstream, which bypasses
+       * FFTextStream::close(), leaves the decoder with its own handle
+       * on the file. */
+   unsigned closeTest()
+   {
+      TUDEF("FFTextStream", "close");
+      string crxName(dataDir + "test_input_rinex3_obs_RinexObsFile.15d");
+      FFTextStream crx(crxName);
+      string first, line;
+      crx.formattedGetLine(first);
+      crx.formattedGetLine(line);
+      FFStream& ffs(crx);
+      static_cast<std::fstream&>(ffs).close();
+      TUASSERT(!crx.is_open());
+      TUASSERT(crx.isCompressed());
+         // the decoder is unaffected
+      crx.formattedGetLine(line);
+      TUASSERT(static_cast<bool>(crx));
+      TUASSERTE(unsigned, 3, crx.lineNumber);
+         // reopening replaces the decoder
+      crx.open(crxName, ios::in);
+      TUASSERT(crx.is_open());
+      TUASSERT(crx.isCompressed());
+      crx.formattedGetLine(line);
+      TUASSERTE(string, first, line);
+      crx.close();
+      TUASSERT(!crx.is_open());
+      TUASSERT(!crx.isCompressed());
+
+         // likewise for read-ahead of a plain file
+      string plainName(dataDir + "test_input_rinex3_obs_RinexObsFile.15o");
+      FFTextStream ref(plainName), plain(plainName);
+      string refLine;
+      ref.formattedGetLine(refLine);
+      plain.formattedGetLine(line);
+      plain.enableReadAhead(4096);
+      TUASSERT(plain.readAheadEnabled());
+      static_cast<std::fstream&>(plain).close();
+      ref.formattedGetLine(refLine);
+      plain.formattedGetLine(line);
+      TUASSERTE(string, refLine, line);
+      TURETURN();
+   }
+
+      /// Decoding errors are reported once the good data is read.
+   unsigned errorTest()
+   {
+      TUDEF("FFTextStream", "formattedGetLine");
+      string line;
+      if (CompressedInputBuf::haveGzip())
+      {
+            // truncate a gzip file
+         string gz(readFile(dataDir + "test_input_SP3c_mgex5.sp3.gz"));
+         string fn(tempDir + "test_output_truncated.sp3.gz");
+         writeFile(fn, gz.substr(0, gz.size()/2));
+         FFTextStream strm(fn);
+         TUASSERT(strm.isCompressed());
+         unsigned lines = 0;
+         try
+         {
+            while (true)
+            {
+               strm.formattedGetLine(line, true);
+               lines++;
+            }
+         }
+         catch (EndOfFile& e)
+         {
+            TUFAIL("EndOfFile thrown for truncated gzip file");
+         }
+         catch (FFStreamError& e)
+         {
+            TUPASS("FFStreamError");
+         }
+         TUASSERT(lines > 0);
+      }
+
+         // a difference before any arc has been initialized
+      string crx(readFile(dataDir + "test_input_rinex3_obs_RinexObsFile.15d"));
+      size_t pos = crx.find("3&23448820047");
+      TUASSERT(pos != string::npos);
+      crx.erase(pos, 2);
+      string fn(tempDir + "test_output_corrupt.15d");
+      writeFile(fn, crx);
+      Rinex3ObsStream strm(fn);
+      Rinex3ObsHeader hdr;
+      Rinex3ObsData rod;
+      strm >> hdr;
+      TUASSERT(static_cast<bool>(strm));
+      strm.exceptions(fstream::failbit);
+      TUTHROW(strm >> rod);
+      TURETURN();
+   }
+
+      /// Decode a few records directly.
+   unsigned decoderTest()
+   {
+      TUDEF("CrinexDecoder", "decodeLine");
+      CrinexDecoder dec;
+      string out;
+      TUASSERT(!CrinexDecoder::isCrinex(
+                  "     3.02           OBSERVATION DATA    "
+                  "GPS(GPS)            RINEX VERSION / TYPE"));
+      TUTHROW(dec.decodeLine("not a CRINEX file", out));
+      dec.reset();
+      const char *lines[] =
+      {
+         "3.0                 COMPACT RINEX FORMAT                    "
+         "CRINEX VERS   / TYPE",
+         "RNX2CRX ver.4.0.7                       17-Oct-26 00:00     "
+         "CRINEX PROG / DATE",
+         "G    2 C1C L1C                                              "
+         "SYS / # / OBS TYPES",
+         "                                                            "
+         "END OF HEADER",
+         "> 2020 01 01 00 00  0.0000000  0  1      G01",
+         "2&123456789012",
+         "3&20000000000 3&100000000000  5 5",
+         "                   3",
+         "125",
+         "1000 -20    &",
+      };
+      for (unsigned i = 0; i < sizeof(lines)/sizeof(lines[0]); i++)
+         dec.decodeLine(lines[i], out);
+      TUASSERTE(int, 3, dec.version());
+      TUASSERTE(unsigned long, 10, dec.lineCount);
+      string expect(
+         "G    2 C1C L1C                                              "
+         "SYS / # / OBS TYPES\n"
+         "                                                            "
+         "END OF HEADER\n"
+         "> 2020 01 01 00 00  0.0000000  0  1       0.123456789012\n"
+         "G01  20000000.000 5 100000000.000 5\n"
+         "> 2020 01 01 00 00 30.0000000  0  1       0.123456789137\n"
+         "G01  20000001.000 5  99999999.980\n");
+      TUASSERTE(string, expect, out);
+      TURETURN();
+   }
+
+private:
+      /// Compare the lines of two text files.
+   void compareLines(TestUtil& testFramework, const string& plainFile,
+                     const string& compressedFile)
+   {
+      FFTextStream plain(plainFile), comp(compressedFile);
+      TUASSERT(comp.isCompressed());
+      string line, cline;
+      try
+      {
+         while (true)
+         {
+            plain.formattedGetLine(line, true);
+            comp.formattedGetLine(cline);
+            TUASSERTE(string, line, cline);
+         }
+      }
+      catch (EndOfFile& e)
+      {
+      }
+      TUTHROW(comp.formattedGetLine(cline, true));
+      TUASSERTE(unsigned, plain.lineNumber, comp.lineNumber);
+   }
+
+      /// Compare the observation records of two files.
+   void compareObs(TestUtil& testFramework, const string& plainFile,
+                   const string& compressedFile)
+   {
+      Rinex3ObsStream strm(plainFile), cstrm(compressedFile);
+      Rinex3ObsHeader hdr, chdr;
+      Rinex3ObsData rod, crod;
+      unsigned records = 0;
+      strm >> hdr;
+      cstrm >> chdr;
+      TUASSERT(static_cast<bool>(cstrm));
+      TUASSERTE(double, hdr.version, chdr.version);
+      TUASSERTE(string, hdr.markerName, chdr.markerName);
+      while (strm >> rod)
+      {
+         TUASSERT(static_cast<bool>(cstrm >> crod));
+         if (!cstrm)
+            break;
+         records++;
+         TUASSERTE(CommonTime, rod.time, crod.time);
+         TUASSERTE(short, rod.epochFlag, crod.epochFlag);
+         TUASSERTE(short, rod.numSVs, crod.numSVs);
+         TUASSERTE(double, rod.clockOffset, crod.clockOffset);
+         TUASSERTE(size_t, rod.obs.size(), crod.obs.size());
+         Rinex3ObsData::DataMap::const_iterator i, ci;
+         for (i = rod.obs.begin(), ci = crod.obs.begin();
+              (i != rod.obs.end()) && (ci != crod.obs.end()); ++i, ++ci)
+         {
+            TUASSERTE(RinexSatID, i->first, ci->first);
+            TUASSERTE(size_t, i->second.size(), ci->second.size());
+            for (unsigned j = 0; j < i->second.size(); j++)
+            {
+               const RinexDatum &d(i->second[j]), &cd(ci->second[j]);
+               TUASSERTE(double, d.data, cd.data);
+               TUASSERTE(short, d.lli, cd.lli);
+               TUASSERTE(short, d.ssi, cd.ssi);
+               TUASSERTE(bool, d.dataBlank, cd.dataBlank);
+            }
+         }
+      }
+      TUASSERT(records > 0);
+      TUASSERT(!(cstrm >> crod));
+      TUASSERT(cstrm.eof());
+   }
+
+   static string readFile(const string& fn)
+   {
+      ifstream ifs(fn.c_str(), ios::in | ios::binary);
+      return string(istreambuf_iterator<char>(ifs),
+                    istreambuf_iterator<char>());
+   }
+
+   static void writeFile(const string& fn, const string& contents)
+   {
+      ofstream ofs(fn.c_str(), ios::out | ios::binary);
+      ofs.write(contents.data(), contents.size());
+   }
+
+   string dataDir;
+   string tempDir;
+};
+
+
+int main()
+{
+   unsigned errorTotal = 0;
+   CompressedInput_T testClass;
+
+   errorTotal += testClass.crinexTest();
+   errorTotal += testClass.gzipTest();
+   errorTotal += testClass.errorTest();
+   errorTotal += testClass.closeTest();
+   errorTotal += testClass.decoderTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal;
+}
@@ -0,0 +1,208 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+
+#include "FFTextStream.hpp"
+#include "RinexNavStream.hpp"
+#include "RinexNavHeader.hpp"
+#include "RinexNavData.hpp"
+#include "Rinex3ObsStream.hpp"
+#include "Rinex3ObsHeader.hpp"
+#include "Rinex3ObsData.hpp"
+#include "TestUtil.hpp"
+
+using namespace std;
+using namespace gpstk;
+
+class FFTextStream_T
+{
+public:
+   FFTextStream_T()
+   {
+      dataDir = getPathData() + getFileSep();
+   }
+
+      /// Lines read ahead match lines read directly.
+   unsigned readAheadLineTest()
+   {
+      TUDEF("FFTextStream", "enableReadAhead");
+      string fn(dataDir + "test_input_rinex3_obs_RinexObsFile.15o");
+      FFTextStream strm(fn), ahead(fn);
+      TUASSERT(!ahead.readAheadEnabled());
+         // small blocks so that lines span blocks
+      ahead.enableReadAhead(100);
+      TUASSERT(ahead.readAheadEnabled());
+      TUASSERT(!ahead.isCompressed());
+      string line, aheadLine;
+      try
+      {
+         while (true)
+         {
+            strm.formattedGetLine(line, true);
+            ahead.formattedGetLine(aheadLine);
+            TUASSERTE(string, line, aheadLine);
+            TUASSERTE(long, static_cast<long>(strm.tellg()),
+                      static_cast<long>(ahead.tellg()));
+         }
+      }
+      catch (EndOfFile& e)
+      {
+      }
+      TUTHROW(ahead.formattedGetLine(aheadLine, true));
+      TUASSERTE(unsigned, strm.lineNumber, ahead.lineNumber);
+
+         // output streams are never read ahead
+      FFTextStream out((getPathTestTemp() + getFileSep() +
+                        "test_output_readahead.txt").c_str(), ios::out);
+      out.enableReadAhead();
+      TUASSERT(!out.readAheadEnabled());
+      TURETURN();
+   }
+
+      /// Navigation records, read ahead from the start of the file.
+   unsigned readAheadNavTest()
+   {
+      TUDEF("RinexNavStream", "enableReadAhead");
+      string fn(dataDir + "test_input_rinex2_nav_RinexNavExample.99n");
+      RinexNavStream strm(fn.c_str()), ahead(fn.c_str());
+      ahead.enableReadAhead(256);
+      RinexNavHeader hdr, aheadHdr;
+      RinexNavData rec, aheadRec;
+      strm >> hdr;
+      ahead >> aheadHdr;
+      TUASSERT(static_cast<bool>(ahead));
+      unsigned records = 0;
+      while (strm >> rec)
+      {
+         TUASSERT(static_cast<bool>(ahead >> aheadRec));
+         if (!ahead)
+            break;
+         records++;
+         TUASSERTE(short, rec.PRNID, aheadRec.PRNID);
+         TUASSERTE(CommonTime, rec.time, aheadRec.time);
+         TUASSERTE(unsigned, strm.lineNumber, ahead.lineNumber);
+         TUASSERTE(unsigned, strm.recordNumber, ahead.recordNumber);
+      }
+      TUASSERT(records > 0);
+      TUASSERT(!(ahead >> aheadRec));
+      TURETURN();
+   }
+
+      /// Observation records, read ahead from after the header.
+   unsigned readAheadObsTest()
+   {
+      TUDEF("Rinex3ObsStream", "enableReadAhead");
+      string fn(dataDir + "test_input_rinex3_76193040.14o");
+      Rinex3ObsStream strm(fn), ahead(fn);
+      Rinex3ObsHeader hdr, aheadHdr;
+      Rinex3ObsData rod, aheadRod;
+      strm >> hdr;
+      ahead >> aheadHdr;
+      long pos = ahead.tellg();
+      ahead.enableReadAhead(4096);
+      TUASSERT(ahead.readAheadEnabled());
+      TUASSERTE(long, pos, static_cast<long>(ahead.tellg()));
+      unsigned records = 0;
+      while (strm >> rod)
+      {
+         TUASSERT(static_cast<bool>(ahead >> aheadRod));
+         if (!ahead)
+            break;
+         records++;
+         TUASSERTE(CommonTime, rod.time, aheadRod.time);
+         TUASSERTE(short, rod.numSVs, aheadRod.numSVs);
+         TUASSERTE(size_t, rod.obs.size(), aheadRod.obs.size());
+         TUASSERTE(unsigned, strm.lineNumber, ahead.lineNumber);
+      }
+      TUASSERT(records > 0);
+      TUASSERT(!(ahead >> aheadRod));
+      TUASSERT(ahead.eof());
+      TURETURN();
+   }
+
+      /// Errors report the same line and record either way.
+   unsigned readAheadErrorTest()
+   {
+      TUDEF("FFTextStream", "enableReadAhead");
+      string fn(dataDir + "test_input_rinex3_obs_BadEpochFlag.15o");
+      Rinex3ObsStream strm(fn), ahead(fn);
+      ahead.enableReadAhead(512);
+      string text, aheadText;
+      Rinex3ObsData rod;
+      try
+      {
+         while (strm >> rod);
+      }
+      catch (...)
+      {
+      }
+      try
+      {
+         while (ahead >> rod);
+      }
+      catch (...)
+      {
+      }
+      text = strm.mostRecentException.getText();
+      aheadText = ahead.mostRecentException.getText();
+      TUASSERT(!text.empty());
+      TUASSERTE(string, text, aheadText);
+      TUASSERTE(unsigned, strm.lineNumber, ahead.lineNumber);
+      TUASSERTE(unsigned, strm.recordNumber, ahead.recordNumber);
+      TURETURN();
+   }
+
+private:
+   string dataDir;
+};
+
+
+int main()
+{
+   unsigned errorTotal = 0;
+   FFTextStream_T testClass;
+
+   errorTotal += testClass.readAheadLineTest();
+   errorTotal += testClass.readAheadNavTest();
+   errorTotal += testClass.readAheadObsTest();
+   errorTotal += testClass.readAheadErrorTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal;
+}
@@ -0,0 +1,105 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/** @file Rinex3ObsBench.cpp
+ * Compare the time taken to read RINEX 3 observation files through
+ * the stream and through a memory mapping.
+ *
+ * Usage: Rinex3ObsBench file [file ...]
+ */
+
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include "Rinex3ObsStream.hpp"
+#include "Rinex3ObsHeader.hpp"
+#include "Rinex3ObsData.hpp"
+
+using namespace std;
+
+/// Read every record of \a fn, returning the number of observations.
+unsigned long readFile(const string& fn, bool mapped)
+{
+   gpstk::Rinex3ObsStream strm(fn);
+   gpstk::Rinex3ObsHeader hdr;
+   gpstk::Rinex3ObsData rod;
+   unsigned long count = 0;
+   strm.memoryMapped = mapped;
+   strm >> hdr;
+   while (strm >> rod)
+   {
+      gpstk::Rinex3ObsData::DataMap::const_iterator i;
+      for (i = rod.obs.begin(); i != rod.obs.end(); ++i)
+         count += i->second.size();
+   }
+   return count;
+}
+
+
+int main(int argc, char *argv[])
+{
+   if (argc < 2)
+   {
+      cerr << "Usage: " << argv[0] << " file [file ...]" << endl;
+      return 1;
+   }
+   try
+   {
+      for (int arg = 1; arg < argc; arg++)
+      {
+         for (int mapped = 0; mapped < 2; mapped++)
+         {
+            auto start = chrono::steady_clock::now();
+            unsigned long count = readFile(argv[arg], mapped);
+            chrono::duration<double> elapsed =
+               chrono::steady_clock::now() - start;
+            cout << argv[arg] << (mapped ? "  mapped  " : "  stream  ")
+                 << setw(10) << count << " obs  " << fixed
+                 << setprecision(3) << elapsed.count() << " s  "
+                 << setprecision(0) << count / elapsed.count() << " obs/s"
+                 << endl;
+         }
+      }
+   }
+   catch (gpstk::Exception& exc)
+   {
+      cerr << exc << endl;
+      return 1;
+   }
+   return 0;
+}
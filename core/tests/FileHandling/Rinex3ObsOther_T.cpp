@@ -64,6 +64,11 @@ public:
       /** Make sure that ionospheric delay pseudo-observables are
        * written to the file correctly. */
    unsigned ionoDelayTest();
+      /** Make sure that reading through a memory-mapped file yields
+       * exactly the same records as reading through the stream. */
+   unsigned memoryMappedTest();
+      /// Read \a fn both ways and compare every record.
+   void compareMapped(gpstk::TestUtil& testFramework, const std::string& fn);
       /// generic filling of generic data.
    void setObs(gpstk::TestUtil& testFramework, const std::string& system,
                gpstk::Rinex3ObsHeader& hdr, gpstk::Rinex3ObsData& rod);
@@ -595,6 +600,75 @@ fillHeader304(gpstk::Rinex3ObsHeader& hdr)
 }
 
 
+void Rinex3ObsOther_T ::
+compareMapped(gpstk::TestUtil& testFramework, const std::string& fn)
+{
+   gpstk::Rinex3ObsStream strm(fn), mstrm(fn);
+   gpstk::Rinex3ObsHeader hdr, mhdr;
+   gpstk::Rinex3ObsData rod, mrod;
+   unsigned records = 0;
+   mstrm.memoryMapped = true;
+   strm >> hdr;
+   mstrm >> mhdr;
+   while (strm >> rod)
+   {
+      TUASSERT(static_cast<bool>(mstrm >> mrod));
+      if (!mstrm)
+         break;
+      records++;
+      TUASSERTE(gpstk::CommonTime, rod.time, mrod.time);
+      TUASSERTE(short, rod.epochFlag, mrod.epochFlag);
+      TUASSERTE(short, rod.numSVs, mrod.numSVs);
+      TUASSERTE(double, rod.clockOffset, mrod.clockOffset);
+      TUASSERTE(size_t, rod.obs.size(), mrod.obs.size());
+      TUASSERTE(unsigned, strm.lineNumber, mstrm.lineNumber);
+      gpstk::Rinex3ObsData::DataMap::const_iterator i, mi;
+      for (i = rod.obs.begin(), mi = mrod.obs.begin();
+           (i != rod.obs.end()) && (mi != mrod.obs.end()); ++i, ++mi)
+      {
+         TUASSERTE(gpstk::RinexSatID, i->first, mi->first);
+         TUASSERTE(size_t, i->second.size(), mi->second.size());
+         for (unsigned j = 0; j < i->second.size(); j++)
+         {
+            const gpstk::RinexDatum &d(i->second[j]), &md(mi->second[j]);
+            TUASSERTE(double, d.data, md.data);
+            TUASSERTE(short, d.lli, md.lli);
+            TUASSERTE(short, d.ssi, md.ssi);
+            TUASSERTE(bool, d.dataBlank, md.dataBlank);
+            TUASSERTE(bool, d.lliBlank, md.lliBlank);
+            TUASSERTE(bool, d.ssiBlank, md.ssiBlank);
+         }
+      }
+   }
+   TUASSERT(records > 0);
+      // both streams should be at the end of the file now
+   TUASSERT(!(mstrm >> mrod));
+   TUASSERT(mstrm.eof());
+}
+
+
+unsigned Rinex3ObsOther_T ::
+memoryMappedTest()
+{
+   TUDEF("Rinex3ObsData", "reallyGetRecordMapped");
+   std::string dataDir = gpstk::getPathData() + gpstk::getFileSep();
+   compareMapped(testFramework, dataDir + "test_input_rinex3_76193040.14o");
+   compareMapped(testFramework,
+                 dataDir + "test_input_rinex3_obs_RinexObsFile.15o");
+   compareMapped(testFramework,
+                 dataDir + "test_input_rinex3_obs_FilterTest1.15o");
+
+      // errors should be reported the same way in either mode
+   gpstk::Rinex3ObsStream strm(dataDir +
+                               "test_input_rinex3_obs_BadEpochFlag.15o");
+   gpstk::Rinex3ObsData rod;
+   strm.memoryMapped = true;
+   strm.exceptions(std::fstream::failbit);
+   TUTHROW(while (strm >> rod) {});
+   TURETURN();
+}
+
+
 int main()
 {
    unsigned errorTotal = 0;
@@ -604,6 +678,7 @@ int main()
    errorTotal += testClass.channelNumTest();
    errorTotal += testClass.ionoDelayTest();
    errorTotal += testClass.obsIDVersionTest();
+   errorTotal += testClass.memoryMappedTest();
    cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
    return errorTotal;
 }
@@ -0,0 +1,146 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+
+/** @file PositionBatchBench.cpp
+ * Compare the time taken to convert a grid of points between
+ * Cartesian and geodetic coordinates with Position and with
+ * PositionBatch.
+ *
+ * Usage: PositionBatchBench [number of points]
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include "Position.hpp"
+#include "PositionBatch.hpp"
+#include "WGS84Ellipsoid.hpp"
+
+using namespace std;
+
+/// Print the time taken by one method, and the rate.
+void report(const string& label, size_t n,
+            const chrono::steady_clock::time_point& start)
+{
+   chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+   cout << setw(45) << left << label << right << fixed
+        << setprecision(3) << elapsed.count() << " s  "
+        << setprecision(0) << n / elapsed.count() << " points/s" << endl;
+}
+
+
+int main(int argc, char *argv[])
+{
+   size_t n = (argc > 1 ? strtoul(argv[1], 0, 10) : 1000000);
+   if (n == 0)
+   {
+      cerr << "Usage: " << argv[0] << " [number of points]" << endl;
+      return 1;
+   }
+   gpstk::WGS84Ellipsoid ell;
+   gpstk::PositionBatch batch(ell);
+
+      // points from below the surface out to GNSS orbits
+   vector<double> llh(3*n), xyz(3*n), out(3*n);
+   for (size_t i = 0; i < n; i++)
+   {
+      llh[3*i] = -90. + 180. * ((i * 7919) % 100003) / 100003.;
+      llh[3*i+1] = 360. * ((i * 104729) % 99991) / 99991.;
+      llh[3*i+2] = -1000. + 2.e7 * ((i * 15485863) % 99989) / 99989.;
+   }
+   batch.convertGeodeticToCartesian(&llh[0], &xyz[0], n);
+   cout << n << " points" << endl;
+
+   double sum = 0;
+   chrono::steady_clock::time_point start = chrono::steady_clock::now();
+   for (size_t i = 0; i < n; i++)
+   {
+      gpstk::Position pos(xyz[3*i], xyz[3*i+1], xyz[3*i+2],
+                          gpstk::Position::Cartesian, &ell);
+      pos.transformTo(gpstk::Position::Geodetic);
+      sum += pos.getHeight();
+   }
+   report("Position::transformTo(Geodetic)", n, start);
+
+   start = chrono::steady_clock::now();
+   for (size_t i = 0; i < n; i++)
+   {
+      gpstk::Triple in(xyz[3*i], xyz[3*i+1], xyz[3*i+2]), res;
+      gpstk::Position::convertCartesianToGeodetic(in, res, ell.a(),
+                                                  ell.eccSquared());
+      sum += res[2];
+   }
+   report("Position::convertCartesianToGeodetic", n, start);
+
+   start = chrono::steady_clock::now();
+   batch.convertCartesianToGeodetic(&xyz[0], &out[0], n);
+   report("PositionBatch::convertCartesianToGeodetic", n, start);
+
+   start = chrono::steady_clock::now();
+   for (size_t i = 0; i < n; i++)
+   {
+      gpstk::Triple in(llh[3*i], llh[3*i+1], llh[3*i+2]), res;
+      gpstk::Position::convertGeodeticToCartesian(in, res, ell.a(),
+                                                  ell.eccSquared());
+      sum += res[2];
+   }
+   report("Position::convertGeodeticToCartesian", n, start);
+
+   start = chrono::steady_clock::now();
+   batch.convertGeodeticToCartesian(&llh[0], &out[0], n);
+   report("PositionBatch::convertGeodeticToCartesian", n, start);
+
+   start = chrono::steady_clock::now();
+   for (size_t i = 0; i < n; i++)
+   {
+      gpstk::Triple in(xyz[3*i], xyz[3*i+1], xyz[3*i+2]), res;
+      gpstk::Position::convertCartesianToGeocentric(in, res);
+      sum += res[2];
+   }
+   report("Position::convertCartesianToGeocentric", n, start);
+
+   start = chrono::steady_clock::now();
+   gpstk::PositionBatch::convertCartesianToGeocentric(&xyz[0], &out[0], n);
+   report("PositionBatch::convertCartesianToGeocentric", n, start);
+
+      // keep the Position loops from being optimized away
+   return (sum == 0.25 ? 2 : 0);
+}
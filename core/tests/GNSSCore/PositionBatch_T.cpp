@@ -0,0 +1,252 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+
+#include <cmath>
+#include <vector>
+#include "PositionBatch.hpp"
+#include "Position.hpp"
+#include "WGS84Ellipsoid.hpp"
+#include "GPSEllipsoid.hpp"
+#include "PZ90Ellipsoid.hpp"
+#include "GalileoEllipsoid.hpp"
+#include "CGCS2000Ellipsoid.hpp"
+#include "TestUtil.hpp"
+
+using namespace std;
+
+class PositionBatch_T
+{
+public:
+      /// A grid of geodetic lat, lon, height, including the poles.
+   static vector<double> makeGrid()
+   {
+      static const double hts[] = { -30000., -1000., 0., 250.,
+                                    20000., 4.e5, 2.02e7, 3.6e7 };
+      vector<double> llh;
+      for (double lat = -90.; lat <= 90.; lat += 7.5)
+         for (double lon = 0.; lon < 360.; lon += 23.)
+            for (unsigned k = 0; k < sizeof(hts)/sizeof(hts[0]); k++)
+            {
+               llh.push_back(lat);
+               llh.push_back(lon);
+               llh.push_back(hts[k]);
+            }
+      return llh;
+   }
+
+      /// Count geodetic triples differing by more than tol meters.
+   static unsigned compareLLH(const double *llh, const gpstk::Triple& ref,
+                              double tol)
+   {
+      unsigned nbad = 0;
+         // degrees of latitude to meters, roughly
+      if (fabs(llh[0] - ref[0]) * 111200. > tol) nbad++;
+      if (fabs(ref[0]) < 90. - 1.e-9)
+      {
+         double dlon = fabs(llh[1] - ref[1]);
+         if (dlon > 180.) dlon = 360. - dlon;
+         if (dlon * 111200. * cos(ref[0] * gpstk::DEG_TO_RAD) > tol) nbad++;
+      }
+      if (fabs(llh[2] - ref[2]) > tol) nbad++;
+      return nbad;
+   }
+
+   unsigned geodeticTest(const gpstk::EllipsoidModel& ell)
+   {
+      TUDEF("PositionBatch", "convertCartesianToGeodetic");
+      gpstk::PositionBatch batch(ell);
+      TUASSERTFE(ell.a(), batch.a());
+      TUASSERTFE(ell.eccSquared(), batch.eccSquared());
+
+      vector<double> llh(makeGrid()), xyz(llh.size()), back(llh.size());
+      size_t n = llh.size() / 3;
+      batch.convertGeodeticToCartesian(&llh[0], &xyz[0], n);
+      batch.convertCartesianToGeodetic(&xyz[0], &back[0], n);
+
+      unsigned nbadXYZ = 0, nbadLLH = 0, nbadTrip = 0;
+      for (size_t i = 0; i < n; i++)
+      {
+         gpstk::Triple inLLH(llh[3*i], llh[3*i+1], llh[3*i+2]), refXYZ;
+         gpstk::Position::convertGeodeticToCartesian(inLLH, refXYZ, ell.a(),
+                                                     ell.eccSquared());
+         for (int k = 0; k < 3; k++)
+            if (fabs(refXYZ[k] - xyz[3*i+k]) > 1.e-8) nbadXYZ++;
+
+         gpstk::Triple inXYZ(xyz[3*i], xyz[3*i+1], xyz[3*i+2]), refLLH;
+         gpstk::Position::convertCartesianToGeodetic(inXYZ, refLLH, ell.a(),
+                                                     ell.eccSquared());
+            // Position iterates to a tolerance of 1e-4 m
+         nbadLLH += compareLLH(&back[3*i], refLLH, 1.e-4);
+            // the round trip is limited by DEG_TO_RAD*RAD_TO_DEG != 1
+         nbadTrip += compareLLH(&back[3*i], inLLH, 1.e-6);
+      }
+      TUASSERTE(unsigned, 0, nbadXYZ);
+      TUASSERTE(unsigned, 0, nbadLLH);
+      TUASSERTE(unsigned, 0, nbadTrip);
+
+         // in place gives the same answer
+      vector<double> inplace(xyz);
+      batch.convertCartesianToGeodetic(&inplace[0], &inplace[0], n);
+      TUASSERT(inplace == back);
+      inplace = llh;
+      batch.convertGeodeticToCartesian(&inplace[0], &inplace[0], n);
+      TUASSERT(inplace == xyz);
+      TURETURN();
+   }
+
+   unsigned geocentricTest(const gpstk::EllipsoidModel& ell)
+   {
+      TUDEF("PositionBatch", "convertGeodeticToGeocentric");
+      gpstk::PositionBatch batch(ell);
+
+      vector<double> llh(makeGrid()), llr(llh.size()), back(llh.size()),
+         xyz(llh.size()), llr2(llh.size());
+      size_t n = llh.size() / 3;
+      batch.convertGeodeticToGeocentric(&llh[0], &llr[0], n);
+      batch.convertGeocentricToGeodetic(&llr[0], &back[0], n);
+      batch.convertGeocentricToCartesian(&llr[0], &xyz[0], n);
+      gpstk::PositionBatch::convertCartesianToGeocentric(&xyz[0], &llr2[0], n);
+
+      unsigned nbadLLR = 0, nbadLLH = 0, nbadXYZ = 0, nbadLLR2 = 0;
+      for (size_t i = 0; i < n; i++)
+      {
+         gpstk::Triple inLLH(llh[3*i], llh[3*i+1], llh[3*i+2]), refLLR;
+         gpstk::Position::convertGeodeticToGeocentric(inLLH, refLLR, ell.a(),
+                                                      ell.eccSquared());
+            // geocentric radius plays the role of height
+         nbadLLR += compareLLH(&llr[3*i], refLLR, 1.e-6);
+
+         gpstk::Triple inLLR(llr[3*i], llr[3*i+1], llr[3*i+2]), refLLH,
+            refXYZ, refLLR2;
+         gpstk::Position::convertGeocentricToGeodetic(inLLR, refLLH, ell.a(),
+                                                      ell.eccSquared());
+         nbadLLH += compareLLH(&back[3*i], refLLH, 1.e-4);
+
+            // Position goes through theta = 90-lat, so the precision
+            // of DEG_TO_RAD shows at the 1e-14 level
+         gpstk::Position::convertGeocentricToCartesian(inLLR, refXYZ);
+         for (int k = 0; k < 3; k++)
+            if (fabs(refXYZ[k] - xyz[3*i+k]) > 1.e-13*llr[3*i+2]) nbadXYZ++;
+
+         gpstk::Position::convertCartesianToGeocentric(refXYZ, refLLR2);
+         nbadLLR2 += compareLLH(&llr2[3*i], refLLR2, 1.e-6);
+      }
+      TUASSERTE(unsigned, 0, nbadLLR);
+      TUASSERTE(unsigned, 0, nbadLLH);
+      TUASSERTE(unsigned, 0, nbadXYZ);
+      TUASSERTE(unsigned, 0, nbadLLR2);
+      TURETURN();
+   }
+
+      /// The poles and the center of the Earth are handled as in Position.
+   unsigned specialTest()
+   {
+      TUDEF("PositionBatch", "convertCartesianToGeodetic");
+      gpstk::WGS84Ellipsoid ell;
+      gpstk::PositionBatch batch(ell);
+      double B = ell.a() * sqrt(1. - ell.eccSquared());
+      double xyz[] = { 0., 0., 0.,
+                       0., 0., 6400000.,
+                       0., 0., -6300000.,
+                       1.e-6, 0., 7000000.,
+                       1000., 2000., -3000. };
+      size_t n = sizeof(xyz) / sizeof(xyz[0]) / 3;
+      double llh[15], llr[15];
+      batch.convertCartesianToGeodetic(xyz, llh, n);
+      gpstk::PositionBatch::convertCartesianToGeocentric(xyz, llr, n);
+      for (size_t i = 0; i < n; i++)
+      {
+         gpstk::Triple in(xyz[3*i], xyz[3*i+1], xyz[3*i+2]), refLLH, refLLR;
+         gpstk::Position::convertCartesianToGeodetic(in, refLLH, ell.a(),
+                                                     ell.eccSquared());
+         gpstk::Position::convertCartesianToGeocentric(in, refLLR);
+         for (int k = 0; k < 3; k++)
+         {
+            TUASSERTFEPS(refLLH[k], llh[3*i+k], 1.e-6);
+            TUASSERTFEPS(refLLR[k], llr[3*i+k], 1.e-6);
+         }
+      }
+      TUASSERTFE(-90., llh[0]);
+      TUASSERTFEPS(-B, llh[2], 1.e-6);
+      TUASSERTFE(90., llh[3]);
+      TUASSERTFEPS(6400000. - B, llh[5], 1.e-6);
+      TUASSERTFE(-90., llh[6]);
+      TUASSERTFE(0., llr[0]);
+      TUASSERTFE(0., llr[2]);
+
+      double llh2[] = { 90., 45., 100.,
+                        -90., 0., 0. };
+      double llr2[6];
+      batch.convertGeodeticToGeocentric(llh2, llr2, 2);
+      TUASSERTFE(90., llr2[0]);
+      TUASSERTFE(0., llr2[1]);
+      TUASSERTFEPS(B + 100., llr2[2], 1.e-6);
+      TUASSERTFE(-90., llr2[3]);
+      batch.convertGeocentricToGeodetic(llr2, llh2, 2);
+      TUASSERTFE(90., llh2[0]);
+      TUASSERTFEPS(100., llh2[2], 1.e-6);
+      TUASSERTFE(-90., llh2[3]);
+      TUASSERTFEPS(0., llh2[5], 1.e-6);
+      TURETURN();
+   }
+};
+
+
+int main()
+{
+   unsigned errorTotal = 0;
+   PositionBatch_T testClass;
+   gpstk::WGS84Ellipsoid wgs84;
+   gpstk::GPSEllipsoid gps;
+   gpstk::PZ90Ellipsoid pz90;
+   gpstk::GalileoEllipsoid galileo;
+   gpstk::CGCS2000Ellipsoid cgcs2000;
+   const gpstk::EllipsoidModel *ells[] = { &wgs84, &gps, &pz90, &galileo,
+                                           &cgcs2000 };
+
+   for (unsigned i = 0; i < sizeof(ells)/sizeof(ells[0]); i++)
+   {
+      errorTotal += testClass.geodeticTest(*ells[i]);
+      errorTotal += testClass.geocentricTest(*ells[i]);
+   }
+   errorTotal += testClass.specialTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+   return errorTotal;
+}
@@ -0,0 +1,401 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+#include "ChebyshevEphemerisStore.hpp"
+#include "SP3EphemerisStore.hpp"
+#include "build_config.h"
+#include "TestUtil.hpp"
+
+using namespace std;
+
+   /// An XvtStore that passes requests to another, except in a gap.
+class GapStore : public gpstk::XvtStore<gpstk::SatID>
+{
+public:
+   GapStore(const gpstk::XvtStore<gpstk::SatID>& r,
+            const gpstk::CommonTime& b, const gpstk::CommonTime& e)
+         : ref(r), gapBegin(b), gapEnd(e)
+   {}
+
+   gpstk::Xvt getXvt(const gpstk::SatID& id, const gpstk::CommonTime& t) const
+   {
+      if (t >= gapBegin && t < gapEnd)
+      {
+         gpstk::InvalidRequest e("In the gap");
+         GPSTK_THROW(e);
+      }
+      return ref.getXvt(id, t);
+   }
+   gpstk::Xvt computeXvt(const gpstk::SatID& id, const gpstk::CommonTime& t)
+      const throw()
+   {
+      gpstk::Xvt rv;
+      try { rv = getXvt(id, t); }
+      catch (gpstk::Exception&)
+      { rv.health = gpstk::Xvt::HealthStatus::Unavailable; }
+      return rv;
+   }
+   gpstk::Xvt::HealthStatus getSVHealth(const gpstk::SatID& id,
+                                        const gpstk::CommonTime& t)
+      const throw()
+   { return computeXvt(id, t).health; }
+   void dump(ostream& s, short detail) const
+   {}
+   void edit(const gpstk::CommonTime& tmin, const gpstk::CommonTime& tmax)
+   {}
+   void clear()
+   {}
+   gpstk::TimeSystem getTimeSystem() const
+   { return ref.getTimeSystem(); }
+   gpstk::CommonTime getInitialTime() const
+   { return ref.getInitialTime(); }
+   gpstk::CommonTime getFinalTime() const
+   { return ref.getFinalTime(); }
+   bool hasVelocity() const
+   { return ref.hasVelocity(); }
+   bool isPresent(const gpstk::SatID& id) const
+   { return ref.isPresent(id); }
+   set<gpstk::SatID> getIndexSet() const
+   { return ref.getIndexSet(); }
+
+private:
+   const gpstk::XvtStore<gpstk::SatID>& ref;
+   gpstk::CommonTime gapBegin, gapEnd;
+};
+
+class ChebyshevEphemerisStore_T
+{
+public:
+   ChebyshevEphemerisStore_T()
+   {
+      string dataFilePath = gpstk::getPathData();
+      string tempFilePath = gpstk::getPathTestTemp();
+      string fileSep = gpstk::getFileSep();
+
+      inputSP3Data = dataFilePath + fileSep +
+         "test_input_sp3_nav_ephemerisData.sp3";
+      outputCache = tempFilePath + fileSep +
+         "test_output_ChebyshevEphemerisStore.bin";
+   }
+
+      /** Fit an SP3 store and check that the series match the Lagrange
+       * interpolation within the reported bounds. */
+   unsigned fitTest()
+   {
+      TUDEF("ChebyshevEphemerisStore", "fit");
+      try
+      {
+         gpstk::SP3EphemerisStore sp3;
+         sp3.loadFile(inputSP3Data);
+         gpstk::ChebyshevEphemerisStore cheb;
+         TUTHROW(cheb.fit(sp3, 0.));
+         TUTHROW(cheb.fit(sp3, 3600., 0));
+         unsigned nseg = cheb.fit(sp3, 3600., 12);
+         TUASSERT(nseg > 0);
+         TUASSERTE(unsigned, nseg, cheb.numSegments());
+         TUASSERTE(unsigned, 12, cheb.getDegree());
+         TUASSERT(cheb.getTimeSystem() == sp3.getTimeSystem());
+
+            // the reported bounds; an hour of a GNSS orbit is smooth,
+            // the clocks in this file less so
+         TUASSERT(cheb.maxPositionError() < 1.e-3);
+         TUASSERT(cheb.maxVelocityError() < 1.e-5);
+         TUASSERT(cheb.maxClockError() < 2.e-8);
+
+            // and at other times, within the segments
+         vector<gpstk::SatID> sats(sp3.getSatList());
+         double posErr(0.0), clkErr(0.0);
+         unsigned nbad(0), ngood(0);
+         for (unsigned i = 0; i < sats.size(); i++)
+         {
+            const vector<gpstk::ChebyshevEphemerisStore::Segment>& segs(
+               cheb.getSegments(sats[i]));
+            for (unsigned k = 0; k < segs.size(); k++)
+            {
+               for (double dt = 13.7; dt < segs[k].length; dt += 611.)
+               {
+                  gpstk::CommonTime t(segs[k].begin + dt);
+                  gpstk::Xvt ref = sp3.getXvt(sats[i], t);
+                  gpstk::Xvt xvt = cheb.getXvt(sats[i], t);
+                  posErr = max(posErr, (ref.x - xvt.x).mag());
+                  clkErr = max(clkErr, fabs(ref.clkbias - xvt.clkbias));
+                  if (fabs(ref.relcorr - xvt.relcorr) > 1.e-12)
+                     nbad++;
+                  ngood++;
+               }
+            }
+         }
+         TUASSERT(ngood > 0);
+         TUASSERTE(unsigned, 0, nbad);
+         TUASSERT(posErr < 2. * cheb.maxPositionError() + 1.e-4);
+         TUASSERT(clkErr < 2. * cheb.maxClockError() + 1.e-12);
+
+            // requests outside the data
+         gpstk::SatID bogus(40, gpstk::SatelliteSystem::GPS);
+         TUTHROW(cheb.getXvt(bogus, sp3.getInitialTime()));
+         TUTHROW(cheb.getXvt(sats[0], sp3.getFinalTime() + 60.));
+         TUASSERTE(gpstk::Xvt::HealthStatus,
+                   gpstk::Xvt::HealthStatus::Unavailable,
+                   cheb.computeXvt(sats[0], sp3.getInitialTime() - 60.).health);
+         TUASSERTE(gpstk::Xvt::HealthStatus,
+                   gpstk::Xvt::HealthStatus::Unused,
+                   cheb.getSVHealth(sats[0], cheb.getInitialTime() + 60.));
+      }
+      catch (gpstk::Exception& e)
+      {
+         cerr << e << endl;
+         TUFAIL("Unexpected exception");
+      }
+      TURETURN();
+   }
+
+      /** Check that the series cover every time that the reference
+       * does, including the ends of the data, where the reference
+       * cannot be evaluated at the nodes of full segments. */
+   unsigned coverageTest()
+   {
+      TUDEF("ChebyshevEphemerisStore", "fit");
+      try
+      {
+         gpstk::SP3EphemerisStore sp3;
+         sp3.loadFile(inputSP3Data);
+         gpstk::ChebyshevEphemerisStore cheb;
+         cheb.fit(sp3, 5000., 12);
+         TUASSERT(cheb.maxPositionError() < 1.e-3);
+
+         vector<gpstk::SatID> sats(sp3.getSatList());
+         unsigned nmissing(0), nextra(0), ncovered(0), nends(0);
+         for (unsigned i = 0; i < sats.size(); i++)
+         {
+            gpstk::CommonTime first(gpstk::CommonTime::END_OF_TIME),
+               last(gpstk::CommonTime::BEGINNING_OF_TIME);
+            for (gpstk::CommonTime t = sp3.getInitialTime();
+                 t <= sp3.getFinalTime(); t += 97.)
+            {
+               bool inRef(true), inCheb(true);
+               try { sp3.getXvt(sats[i], t); }
+               catch (gpstk::InvalidRequest&) { inRef = false; }
+               try { cheb.getXvt(sats[i], t); }
+               catch (gpstk::InvalidRequest&) { inCheb = false; }
+               if (inRef && !inCheb)
+                  nmissing++;
+               else if (!inRef && inCheb)
+                  nextra++;
+               else if (inRef)
+               {
+                  ncovered++;
+                  if (t < first) first = t;
+                  last = t;
+               }
+            }
+               // the ends of the data are not at segment boundaries
+            if (ncovered > 0 &&
+                first > sp3.getInitialTime() && last < sp3.getFinalTime())
+            {
+               nends++;
+               gpstk::Xvt ref = sp3.getXvt(sats[i], first);
+               gpstk::Xvt xvt = cheb.getXvt(sats[i], first);
+               TUASSERT((ref.x - xvt.x).mag() < 1.e-3);
+               ref = sp3.getXvt(sats[i], last);
+               xvt = cheb.getXvt(sats[i], last);
+               TUASSERT((ref.x - xvt.x).mag() < 1.e-3);
+            }
+         }
+         TUASSERT(ncovered > 0);
+         TUASSERT(nends > 0);
+         TUASSERTE(unsigned, 0, nmissing);
+         TUASSERTE(unsigned, 0, nextra);
+      }
+      catch (gpstk::Exception& e)
+      {
+         cerr << e << endl;
+         TUFAIL("Unexpected exception");
+      }
+      TURETURN();
+   }
+
+      /** Check that a gap in the reference that falls between the
+       * nodes of a segment, but not between its check points, is
+       * also a gap in the series. */
+   unsigned gapTest()
+   {
+      TUDEF("ChebyshevEphemerisStore", "fit");
+      try
+      {
+         gpstk::SP3EphemerisStore sp3;
+         sp3.loadFile(inputSP3Data);
+            // for 3600 s segments of degree 12, nodes are near 1369 and
+            // 1800 s from the segment start, with a check point at 1583 s
+         gpstk::CommonTime gapBegin(sp3.getInitialTime() + 7200. + 1500.),
+            gapEnd(gapBegin + 150.);
+         GapStore ref(sp3, gapBegin, gapEnd);
+         gpstk::ChebyshevEphemerisStore cheb;
+         cheb.fit(ref, 3600., 12);
+         TUASSERT(cheb.maxPositionError() < 1.e-3);
+
+         vector<gpstk::SatID> sats(sp3.getSatList());
+         unsigned nmissing(0), nextra(0), ncovered(0);
+         for (unsigned i = 0; i < sats.size(); i++)
+         {
+            for (gpstk::CommonTime t = gapBegin - 300.; t < gapEnd + 300.;
+                 t += 7.)
+            {
+               bool inRef(true), inCheb(true);
+               try { ref.getXvt(sats[i], t); }
+               catch (gpstk::InvalidRequest&) { inRef = false; }
+               try { cheb.getXvt(sats[i], t); }
+               catch (gpstk::InvalidRequest&) { inCheb = false; }
+               if (inRef && !inCheb)
+                  nmissing++;
+               else if (!inRef && inCheb)
+                  nextra++;
+               else if (inRef)
+                  ncovered++;
+            }
+         }
+         TUASSERT(ncovered > 0);
+         TUASSERTE(unsigned, 0, nmissing);
+         TUASSERTE(unsigned, 0, nextra);
+      }
+      catch (gpstk::Exception& e)
+      {
+         cerr << e << endl;
+         TUFAIL("Unexpected exception");
+      }
+      TURETURN();
+   }
+
+      /// Check that the binary file reproduces the store exactly.
+   unsigned fileTest()
+   {
+      TUDEF("ChebyshevEphemerisStore", "saveFile");
+      try
+      {
+         gpstk::SP3EphemerisStore sp3;
+         sp3.loadFile(inputSP3Data);
+         gpstk::ChebyshevEphemerisStore cheb, copy;
+         cheb.fit(sp3, 1800., 9);
+         cheb.saveFile(outputCache);
+         TUCSM("loadFile");
+         copy.loadFile(outputCache);
+         TUASSERTE(unsigned, cheb.numSegments(), copy.numSegments());
+         TUASSERTE(unsigned, cheb.getDegree(), copy.getDegree());
+         TUASSERTE(gpstk::CommonTime, cheb.getInitialTime(),
+                   copy.getInitialTime());
+         TUASSERTE(gpstk::CommonTime, cheb.getFinalTime(), copy.getFinalTime());
+         TUASSERTE(double, cheb.maxPositionError(), copy.maxPositionError());
+
+         vector<gpstk::SatID> sats(sp3.getSatList());
+         unsigned nbad(0);
+         for (unsigned i = 0; i < sats.size(); i++)
+         {
+            for (gpstk::CommonTime t = cheb.getInitialTime();
+                 t < cheb.getFinalTime(); t += 977.)
+            {
+               gpstk::Xvt a = cheb.computeXvt(sats[i], t);
+               gpstk::Xvt b = copy.computeXvt(sats[i], t);
+               if (!(a.x == b.x) || !(a.v == b.v) || a.clkbias != b.clkbias ||
+                   a.health != b.health)
+                  nbad++;
+            }
+         }
+         TUASSERTE(unsigned, 0, nbad);
+
+            // bad files
+         TUTHROW(copy.loadFile(inputSP3Data));
+         TUTHROW(copy.loadFile(outputCache + ".missing"));
+         ifstream ifs(outputCache.c_str(), ios::binary);
+         ostringstream oss;
+         oss << ifs.rdbuf();
+         string truncated(outputCache + ".trunc");
+         ofstream ofs(truncated.c_str(), ios::binary);
+         ofs << oss.str().substr(0, oss.str().size() - 5);
+         ofs.close();
+         TUTHROW(copy.loadFile(truncated));
+            // a corrupt segment count must not be trusted
+         string corrupt(outputCache + ".count");
+         string bad(oss.str());
+         bad.replace(8 + 4*4 + 2*4, 4, "\xff\xff\xff\x7f");
+         ofs.open(corrupt.c_str(), ios::binary);
+         ofs << bad;
+         ofs.close();
+         TUTHROW(copy.loadFile(corrupt));
+            // a failed load leaves the store as it was
+         TUASSERTE(unsigned, cheb.numSegments(), copy.numSegments());
+
+         TUCSM("edit");
+         gpstk::CommonTime tmid(cheb.getInitialTime() + 7200.);
+         copy.edit(tmid, tmid + 3600.);
+         TUASSERT(copy.numSegments() < cheb.numSegments());
+         TUASSERT(copy.getInitialTime() <= tmid);
+         TUASSERT(copy.getFinalTime() >= tmid + 3600.);
+         copy.clear();
+         TUASSERTE(unsigned, 0, copy.numSegments());
+         TUTHROW(copy.getInitialTime());
+      }
+      catch (gpstk::Exception& e)
+      {
+         cerr << e << endl;
+         TUFAIL("Unexpected exception");
+      }
+      TURETURN();
+   }
+
+private:
+   string inputSP3Data;
+   string outputCache;
+};
+
+
+int main()
+{
+   unsigned errorTotal = 0;
+   ChebyshevEphemerisStore_T testClass;
+
+   errorTotal += testClass.fitTest();
+   errorTotal += testClass.coverageTest();
+   errorTotal += testClass.gapTest();
+   errorTotal += testClass.fileTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+   return errorTotal;
+}
@@ -178,6 +178,32 @@ public:
       testFramework.assert(gpstk::EngNav::checkParity(subframe3P, false),
                            testMesg, __LINE__);
 
+         // batch check of good and corrupted subframes, more than
+         // one block's worth
+      const uint32_t *good[3] = { subframe1P, subframe2P, subframe3P };
+      uint32_t sfs[40][10];
+      const uint32_t *sfp[40];
+      for (unsigned i = 0; i < 40; i++)
+      {
+         for (unsigned w = 0; w < 10; w++)
+            sfs[i][w] = good[i % 3][w];
+         if (i % 4 == 1)
+            sfs[i][i % 10] ^= 1 << (i % 30);
+         sfp[i] = sfs[i];
+      }
+      bool ok[40];
+      for (int upright = 1; upright >= 0; upright--)
+      {
+         gpstk::EngNav::checkParity(sfp, 40, ok, upright);
+         for (unsigned i = 0; i < 40; i++)
+         {
+            TUASSERTE(bool, gpstk::EngNav::checkParity(sfs[i], upright),
+                      ok[i]);
+         }
+      }
+      TUASSERT(!ok[1]);
+      TUASSERT(ok[2]);
+
       TURETURN();
    }
 
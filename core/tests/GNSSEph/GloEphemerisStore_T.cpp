@@ -36,8 +36,12 @@
 //
 //==============================================================================
 
+#include <algorithm>
+#include <fstream>
+#include <sstream>
 #include "Exception.hpp"
 #include "GloEphemerisStore.hpp"
+#include "Rinex3EphemerisStore.hpp"
 #include "CivilTime.hpp"
 #include "TimeString.hpp"
 #include "TestUtil.hpp"
@@ -61,6 +65,8 @@ class OrbElemStore_T
 {
 public:
    std::string inputRN3Data;
+   std::string inputGalData;
+   std::string snapshotFile;
 
    OrbElemStore_T()
    {
@@ -69,6 +75,8 @@ public:
       std::string fileSep = gpstk::getFileSep();
 
       inputRN3Data = dataFilePath + fileSep + "mixed.06n";
+      inputGalData = dataFilePath + fileSep + "test_input_rinex3_nav_gal.20n";
+      snapshotFile = tempFilePath + fileSep + "test_output_Rinex3Eph.snap";
    }
 
 
@@ -197,6 +205,170 @@ public:
    }
 
 
+      /** Check that svXvt() continuing from the integration
+       * checkpoints gives exactly the results of integrating from
+       * the ephemeris epoch, for requests in any order. */
+   unsigned integrationCacheTest()
+   {
+      TUDEF("GloEphemeris", "svXvt");
+      try
+      {
+         gpstk::GloEphemerisStore store;
+         gpstk::Rinex3NavData nd = loadNav(store, testFramework, false);
+         const gpstk::GloEphemeris& eph = store.findEphemeris(nd.sat, nd.time);
+         gpstk::CommonTime toe(eph.getEphemerisEpoch());
+
+         vector<double> offsets;
+         for (double dt = -899.75; dt < 900.; dt += 7.25)
+            offsets.push_back(dt);
+         for (int k = -28; k <= 28; k++)
+            offsets.push_back(32. * k);           // on the checkpoints
+         offsets.push_back(32. + 5.e-10);         // within tolerance of one
+         offsets.push_back(-64. - 5.e-10);
+            // ascending, descending and scattered
+         vector<double> order(offsets);
+         sort(order.begin(), order.end());
+         for (int i = order.size()-1; i >= 0; i--)
+            order.push_back(order[i]);
+         for (size_t i = 0; i < offsets.size(); i++)
+            order.push_back(offsets[(i * 97) % offsets.size()]);
+
+         unsigned nbad = 0;
+         for (size_t i = 0; i < order.size(); i++)
+         {
+            gpstk::CommonTime t(toe + order[i]);
+            gpstk::Xvt cached = store.getXvt(nd.sat, t);
+            gpstk::GloEphemeris fresh(eph);      // copies start empty
+            gpstk::Xvt ref = fresh.svXvt(t);
+            if (!(cached.x == ref.x) || !(cached.v == ref.v) ||
+                cached.clkbias != ref.clkbias)
+               nbad++;
+         }
+         TUASSERTE(unsigned, 0, nbad);
+
+            // changing the data discards the checkpoints
+         gpstk::GloEphemeris changed(eph);
+         changed.svXvt(toe + 600.);
+         changed.setRecord(eph.getSatSys(), eph.getPRNID(), toe,
+                           eph.x + gpstk::Triple(0.1, 0., 0.), eph.v,
+                           eph.getAcc(), eph.getTauN(), eph.getGammaN(),
+                           eph.getMFtime(), eph.getHealth(), eph.getfreqNum(),
+                           eph.getAgeOfInfo());
+         gpstk::GloEphemeris fresh(changed);
+         gpstk::Xvt a = changed.svXvt(toe + 700.), b = fresh.svXvt(toe + 700.);
+         TUASSERT(a.x == b.x);
+         TUASSERT(a.v == b.v);
+      }
+      catch (gpstk::Exception &exc)
+      {
+         cerr << exc << endl;
+         TUFAIL("Unexpected exception");
+      }
+      TURETURN();
+   }
+
+
+      /** Check that a store restored from a snapshot is identical to
+       * the one that was saved, and that bad snapshots are refused. */
+   unsigned snapshotTest()
+   {
+      TUDEF("Rinex3EphemerisStore", "saveSnapshot");
+      try
+      {
+         gpstk::Rinex3EphemerisStore store;
+         TUASSERT(store.loadFile(inputRN3Data) > 0);
+            // add the Galileo data record by record, as loadFile()
+            // stops at the first bad record
+         gpstk::Rinex3NavStream ns(inputGalData.c_str());
+         gpstk::Rinex3NavHeader nh;
+         gpstk::Rinex3NavData nd;
+         ns >> nh;
+         store.addFile(inputGalData, nh);
+         while (ns >> nd)
+            store.addEphemeris(nd);
+         TUASSERT(store.size(gpstk::SatID(-1, gpstk::SatelliteSystem::Galileo))
+                  > 0);
+         store.setGLOStep(10.);
+         TUCATCH(store.saveSnapshot(snapshotFile));
+
+         TUCSM("loadSnapshot");
+         gpstk::Rinex3EphemerisStore copy;
+         TUCATCH(copy.loadSnapshot(snapshotFile));
+         ostringstream s1, s2;
+         store.dump(s1, 2);
+         copy.dump(s2, 2);
+         TUASSERTE(std::string, s1.str(), s2.str());
+         TUASSERTE(double, 10., copy.getGLOStep());
+
+            // positions from every ephemeris must match exactly
+         std::set<gpstk::SatID> sats(store.getIndexSet());
+         TUASSERT(sats == copy.getIndexSet());
+         unsigned nbad = 0, ngood = 0;
+         for (std::set<gpstk::SatID>::const_iterator si = sats.begin();
+              si != sats.end(); ++si)
+         {
+            gpstk::CommonTime t(store.getInitialTime(*si));
+            gpstk::CommonTime tEnd(store.getFinalTime(*si));
+            for (; t <= tEnd; t += 1800.)
+            {
+               gpstk::Xvt a, b;
+               bool okA = true, okB = true;
+               try { a = store.getXvt(*si, t); }
+               catch (gpstk::InvalidRequest&) { okA = false; }
+               try { b = copy.getXvt(*si, t); }
+               catch (gpstk::InvalidRequest&) { okB = false; }
+               if (okA != okB ||
+                   (okA && (!(a.x == b.x) || !(a.v == b.v) ||
+                            a.clkbias != b.clkbias || a.health != b.health)))
+                  nbad++;
+               else if (okA)
+                  ngood++;
+            }
+         }
+         TUASSERTE(unsigned, 0, nbad);
+         TUASSERT(ngood > 0);
+
+            // the GLONASS part alone is not the same kind of snapshot
+         gpstk::GloEphemerisStore glo;
+         TUTHROW(glo.loadSnapshot(snapshotFile));
+         TUASSERTE(unsigned, 0, glo.size());
+
+            // a damaged snapshot is refused and leaves the store as it was
+         std::string data;
+         {
+            ifstream ifs(snapshotFile.c_str(), ios::binary);
+            data.assign(istreambuf_iterator<char>(ifs),
+                        istreambuf_iterator<char>());
+         }
+         data[data.size()/2] ^= 0x10;
+         {
+            ofstream ofs(snapshotFile.c_str(), ios::binary);
+            ofs.write(data.data(), data.size());
+         }
+         TUTHROW(copy.loadSnapshot(snapshotFile));
+         ostringstream s3;
+         copy.dump(s3, 2);
+         TUASSERTE(std::string, s1.str(), s3.str());
+
+         try
+         {
+            copy.loadSnapshot(snapshotFile + ".missing");
+            TUFAIL("loadSnapshot of a missing file did not throw");
+         }
+         catch (gpstk::FileMissingException&)
+         {
+            TUPASS("FileMissingException");
+         }
+      }
+      catch (gpstk::Exception &exc)
+      {
+         cerr << exc << endl;
+         TUFAIL("Unexpected exception");
+      }
+      TURETURN();
+   }
+
+
    gpstk::Rinex3NavData loadNav(gpstk::GloEphemerisStore& store,
                                 gpstk::TestUtil& testFramework,
                                 bool firstOnly)
@@ -246,6 +418,8 @@ int main(int argc, char *argv[])
    total += testClass.doFindEphEmptyTests();
    total += testClass.computeXvtTest();
    total += testClass.getSVHealthTest();
+   total += testClass.integrationCacheTest();
+   total += testClass.snapshotTest();
 
    cout << "Total Failures for " << __FILE__ << ": " << total << endl;
    return total;
@@ -0,0 +1,211 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+#include <cmath>
+#include "OrbitEphBatch.hpp"
+#include "GPSWeekSecond.hpp"
+#include "GNSSconstants.hpp"
+#include "TestUtil.hpp"
+
+using namespace std;
+
+class OrbitEphBatch_T
+{
+public:
+      /** Make an OrbitEph with plausible elements for sat, with Toe
+       * at sow and eccentricity ecc. */
+   static gpstk::OrbitEph makeEph(const gpstk::SatID& sat, double sow,
+                                  double ecc, double A, double i0)
+   {
+      gpstk::OrbitEph eph;
+      eph.dataLoadedFlag = true;
+      eph.satID = sat;
+      eph.ctToe = gpstk::GPSWeekSecond(2000, sow);
+      eph.ctToc = eph.ctToe;
+      eph.beginValid = eph.ctToe - 7200.;
+      eph.endValid = eph.ctToe + 7200.;
+      eph.af0 = -1.2e-4 + 1.e-5 * sat.id;
+      eph.af1 = 3.4e-12;
+      eph.af2 = 1.e-19;
+      eph.M0 = 0.37 * sat.id - 2.;
+      eph.dn = 4.6e-9;
+      eph.dndot = 1.e-13;
+      eph.ecc = ecc;
+      eph.A = A;
+      eph.Adot = 0.01;
+      eph.OMEGA0 = 0.41 * sat.id - 3.;
+      eph.i0 = i0;
+      eph.w = -1.7 + 0.1 * sat.id;
+      eph.OMEGAdot = -8.2e-9;
+      eph.idot = 1.7e-10;
+      eph.Cuc = -3.1e-6;
+      eph.Cus = 8.3e-6;
+      eph.Crc = 180.;
+      eph.Crs = -56.4;
+      eph.Cic = 2.8e-7;
+      eph.Cis = -4.3e-8;
+      return eph;
+   }
+
+      /// Orbits of each supported kind, including eccentric ones.
+   static vector<gpstk::OrbitEph> makeOrbits()
+   {
+      vector<gpstk::OrbitEph> ephs;
+      for (int prn = 1; prn <= 11; prn++)
+      {
+         gpstk::SatID sat(prn, gpstk::SatelliteSystem::GPS);
+         ephs.push_back(makeEph(sat, 7200.*prn, 0.003*prn, 26559710., 0.96));
+      }
+         // Galileo E14/E18 are in orbits with e = 0.16
+      ephs.push_back(makeEph(gpstk::SatID(14, gpstk::SatelliteSystem::Galileo),
+                             14400., 0.16, 27977550., 0.87));
+      ephs.push_back(makeEph(gpstk::SatID(11, gpstk::SatelliteSystem::Galileo),
+                             21600., 0.0002, 29600318., 0.96));
+         // QZSS IGSO, BeiDou MEO and IGSO
+      ephs.push_back(makeEph(gpstk::SatID(1, gpstk::SatelliteSystem::QZSS),
+                             3600., 0.075, 42164200., 0.71));
+      ephs.push_back(makeEph(gpstk::SatID(11, gpstk::SatelliteSystem::BeiDou),
+                             0., 0.002, 27906100., 0.96));
+      ephs.push_back(makeEph(gpstk::SatID(7, gpstk::SatelliteSystem::BeiDou),
+                             0., 0.006, 42162200., 0.95));
+      return ephs;
+   }
+
+      /// Count results that differ from svXvt() beyond tolerance.
+   static unsigned compare(const gpstk::OrbitEph& eph, const gpstk::CommonTime& t,
+                           const gpstk::Xvt& xvt)
+   {
+      gpstk::Xvt ref = eph.svXvt(t);
+      unsigned nbad = 0;
+      for (int i = 0; i < 3; i++)
+      {
+         if (fabs(ref.x[i] - xvt.x[i]) > 1.e-4) nbad++;
+         if (fabs(ref.v[i] - xvt.v[i]) > 1.e-7) nbad++;
+      }
+      if (fabs(ref.clkbias - xvt.clkbias) > 1.e-16) nbad++;
+      if (fabs(ref.clkdrift - xvt.clkdrift) > 1.e-20) nbad++;
+      if (fabs(ref.relcorr - xvt.relcorr) > 1.e-14) nbad++;
+      if (ref.frame != xvt.frame) nbad++;
+      return nbad;
+   }
+
+   unsigned evaluateTest()
+   {
+      TUDEF("OrbitEphBatch", "evaluate");
+      try
+      {
+         vector<gpstk::OrbitEph> ephs(makeOrbits());
+         gpstk::OrbitEphBatch batch;
+         for (unsigned i = 0; i < ephs.size(); i++)
+            TUASSERTE(unsigned, i, batch.add(ephs[i]));
+         TUASSERTE(unsigned, ephs.size(), batch.size());
+
+            // every orbit at one time, over more than a day
+         gpstk::CommonTime t0(gpstk::GPSWeekSecond(2000, 0.));
+         vector<gpstk::Xvt> xvts;
+         unsigned nbad = 0;
+         for (double dt = -14400.; dt < 100000.; dt += 1234.5)
+         {
+            batch.evaluate(t0 + dt, xvts);
+            TUASSERTE(size_t, ephs.size(), xvts.size());
+            for (unsigned i = 0; i < ephs.size(); i++)
+               nbad += compare(ephs[i], t0 + dt, xvts[i]);
+         }
+         TUASSERTE(unsigned, 0, nbad);
+
+            // scattered (orbit, time) pairs, not a multiple of BLOCK
+         vector<unsigned> index;
+         vector<gpstk::CommonTime> times;
+         for (unsigned k = 0; k < 1003; k++)
+         {
+            index.push_back((k * 7) % ephs.size());
+            times.push_back(ephs[index.back()].ctToe + (k * 37.3 - 18000.));
+         }
+         batch.evaluate(index, times, xvts);
+         TUASSERTE(size_t, index.size(), xvts.size());
+         nbad = 0;
+         for (unsigned k = 0; k < index.size(); k++)
+            nbad += compare(ephs[index[k]], times[k], xvts[k]);
+         TUASSERTE(unsigned, 0, nbad);
+
+            // bad requests
+         index.push_back(ephs.size());
+         times.push_back(t0);
+         TUTHROW(batch.evaluate(index, times, xvts));
+         times.pop_back();
+         TUTHROW(batch.evaluate(index, times, xvts));
+
+         batch.clear();
+         TUASSERTE(unsigned, 0, batch.size());
+         batch.evaluate(t0, xvts);
+         TUASSERTE(size_t, 0, xvts.size());
+      }
+      catch (gpstk::Exception& e)
+      {
+         cerr << e << endl;
+         TUFAIL("Unexpected exception");
+      }
+      TURETURN();
+   }
+
+   unsigned addTest()
+   {
+      TUDEF("OrbitEphBatch", "add");
+      gpstk::OrbitEphBatch batch;
+      gpstk::OrbitEph empty;
+      TUTHROW(batch.add(empty));
+      gpstk::OrbitEph geo(makeEph(gpstk::SatID(3, gpstk::SatelliteSystem::BeiDou),
+                                  0., 0.0003, 42164200., 0.01));
+      TUTHROW(batch.add(geo));
+      TUASSERTE(unsigned, 0, batch.size());
+      TURETURN();
+   }
+};
+
+
+int main()
+{
+   unsigned errorTotal = 0;
+   OrbitEphBatch_T testClass;
+
+   errorTotal += testClass.addTest();
+   errorTotal += testClass.evaluateTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+   return errorTotal;
+}
@@ -41,6 +41,7 @@
 #include "TimeString.hpp"
 #include "TestUtil.hpp"
 #include "GPSWeekSecond.hpp"
+#include "GPSEphemerisStore.hpp"
 
 using namespace std;
 
@@ -241,6 +242,196 @@ public:
       }
       TURETURN();
    }    
+
+
+      /** Make an OrbitEph for sat with Toe at sow and the given
+       * validity half-width, with a plausible GPS orbit. */
+   static gpstk::OrbitEph makeEph(const gpstk::SatID& sat, double sow,
+                                  double halfFit)
+   {
+      gpstk::OrbitEph eph;
+      eph.dataLoadedFlag = true;
+      eph.satID = sat;
+      eph.obsID = gpstk::ObsID(gpstk::ObservationType::NavMsg,
+                               gpstk::CarrierBand::L1,
+                               gpstk::TrackingCode::CA);
+      eph.ctToe = gpstk::GPSWeekSecond(2000, sow);
+      eph.ctToc = eph.ctToe;
+      eph.beginValid = eph.ctToe - halfFit;
+      eph.endValid = eph.ctToe + halfFit;
+      eph.af0 = 1.e-5 * sat.id;
+      eph.af1 = 1.e-12;
+      eph.M0 = 0.1 * sat.id + sow * 1.e-5;
+      eph.ecc = 0.01;
+      eph.A = 26559710.;
+      eph.OMEGA0 = 0.3 * sat.id;
+      eph.i0 = 0.96;
+      eph.w = 0.5;
+      eph.OMEGAdot = -8.e-9;
+      return eph;
+   }
+
+
+      /** Check that getXvts() gives exactly what getXvt() does, for
+       * requests in various orders, with gaps and overlaps in the
+       * tables, and for both search methods. */
+   unsigned getXvtsTests()
+   {
+      TUDEF("OrbitEphStore","getXvts");
+      try
+      {
+         for (int near = 0; near < 2; near++)
+         {
+            gpstk::OrbitEphStore store;
+            if (near)
+               TUASSERT(store.SearchNear());
+            gpstk::SatID sat1(1, gpstk::SatelliteSystem::GPS);
+            gpstk::SatID sat2(7, gpstk::SatelliteSystem::GPS);
+            gpstk::SatID bogus(33, gpstk::SatelliteSystem::GPS);
+               // sat1: overlapping fits, a gap, then one more
+            for (int i = 0; i < 4; i++)
+            {
+               gpstk::OrbitEph eph(makeEph(sat1, 7200.*(i+1), 7200.));
+               store.addEphemeris(&eph);
+            }
+            gpstk::OrbitEph eph1(makeEph(sat1, 72000., 3600.));
+            store.addEphemeris(&eph1);
+               // sat2: short fits with gaps between
+            for (int i = 0; i < 5; i++)
+            {
+               gpstk::OrbitEph eph(makeEph(sat2, 14400.*(i+1), 3600.));
+               store.addEphemeris(&eph);
+            }
+
+            std::vector<gpstk::SatID> ids;
+            std::vector<gpstk::CommonTime> times;
+            gpstk::CommonTime t0(gpstk::GPSWeekSecond(2000, 0.));
+               // satellite-major, then time-major with reversals
+            for (double dt = -600.; dt < 86400.; dt += 450.)
+            {
+               ids.push_back(sat1);
+               times.push_back(t0 + dt);
+            }
+            for (double dt = -600.; dt < 86400.; dt += 900.)
+            {
+               ids.push_back(sat2);
+               times.push_back(t0 + dt);
+               ids.push_back(bogus);
+               times.push_back(t0 + dt);
+               ids.push_back(sat1);
+               times.push_back(t0 + 86400. - dt);
+            }
+               // exactly on the table keys
+            ids.push_back(sat1);
+            times.push_back(eph1.beginValid);
+            ids.push_back(sat1);
+            times.push_back(eph1.beginValid - 7200.);
+
+            std::vector<gpstk::Xvt> xvts;
+            std::vector<bool> valid;
+            unsigned nvalid = store.getXvts(ids, times, xvts, valid);
+            TUASSERTE(size_t, ids.size(), xvts.size());
+            TUASSERTE(size_t, ids.size(), valid.size());
+            unsigned nbad = 0, ngood = 0;
+            for (size_t i = 0; i < ids.size(); i++)
+            {
+               gpstk::Xvt xvt;
+               bool ok = true;
+               try
+               {
+                  xvt = store.getXvt(ids[i], times[i]);
+               }
+               catch (gpstk::InvalidRequest&)
+               {
+                  ok = false;
+               }
+               if (ok != valid[i])
+                  nbad++;
+               else if (!ok)
+               {
+                  if (xvts[i].health != gpstk::Xvt::HealthStatus::Unavailable)
+                     nbad++;
+               }
+               else if (!(xvt.x == xvts[i].x) || !(xvt.v == xvts[i].v) ||
+                        xvt.clkbias != xvts[i].clkbias ||
+                        xvt.health != xvts[i].health)
+                  nbad++;
+               else
+                  ngood++;
+            }
+            TUASSERTE(unsigned, 0, nbad);
+            TUASSERTE(unsigned, ngood, nvalid);
+            TUASSERT(ngood > 0);
+            TUASSERT(ngood < ids.size());
+
+            times.pop_back();
+            TUTHROW(store.getXvts(ids, times, xvts, valid));
+         }
+      }
+      catch (gpstk::Exception &exc)
+      {
+         cerr << exc << endl;
+         TUFAIL("Unexpected exception");
+      }
+      catch (...)
+      {
+         TUFAIL("Unexpected exception");
+      }
+      TURETURN();
+   }
+
+   unsigned snapshotTests()
+   {
+      TUDEF("OrbitEphStore","saveSnapshot");
+      try
+      {
+         std::string fn = gpstk::getPathTestTemp() + gpstk::getFileSep() +
+            "test_output_OrbitEphStore.snap";
+         gpstk::OrbitEphStore store;
+         TUASSERT(store.SearchNear());
+         store.setOnlyHealthyFlag(true);
+         gpstk::SatID sat1(1, gpstk::SatelliteSystem::GPS);
+         gpstk::SatID sat2(7, gpstk::SatelliteSystem::GPS);
+         for (int i = 0; i < 4; i++)
+         {
+            gpstk::OrbitEph eph1(makeEph(sat1, 7200.*(i+1), 7200.));
+            gpstk::OrbitEph eph2(makeEph(sat2, 14400.*(i+1), 3600.));
+            store.addEphemeris(&eph1);
+            store.addEphemeris(&eph2);
+         }
+         TUCATCH(store.saveSnapshot(fn));
+
+         TUCSM("loadSnapshot");
+         gpstk::OrbitEphStore copy;
+         TUCATCH(copy.loadSnapshot(fn));
+         TUASSERTE(unsigned, store.size(), copy.size());
+         TUASSERTE(gpstk::CommonTime, store.getInitialTime(),
+                   copy.getInitialTime());
+         TUASSERTE(gpstk::CommonTime, store.getFinalTime(),
+                   copy.getFinalTime());
+         TUASSERT(copy.getOnlyHealthyFlag());
+         gpstk::CommonTime t(gpstk::GPSWeekSecond(2000, 10000.));
+         TUASSERTE(gpstk::Triple, store.computeXvt(sat1, t).x,
+                   copy.computeXvt(sat1, t).x);
+         TUASSERTE(double, store.computeXvt(sat2, t).clkbias,
+                   copy.computeXvt(sat2, t).clkbias);
+
+            // snapshots are specific to the class of store
+         gpstk::GPSEphemerisStore gps;
+         TUTHROW(gps.loadSnapshot(fn));
+         TUASSERTE(unsigned, 0, gps.size());
+      }
+      catch (gpstk::Exception &exc)
+      {
+         cerr << exc << endl;
+         TUFAIL("Unexpected exception");
+      }
+      catch (...)
+      {
+         TUFAIL("Unexpected exception");
+      }
+      TURETURN();
+   }
 };
 
 
@@ -250,6 +441,8 @@ int main(int argc, char *argv[])
    OrbitEphStore_T testClass;
    total += testClass.doFindEphEmptyTests();
    total += testClass.basicTests();
+   total += testClass.getXvtsTests();
+   total += testClass.snapshotTests();
 
    cout << "Total Failures for " << __FILE__ << ": " << total << endl;
    return total;
@@ -0,0 +1,205 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/** @file PackedNavBitsBench.cpp
+ * Time the packing, decoding and comparison of LNAV and CNAV
+ * messages held in PackedNavBits.
+ *
+ * Usage: PackedNavBitsBench [messages]
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <set>
+#include <vector>
+#include "PackedNavBits.hpp"
+
+using namespace std;
+
+typedef vector<gpstk::PackedNavBits> MsgList;
+
+   /// Print the time taken for \a count operations of \a what.
+void report(const char *what, unsigned long count,
+            const chrono::steady_clock::time_point& start)
+{
+   chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+   cout << setw(16) << left << what << right << setw(10) << count
+        << " ops  " << fixed << setprecision(3) << elapsed.count() << " s  "
+        << setprecision(0) << count / elapsed.count() << " ops/s" << endl;
+}
+
+   /** Make \a n 300 bit messages of random content, in 30 bit words
+    * as LNAV is, with every eighth message a copy of the one before
+    * so that the comparisons find some matches. */
+MsgList makeMessages(unsigned n, unsigned seed)
+{
+   mt19937 gen(seed);
+   gpstk::SatID sat(1, gpstk::SatelliteSystem::GPS);
+   gpstk::ObsID obs(gpstk::ObservationType::NavMsg, gpstk::CarrierBand::L1,
+                    gpstk::TrackingCode::CA);
+   MsgList msgs;
+   msgs.reserve(n);
+   for (unsigned i = 0; i < n; i++)
+   {
+      if (i % 8 == 7)
+      {
+         msgs.push_back(msgs.back());
+         continue;
+      }
+      msgs.emplace_back(sat, obs, gpstk::CommonTime());
+      for (unsigned w = 0; w < 10; w++)
+         msgs.back().addUnsignedLong(gen() & 0x3FFFFFFF, 30, 1);
+      msgs.back().trimsize();
+   }
+   return msgs;
+}
+
+   /// Decode the fields of an LNAV subframe 2, some split across words.
+double decodeLNAV(const gpstk::PackedNavBits& msg)
+{
+   static const unsigned M0start[] = { 106, 120 }, M0num[] = { 8, 24 };
+   static const unsigned eStart[] = { 166, 180 }, eNum[] = { 8, 24 };
+   static const unsigned Astart[] = { 226, 240 }, Anum[] = { 8, 24 };
+   double sum = msg.asUnsignedLong(60, 8, 1);                // IODE
+   sum += msg.asSignedDouble(68, 16, -5);                    // Crs
+   sum += msg.asDoubleSemiCircles(90, 16, -43);              // dn
+   sum += msg.asDoubleSemiCircles(M0start, M0num, 2, -31);   // M0
+   sum += msg.asSignedDouble(150, 16, -29);                  // Cuc
+   sum += msg.asUnsignedDouble(eStart, eNum, 2, -33);        // ecc
+   sum += msg.asSignedDouble(210, 16, -29);                  // Cus
+   sum += msg.asUnsignedDouble(Astart, Anum, 2, -19);        // sqrtA
+   sum += msg.asUnsignedLong(270, 16, 16);                   // toe
+   sum += msg.asBool(286);                                   // fit interval
+   return sum;
+}
+
+   /// Decode the fields of a CNAV message type 10.
+double decodeCNAV(const gpstk::PackedNavBits& msg)
+{
+   double sum = msg.asUnsignedLong(38, 13, 1);               // WN
+   sum += msg.asUnsignedLong(51, 3, 1);                      // health
+   sum += msg.asUnsignedLong(54, 11, 300);                   // top
+   sum += msg.asLong(65, 5, 1);                              // URA
+   sum += msg.asUnsignedLong(70, 11, 300);                   // toe
+   sum += msg.asSignedDouble(81, 26, -9);                    // dA
+   sum += msg.asSignedDouble(107, 25, -21);                  // Adot
+   sum += msg.asDoubleSemiCircles(132, 17, -44);             // dn0
+   sum += msg.asDoubleSemiCircles(149, 23, -57);             // dn0dot
+   sum += msg.asDoubleSemiCircles(172, 33, -32);             // M0
+   sum += msg.asUnsignedDouble(205, 33, -34);                // e
+   sum += msg.asDoubleSemiCircles(238, 33, -32);             // w
+   return sum;
+}
+
+   /// Order messages by their bits only, for the set used by compare.
+struct BitsLess
+{
+   bool operator()(const gpstk::PackedNavBits* l,
+                   const gpstk::PackedNavBits* r) const
+   { return *l < *r; }
+};
+
+
+int main(int argc, char *argv[])
+{
+   unsigned n = (argc > 1 ? atoi(argv[1]) : 200000);
+   if (n < 2)
+   {
+      cerr << "Usage: " << argv[0] << " [messages]" << endl;
+      return 1;
+   }
+   try
+   {
+      const unsigned reps = 10;
+      double sum = 0.;
+      unsigned long count;
+
+      auto start = chrono::steady_clock::now();
+      MsgList msgs(makeMessages(n, 1));
+      report("pack", n, start);
+
+      start = chrono::steady_clock::now();
+      for (unsigned r = 0; r < reps; r++)
+         for (unsigned i = 0; i < n; i++)
+            sum += decodeLNAV(msgs[i]);
+      report("decode LNAV", (unsigned long)reps * n, start);
+
+      start = chrono::steady_clock::now();
+      for (unsigned r = 0; r < reps; r++)
+         for (unsigned i = 0; i < n; i++)
+            sum += decodeCNAV(msgs[i]);
+      report("decode CNAV", (unsigned long)reps * n, start);
+
+         // neighbours, as a filter comparing successive messages does
+      start = chrono::steady_clock::now();
+      count = 0;
+      for (unsigned r = 0; r < reps; r++)
+         for (unsigned i = 1; i < n; i++)
+            count += msgs[i].matchBits(msgs[i-1]);
+      report("matchBits", (unsigned long)reps * (n-1), start);
+      sum += count;
+
+      start = chrono::steady_clock::now();
+      count = 0;
+      for (unsigned r = 0; r < reps; r++)
+         for (unsigned i = 1; i < n; i++)
+            count += (msgs[i] == msgs[i-1]);
+      report("operator==", (unsigned long)reps * (n-1), start);
+      sum += count;
+
+         // the unique messages, as a filter voting on them does
+      start = chrono::steady_clock::now();
+      set<const gpstk::PackedNavBits*, BitsLess> unique;
+      for (unsigned i = 0; i < n; i++)
+         unique.insert(&msgs[i]);
+      report("operator< set", n, start);
+      sum += unique.size();
+
+         // keep the compiler from discarding the work
+      cout << "checksum " << setprecision(6) << sum << endl;
+   }
+   catch (gpstk::Exception& exc)
+   {
+      cerr << exc << endl;
+      return 1;
+   }
+   return 0;
+}
@@ -64,6 +64,7 @@ public:
    unsigned realDataTest();
    unsigned equalityTest();
    unsigned ancillaryMethods();
+   unsigned wordBoundaryTest();
 
    double eps; 
 };
@@ -836,6 +837,91 @@ ancillaryMethods()
    TURETURN();
 }
 
+   // The bits are stored in 64-bit words; check fields that start,
+   // end, and straddle word boundaries against a bit by bit reference.
+unsigned PackedNavBits_T ::
+wordBoundaryTest()
+{
+   TUDEF("PackedNavBits", "asUnsignedLong");
+   SatID satID(1, SatelliteSystem::GPS);
+   ObsID obsID(ObservationType::NavMsg, CarrierBand::L1, TrackingCode::CA);
+   CommonTime ct = CivilTime(2011, 6, 2, 12, 14, 44.0, TimeSystem::GPS);
+   PackedNavBits pnb(satID, obsID, ct);
+   uint32_t seed = 12345;
+   for (int i = 0; i < 10; i++)
+   {
+      seed = seed * 1664525 + 1013904223;
+      pnb.addUnsignedLong(seed, 32, 1);
+   }
+      // odd length, so the last word is partial
+   pnb.addUnsignedLong(5, 3, 1);
+   pnb.trimsize();
+   TUASSERTE(size_t, 323, pnb.getNumBits());
+   vector<bool> ref = pnb.getBits();
+   TUASSERTE(size_t, 323, ref.size());
+
+   bool fieldsOK = true;
+   for (int start = 0; start < 323 && fieldsOK; start++)
+   {
+      for (int num = 1; num <= 32 && start + num <= 323; num++)
+      {
+         unsigned long expect = 0;
+         for (int i = start; i < start + num; i++)
+            expect = (expect << 1) | (ref[i] ? 1 : 0);
+         if (pnb.asUnsignedLong(start, num, 1) != expect)
+         {
+            fieldsOK = false;
+            break;
+         }
+      }
+   }
+   TUASSERT(fieldsOK);
+   TUASSERTE(unsigned long, 5, pnb.asUnsignedLong(320, 3, 1));
+   TUTHROW(pnb.asUnsignedLong(320, 4, 1));
+
+      // 64 bits at once
+   uint64_t wide = (uint64_t(pnb.asUnsignedLong(60, 32, 1)) << 32) |
+      pnb.asUnsignedLong(92, 32, 1);
+   TUASSERTE(double, double(wide), pnb.asUnsignedDouble(60, 64, 0));
+
+   TUCSM("addPackedNavBits");
+   PackedNavBits head(satID, obsID, ct);
+   head.addUnsignedLong(3, 5, 1);
+   head.addPackedNavBits(pnb);
+   TUASSERTE(size_t, 328, head.getNumBits());
+   TUASSERTE(unsigned long, 3, head.asUnsignedLong(0, 5, 1));
+   bool copyOK = true;
+   for (int i = 0; i < 323; i++)
+      copyOK &= (head.asBool(i+5) == ref[i]);
+   TUASSERT(copyOK);
+
+   TUCSM("matchBits");
+   PackedNavBits other(pnb);
+   TUASSERTE(bool, true, other.matchBits(pnb));
+   TUASSERTE(size_t, pnb.hashBits(), other.hashBits());
+   other.insertUnsignedLong(pnb.asUnsignedLong(128, 1, 1) ^ 1, 128, 1);
+   TUASSERTE(bool, false, other.matchBits(pnb));
+   TUASSERTE(bool, false, other.matchBits(pnb, 128, 128));
+   TUASSERTE(bool, false, other.matchBits(pnb, 100, 200));
+   TUASSERTE(bool, true, other.matchBits(pnb, 0, 127));
+   TUASSERTE(bool, true, other.matchBits(pnb, 129));
+   TUASSERT(pnb.hashBits() != other.hashBits());
+
+   TUCSM("operator<");
+   TUASSERTE(bool, (pnb.asBool(128) == false), pnb < other);
+   TUASSERTE(bool, (pnb.asBool(128) == true), other < pnb);
+   TUASSERTE(bool, false, pnb < pnb);
+
+   TUCSM("invert");
+   other = pnb;
+   other.invert();
+   other.invert();
+   TUASSERTE(bool, true, other.matchBits(pnb));
+   TUASSERTE(size_t, pnb.hashBits(), other.hashBits());
+
+   TURETURN();
+}
+
 int main()
 {
    unsigned errorTotal = 0;
@@ -846,6 +932,7 @@ int main()
    errorTotal += testClass.realDataTest();
    errorTotal += testClass.equalityTest();
    errorTotal += testClass.ancillaryMethods();
+   errorTotal += testClass.wordBoundaryTest();
 
    cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
 
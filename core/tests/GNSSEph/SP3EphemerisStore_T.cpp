@@ -42,12 +42,16 @@
 #include <fstream>
 #include <iomanip>
 #include <sstream>
+#include <cstdio>
+#include <atomic>
+#include <thread>
 
 #include "SatID.hpp"
 #include "Exception.hpp"
 #include "CivilTime.hpp"
 #include "CommonTime.hpp"
 #include "SP3EphemerisStore.hpp"
+#include "SP3Cache.hpp"
 #include "TestUtil.hpp"
 
 using namespace gpstk;
@@ -80,6 +84,7 @@ public:
          "inputs" + fileSep + "igs" + fileSep + "igr20354.sp3";
       inputNotaFile = dataFilePath + fileSep + "NotaFILE";
       outputDataDump = tempFilePath + fileSep + "SP3_DataDump.txt";
+      cacheDir = tempFilePath;
 
       inputComparisonOutput1 =
          "x:(-1.51906e+07, -2.15539e+07, 3.31227e+06),"
@@ -696,6 +701,288 @@ public:
       TURETURN();
    }
 
+//=============================================================================
+// Test that a frozen store (flat time index) gives exactly the results
+// of the std::map lookups, including errors, and that it follows
+// changes to the tables.
+//=============================================================================
+   unsigned freezeTest()
+   {
+      TUDEF("SP3EphemerisStore", "freeze");
+
+      gpstk::SP3EphemerisStore mapStore, flatStore;
+      mapStore.loadFile(inputSP3Data);
+      flatStore.loadFile(inputSP3Data);
+      flatStore.freeze();
+      TUASSERT(!mapStore.isFrozen());
+      TUASSERT(flatStore.isFrozen());
+
+      compareStores(testFramework, mapStore, flatStore);
+
+         // concurrent lookups in the frozen store
+      std::vector<gpstk::SatID> sats(mapStore.getSatList());
+      std::atomic<unsigned> nbad(0);
+      std::vector<std::thread> threads;
+      for (unsigned n = 0; n < 4; n++)
+      {
+         threads.push_back(std::thread([&, n]()
+         {
+            gpstk::CommonTime t(mapStore.getInitialTime() + 30.*n);
+            for (; t < mapStore.getFinalTime(); t += 330.)
+            {
+               for (unsigned i = n; i < sats.size(); i += 2)
+               {
+                  try
+                  {
+                     gpstk::Xvt mx(mapStore.getXvt(sats[i], t));
+                     gpstk::Xvt fx(flatStore.getXvt(sats[i], t));
+                     if (!(mx.x == fx.x) || mx.clkbias != fx.clkbias)
+                        nbad++;
+                  }
+                  catch (gpstk::Exception&)
+                  {
+                  }
+               }
+            }
+         }));
+      }
+      for (unsigned n = 0; n < threads.size(); n++)
+         threads[n].join();
+      TUASSERTE(unsigned, 0, nbad);
+
+         // with gap and interval checking
+      mapStore.setPosGapInterval(1000.);
+      flatStore.setPosGapInterval(1000.);
+      mapStore.setPosMaxInterval(8101.);
+      flatStore.setPosMaxInterval(8101.);
+      compareStores(testFramework, mapStore, flatStore);
+
+         // copies and edits
+      gpstk::SP3EphemerisStore copyStore(flatStore);
+      TUASSERT(copyStore.isFrozen());
+      compareStores(testFramework, mapStore, copyStore);
+      gpstk::CommonTime tmid(mapStore.getInitialTime() + 7200.);
+      mapStore.edit(tmid, mapStore.getFinalTime() - 3600.);
+      copyStore.edit(tmid, copyStore.getFinalTime() - 3600.);
+      compareStores(testFramework, mapStore, copyStore);
+
+      flatStore.thaw();
+      TUASSERT(!flatStore.isFrozen());
+
+         // insert records after lookups; uniform then non-uniform spacing
+      gpstk::PositionSatStore mapPos, flatPos;
+      gpstk::SatID sat(5, gpstk::SatelliteSystem::GPS);
+      gpstk::CommonTime t0(gpstk::CivilTime(2020,1,1,0,0,0.0));
+      flatPos.freeze();
+      for (int i = 0; i < 20; i++)
+      {
+         gpstk::Triple pos(2.e7+i*1000., 1.e7-i*i*10., 5.e6+i*i*i);
+         mapPos.addPositionData(sat, t0 + i*900., pos);
+         flatPos.addPositionData(sat, t0 + i*900., pos);
+      }
+      comparePositions(testFramework, mapPos, flatPos, sat, t0);
+      for (int i = 20; i < 30; i++)
+      {
+         gpstk::Triple pos(2.e7+i*1000., 1.e7-i*i*10., 5.e6+i*i*i);
+         mapPos.addPositionData(sat, t0 + i*900. + (i%3)*10., pos);
+         flatPos.addPositionData(sat, t0 + i*900. + (i%3)*10., pos);
+      }
+      comparePositions(testFramework, mapPos, flatPos, sat, t0);
+
+      TURETURN();
+   }
+
+//=============================================================================
+// Test that getXvts() gives exactly the results of getXvt(), for requests
+// that share interpolation intervals and ones that do not.
+//=============================================================================
+   unsigned getXvtsTest()
+   {
+      TUDEF("SP3EphemerisStore", "getXvts");
+
+      gpstk::SP3EphemerisStore store;
+      store.loadFile(inputSP3Data);
+      std::vector<gpstk::SatID> sats(store.getSatList());
+      gpstk::CommonTime tbeg(store.getInitialTime() - 1800.);
+      gpstk::CommonTime tend(store.getFinalTime() + 1800.);
+
+      std::vector<gpstk::SatID> ids;
+      std::vector<gpstk::CommonTime> times;
+         // epoch-major, as in a position solution, then satellite-major
+      for (gpstk::CommonTime t = tbeg; t <= tend; t += 397.)
+      {
+         for (unsigned i = 0; i < sats.size(); i += 2)
+         {
+            ids.push_back(sats[i]);
+            times.push_back(t);
+         }
+      }
+      for (unsigned i = 1; i < sats.size(); i += 5)
+      {
+         for (gpstk::CommonTime t = tbeg; t <= tend; t += 300.)
+         {
+            ids.push_back(sats[i]);
+            times.push_back(t);
+         }
+      }
+      ids.push_back(gpstk::SatID(40, gpstk::SatelliteSystem::GPS));
+      times.push_back(tbeg + 3600.);
+
+      std::vector<gpstk::Xvt> xvts;
+      std::vector<bool> valid;
+         // then with gap and interval checking, which reused
+         // intervals must still respect
+      for (int pass = 0; pass < 2; pass++)
+      {
+         if (pass == 1)
+         {
+            store.setPosGapInterval(1000.);
+            store.setPosMaxInterval(8101.);
+         }
+         unsigned nvalid = store.getXvts(ids, times, xvts, valid);
+         TUASSERTE(size_t, ids.size(), xvts.size());
+         unsigned nbad(0), ngood(0);
+         for (unsigned i = 0; i < ids.size(); i++)
+         {
+            gpstk::Xvt xvt;
+            bool ok(true);
+            try { xvt = store.getXvt(ids[i], times[i]); }
+            catch (gpstk::InvalidRequest&) { ok = false; }
+            if (ok != valid[i])
+               nbad++;
+            else if (ok && (!(xvt.x == xvts[i].x) || !(xvt.v == xvts[i].v) ||
+                            xvt.clkbias != xvts[i].clkbias ||
+                            xvt.clkdrift != xvts[i].clkdrift ||
+                            xvt.relcorr != xvts[i].relcorr))
+               nbad++;
+            else if (ok)
+               ngood++;
+         }
+         TUASSERTE(unsigned, 0, nbad);
+         TUASSERTE(unsigned, ngood, nvalid);
+         TUASSERT(ngood > 0);
+         TUASSERT(ngood < ids.size());
+      }
+
+      times.pop_back();
+      TUTHROW(store.getXvts(ids, times, xvts, valid));
+
+      TURETURN();
+   }
+
+//=============================================================================
+// Test that stores loaded from SP3 cache files match stores loaded
+// from the SP3 files, and that caches are only used for the file
+// they were made from.
+//=============================================================================
+   unsigned cacheTest()
+   {
+      TUDEF("SP3EphemerisStore", "enableCache");
+
+      const std::string inputs[2] = { inputSP3Data, inputSP3cData };
+      for (unsigned f = 0; f < 2; f++)
+      {
+         std::string cacheName(gpstk::SP3Cache::cacheFileName(inputs[f],
+                                                              cacheDir));
+         std::remove(cacheName.c_str());
+         gpstk::SP3EphemerisStore textStore;
+         textStore.loadFile(inputs[f]);
+
+            // the first load writes the cache
+         gpstk::SP3EphemerisStore writeStore;
+         writeStore.enableCache(cacheDir);
+         writeStore.loadFile(inputs[f]);
+         gpstk::SP3Cache cache;
+         TUASSERT(cache.open(cacheName, inputs[f]));
+         TUASSERT(cache.size() > 0);
+         cache.close();
+         compareStores(testFramework, textStore, writeStore);
+
+            // the second one reads it
+         gpstk::SP3EphemerisStore readStore;
+         readStore.enableCache(cacheDir);
+         readStore.loadFile(inputs[f]);
+         TUASSERTE(int, textStore.ndata(), readStore.ndata());
+         TUASSERTE(gpstk::CommonTime, textStore.getInitialTime(),
+                   readStore.getInitialTime());
+         TUASSERTE(gpstk::CommonTime, textStore.getFinalTime(),
+                   readStore.getFinalTime());
+         compareStores(testFramework, textStore, readStore);
+      }
+
+         // a cache made from one file is not used for another
+      std::string cacheName(gpstk::SP3Cache::cacheFileName(inputSP3Data,
+                                                           cacheDir));
+      gpstk::SP3Cache cache;
+      TUASSERT(cache.open(cacheName, inputSP3Data));
+      TUASSERT(!cache.open(cacheName, inputSP3cData));
+      TUASSERT(!cache.open(cacheName, inputNotaFile));
+      TUASSERT(!cache.open(inputSP3Data, inputSP3Data));
+      std::remove(cacheName.c_str());
+      std::remove(gpstk::SP3Cache::cacheFileName(inputSP3cData,
+                                                 cacheDir).c_str());
+
+      TURETURN();
+   }
+
+      /// compare getXvt() from two stores at many times, on and off the grid
+   void compareStores(gpstk::TestUtil& testFramework,
+                      const gpstk::SP3EphemerisStore& mapStore,
+                      const gpstk::SP3EphemerisStore& flatStore)
+   {
+      std::vector<gpstk::SatID> sats(mapStore.getSatList());
+      gpstk::CommonTime tbeg(mapStore.getInitialTime() - 1800.);
+      gpstk::CommonTime tend(mapStore.getFinalTime() + 1800.);
+      unsigned nbad(0), ngood(0);
+      for (unsigned i = 0; i < sats.size(); i += 3)
+      {
+         for (gpstk::CommonTime t = tbeg; t <= tend; t += 450.)
+         {
+            for (int k = 0; k < 2; k++)
+            {
+               gpstk::CommonTime tt(t + k*97.);
+               std::string mapErr, flatErr;
+               gpstk::Xvt mx, fx;
+               try { mx = mapStore.getXvt(sats[i], tt); }
+               catch (gpstk::Exception& e) { mapErr = e.getText(); }
+               try { fx = flatStore.getXvt(sats[i], tt); }
+               catch (gpstk::Exception& e) { flatErr = e.getText(); }
+               if (mapErr != flatErr || !(mx.x == fx.x) || !(mx.v == fx.v) ||
+                   mx.clkbias != fx.clkbias || mx.clkdrift != fx.clkdrift)
+                  nbad++;
+               else if (mapErr.empty())
+                  ngood++;
+            }
+         }
+      }
+      TUASSERTE(unsigned, 0, nbad);
+      TUASSERT(ngood > 0);
+   }
+
+      /// compare getValue() from two position stores at many times
+   void comparePositions(gpstk::TestUtil& testFramework,
+                         const gpstk::PositionSatStore& mapPos,
+                         const gpstk::PositionSatStore& flatPos,
+                         const gpstk::SatID& sat, const gpstk::CommonTime& t0)
+   {
+      unsigned nbad(0), ngood(0);
+      for (double dt = -1000.; dt < 30*900.; dt += 113.)
+      {
+         std::string mapErr, flatErr;
+         gpstk::PositionRecord mr, fr;
+         try { mr = mapPos.getValue(sat, t0 + dt); }
+         catch (gpstk::Exception& e) { mapErr = e.getText(); }
+         try { fr = flatPos.getValue(sat, t0 + dt); }
+         catch (gpstk::Exception& e) { flatErr = e.getText(); }
+         if (mapErr != flatErr || !(mr.Pos == fr.Pos) || !(mr.Vel == fr.Vel))
+            nbad++;
+         else if (mapErr.empty())
+            ngood++;
+      }
+      TUASSERTE(unsigned, 0, nbad);
+      TUASSERT(ngood > 0);
+   }
+
 private:
    double epsilon; // Floating point error threshold
    std::string dataFilePath;
@@ -706,6 +993,7 @@ private:
    std::string inputSixNinesData;
 
    std::string outputDataDump;
+   std::string cacheDir;
 
    std::string inputNotaFile;
 
@@ -730,6 +1018,9 @@ int main() // Main function to initialize and run all tests above
    errorTotal += testClass.getFinalTimeTest();
    errorTotal += testClass.getPositionTest();
    errorTotal += testClass.getVelocityTest();
+   errorTotal += testClass.freezeTest();
+   errorTotal += testClass.getXvtsTest();
+   errorTotal += testClass.cacheTest();
 
    cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
 
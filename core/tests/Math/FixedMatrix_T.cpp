@@ -0,0 +1,202 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+#include <iostream>
+
+#include "FixedMatrix.hpp"
+#include "TestUtil.hpp"
+
+using namespace std;
+
+   // a 6x4 partials matrix and data, like a 6 satellite position solution
+static double pA[24] = {  0.3, -0.5,  0.8, 1,
+                         -0.7,  0.1,  0.7, 1,
+                          0.2,  0.9,  0.4, 1,
+                         -0.1, -0.8,  0.6, 1,
+                          0.6,  0.6,  0.5, 1,
+                         -0.4,  0.3,  0.9, 1 };
+static double pb[6] = { 1.5, -2.0, 0.5, 3.0, -1.0, 2.5 };
+
+unsigned interopTest()
+{
+   TUDEF("FixedMatrix", "interop");
+   gpstk::Matrix<double> A(6,4);
+   A = pA;
+   gpstk::FixedMatrix<double,6,4> F(A);
+   TUASSERTFE(A, gpstk::Matrix<double>(F));
+   gpstk::FixedMatrix<double,4,6> FT(transpose(F));
+   TUASSERTFE(transpose(A), gpstk::Matrix<double>(FT));
+   TUASSERTFEPS(transpose(A)*A, gpstk::Matrix<double>(FT*F), 1.e-14);
+   TUASSERTFEPS(inverseSVD(transpose(A)*A), inverseSVD(FT*F), 1.e-12);
+
+   gpstk::Vector<double> b(6);
+   b = pb;
+   gpstk::FixedVector<double,6> fb(b);
+   TUASSERTFEPS(transpose(A)*b, gpstk::Vector<double>(FT*fb), 1.e-14);
+
+   gpstk::FixedMatrix<double,4,4> Z(0.0);
+   TUASSERTFE(gpstk::Matrix<double>(4,4,0.0), gpstk::Matrix<double>(Z));
+   typedef gpstk::FixedMatrix<double,4,4> Fixed44;
+   typedef gpstk::FixedVector<double,4> Fixed4;
+   TUTHROW(Fixed44 W(A));
+   TUTHROW(Fixed4 w(b));
+   TURETURN();
+}
+
+unsigned choleskyTest()
+{
+   TUDEF("FixedCholesky", "operator()");
+   gpstk::Matrix<double> A(6,4);
+   A = pA;
+   gpstk::Vector<double> b(6);
+   b = pb;
+   gpstk::Matrix<double> Info(transpose(A)*A);
+   gpstk::Vector<double> xref(inverseSVD(Info) * (transpose(A)*b));
+
+   gpstk::FixedCholesky<double,4> Ch;
+   Ch(gpstk::FixedMatrix<double,4,4>(Info));
+   TUASSERTFEPS(Info, gpstk::Matrix<double>(Ch.L*transpose(Ch.L)), 1.e-14);
+   TUASSERTFEPS(inverseSVD(Info), gpstk::Matrix<double>(Ch.inverse()), 1.e-12);
+   gpstk::FixedVector<double,4> x(transpose(A)*b);
+   Ch.backSub(x);
+   TUASSERTFEPS(xref, gpstk::Vector<double>(x), 1.e-12);
+
+   TUCSM("operator() singular");
+      // two identical columns
+   gpstk::FixedMatrix<double,2,2> S(1.0);
+   gpstk::FixedCholesky<double,2> Ch2;
+   try
+   {
+      Ch2(S);
+      TUFAIL("Did not throw SingularMatrixException");
+   }
+   catch (gpstk::SingularMatrixException& e)
+   {
+      TUPASS("SingularMatrixException");
+   }
+
+   TUCSM("factor");
+   TUASSERT(Ch.factor(gpstk::FixedMatrix<double,4,4>(Info)));
+   TUASSERT(!Ch2.factor(S));
+   TURETURN();
+}
+
+unsigned symSVDTest()
+{
+   TUDEF("FixedSymSVD", "operator()");
+   gpstk::Matrix<double> A(6,4);
+   A = pA;
+   gpstk::Matrix<double> Info(transpose(A)*A);
+   gpstk::FixedMatrix<double,4,4> F(Info);
+
+   gpstk::FixedSymSVD<double,4> svd;
+   svd(F);
+   gpstk::FixedMatrix<double,4,4> VS;
+   for(size_t i=0; i<4; i++)
+      for(size_t j=0; j<4; j++)
+         VS(i,j) = svd.V(i,j)*svd.S(j);
+   TUASSERTFEPS(Info, gpstk::Matrix<double>(VS*transpose(svd.V)), 1.e-13);
+   TUASSERTFEPS(gpstk::ident<double>(4),
+                gpstk::Matrix<double>(transpose(svd.V)*svd.V), 1.e-14);
+
+   TUCSM("inverse");
+   TUASSERTFEPS(inverseSVD(Info), gpstk::Matrix<double>(svd.inverse()), 1.e-12);
+
+      // rank deficient: a fifth unknown with no data, like the clock of a
+      // system with no satellites
+   gpstk::Matrix<double> A5(6,5,0.0);
+   for(size_t i=0; i<6; i++)
+      for(size_t j=0; j<4; j++)
+         A5(i,j) = A(i,j);
+   gpstk::Matrix<double> Info5(transpose(A5)*A5);
+   gpstk::FixedSymSVD<double,5> svd5;
+   svd5(gpstk::FixedMatrix<double,5,5>(Info5));
+   TUASSERTFEPS(inverseSVD(Info5), gpstk::Matrix<double>(svd5.inverse()),
+                1.e-12);
+
+   gpstk::FixedSymSVD<double,2> svd2;
+   svd2(gpstk::FixedMatrix<double,2,2>(0.0));
+   TUTHROW(svd2.inverse());
+   TURETURN();
+}
+
+unsigned inverseSymmetricTest()
+{
+   TUDEF("FixedMatrix", "inverseSymmetric");
+   gpstk::Matrix<double> A(6,4);
+   A = pA;
+   gpstk::Matrix<double> Info(transpose(A)*A);
+   gpstk::FixedMatrix<double,4,4> F(Info);
+      // only the lower triangle is used
+   F(0,3) = F(1,2) = 1.e10;
+   TUASSERTFEPS(inverseSVD(Info), gpstk::Matrix<double>(inverseSymmetric(F)),
+                1.e-12);
+
+      // singular, so the SVD is used
+   gpstk::Matrix<double> A5(6,5,0.0);
+   for(size_t i=0; i<6; i++)
+      for(size_t j=0; j<4; j++)
+         A5(i,j) = A(i,j);
+   gpstk::Matrix<double> Info5(transpose(A5)*A5);
+   gpstk::FixedMatrix<double,5,5> F5(Info5);
+   TUASSERTFEPS(inverseSVD(Info5), gpstk::Matrix<double>(inverseSymmetric(F5)),
+                1.e-12);
+
+      // positive definite, but nearly singular: edited like inverseSVD
+   Info5(4,4) = 1.e-12;
+   F5 = Info5;
+   TUASSERTFEPS(inverseSVD(Info5), gpstk::Matrix<double>(inverseSymmetric(F5)),
+                1.e-12);
+
+   TUTHROW(inverseSymmetric(gpstk::FixedMatrix<double,3,3>(0.0)));
+   TURETURN();
+}
+
+int main()
+{
+   unsigned errorTotal = 0;
+
+   errorTotal += interopTest();
+   errorTotal += choleskyTest();
+   errorTotal += symSVDTest();
+   errorTotal += inverseSymmetricTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal;
+}
@@ -0,0 +1,243 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/** @file NavFilterMgrBench.cpp
+ * Compare the time taken to filter LNAV subframes held in messages
+ * allocated one at a time on the heap and held in a NavMsgArena.
+ * The input is in the format of data/test_input_NavFilterMgr.txt.
+ *
+ * Usage: NavFilterMgrBench file [file ...]
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <new>
+#include <vector>
+#include "NavFilterMgr.hpp"
+#include "NavMsgArena.hpp"
+#include "LNavFilterData.hpp"
+#include "LNavCookFilter.hpp"
+#include "LNavParityFilter.hpp"
+#include "LNavTLMHOWFilter.hpp"
+#include "LNavCrossSourceFilter.hpp"
+#include "StringUtils.hpp"
+#include "TimeString.hpp"
+
+using namespace std;
+
+/// Number of calls to operator new, including those of the filters.
+static unsigned long numAllocs = 0;
+
+void* operator new(size_t size)
+{
+   numAllocs++;
+   void *rv = malloc(size ? size : 1);
+   if (rv == NULL)
+      throw std::bad_alloc();
+   return rv;
+}
+
+void operator delete(void *ptr) noexcept
+{
+   free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+   free(ptr);
+}
+
+/// LNAV message with its own subframe storage.
+struct BenchNavData : public gpstk::LNavFilterData
+{
+   BenchNavData()
+   { sf = words; }
+   uint32_t words[10];
+};
+
+/// Load the subframes of \a fn into \a data.
+void loadFile(const string& fn, vector<BenchNavData>& data)
+{
+   ifstream inf(fn.c_str());
+   string line;
+   if (!inf)
+   {
+      gpstk::Exception exc("Could not open \"" + fn + "\"");
+      GPSTK_THROW(exc);
+   }
+   data.clear();
+   while (getline(inf, line))
+   {
+      if (line.empty() || line[0] == '#')
+         continue;
+      data.push_back(BenchNavData());
+      BenchNavData& fd(data.back());
+      gpstk::scanTime(fd.timeStamp, gpstk::StringUtils::firstWord(line, ','),
+                      "%4Y %3j %02H:%02M:%04.1f");
+      fd.prn = gpstk::StringUtils::asUnsigned(
+         gpstk::StringUtils::word(line, 2, ','));
+      fd.carrier = (gpstk::CarrierBand)gpstk::StringUtils::asInt(
+         gpstk::StringUtils::word(line, 3, ','));
+      fd.code = (gpstk::TrackingCode)gpstk::StringUtils::asInt(
+         gpstk::StringUtils::word(line, 4, ','));
+      for (unsigned w = 0; w < 10; w++)
+      {
+         fd.words[w] = gpstk::StringUtils::x2uint(
+            gpstk::StringUtils::word(line, w+6, ','));
+      }
+   }
+}
+
+   /** Copy \a src into a message allocated by \a arena, or by new if
+    * \a arena is NULL. */
+BenchNavData* newMessage(const BenchNavData& src,
+                         gpstk::NavMsgArena<BenchNavData>* arena)
+{
+   BenchNavData *fd = (arena ? arena->allocate() : new BenchNavData());
+   gpstk::LNavFilterData *lfd = fd;
+   *lfd = src;
+   fd->sf = fd->words;
+   std::copy(src.words, src.words+10, fd->words);
+   return fd;
+}
+
+   /// Give a message that has left the filters back to where it came from.
+void freeMessage(gpstk::NavFilterKey* msg,
+                 gpstk::NavMsgArena<BenchNavData>* arena)
+{
+   if (arena)
+      arena->deallocate(msg);
+   else
+      delete static_cast<BenchNavData*>(msg);
+}
+
+   /// Give back the accepted and rejected messages.
+void freeMessages(gpstk::NavFilterMgr& mgr,
+                  gpstk::NavFilter::NavMsgList& accepted,
+                  gpstk::NavMsgArena<BenchNavData>* arena)
+{
+   gpstk::NavFilter::NavMsgList::const_iterator nmli;
+   for (nmli = accepted.begin(); nmli != accepted.end(); nmli++)
+      freeMessage(*nmli, arena);
+   gpstk::NavFilterMgr::FilterSet::const_iterator fsi;
+   for (fsi = mgr.rejected.begin(); fsi != mgr.rejected.end(); fsi++)
+   {
+      for (nmli = (*fsi)->rejected.begin(); nmli != (*fsi)->rejected.end();
+           nmli++)
+      {
+         freeMessage(*nmli, arena);
+      }
+   }
+}
+
+   /** Filter all of \a data through cook, parity, TLM/HOW and
+    * cross-source filters, returning the number of subframes
+    * accepted. */
+unsigned long filterData(const vector<BenchNavData>& data,
+                         gpstk::NavMsgArena<BenchNavData>* arena)
+{
+   gpstk::NavFilterMgr mgr;
+   gpstk::LNavCookFilter filtCook;
+   gpstk::LNavParityFilter filtParity;
+   gpstk::LNavTLMHOWFilter filtTLMHOW;
+   gpstk::LNavCrossSourceFilter filtVote;
+   gpstk::NavFilter::NavMsgList l;
+   unsigned long count = 0;
+   mgr.addFilter(&filtCook);
+   mgr.addFilter(&filtParity);
+   mgr.addFilter(&filtTLMHOW);
+   mgr.addFilter(&filtVote);
+   for (size_t i = 0; i < data.size(); i++)
+   {
+      l = mgr.validate(newMessage(data[i], arena));
+      count += l.size();
+      freeMessages(mgr, l, arena);
+   }
+   l = mgr.finalize();
+   count += l.size();
+   freeMessages(mgr, l, arena);
+   return count;
+}
+
+
+int main(int argc, char *argv[])
+{
+   if (argc < 2)
+   {
+      cerr << "Usage: " << argv[0] << " file [file ...]" << endl;
+      return 1;
+   }
+   try
+   {
+      const unsigned reps = 10;
+      vector<BenchNavData> data;
+      for (int arg = 1; arg < argc; arg++)
+      {
+         loadFile(argv[arg], data);
+         for (int pooled = 0; pooled < 2; pooled++)
+         {
+            gpstk::NavMsgArena<BenchNavData> arena;
+            gpstk::NavMsgArena<BenchNavData> *ap = (pooled ? &arena : NULL);
+            unsigned long count = 0, allocs = numAllocs;
+            auto start = chrono::steady_clock::now();
+            for (unsigned r = 0; r < reps; r++)
+               count += filterData(data, ap);
+            chrono::duration<double> elapsed =
+               chrono::steady_clock::now() - start;
+            allocs = numAllocs - allocs;
+            unsigned long total = (unsigned long)reps * data.size();
+            cout << argv[arg] << (pooled ? "  arena  " : "  heap   ")
+                 << setw(8) << total << " msgs  " << setw(8) << count
+                 << " accepted  " << fixed << setprecision(3)
+                 << elapsed.count() << " s  " << setprecision(0)
+                 << total / elapsed.count() << " msgs/s  "
+                 << setprecision(2) << double(allocs) / total
+                 << " allocs/msg" << endl;
+         }
+      }
+   }
+   catch (gpstk::Exception& exc)
+   {
+      cerr << exc << endl;
+      return 1;
+   }
+   return 0;
+}
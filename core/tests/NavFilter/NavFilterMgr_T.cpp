@@ -46,6 +46,8 @@
 #include "LNavEphMaker.hpp"
 #include "LNavCrossSourceFilter.hpp"
 #include "NavOrderFilter.hpp"
+#include "NavMsgArena.hpp"
+#include "ShardedNavFilterMgr.hpp"
 #include "CommonTime.hpp"
 #include "TimeString.hpp"
 
@@ -131,6 +133,47 @@ public:
    NavMsgList cache;
 };
 
+// filter that holds every message until finalize(), then rejects
+// every other one
+class HoldFilter : public NavFilter
+{
+public:
+   HoldFilter() {}
+   virtual void validate(NavMsgList& msgBitsIn, NavMsgList& msgBitsOut)
+   {
+      std::copy(msgBitsIn.begin(), msgBitsIn.end(),
+                std::back_insert_iterator<NavMsgList>(cache));
+   }
+   virtual void finalize(NavMsgList& msgBitsOut)
+   {
+      bool odd = false;
+      NavMsgList::iterator nmli;
+      for (nmli = cache.begin(); nmli != cache.end(); nmli++)
+      {
+         if (odd)
+            accept(*nmli, msgBitsOut);
+         else
+            reject(*nmli);
+         odd = !odd;
+      }
+      cache.clear();
+   }
+   virtual unsigned processingDepth() const throw()
+   { return 1; }
+   virtual std::string filterName() const throw()
+   { return "Hold"; }
+   NavMsgList cache;
+};
+
+// LNAV message with its own subframe storage, for NavMsgArena
+class ArenaFilterData : public LNavFilterData
+{
+public:
+   ArenaFilterData()
+   { sf = words; }
+   uint32_t words[10];
+};
+
 class NavFilterMgr_T
 {
 public:
@@ -168,6 +211,15 @@ public:
    unsigned testBunk1();
       /// test a filter with behavior like multiple input epochs
    unsigned testBunk2();
+      /** Test that filtering messages stored in a NavMsgArena gives
+       * the same results as messages stored elsewhere. */
+   unsigned testArena();
+      /** Test that ShardedNavFilterMgr gives the same results as
+       * NavFilterMgr with the same filters. */
+   unsigned testSharded();
+      /** Test that ShardedNavFilterMgr reports the messages rejected
+       * by shard and cross-source filters in finalize(). */
+   unsigned testShardedFinalize();
 
    string inputFileLNAV;
    string inputFileBunk;
@@ -797,6 +849,253 @@ testBunk2()
 }
 
 
+unsigned NavFilterMgr_T ::
+testArena()
+{
+   TUDEF("NavMsgArena", "allocate");
+
+   NavFilterMgr mgrRef, mgrArena;
+   LNavParityFilter filtParityRef, filtParityArena;
+   LNavTLMHOWFilter filtTLMHOWRef, filtTLMHOWArena;
+   LNavCrossSourceFilter filtVoteRef, filtVoteArena;
+   mgrRef.addFilter(&filtParityRef);
+   mgrRef.addFilter(&filtTLMHOWRef);
+   mgrRef.addFilter(&filtVoteRef);
+   mgrArena.addFilter(&filtParityArena);
+   mgrArena.addFilter(&filtTLMHOWArena);
+   mgrArena.addFilter(&filtVoteArena);
+
+   NavMsgArena<ArenaFilterData> arena(64);
+      // summaries of the accepted messages from each path
+   vector<string> accRef, accArena;
+   unsigned long rejRef = 0, rejArena = 0;
+   size_t maxSize = 0;
+
+   for (unsigned i = 0; i <= dataIdxLNAV; i++)
+   {
+      gpstk::NavFilter::NavMsgList lRef, lArena;
+      if (i < dataIdxLNAV)
+      {
+         ArenaFilterData *fd = arena.allocate();
+         LNavFilterData *sfd = fd;
+         *sfd = dataLNAV[i];
+         fd->sf = fd->words;
+         std::copy(dataLNAV[i].sf, dataLNAV[i].sf+10, fd->words);
+         maxSize = std::max(maxSize, arena.size());
+         lRef = mgrRef.validate(&dataLNAV[i]);
+         lArena = mgrArena.validate(fd);
+      }
+      else
+      {
+         lRef = mgrRef.finalize();
+         lArena = mgrArena.finalize();
+      }
+      gpstk::NavFilter::NavMsgList::const_iterator nmli;
+      for (nmli = lRef.begin(); nmli != lRef.end(); nmli++)
+      {
+         LNavFilterData *fd = dynamic_cast<LNavFilterData*>(*nmli);
+         ostringstream ss;
+         ss << *fd;
+         accRef.push_back(ss.str());
+      }
+      for (nmli = lArena.begin(); nmli != lArena.end(); nmli++)
+      {
+         ArenaFilterData *fd = dynamic_cast<ArenaFilterData*>(*nmli);
+         ostringstream ss;
+         ss << *fd;
+         accArena.push_back(ss.str());
+         arena.deallocate(fd);
+      }
+      NavFilterMgr::FilterSet::const_iterator fsi;
+      for (fsi = mgrRef.rejected.begin(); fsi != mgrRef.rejected.end(); fsi++)
+         rejRef += (*fsi)->rejected.size();
+      for (fsi = mgrArena.rejected.begin(); fsi != mgrArena.rejected.end();
+           fsi++)
+      {
+         rejArena += (*fsi)->rejected.size();
+         for (nmli = (*fsi)->rejected.begin();
+              nmli != (*fsi)->rejected.end(); nmli++)
+         {
+            arena.deallocate(*nmli);
+         }
+      }
+   }
+   TUASSERT(!accRef.empty());
+   TUASSERTE(size_t, accRef.size(), accArena.size());
+   TUASSERT(accRef == accArena);
+   TUASSERTE(unsigned long, rejRef, rejArena);
+   TUASSERTE(unsigned long, dataIdxLNAV, accArena.size() + rejArena);
+      // storage is reused
+   TUASSERTE(size_t, 0, arena.size());
+   TUASSERT(maxSize < 500);
+   TUASSERT(arena.capacity() >= maxSize);
+   TUASSERT(arena.capacity() < maxSize + 64);
+
+   TUCSM("release");
+   size_t cap = arena.capacity();
+   for (unsigned i = 0; i < 10; i++)
+      arena.allocate();
+   TUASSERTE(size_t, 10, arena.size());
+   arena.release();
+   TUASSERTE(size_t, 0, arena.size());
+   TUASSERTE(size_t, cap, arena.capacity());
+   ArenaFilterData *fd = arena.allocate();
+   TUASSERT(fd->sf == fd->words);
+   TUASSERTE(size_t, 1, arena.size());
+
+   TURETURN();
+}
+
+
+unsigned NavFilterMgr_T ::
+testSharded()
+{
+   TUDEF("ShardedNavFilterMgr", "validate");
+
+      // reference: one manager, one message at a time
+   NavFilterMgr mgrRef;
+   LNavParityFilter filtParity;
+   LNavEmptyFilter filtEmpty;
+   LNavTLMHOWFilter filtTLMHOW;
+   LNavCrossSourceFilter filtVoteRef;
+   mgrRef.addFilter(&filtParity);
+   mgrRef.addFilter(&filtEmpty);
+   mgrRef.addFilter(&filtTLMHOW);
+   mgrRef.addFilter(&filtVoteRef);
+   vector<NavFilterKey*> accRef;
+   unsigned long rejRef = 0;
+   for (unsigned i = 0; i <= dataIdxLNAV; i++)
+   {
+      gpstk::NavFilter::NavMsgList l;
+      if (i < dataIdxLNAV)
+         l = mgrRef.validate(&dataLNAV[i]);
+      else
+         l = mgrRef.finalize();
+      accRef.insert(accRef.end(), l.begin(), l.end());
+      NavFilterMgr::FilterSet::const_iterator fsi;
+      for (fsi = mgrRef.rejected.begin(); fsi != mgrRef.rejected.end(); fsi++)
+         rejRef += (*fsi)->rejected.size();
+   }
+   TUASSERTE(unsigned, 2, mgrRef.processingDepth());
+
+   ShardedNavFilterMgr::FilterChainFactory factory =
+      []()
+      {
+         ShardedNavFilterMgr::FilterChain rv;
+         rv.push_back(std::make_shared<LNavParityFilter>());
+         rv.push_back(std::make_shared<LNavEmptyFilter>());
+         rv.push_back(std::make_shared<LNavTLMHOWFilter>());
+         return rv;
+      };
+   for (unsigned nthreads = 1; nthreads <= 4; nthreads += 3)
+   {
+      ShardedNavFilterMgr mgr(factory);
+      LNavCrossSourceFilter filtVote;
+      mgr.addCrossFilter(&filtVote);
+      mgr.setThreads(nthreads);
+      vector<NavFilterKey*> acc;
+      unsigned long rej = 0;
+      unsigned i = 0;
+      while (i <= dataIdxLNAV)
+      {
+         gpstk::NavFilter::NavMsgList l;
+         if (i < dataIdxLNAV)
+         {
+               // all the messages for one epoch
+            gpstk::NavFilter::NavMsgList epoch;
+            CommonTime t(dataLNAV[i].timeStamp);
+            while (i < dataIdxLNAV && dataLNAV[i].timeStamp == t)
+               epoch.push_back(&dataLNAV[i++]);
+            l = mgr.validate(epoch);
+            rej += mgr.rejected.size();
+         }
+         else
+         {
+               // mgrRef.finalize() does not report its rejections
+            l = mgr.finalize();
+            i++;
+         }
+         acc.insert(acc.end(), l.begin(), l.end());
+      }
+      TUASSERT(mgr.numShards() > 20);
+      TUASSERTE(unsigned, 2, mgr.processingDepth());
+      TUASSERTE(size_t, accRef.size(), acc.size());
+      TUASSERT(accRef == acc);
+      TUASSERTE(unsigned long, rejRef, rej);
+   }
+
+   TURETURN();
+}
+
+
+unsigned NavFilterMgr_T ::
+testShardedFinalize()
+{
+   TUDEF("ShardedNavFilterMgr", "finalize");
+
+   ShardedNavFilterMgr::FilterChainFactory factory =
+      []()
+      {
+         ShardedNavFilterMgr::FilterChain rv;
+         rv.push_back(std::make_shared<LNavParityFilter>());
+         rv.push_back(std::make_shared<HoldFilter>());
+         return rv;
+      };
+   for (unsigned nthreads = 1; nthreads <= 4; nthreads += 3)
+   {
+      ShardedNavFilterMgr mgr(factory);
+      HoldFilter filtHold1, filtHold2;
+      mgr.addCrossFilter(&filtHold1);
+      mgr.addCrossFilter(&filtHold2);
+      mgr.setThreads(nthreads);
+         // every message is either accepted or rejected, just once
+      std::set<NavFilterKey*> seen;
+      size_t count = 0;
+      unsigned i = 0;
+      while (i < dataIdxLNAV)
+      {
+         gpstk::NavFilter::NavMsgList epoch;
+         CommonTime t(dataLNAV[i].timeStamp);
+         while (i < dataIdxLNAV && dataLNAV[i].timeStamp == t)
+            epoch.push_back(&dataLNAV[i++]);
+         gpstk::NavFilter::NavMsgList l = mgr.validate(epoch);
+            // everything is held until finalize()
+         TUASSERTE(size_t, 0, l.size());
+         seen.insert(mgr.rejected.begin(), mgr.rejected.end());
+         count += mgr.rejected.size();
+      }
+      gpstk::NavFilter::NavMsgList l = mgr.finalize();
+      TUASSERT(!l.empty());
+      TUASSERT(!filtHold1.rejected.empty());
+      TUASSERT(!filtHold2.rejected.empty());
+         // both cross-source filters' finalize() rejections are reported
+      std::set<NavFilterKey*> finRej(mgr.rejected.begin(),
+                                     mgr.rejected.end());
+      NavFilter::NavMsgList::const_iterator nmli;
+      for (nmli = filtHold1.rejected.begin();
+           nmli != filtHold1.rejected.end(); nmli++)
+      {
+         TUASSERT(finRej.count(*nmli) == 1);
+      }
+      for (nmli = filtHold2.rejected.begin();
+           nmli != filtHold2.rejected.end(); nmli++)
+      {
+         TUASSERT(finRej.count(*nmli) == 1);
+      }
+         // and so are the shard filters'
+      TUASSERT(mgr.rejected.size() >
+               filtHold1.rejected.size() + filtHold2.rejected.size());
+      seen.insert(mgr.rejected.begin(), mgr.rejected.end());
+      seen.insert(l.begin(), l.end());
+      count += mgr.rejected.size() + l.size();
+      TUASSERTE(size_t, dataIdxLNAV, count);
+      TUASSERTE(size_t, dataIdxLNAV, seen.size());
+   }
+
+   TURETURN();
+}
+
+
 int main()
 {
    unsigned errorTotal = 0;
@@ -814,6 +1113,9 @@ int main()
    errorTotal += testClass.testProcessingDepths();
    errorTotal += testClass.testBunk1();
    errorTotal += testClass.testBunk2();
+   errorTotal += testClass.testArena();
+   errorTotal += testClass.testSharded();
+   errorTotal += testClass.testShardedFinalize();
 
    cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
 
@@ -0,0 +1,157 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+#include <iostream>
+#include <unordered_set>
+#include "TestUtil.hpp"
+#include "TimeKey.hpp"
+#include "CivilTime.hpp"
+#include "GPSWeekSecond.hpp"
+
+using namespace std;
+using namespace gpstk;
+
+
+class TimeKey_T
+{
+public:
+      /// Conversion to and from CommonTime
+   unsigned convertTest()
+   {
+      TUDEF("TimeKey", "TimeKey(CommonTime)");
+      CommonTime epoch(GPSWeekSecond(0, 0., TimeSystem::GPS));
+      TUASSERTE(int64_t, 0, TimeKey(epoch).nanoseconds());
+      TUASSERTE(TimeSystem, TimeSystem::GPS, TimeKey(epoch).getTimeSystem());
+
+      CommonTime t1(GPSWeekSecond(1854, 233472.125, TimeSystem::GPS));
+      TimeKey k1(t1);
+      TUASSERTE(int64_t, (1854LL*604800LL + 233472LL) * 1000000000LL
+                + 125000000LL, k1.nanoseconds());
+      TUCSM("toCommonTime");
+      TUASSERTE(CommonTime, t1, k1.toCommonTime());
+
+         // before the GPS epoch
+      CommonTime t2(CivilTime(1975, 3, 4, 5, 6, 7.25, TimeSystem::UTC));
+      TimeKey k2(t2);
+      TUASSERT(k2.nanoseconds() < 0);
+      TUASSERTE(CommonTime, t2, k2.toCommonTime());
+      TUASSERTE(TimeSystem, TimeSystem::UTC, k2.getTimeSystem());
+
+         // sub-millisecond part, rounded to the nanosecond
+      CommonTime t3(t1);
+      t3 += 0.0001234567894;
+      TUASSERTE(int64_t, k1.nanoseconds() + 123457, TimeKey(t3).nanoseconds());
+      TUASSERTFEPS(t3 - TimeKey(t3).toCommonTime(), 0., 1e-9);
+
+         // the ends of time are clamped, in order
+      TUCSM("TimeKey(CommonTime)");
+      TimeKey kb(CommonTime::BEGINNING_OF_TIME), ke(CommonTime::END_OF_TIME);
+      TUASSERTE(int64_t, INT64_MIN, kb.nanoseconds());
+      TUASSERTE(int64_t, INT64_MAX, ke.nanoseconds());
+      TUASSERT(kb < k2);
+      TUASSERT(k1 < ke);
+      TURETURN();
+   }
+
+
+      /// Ordering, differencing and containers
+   unsigned orderTest()
+   {
+      TUDEF("TimeKey", "operator<");
+      CommonTime t1(GPSWeekSecond(2000, 1000., TimeSystem::GPS));
+      CommonTime t2(t1), t3(t1);
+      t2 += 1e-6;
+      t3.setTimeSystem(TimeSystem::GLO);
+      TimeKey k1(t1), k2(t2), k3(t3);
+      TUASSERT(k1 < k2);
+      TUASSERT(!(k2 < k1));
+      TUASSERT(k1 <= k2);
+      TUASSERT(k2 > k1);
+      TUASSERT(k2 >= k1);
+      TUASSERT(k1 != k2);
+      TUASSERT(k1 == TimeKey(t1));
+         // same time, different systems: distinct but ordered, no throw
+      TUASSERT(k1 != k3);
+      TUASSERT((k1 < k3) != (k3 < k1));
+      TUASSERT(k3 < k2);
+
+      TUCSM("operator-");
+      TUASSERTFEPS(k2 - k1, 1e-6, 1e-15);
+      TUASSERTFEPS(k1 - k2, -1e-6, 1e-15);
+
+      TUCSM("TimeKeyMap");
+      TimeKeyMap<int> m;
+      for (int i = 9; i >= 0; i--)
+      {
+         CommonTime t(t1);
+         t += i * 30.;
+         m[TimeKey(t)] = i;
+      }
+      int expect = 0;
+      for (TimeKeyMap<int>::const_iterator i = m.begin(); i != m.end(); i++)
+         TUASSERTE(int, expect++, i->second);
+      CommonTime t(t1);
+      t += 95.;
+      TimeKeyMap<int>::const_iterator lb = m.lower_bound(TimeKey(t));
+      TUASSERTE(int, 4, lb->second);
+
+      TUCSM("hash");
+      unordered_set<TimeKey> hs;
+      hs.insert(k1);
+      hs.insert(k2);
+      hs.insert(k3);
+      hs.insert(TimeKey(t1));
+      TUASSERTE(size_t, 3, hs.size());
+      TUASSERT(hs.count(TimeKey(t2)) == 1);
+      TURETURN();
+   }
+};
+
+
+int main()
+{
+   unsigned errorTotal = 0;
+   TimeKey_T testClass;
+
+   errorTotal += testClass.convertTest();
+   errorTotal += testClass.orderTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal;
+}
@@ -39,8 +39,11 @@
 #include "TestUtil.hpp"
 #include "BinUtils.hpp"
 #include "Exception.hpp"
+#include "StringUtils.hpp"
 #include <iostream>
 #include <cmath>
+#include <cstdio>
+#include <cstring>
 
 using namespace std;
 
@@ -499,6 +502,162 @@ public:
       crc = computeCRC(data2, len2, gpstk::BinUtils::CRCCCITT);
       TUASSERTE(unsigned long, 0xbf25, crc);
 
+      return testFramework.countFails();
+   }
+
+      //==========================================================
+      //        Test Suite: crc24qTest()
+      //==========================================================
+      //
+      //        Tests the table-driven CRC-24Q against the bit-by-bit
+      //        computeCRC, for byte data and for bit strings of
+      //        every length up to 300 bits.
+      //
+      //==========================================================
+   int crc24qTest(void)
+   {
+      using gpstk::BinUtils::computeCRC;
+      using gpstk::BinUtils::CRCParam;
+      TUDEF("BinUtils", "crc24q");
+      CRCParam gpsCRC(24, 0x864cfb, 0, 0, true, false, false);
+      unsigned char data1[] = "This is a Test!@#$^...";
+      unsigned long len1 = sizeof(data1)-1;
+      TUASSERTE(unsigned long, computeCRC(data1, len1, gpsCRC),
+                gpstk::BinUtils::crc24q(data1, len1));
+         // same result in pieces
+      uint32_t crc = gpstk::BinUtils::crc24q(data1, 5);
+      TUASSERTE(unsigned long, computeCRC(data1, len1, gpsCRC),
+                gpstk::BinUtils::crc24q(data1+5, len1-5, crc));
+
+         // pseudo-random bits, compared bit by bit
+      uint64_t words[5];
+      uint64_t x = 0x123456789abcdef1ULL;
+      for (unsigned i = 0; i < 5; i++)
+      {
+         x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+         words[i] = x;
+      }
+      bool allMatch = true;
+      for (size_t numBits = 0; numBits <= 300; numBits++)
+      {
+         uint32_t ref = 0;
+         for (size_t n = 0; n < numBits; n++)
+         {
+            ref ^= (uint32_t)((words[n >> 6] >> (63 - (n & 63))) & 1) << 23;
+            ref = (ref & 0x800000) ? ((ref << 1) ^ 0x864cfb) : (ref << 1);
+            ref &= 0xffffff;
+         }
+         if (ref != gpstk::BinUtils::crc24qBits(words, numBits))
+         {
+            allMatch = false;
+            TUFAIL("crc24qBits mismatch at " + gpstk::StringUtils::asString(numBits) + " bits");
+         }
+      }
+      TUASSERT(allMatch);
+
+         // appending the CRC gives a remainder of 0
+      unsigned char msg[11] = { 0xd3, 0x00, 0x13, 0x3e, 0xd7, 0xd3, 0x02, 0x02,
+                                0, 0, 0 };
+      crc = gpstk::BinUtils::crc24q(msg, 8);
+      msg[8] = crc >> 16;
+      msg[9] = crc >> 8;
+      msg[10] = crc;
+      TUASSERTE(unsigned long, 0, gpstk::BinUtils::crc24q(msg, 11));
+
+      return testFramework.countFails();
+   }
+
+      //==========================================================
+      //        Test Suite: crc16crc32md5Test()
+      //==========================================================
+      //
+      //        Tests the table-driven CRC-16 and CRC-32 against the
+      //        bit-by-bit computeCRC, including initial values other
+      //        than the default, and MD5 against the RFC 1321 test
+      //        suite.
+      //
+      //==========================================================
+   int crc16crc32md5Test(void)
+   {
+      using gpstk::BinUtils::computeCRC;
+      using gpstk::BinUtils::CRCParam;
+      TUDEF("BinUtils", "crc16");
+      unsigned char data[1000];
+      uint32_t x = 0x12345678;
+      for (unsigned i = 0; i < sizeof(data); i++)
+      {
+         x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+         data[i] = x;
+      }
+      CRCParam p16(gpstk::BinUtils::CRC16), p32(gpstk::BinUtils::CRC32);
+      unsigned nbad16 = 0, nbad32 = 0;
+      for (unsigned len = 0; len < 70; len++)
+      {
+         for (unsigned i = 0; i < 3; i++)
+         {
+            uint32_t init = i * 0x9e3779b9;
+            p16.initial = init & 0xffff;
+            p32.initial = init;
+            if (i == 0)
+               p32.initial = 0xffffffff;
+            if (computeCRC(data + i, len, p16) !=
+                gpstk::BinUtils::crc16(data + i, len, p16.initial))
+               nbad16++;
+            if (computeCRC(data + i, len, p32) !=
+                gpstk::BinUtils::crc32(data + i, len, p32.initial))
+               nbad32++;
+         }
+      }
+      TUASSERTE(unsigned, 0, nbad16);
+      TUCSM("crc32");
+      TUASSERTE(unsigned, 0, nbad32);
+      TUASSERTE(unsigned long, computeCRC(data, sizeof(data),
+                                          gpstk::BinUtils::CRC32),
+                gpstk::BinUtils::crc32(data, sizeof(data)));
+         // the standard check value
+      const unsigned char check[] = "123456789";
+      TUASSERTE(unsigned long, 0xcbf43926,
+                gpstk::BinUtils::crc32(check, 9));
+      TUCSM("crc16");
+      TUASSERTE(unsigned long, 0xbb3d, gpstk::BinUtils::crc16(check, 9));
+
+      TUCSM("MD5");
+      const char *msgs[] =
+      {
+         "", "a", "abc", "message digest", "abcdefghijklmnopqrstuvwxyz",
+         "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789",
+         "1234567890123456789012345678901234567890"
+         "1234567890123456789012345678901234567890"
+      };
+      const char *digests[] =
+      {
+         "d41d8cd98f00b204e9800998ecf8427e",
+         "0cc175b9c0f1b6a831c399e269772661",
+         "900150983cd24fb0d6963f7d28e17f72",
+         "f96b697d7cb7938d525a2f31aaf161d0",
+         "c3fcd3d76192e4007dfb496cca67e13b",
+         "d174ab98d277d9f5a5611c2c9f419d9f",
+         "57edf4a22be3c955ac49da2e2107b67a"
+      };
+      gpstk::BinUtils::MD5 md5;
+      for (unsigned i = 0; i < 7; i++)
+      {
+            // add the message in two pieces
+         size_t len = strlen(msgs[i]), half = len / 3;
+         unsigned char digest[16];
+         md5.update((const unsigned char*)msgs[i], half);
+         md5.update((const unsigned char*)msgs[i] + half, len - half);
+         md5.digest(digest);
+         std::string hex;
+         for (unsigned j = 0; j < 16; j++)
+         {
+            char buf[3];
+            snprintf(buf, sizeof(buf), "%02x", digest[j]);
+            hex += buf;
+         }
+         TUASSERTE(std::string, digests[i], hex);
+      }
+
       return testFramework.countFails();
    }
 
@@ -606,6 +765,8 @@ int main (void)
    errorTotal += testClass.encodeVarTest();
    errorTotal += testClass.encodeVarLETest();
    errorTotal += testClass.computeCRCTest();
+   errorTotal += testClass.crc24qTest();
+   errorTotal += testClass.crc16crc32md5Test();
    errorTotal += testClass.xorChecksumTest();
    errorTotal += testClass.countBitsTest();
 
@@ -412,6 +412,40 @@ public:
    }
 
 
+      /**
+       * Tests for the fixed-width field to number methods.  These
+       * must return exactly what the std::string versions return for
+       * the same characters.
+       */
+   unsigned fieldToNumberTest()
+   {
+      TUDEF("StringUtils", "asDouble(const char*,size_t)");
+      const char *fields[] =
+      {
+         "  23619095.450 ", "    -53875.632 ", "         0.000 ",
+         "        -0.000 ", "   1.234567e+03", "1234567890.12345",
+         "  0.1D+02      ", "          40.25", "      .5       ",
+         "   -          ", "              ", " 0x1A          ",
+         "  12 34        ", "  -999999999.999"
+      };
+      for (unsigned i = 0; i < sizeof(fields)/sizeof(fields[0]); i++)
+      {
+         string field(fields[i]);
+         TUASSERTE(double, asDouble(field),
+                   asDouble(field.c_str(), field.length()));
+         TUASSERTE(long, asInt(field), asInt(field.c_str(), field.length()));
+      }
+         // fields are not assumed to be terminated
+      const char *line = "> 2015 01 01 00 00  0.0000000  0 12";
+      TUCSM("asInt(const char*,size_t)");
+      TUASSERTE(long, 2015, asInt(line+2, 4));
+      TUASSERTE(long, 12, asInt(line+32, 3));
+      TUASSERTE(long, 1, asInt(line+10, 2));
+      TUASSERTE(long, 2147483647L, asInt("2147483647", 10));
+      TURETURN();
+   }
+
+
       /**
        * Tests for the number to string method.
        * Given numbers of various types, convert them to a string and
@@ -1255,6 +1289,7 @@ int main() // Main function to initialize and run all tests above
    errorTotal += testClass.stripTrailingTest();
    errorTotal += testClass.stripTest();
    errorTotal += testClass.stringToNumberTest();
+   errorTotal += testClass.fieldToNumberTest();
    errorTotal += testClass.numberToStringTest();
    errorTotal += testClass.hexConversionTest();
    errorTotal += testClass.stringReplaceTest();
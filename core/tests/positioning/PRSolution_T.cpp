@@ -0,0 +1,181 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+#include "PRSolution.hpp"
+#include "SP3EphemerisStore.hpp"
+#include "RinexObsStream.hpp"
+#include "RinexObsHeader.hpp"
+#include "RinexObsData.hpp"
+#include "NBTropModel.hpp"
+#include "build_config.h"
+#include "TestUtil.hpp"
+
+using namespace std;
+
+class PRSolution_T
+{
+public:
+   PRSolution_T()
+   {
+      string dataFilePath = gpstk::getPathData();
+      string fileSep = gpstk::getFileSep();
+
+      inputObs = dataFilePath + fileSep + "arlm200b.15o";
+      inputSP3 = dataFilePath + fileSep + "test_input_sp3_nav_2015_200.sp3";
+   }
+
+      /** Run RAIM on C1 data, with two satellites given large errors at
+       * each epoch, serially and with threads; the results must be
+       * identical. */
+   unsigned threadTest()
+   {
+      TUDEF("PRSolution", "RAIMCompute");
+      try
+      {
+         gpstk::SP3EphemerisStore eph;
+         eph.loadFile(inputSP3);
+
+         for (int early = 0; early < 2; early++)
+         {
+            gpstk::PRSolution serial, threaded;
+            setup(serial, early);
+            setup(threaded, early);
+            threaded.NThreads = 4;
+            gpstk::NBTropModel tropSerial(200., 30.4, 200), tropThreaded(200., 30.4, 200);
+
+            gpstk::RinexObsStream ros(inputObs.c_str());
+            gpstk::RinexObsHeader roh;
+            gpstk::RinexObsData rod;
+            ros >> roh;
+            int nepochs = 0, ngood = 0;
+            while (ros >> rod && nepochs < 30)
+            {
+               vector<gpstk::SatID> sats;
+               vector<double> prs;
+               gpstk::RinexObsData::RinexSatMap::const_iterator it;
+               for (it = rod.obs.begin(); it != rod.obs.end(); it++)
+               {
+                  double c1 = it->second.find(gpstk::RinexObsHeader::C1)
+                     ->second.data;
+                  if (c1 == 0.)
+                     continue;
+                     // blunders that need two rejections
+                  if (sats.size() == 1)
+                     c1 += 150.;
+                  else if (sats.size() == 4)
+                     c1 -= 400.;
+                  sats.push_back(it->first);
+                  prs.push_back(c1);
+               }
+               vector<gpstk::SatID> satsThreaded(sats);
+               gpstk::Matrix<double> invMC;
+               int iretS = serial.RAIMCompute(rod.time, sats, prs, invMC,
+                                              &eph, &tropSerial);
+               int iretT = threaded.RAIMCompute(rod.time, satsThreaded, prs,
+                                                invMC, &eph, &tropThreaded);
+               nepochs++;
+               TUASSERTE(int, iretS, iretT);
+               TUASSERTE(bool, serial.isValid(), threaded.isValid());
+               TUASSERT(sats == satsThreaded);
+               if (iretS < 0)
+                  continue;
+               TUASSERTE(int, serial.Nsvs, threaded.Nsvs);
+               TUASSERTE(double, serial.RMSResidual, threaded.RMSResidual);
+               TUASSERTE(double, serial.MaxSlope, threaded.MaxSlope);
+               TUASSERTE(int, serial.NIterations, threaded.NIterations);
+               TUASSERTE(size_t, serial.Solution.size(),
+                         threaded.Solution.size());
+               for (unsigned i = 0; i < serial.Solution.size(); i++)
+                  TUASSERTE(double, serial.Solution(i), threaded.Solution(i));
+               TUASSERTE(size_t, serial.PreFitResidual.size(),
+                         threaded.PreFitResidual.size());
+               for (unsigned i = 0; i < serial.PreFitResidual.size(); i++)
+                  TUASSERTE(double, serial.PreFitResidual(i),
+                            threaded.PreFitResidual(i));
+               for (unsigned i = 0; i < serial.Covariance.rows(); i++)
+                  for (unsigned j = 0; j < serial.Covariance.cols(); j++)
+                     TUASSERTE(double, serial.Covariance(i,j),
+                               threaded.Covariance(i,j));
+               if (iretS > 0)
+                  continue;
+               ngood++;
+                  // both blunders are removed
+               TUASSERT(sats[1].id < 0);
+               TUASSERT(sats[4].id < 0);
+               if (early)
+               {
+                  TUASSERT(serial.RMSResidual < serial.RMSLimit);
+                  TUASSERT(serial.MaxSlope <= serial.SlopeLimit);
+               }
+            }
+            TUASSERTE(int, 30, nepochs);
+            TUASSERT(ngood > 20);
+         }
+      }
+      catch (gpstk::Exception& exc)
+      {
+         cerr << exc << endl;
+         TUFAIL("Unexpected exception");
+      }
+      TURETURN();
+   }
+
+private:
+   void setup(gpstk::PRSolution& prs, bool early)
+   {
+      prs.allowedGNSS.push_back(gpstk::SatelliteSystem::GPS);
+      prs.RMSLimit = 10.;
+      prs.NSatsReject = 2;
+      prs.EarlyTermination = early;
+   }
+
+   string inputObs, inputSP3;
+};
+
+
+int main()
+{
+   unsigned errorTotal = 0;
+   PRSolution_T testClass;
+
+   errorTotal += testClass.threadTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal;
+}
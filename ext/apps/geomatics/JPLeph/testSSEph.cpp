@@ -102,7 +102,7 @@ try {
       + Version + ", " + printTime(CurrEpoch,"Run %04Y/%02m/%02d at %02H:%02M:%02S");
 
    // default command line input
-   bool verbose=false,debug=false;
+   bool verbose=false,debug=false,mapped=false;
    string inputFilename,testFilename,logFilename;
 
    // parse the command line input
@@ -127,6 +127,7 @@ try {
             << "   --log <file>   name of optional log file (otherwise stderr)\n"
             << "   --file <file>  name of binary SS ephemeris file\n"
             << "   --test <file>  name of JPL test file (e.g. testpo.403)\n"
+            << "   --mapped       map the binary file into memory, rather than read it.\n"
             << "   --verbose      print info to the log file.\n"
             << "   --debug        print debugging info to the log file.\n"
             << "   --help         print this and quit.\n"
@@ -139,6 +140,7 @@ try {
       else if(word == "--log") logFilename = string(argv[++i]);
       else if(word == "--file") inputFilename = string(argv[++i]);
       else if(word == "--test") testFilename = string(argv[++i]);
+      else if(word == "--mapped") mapped = true;
    }
 
    // test input
@@ -179,7 +181,10 @@ try {
    // now read the binary file, and read selected records
    // use the binary to test using the JPL file testpo.<EPH#>
    LOG(VERBOSE) << "Initialize with file " << inputFilename;
-   SSEphemeris.initializeWithBinaryFile(inputFilename);
+   if(mapped)
+      SSEphemeris.initializeWithMappedFile(inputFilename);
+   else
+      SSEphemeris.initializeWithBinaryFile(inputFilename);
    LOG(VERBOSE) << "End Initialize";
    LOG(INFO) << "Ephemeris number is " << SSEphemeris.EphNumber();
 
@@ -41,6 +41,8 @@
 #ifndef GPSTK_ENUUTIL_HPP
 #define GPSTK_ENUUTIL_HPP
 
+#include <cstddef>
+
 // gpstk
 #include "Triple.hpp"
 #include "Matrix.hpp"
@@ -79,6 +81,17 @@ namespace gpstk
          gpstk::Triple         convertToENU( const gpstk::Triple& inVec ) const;
          gpstk::Xvt            convertToENU( const gpstk::Xvt& in ) const;
 
+         /**
+          * Convert n vectors in ECEF XYZ, stored as contiguous
+          * triples, to ENU using the current rotation matrix.
+          * @param inXYZ n vectors of interest in ECEF XYZ.
+          * @param outENU n vectors in ENU; may be the same array as inXYZ.
+          * @param n number of vectors.
+          */
+         void                  convertToENU( const double *inXYZ,
+                                             double *outENU,
+                                             std::size_t n ) const;
+
          /**
           * Update the rotation matrix to the new location without creating
           * a new object
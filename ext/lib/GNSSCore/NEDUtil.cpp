@@ -112,4 +112,20 @@ gpstk::Xvt NEDUtil::convertToNED( const gpstk::Xvt& in ) const
    out.v = convertToNED( in.v );
    return(out);
 }
+
+void NEDUtil::convertToNED( const double *inXYZ,
+                           double *outNED,
+                           std::size_t n ) const
+{
+   const double r00 = rotMat(0,0), r01 = rotMat(0,1), r02 = rotMat(0,2);
+   const double r10 = rotMat(1,0), r11 = rotMat(1,1), r12 = rotMat(1,2);
+   const double r20 = rotMat(2,0), r21 = rotMat(2,1), r22 = rotMat(2,2);
+   for (std::size_t i=0; i<n; i++, inXYZ+=3, outNED+=3)
+   {
+      double x = inXYZ[0], y = inXYZ[1], z = inXYZ[2];
+      outNED[0] = r00*x + r01*y + r02*z;
+      outNED[1] = r10*x + r11*y + r12*z;
+      outNED[2] = r20*x + r21*y + r22*z;
+   }
+}
 }     // end namespace gpstk
@@ -41,6 +41,8 @@
 #ifndef GPSTK_NEDUTIL_HPP
 #define GPSTK_NEDUTIL_HPP
 
+#include <cstddef>
+
 // gpstk
 #include "Triple.hpp"
 #include "Matrix.hpp"
@@ -77,6 +79,17 @@ namespace gpstk
          gpstk::Vector<double> convertToNED( const gpstk::Vector<double>& inV ) const;
          gpstk::Triple         convertToNED( const gpstk::Triple& inVec ) const;
          gpstk::Xvt            convertToNED( const gpstk::Xvt& in ) const;
+
+         /**
+          * Convert n vectors in ECEF XYZ, stored as contiguous
+          * triples, to NED using the current rotation matrix.
+          * @param inXYZ n vectors of interest in ECEF XYZ.
+          * @param outNED n vectors in NED; may be the same array as inXYZ.
+          * @param n number of vectors.
+          */
+         void                  convertToNED( const double *inXYZ,
+                                             double *outNED,
+                                             std::size_t n ) const;
          
          /**
           * Update the rotation matrix to the new location without creating
@@ -100,6 +100,20 @@ public:
    ///                if there is corruption in the static arrays
    Triple computeDisplacement(std::string site, EphTime t, double UT1mUTC=0);
 
+   /// Return the 12 coefficients for the given site, in millimeters, in the order
+   /// (cos1,sin1,cos2,sin2) for each of RADIAL, NS and EW; see computeDisplacement().
+   /// @param site  string Input name of the site; must be the same as previously
+   ///              successfully passed to initializeSites().
+   /// @throw if the site has not been initialized.
+   const std::vector<double>& getCoefficients(std::string site) const
+   {
+      std::map<std::string, std::vector<double> >::const_iterator it;
+      it = coefficientMap.find(site);
+      if(it == coefficientMap.end())
+         GPSTK_THROW(Exception("Site not found in atmospheric loading store"));
+      return it->second;
+   }
+
    /// Return the recorded latitude, longitude and ht(=0) for the given site.
    /// Return value of (0.0,0.0,0.0) probably means the position was not found.
    Triple getPosition(std::string site)
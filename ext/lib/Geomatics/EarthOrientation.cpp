@@ -50,6 +50,7 @@
 #include "logstream.hpp"
 
 #include "EarthOrientation.hpp"
+#include "NutationSeries.hpp"
 
 //------------------------------------------------------------------------------------
 using namespace std;
@@ -1463,96 +1464,8 @@ namespace gpstk
    void EarthOrientation::XYCIO(double& T, double& X, double& Y)
       throw()
    {
-      // include data arrays : defines MAXPT
-      #include "IERS2010CIOSeriesData.hpp"
-
-      int i,j;
-      double t;
-
-      // compute and store powers of T
-      double powsT[MAXPT+1];
-      t = 1.0;
-      for(i=0; i<=MAXPT; i++) {
-         powsT[i] = t;
-         t *= T;
-      }
-
-      // fundamental arguments
-      double fa[14];
-      fa[0] = L(T);     // mean anomaly of the moon
-      fa[1] = Lp(T);    // mean anomaly of the sun
-      fa[2] = F(T);     // mean longitude of the moon - Omega
-      fa[3] = D(T);     // mean elongation of the moon from the sun
-      fa[4] = Omega2003(T); // mean longitude of lunar ascending node
-      fa[5] = LMe(T);   // mean longitude Mercury
-      fa[6] = LV(T);    // mean longitude of Venus
-      fa[7] = LE(T);    // mean longitude of Earth
-      fa[8] = LMa(T);   // mean longitude Mars
-      fa[9] = LJ(T);    // mean longitude Jupiter
-      fa[10] = LS(T);   // mean longitude Saturn
-      fa[11] = LU(T);   // mean longitude Uranus
-      fa[12] = LN(T);   // mean longitude Neptune
-      fa[13] = Pa(T);   // general precession in longitude
-
-      // intermediate totals
-      double xypoly[2]={0.0,0.0},xylunarsolar[2]={0.0,0.0},xyplanet[2]={0.0,0.0};
-
-      // polynomial
-      for(i=0; i<2; i++) {
-         for(j=MAXPT; j>=0; j--)
-            xypoly[i] += XYcoeff[i][j] * powsT[j];
-      }
-
-      // nutation planetary terms
-      int ilast(NAmp),jlast;
-      double sc[2];
-      for(int ifreq=NFAP-1; ifreq >= 0; ifreq--) {
-         // build the argument
-         double arg(0.0);
-         for(i=0; i<14; i++)
-            if(nFAplanetary[ifreq][i])                         // don't add zero
-               arg += double(nFAplanetary[ifreq][i]) * fa[i];
-            
-         // store sin and cos
-         sc[0] = ::sin(arg);
-         sc[1] = ::cos(arg);
-
-         // amplitudes
-         jlast = iamp[ifreq+NFALS];
-         for(i=ilast; i >= jlast; i--) {
-            j = i - jlast;          // coeff number
-            xyplanet[jaxy[j]] += amp[i-1] * sc[jasc[j]] * powsT[japt[j]];
-         }
-         ilast = jlast - 1;
-      }
-
-      // NB ilast is maintained through this point
-
-      // nutation lunar solar terms
-      for(int ifreq=NFALS-1; ifreq >= 0; ifreq--) {
-         // build the argument
-         double arg(0.0);
-         for(i=0; i<5; i++)
-            if(nFAlunarsolar[ifreq][i])                         // don't add zero
-               arg += double(nFAlunarsolar[ifreq][i]) * fa[i];
-            
-         // store sin and cos
-         sc[0] = ::sin(arg);
-         sc[1] = ::cos(arg);
-
-         // amplitudes
-         jlast = iamp[ifreq];
-         for(i=ilast; i >= jlast; i--) {
-            j = i - jlast;          // coeff number
-            xylunarsolar[jaxy[j]] += amp[i-1] * sc[jasc[j]] * powsT[japt[j]];
-         }
-         ilast = jlast - 1;
-      }
-
-      X = xypoly[0] + (xylunarsolar[0]+xyplanet[0])*1.e-6;
-      X *= ARCSEC_TO_RAD;
-      Y = xypoly[1] + (xylunarsolar[1]+xyplanet[1])*1.e-6;
-      Y *= ARCSEC_TO_RAD;
+      // the series is evaluated by NutationSeries, from IERS2010CIOSeriesData.hpp
+      NutationSeries::XYCIO(&T, 1, &X, &Y);
    }
 
    //---------------------------------------------------------------------------------
@@ -2191,119 +2104,8 @@ namespace gpstk
    void EarthOrientation::NutationAngles2003(double T, double& deps, double& dpsi)
       throw()
    {
-      // sin and cos coefficients have units 0.1 microarcsec = 1e-7as
-      const double COEFF_TO_RAD(ARCSEC_TO_RAD*1.0e-7);
-
-      // -----------------------------------------
-      // include huge static arrays of coefficients
-      #include "IERS2003NutationData.hpp"
-
-      // -----------------------------------------
-      // Lunar-Solar nutation
-      // fundamental arguments, in radians
-      double l(L(T));                 // mean anomaly of the moon
-
-      double lp(::fmod(  1287104.79305    // mean anomaly of the sun MHB2000 value
-                  + T*(129596581.0481
-                  + T*(       -0.5532
-                  + T*(        0.000136
-                  + T*(       -0.00001149)))), ARCSEC_PER_CIRCLE) * ARCSEC_TO_RAD);
-
-      double f(::fmod(    335779.526232 // mean longitude of moon minus Omega MHB2000
-                 + T*(1739527262.8478
-                 + T*(       -12.7512
-                 + T*(        -0.001037
-                 + T*(         0.00000417)))), ARCSEC_PER_CIRCLE) * ARCSEC_TO_RAD);
-
-      double d(::fmod(   1072260.70369     // mean elongation moon from sun MHB2000
-                 + T*(1602961601.2090
-                 + T*(        -6.3706
-                 + T*(         0.006593
-                 + T*(        -0.00003169)))), ARCSEC_PER_CIRCLE) * ARCSEC_TO_RAD);
-
-      double Om(Omega2003(T));        // mean longitude of lunar ascending node
-
-      // initialize
-      deps = dpsi = 0.0;
-      int i;
-      double arg,sina,cosa;
-
-      // form the LS series
-      for(i=NLS-1; i>=0; --i) {
-         // argument
-         arg = ::fmod(LSCoeff[i].nl * l +
-                      LSCoeff[i].nlp * lp +
-                      LSCoeff[i].nf * f +
-                      LSCoeff[i].nd * d +
-                      LSCoeff[i].nom * Om, TWOPI);
-         sina = ::sin(arg);
-         cosa = ::cos(arg);
-         // term
-         deps += (LSCoeff[i].ce + LSCoeff[i].cet * T) * cosa + LSCoeff[i].se * sina;
-         dpsi += (LSCoeff[i].sp + LSCoeff[i].spt * T) * sina + LSCoeff[i].cp * cosa;
-      }
-
-      // -----------------------------------------
-      // Planetary nutation
-      // fundamental arguments, in radians.
-
-      // NB MHB2000 values are very close to IERS2003; follow SOFA here TD ??
-      // mean anomaly of the moon MHB2000 value
-      l = ::fmod(2.35555598 + 8328.6914269554 * T, TWOPI);
-      // mean longitude of the moon minus Omega MHB2000 value
-      f = ::fmod(1.627905234 + 8433.466158131 * T, TWOPI);
-      // mean elongation of the Moon from the Sun MHB2000 value
-      d = ::fmod(5.198466741 + 7771.3771468121 * T, TWOPI);
-      // mean longitude of lunar ascending node MHB2000 value
-      Om = ::fmod(2.18243920 - 33.757045 * T, TWOPI);
-
-      // mean longitude Mercury
-      double lme(LMe(T));
-      // mean longitude of Venus
-      double lve(LV(T));
-      // mean longitude of Earth
-      double lea(LE(T));
-      // mean longitude Mars
-      double lma(LMa(T));
-      // mean longitude Jupiter
-      double lju(LJ(T));
-      // mean longitude Saturn
-      double lsa(LS(T));
-      // mean longitude Uranus
-      double lur(LU(T));
-      // mean longitude Neptune
-      double lne(::fmod(5.321159000 + 3.8127774000 * T, TWOPI));
-      // general precession in longitude
-      double pa(Pa(T));
-
-      // form the planetary series
-      for(i=NP-1; i>=0; --i) {
-         // argument
-         arg = ::fmod(PCoeff[i].nl * l +
-                    PCoeff[i].nf * f +
-                    PCoeff[i].nd * d +
-                    PCoeff[i].nom * Om +
-                    PCoeff[i].nme * lme +
-                    PCoeff[i].nve * lve +
-                    PCoeff[i].nea * lea +
-                    PCoeff[i].nma * lma +
-                    PCoeff[i].nju * lju +
-                    PCoeff[i].nsa * lsa +
-                    PCoeff[i].nur * lur +
-                    PCoeff[i].nne * lne +
-                    PCoeff[i].npa * pa, TWOPI);
-         sina = ::sin(arg);
-         cosa = ::cos(arg);
-         // term
-         deps += PCoeff[i].ce * cosa + PCoeff[i].se * sina;
-         dpsi += PCoeff[i].sp * sina + PCoeff[i].cp * cosa;
-      }
-
-      // convert 0.1microarcsec to radians
-      deps *= COEFF_TO_RAD;
-      dpsi *= COEFF_TO_RAD;
-
-      return;
+      // the series is evaluated by NutationSeries, from IERS2003NutationData.hpp
+      NutationSeries::NutationAngles2003(&T, 1, &deps, &dpsi);
    }
 
    //---------------------------------------------------------------------------------
@@ -2588,6 +2390,116 @@ namespace gpstk
       catch(Exception& e) { GPSTK_RETHROW(e); }
    }
 
+   //---------------------------------------------------------------------------------
+   // Precession-nutation matrix for IERS 1996, the product N*P used in
+   // ECEFtoInertial1996(), plus the angles that gast1996() needs, all of which
+   // depend only on the coordinate transformation time T.
+   // param T CoordTransTime of interest
+   // param om output mean longitude of lunar ascending node in radians
+   // param eps output mean obliquity of the ecliptic in radians
+   // param dpsi output nutation in longitude in radians
+   // return 3x3 rotation matrix
+   Matrix<double> EarthOrientation::NPBMatrix1996(double T,
+                                         double& om, double& eps, double& dpsi)
+      throw()
+   {
+      // precession
+      Matrix<double> P = PrecessionMatrix1996(T);
+      LOG(DEBUG7) << "\nprecession matrix:\n" << fixed << setprecision(15)
+            << setw(18) << showpos << P;
+
+      // nutation
+      double deps;
+      // mean obliquity radians
+      eps = Obliquity1996(T);
+      LOG(DEBUG7) << "\nmean obliquity " << fixed << setprecision(15)
+         << showpos << eps;
+      // nutation angles - om is used in gast
+      NutationAngles1996(T,deps,dpsi,om);
+      LOG(DEBUG7) << "\nnutation angles psi eps " << fixed << setprecision(15)
+         << showpos << dpsi << " " << deps;
+      // nutation matrix
+      Matrix<double> N = NutationMatrix(eps,dpsi,deps);
+      LOG(DEBUG7) << "\nnutation matrix:\n" << fixed << setprecision(15)
+            << setw(18) << showpos << N;
+
+      Matrix<double> NP(N*P);
+      LOG(DEBUG7) << "\nNPB matrix:\n" << fixed << setprecision(15)
+            << setw(18) << showpos << NP;
+
+      return NP;
+   }
+
+   //---------------------------------------------------------------------------------
+   // Nutation x precession x frame bias matrix for IERS 2003, as used in
+   // ECEFtoInertial2003(); this is the part of the transformation that depends
+   // only on the coordinate transformation time T.
+   // param T CoordTransTime of interest
+   // return 3x3 rotation matrix
+   Matrix<double> EarthOrientation::NPBMatrix2003(double T)
+      throw()
+   {
+      // nutation
+      double deps, dpsi, dpsipr, depspr;
+      NutationAngles2003(T,deps,dpsi);
+      LOG(DEBUG7) << "\nnutation angles psi eps " << fixed << setprecision(15)
+         << showpos << dpsi << " " << deps;
+
+      // Precession rate contributions with respect to IAU 2000
+      // Precession and obliquity corrections (radians)
+      PrecessionRateCorrections2003(T, dpsipr, depspr);
+      LOG(DEBUG7) << "\nprecession-rate " << fixed << setprecision(15)
+         << showpos << dpsipr << " " << depspr;
+
+      double eps(Obliquity1996(T));         // same as 2003
+      LOG(DEBUG7) << "\nmean obliquity " << fixed << setprecision(15)
+         << showpos << eps;
+      eps += depspr;
+
+      Matrix<double> N = NutationMatrix(eps,dpsi,deps);
+      LOG(DEBUG7) << "\nnutation matrix:\n" << fixed << setprecision(15)
+            << setw(18) << showpos << N;
+
+      // precession
+      Matrix<double> P = PrecessionMatrix2003(T);
+
+      Matrix<double> NPB(N*P);
+      LOG(DEBUG7) << "\nNPB matrix:\n" << fixed << setprecision(15) << setw(18)
+            << showpos << NPB;
+
+      return NPB;
+   }
+
+   //---------------------------------------------------------------------------------
+   // GCRS-to-CIRS matrix for IERS 2010, from the CIO coordinates X,Y and the
+   // locator s, as used in ECEFtoInertial2010(); cf. sofa c2ixys.
+   // param T CoordTransTime of interest
+   // return 3x3 rotation matrix
+   Matrix<double> EarthOrientation::NPBMatrix2010(double T)
+      throw()
+   {
+      // get the CIO coordinates and s
+      // note that X,Y could also be obtained as (2,0),(2,1) components
+      // of FukushimaWilliams()
+      double X,Y,s;
+      XYCIO(T, X, Y);
+      s = S(T,X,Y,IERSConvention::IERS2010);
+      LOG(DEBUG7) << "X = " << fixed << setprecision(15) << showpos << X;
+      LOG(DEBUG7) << "Y = " << fixed << setprecision(15) << showpos << Y;
+      LOG(DEBUG7) << "s\" = " << fixed << setprecision(15) << s/ARCSEC_TO_RAD;
+
+      // compute transformation GCRS-to-CIRS or inertial-to-intermediate-celestial
+      double r2(X*X+Y*Y);                          // squared radius
+      double e(r2 != 0.0 ? ::atan2(Y, X) : 0.0);   // spherical angles
+      double d(::atan(::sqrt(r2/(1.0-r2))));       //
+      Matrix<double> GCRStoCIRS;
+      GCRStoCIRS = rotation(-(e+s),3) * rotation(d, 2) * rotation(e, 3);
+      LOG(DEBUG7) << "\nNPB matrix:\n" << fixed << setprecision(15) << setw(18)
+            << showpos << GCRStoCIRS;
+
+      return GCRStoCIRS;
+   }
+
    //---------------------------------------------------------------------------------
    // Generate the full transformation matrix (3x3 rotation) relating the ECEF
    // frame to the conventional inertial frame, using IERS 1996 conventions.
@@ -2598,32 +2510,13 @@ namespace gpstk
                        double xp, double yp, double UT1mUTC, bool reduced)
    {
       try {
-         Matrix<double> P,N,W,S;
+         Matrix<double> NP,W,S;
 
          double T=CoordTransTime(t);
 
-         // precession
-         P = PrecessionMatrix1996(T);
-         LOG(DEBUG7) << "\nprecession matrix:\n" << fixed << setprecision(15)
-               << setw(18) << showpos << P;
-
-         // nutation
-         double eps,deps,dpsi,om;
-         // mean obliquity radians
-         eps = Obliquity1996(T);
-         LOG(DEBUG7) << "\nmean obliquity " << fixed << setprecision(15)
-            << showpos << eps;
-         // nutation angles - om is used in gast
-         NutationAngles1996(T,deps,dpsi,om);
-         LOG(DEBUG7) << "\nnutation angles psi eps " << fixed << setprecision(15)
-            << showpos << dpsi << " " << deps;
-         // nutation matrix
-         N = NutationMatrix(eps,dpsi,deps);
-         LOG(DEBUG7) << "\nnutation matrix:\n" << fixed << setprecision(15)
-               << setw(18) << showpos << N;
-
-         LOG(DEBUG7) << "\nNPB matrix:\n" << fixed << setprecision(15)
-               << setw(18) << showpos << N*P;
+         // precession and nutation
+         double om,eps,dpsi;
+         NP = NPBMatrix1996(T, om, eps, dpsi);
 
          // if reduced (NGA), correct UT1mUTC for tides
          double UT1mUT1R,dlodR,domegaR;
@@ -2638,14 +2531,14 @@ namespace gpstk
 
          S = rotation(g,3);
          LOG(DEBUG7) << "\ncelestial-to-terrestrial matrix (no polar motion):\n"
-               << fixed << setprecision(15) << setw(18) << showpos << S*N*P;
+               << fixed << setprecision(15) << setw(18) << showpos << S*NP;
 
          // Polar Motion
          W = PolarMotionMatrix1996(xp, yp);
          LOG(DEBUG7) << "\npolar motion matrix:\n" << fixed << setprecision(15)
                << setw(18) << showpos << W;
 
-         return transpose(W*S*N*P);
+         return transpose(W*S*NP);
       }
       catch(Exception& e) { GPSTK_RETHROW(e); }
    }
@@ -2660,7 +2553,7 @@ namespace gpstk
                                                 double xp, double yp, double UT1mUTC)
    {
       try {
-         Matrix<double> P,N,R,W;
+         Matrix<double> R,W;
 
          double T(CoordTransTime(t));
 
@@ -2674,33 +2567,8 @@ namespace gpstk
                   << showpos << gast*RAD_TO_DEG;
          }
 
-         // nutation
-         double deps, dpsi, dpsipr, depspr;
-         NutationAngles2003(T,deps,dpsi);
-         LOG(DEBUG7) << "\nnutation angles psi eps " << fixed << setprecision(15)
-            << showpos << dpsi << " " << deps;
-
-         // Precession rate contributions with respect to IAU 2000
-         // Precession and obliquity corrections (radians)
-         PrecessionRateCorrections2003(T, dpsipr, depspr);
-         LOG(DEBUG7) << "\nprecession-rate " << fixed << setprecision(15)
-            << showpos << dpsipr << " " << depspr;
-
-         double eps(Obliquity1996(T));         // same as 2003
-         LOG(DEBUG7) << "\nmean obliquity " << fixed << setprecision(15)
-            << showpos << eps;
-         eps += depspr;
-
-         N = NutationMatrix(eps,dpsi,deps);
-         LOG(DEBUG7) << "\nnutation matrix:\n" << fixed << setprecision(15)
-               << setw(18) << showpos << N;
-
-         // precession
-         P = PrecessionMatrix2003(T);
-
-         Matrix<double> NPB(N*P);
-         LOG(DEBUG7) << "\nNPB matrix:\n" << fixed << setprecision(15) << setw(18)
-               << showpos << NPB;
+         // nutation, precession and frame bias
+         Matrix<double> NPB(NPBMatrix2003(T));
 
          // ERA replaces GAST in the Earth rotation matrix
          double era(EarthRotationAngle(t,UT1mUTC));
@@ -2716,7 +2584,7 @@ namespace gpstk
          LOG(DEBUG7) << "\npolar motion matrix:\n" << fixed << setprecision(15)
                << setw(18) << showpos << W;
 
-         return transpose(W*R*N*P);
+         return transpose(W*R*NPB);
       }
       catch(Exception& e) { GPSTK_RETHROW(e); }
    }
@@ -2733,25 +2601,8 @@ namespace gpstk
       try {
          double T(CoordTransTime(t));
 
-         // get the CIO coordinates and s
-         // note that X,Y could also be obtained as (2,0),(2,1) components
-         // of FukushimaWilliams()
-         double X,Y,s;
-         XYCIO(T, X, Y);
-         s = S(T,X,Y,IERSConvention::IERS2010);
-         LOG(DEBUG7) << "X = " << fixed << setprecision(15) << showpos << X;
-         LOG(DEBUG7) << "Y = " << fixed << setprecision(15) << showpos << Y;
-         LOG(DEBUG7) << "s\" = " << fixed << setprecision(15) << s/ARCSEC_TO_RAD;
-
-         // compute transformation GCRS-to-CIRS or inertial-to-intermediate-celestial
-         // cf. sofa c2ixys
-         double r2(X*X+Y*Y);                          // squared radius
-         double e(r2 != 0.0 ? ::atan2(Y, X) : 0.0);   // spherical angles
-         double d(::atan(::sqrt(r2/(1.0-r2))));       //
-         Matrix<double> GCRStoCIRS;
-         GCRStoCIRS = rotation(-(e+s),3) * rotation(d, 2) * rotation(e, 3);
-         LOG(DEBUG7) << "\nNPB matrix:\n" << fixed << setprecision(15) << setw(18)
-               << showpos << GCRStoCIRS;
+         // GCRS-to-CIRS or inertial-to-intermediate-celestial
+         Matrix<double> GCRStoCIRS(NPBMatrix2010(T));
 
          // note that we could have called PreciseEarthRotation2010() instead
 
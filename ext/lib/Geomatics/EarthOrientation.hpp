@@ -382,6 +382,10 @@ namespace gpstk {
       Matrix<double> ECEFtoJ2000(const EphTime& t, bool reduced=false);
 
    private:
+      /// EarthRotationCache interpolates the NPB matrices and applies the same
+      /// polar motion and Earth rotation, so it uses the private functions.
+      friend class EarthRotationCache;
+
       //------------------------------------------------------------------------------
       /// locator s which gives the position of the CIO on the equator of
       /// the CIP, given the coordinate transformation time T and the coordinates X,Y
@@ -732,6 +736,36 @@ namespace gpstk {
       /// @throw Exception if the TimeSystem conversion fails (if TimeSystem is Unknown)
       static Matrix<double> PreciseEarthRotation2010(double T);
 
+      //------------------------------------------------------------------------------
+      /// Precession-nutation matrix N*P for IERS 1996, as used in
+      /// ECEFtoInertial1996(), plus the angles passed to gast1996(). These
+      /// depend only on T; cf. EarthRotationCache.
+      /// @param T CoordTransTime(EphTime t) for time of interest
+      /// @param om output Omega(T), mean longitude of lunar ascending node, radians
+      /// @param eps output mean obliquity of the ecliptic, radians
+      /// @param dpsi output nutation in longitude, radians
+      /// @return 3x3 rotation matrix
+      static Matrix<double> NPBMatrix1996(double T,
+                                          double& om, double& eps, double& dpsi)
+         throw();
+
+      //------------------------------------------------------------------------------
+      /// Nutation x precession x frame bias matrix for IERS 2003, as used in
+      /// ECEFtoInertial2003(). This depends only on T; cf. EarthRotationCache.
+      /// @param T CoordTransTime(EphTime t) for time of interest
+      /// @return 3x3 rotation matrix
+      static Matrix<double> NPBMatrix2003(double T)
+         throw();
+
+      //------------------------------------------------------------------------------
+      /// GCRS-to-CIRS matrix for IERS 2010, computed from the CIO coordinates X,Y
+      /// and the locator s, as used in ECEFtoInertial2010(). This depends only on T;
+      /// cf. EarthRotationCache.
+      /// @param T CoordTransTime(EphTime t) for time of interest
+      /// @return 3x3 rotation matrix
+      static Matrix<double> NPBMatrix2010(double T)
+         throw();
+
       //------------------------------------------------------------------------------
       /// Generate the full transformation matrix (3x3 rotation) relating the ECEF
       /// frame to the conventional inertial frame, using IERS 1996 conventions.
@@ -0,0 +1,323 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+
+/// @file EarthRotationCache.cpp
+/// Implement class EarthRotationCache, which computes the transformation between
+/// the ECEF and inertial frames of EarthOrientation at many epochs, interpolating
+/// the slowly varying precession-nutation part.
+
+//------------------------------------------------------------------------------------
+// system includes
+#include <cmath>
+// GPSTk
+#include "EarthRotationCache.hpp"
+
+//------------------------------------------------------------------------------------
+using namespace std;
+
+namespace gpstk
+{
+   //---------------------------------------------------------------------------------
+   // constants
+   // grid step limits, days
+   const double EarthRotationCache::minStep=1.0/96.0;
+   const double EarthRotationCache::maxStep=4.0;
+
+   // maximum number of grid points in the cache; with the default accuracy this is
+   // more than two years
+   const unsigned EarthRotationCache::maxNodes=2048;
+
+   // The error of 4-point Lagrange interpolation with step h is bounded by
+   // (9/16)/4! * h^4 * max|f''''|; the fourth derivative of the NPB elements is
+   // dominated by the fortnightly and 9-day nutation terms. This constant
+   // (radians/day^4) is the bound, with margin, so that h = (accuracy/C)^(1/4).
+   static const double interpErrorCoeff=5.0e-9;
+
+   //---------------------------------------------------------------------------------
+   // 3x3 helpers - internal use only
+
+   // R = rotation(angle,axis), as gpstk::rotation() but fixed size
+   static void rotation3(double angle, int axis, double R[3][3]) throw()
+   {
+      int i1 = axis-1;
+      int i2 = (i1+1) % 3;
+      int i3 = (i2+1) % 3;
+      for(int i=0; i<3; i++)
+         for(int j=0; j<3; j++)
+            R[i][j] = 0.0;
+      R[i1][i1] = 1.0;
+      R[i2][i2] = R[i3][i3] = ::cos(angle);
+      R[i3][i2] = -(R[i2][i3] = ::sin(angle));
+   }
+
+   // C = A * B; C may not be A or B
+   static void multiply3(const double A[3][3], const double B[3][3], double C[3][3])
+      throw()
+   {
+      for(int i=0; i<3; i++)
+         for(int j=0; j<3; j++)
+            C[i][j] = A[i][0]*B[0][j] + A[i][1]*B[1][j] + A[i][2]*B[2][j];
+   }
+
+   //---------------------------------------------------------------------------------
+   EarthRotationCache::Rotation EarthRotationCache::Rotation::transpose(void) const
+      throw()
+   {
+      Rotation R;
+      for(int i=0; i<3; i++)
+         for(int j=0; j<3; j++)
+            R.m[i][j] = m[j][i];
+      return R;
+   }
+
+   //---------------------------------------------------------------------------------
+   void EarthRotationCache::Rotation::rotate(const double in[3], double out[3]) const
+      throw()
+   {
+      double v[3] = { in[0], in[1], in[2] };
+      for(int i=0; i<3; i++)
+         out[i] = m[i][0]*v[0] + m[i][1]*v[1] + m[i][2]*v[2];
+   }
+
+   //---------------------------------------------------------------------------------
+   Matrix<double> EarthRotationCache::Rotation::asMatrix(void) const
+   {
+      Matrix<double> M(3,3);
+      for(int i=0; i<3; i++)
+         for(int j=0; j<3; j++)
+            M(i,j) = m[i][j];
+      return M;
+   }
+
+   //---------------------------------------------------------------------------------
+   EarthRotationCache::EarthRotationCache(IERSConvention conv, double acc)
+      : convention(conv), haveLast(false)
+   {
+      if(convention != IERSConvention::IERS1996 &&
+         convention != IERSConvention::IERS2003 &&
+         convention != IERSConvention::IERS2010) {
+         Exception e("IERS convention is not defined");
+         GPSTK_THROW(e);
+      }
+      setAccuracy(acc);
+   }
+
+   //---------------------------------------------------------------------------------
+   void EarthRotationCache::setAccuracy(double acc)
+   {
+      if(acc <= 0.0) {
+         Exception e("Accuracy must be positive");
+         GPSTK_THROW(e);
+      }
+      accuracy = acc;
+      step = ::pow(accuracy/interpErrorCoeff, 0.25);
+      if(step < minStep) step = minStep;
+      if(step > maxStep) step = maxStep;
+      clear();
+   }
+
+   //---------------------------------------------------------------------------------
+   void EarthRotationCache::clear(void) throw()
+   {
+      nodes.clear();
+      haveLast = false;
+   }
+
+   //---------------------------------------------------------------------------------
+   // Generate the transformation matrix relating the ECEF frame to the conventional
+   // inertial frame; the NPB part is interpolated, Earth rotation and polar motion
+   // are computed as in EarthOrientation::ECEFtoInertial1996, 2003 and 2010.
+   EarthRotationCache::Rotation EarthRotationCache::ECEFtoInertial(
+                         const EarthOrientation& eo, const EphTime& t, bool reduced)
+   {
+      try {
+         if(eo.convention != convention) {
+            Exception e("IERS convention of the EOPs is not that of the cache");
+            GPSTK_THROW(e);
+         }
+
+         // same epoch and EOPs as last time?
+         if(haveLast && t.lMJD() == lastMJD && t.secOfDay() == lastSOD
+               && t.getTimeSystem() == lastSystem && eo.xp == lastXp
+               && eo.yp == lastYp && eo.UT1mUTC == lastUT1mUTC
+               && reduced == lastReduced)
+            return last;
+
+         double T(EarthOrientation::CoordTransTime(t));
+
+         // interpolated precession-nutation-bias
+         Rotation NPB;
+         double ee;
+         interpolate(T, NPB, ee);
+
+         // Earth rotation and polar motion
+         double R[3][3], W[3][3], W1[3][3], W2[3][3], W3[3][3];
+         double xp(eo.xp * EarthOrientation::ARCSEC_TO_RAD);
+         double yp(eo.yp * EarthOrientation::ARCSEC_TO_RAD);
+         if(convention == IERSConvention::IERS1996) {
+            // GAST = GMST + equation of equinoxes
+            double UT1mUTC(eo.UT1mUTC);
+            if(reduced) {
+               double UT1mUT1R,dlodR,domegaR;
+               EarthOrientation::UT1mUTCTidalCorrections(T, UT1mUT1R, dlodR, domegaR);
+               UT1mUTC = UT1mUT1R - UT1mUTC;
+            }
+            double g(EarthOrientation::GMST1996(t, UT1mUTC, false) + ee);
+            rotation3(g, 3, R);
+
+            // W = R2(-xp)*R1(-yp), cf. PolarMotionMatrix1996
+            rotation3(-xp, 2, W2);
+            rotation3(-yp, 1, W1);
+            multiply3(W2, W1, W);
+         }
+         else {
+            // ERA replaces GAST
+            double era(EarthOrientation::EarthRotationAngle(t, eo.UT1mUTC));
+            rotation3(era, 3, R);
+
+            // W = R1(-yp)*R2(-xp)*R3(s'), cf. PolarMotionMatrix2003
+            double WW[3][3];
+            rotation3(EarthOrientation::Sprime(T), 3, W3);
+            rotation3(-xp, 2, W2);
+            rotation3(-yp, 1, W1);
+            multiply3(W1, W2, WW);
+            multiply3(WW, W3, W);
+         }
+
+         // ECEFtoInertial = transpose(W*R*NPB)
+         double WR[3][3], WRN[3][3];
+         multiply3(W, R, WR);
+         multiply3(WR, NPB.m, WRN);
+         for(int i=0; i<3; i++)
+            for(int j=0; j<3; j++)
+               last.m[i][j] = WRN[j][i];
+
+         haveLast = true;
+         lastMJD = t.lMJD();
+         lastSOD = t.secOfDay();
+         lastSystem = t.getTimeSystem();
+         lastXp = eo.xp;
+         lastYp = eo.yp;
+         lastUT1mUTC = eo.UT1mUTC;
+         lastReduced = reduced;
+
+         return last;
+      }
+      catch(Exception& e) { GPSTK_RETHROW(e); }
+   }
+
+   //---------------------------------------------------------------------------------
+   EarthRotationCache::Rotation EarthRotationCache::NPBMatrix(const EphTime& t)
+   {
+      try {
+         Rotation NPB;
+         double ee;
+         interpolate(EarthOrientation::CoordTransTime(t), NPB, ee);
+         return NPB;
+      }
+      catch(Exception& e) { GPSTK_RETHROW(e); }
+   }
+
+   //---------------------------------------------------------------------------------
+   // private
+   const EarthRotationCache::Node& EarthRotationCache::node(long k)
+   {
+      map<long, Node>::const_iterator it = nodes.find(k);
+      if(it != nodes.end()) return it->second;
+
+      // limit the size of the cache, dropping the point farthest from k
+      if(nodes.size() >= maxNodes) {
+         if(k - nodes.begin()->first > nodes.rbegin()->first - k)
+            nodes.erase(nodes.begin());
+         else
+            nodes.erase(--nodes.end());
+      }
+
+      // compute with the full series
+      double T(double(k)*step/36525.0);
+      Node& nd(nodes[k]);
+      Matrix<double> M;
+      nd.ee = 0.0;
+      if(convention == IERSConvention::IERS1996) {
+         double om,eps,dpsi;
+         M = EarthOrientation::NPBMatrix1996(T, om, eps, dpsi);
+         // equation of equinoxes: dpsi, eps and Omega terms, cf. gast1996()
+         nd.ee = dpsi * ::cos(eps)
+               + (0.00264  * ::sin(om) + 0.000063 * ::sin(2.0*om))
+                  * EarthOrientation::ARCSEC_TO_RAD;
+      }
+      else if(convention == IERSConvention::IERS2003)
+         M = EarthOrientation::NPBMatrix2003(T);
+      else
+         M = EarthOrientation::NPBMatrix2010(T);
+      for(int i=0; i<3; i++)
+         for(int j=0; j<3; j++)
+            nd.npb[3*i+j] = M(i,j);
+
+      return nd;
+   }
+
+   //---------------------------------------------------------------------------------
+   // private
+   void EarthRotationCache::interpolate(double T, Rotation& npb, double& ee)
+   {
+      // grid interval k,k+1 containing T, and fraction f of the interval
+      double x((T*36525.0)/step);
+      long k(long(::floor(x)));
+      double f(x - double(k));
+
+      // 4-point Lagrange weights, points k-1, k, k+1, k+2
+      double w[4];
+      w[0] = -f*(f-1.0)*(f-2.0)/6.0;
+      w[1] = (f+1.0)*(f-1.0)*(f-2.0)/2.0;
+      w[2] = -(f+1.0)*f*(f-2.0)/2.0;
+      w[3] = (f+1.0)*f*(f-1.0)/6.0;
+
+      double *m(&npb.m[0][0]);
+      for(int i=0; i<9; i++) m[i] = 0.0;
+      ee = 0.0;
+      for(int n=0; n<4; n++) {
+         const Node& nd(node(k-1+n));
+         for(int i=0; i<9; i++)
+            m[i] += w[n] * nd.npb[i];
+         ee += w[n] * nd.ee;
+      }
+   }
+
+} // end namespace gpstk
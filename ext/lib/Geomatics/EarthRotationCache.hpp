@@ -0,0 +1,213 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+
+/// @file EarthRotationCache.hpp
+/// Include file defining the EarthRotationCache class, which computes the
+/// transformation between the ECEF and inertial frames of EarthOrientation at
+/// many epochs, interpolating the slowly varying precession-nutation part.
+
+#ifndef CLASS_EARTHROTATIONCACHE_INCLUDE
+#define CLASS_EARTHROTATIONCACHE_INCLUDE
+
+//------------------------------------------------------------------------------------
+// system includes
+#include <map>
+// GPSTk
+#include "Exception.hpp"
+#include "Matrix.hpp"
+// geomatics
+#include "EphTime.hpp"
+#include "IERSConvention.hpp"
+#include "EarthOrientation.hpp"
+
+//------------------------------------------------------------------------------------
+namespace gpstk {
+
+   /// class EarthRotationCache computes the transformation between the ECEF
+   /// (terrestrial) frame and the conventional inertial (celestial) frame, as does
+   /// EarthOrientation::ECEFtoInertial(), but for loops, e.g. orbit determination
+   /// or satellite attitude, that need it at every epoch.
+   /// The transformation is W * R * NPB, where NPB is the precession-nutation-bias
+   /// matrix, which depends only on time and varies slowly, and R (the Earth
+   /// rotation angle, or GAST for IERS1996) and W (polar motion) depend on the EOPs.
+   /// The NPB matrix (and for IERS1996 the equation of the equinoxes) is computed
+   /// with the full IERS series only on a grid of times, and interpolated with a
+   /// 4-point Lagrange polynomial; the grid step is chosen from the requested
+   /// accuracy of the matrix elements. R and W are computed exactly at each epoch.
+   /// The grid values are cached, as is the result at the last epoch, and results
+   /// are returned as a fixed size EarthRotationCache::Rotation, with no allocation.
+   /// An object is not thread-safe; use one per thread.
+   /// Example:
+   /// <pre>
+   ///    EarthRotationCache erc(IERSConvention::IERS2010, 1.e-10);
+   ///    for(each epoch t) {
+   ///       EarthOrientation eo = eopStore.getEOP(t.dMJD(), IERSConvention::IERS2010);
+   ///       EarthRotationCache::Rotation R = erc.ECEFtoInertial(eo, t);
+   ///       R.rotate(posECEF, posInertial);
+   ///    }
+   /// </pre>
+   class EarthRotationCache
+   {
+   public:
+      /// Fixed size 3x3 rotation matrix.
+      class Rotation
+      {
+      public:
+         /// @return element in row i and column j
+         double operator()(int i, int j) const throw()
+            { return m[i][j]; }
+
+         /// @return reference to element in row i and column j
+         double& operator()(int i, int j) throw()
+            { return m[i][j]; }
+
+         /// @return the transpose, which for a rotation is the inverse.
+         Rotation transpose(void) const throw();
+
+         /// Rotate the vector in into out = R*in; in and out may be the same.
+         void rotate(const double in[3], double out[3]) const throw();
+
+         /// @return this rotation as a Matrix<double>(3,3)
+         Matrix<double> asMatrix(void) const;
+
+         /// the elements, by row
+         double m[3][3];
+      };
+
+      /// Constructor.
+      /// @param conv IERS convention; must be that of the EOPs passed later.
+      /// @param accuracy the target accuracy of the interpolated elements of the
+      ///                 matrix, in radians.
+      /// @throw Exception if the convention is Unknown or accuracy is not positive
+      EarthRotationCache(IERSConvention conv=IERSConvention::IERS2010,
+                         double accuracy=1.e-10);
+
+      /// Change the target accuracy, and clear the cache.
+      /// @param accuracy the target accuracy of the matrix elements, in radians;
+      ///                 the grid step is limited to the range
+      ///                 [minStep,maxStep] days.
+      /// @throw Exception if accuracy is not positive
+      void setAccuracy(double accuracy);
+
+      /// @return the target accuracy in radians
+      double getAccuracy(void) const throw()
+         { return accuracy; }
+
+      /// @return the grid step, in days
+      double gridStep(void) const throw()
+         { return step; }
+
+      /// @return the IERS convention
+      IERSConvention getConvention(void) const throw()
+         { return convention; }
+
+      /// @return the number of grid points in the cache
+      unsigned size(void) const throw()
+         { return nodes.size(); }
+
+      /// Remove all the cached values.
+      void clear(void) throw();
+
+      /// Generate the transformation matrix (3x3 rotation) relating the ECEF frame
+      /// to the conventional inertial frame, as EarthOrientation::ECEFtoInertial().
+      /// @param eo EOPs at the time of interest, e.g. from EOPStore::getEOP().
+      /// @param t EphTime epoch of the rotation.
+      /// @param reduced, bool true when UT1mUTC is 'reduced', meaning assumes
+      ///                 'no tides', as is the case with the NGA EOPs (default=F).
+      ///                 This applies only to IERS1996, as in EarthOrientation.
+      /// @return 3x3 rotation matrix
+      /// @throw Exception if the convention of eo is not that of this object,
+      /// or if the TimeSystem conversion fails (if TimeSystem is Unknown)
+      Rotation ECEFtoInertial(const EarthOrientation& eo, const EphTime& t,
+                              bool reduced=false);
+
+      /// Generate the inverse of ECEFtoInertial(); see that function.
+      /// @throw Exception
+      Rotation InertialtoECEF(const EarthOrientation& eo, const EphTime& t,
+                              bool reduced=false)
+         { return ECEFtoInertial(eo, t, reduced).transpose(); }
+
+      /// Interpolate the precession-nutation-bias matrix at the given time, i.e.
+      /// the interpolated value of EarthOrientation::NPBMatrix2003() etc.
+      /// @param t EphTime epoch of interest.
+      /// @return 3x3 rotation matrix
+      /// @throw Exception if the TimeSystem conversion fails
+      Rotation NPBMatrix(const EphTime& t);
+
+      /// limits on the grid step, in days
+      static const double minStep, maxStep;
+
+      /// maximum number of grid points kept in the cache
+      static const unsigned maxNodes;
+
+   private:
+      /// values stored at each grid point
+      struct Node {
+         double npb[9];    ///< NPB matrix, by row
+         double ee;        ///< equation of the equinoxes (IERS1996 only)
+      };
+
+      /// Return the grid point k, at time k*step days after J2000, computing it
+      /// if it is not in the cache.
+      const Node& node(long k);
+
+      /// Interpolate the NPB matrix and the equation of the equinoxes at the
+      /// coordinate transformation time T.
+      void interpolate(double T, Rotation& npb, double& ee);
+
+      IERSConvention convention;    ///< IERS convention
+      double accuracy;              ///< target accuracy in radians
+      double step;                  ///< grid step in days
+      std::map<long, Node> nodes;   ///< cache of grid points
+
+      // the last result, and what it was computed from
+      bool haveLast;                ///< true if last is valid
+      long lastMJD;                 ///< MJD of the last epoch
+      double lastSOD;               ///< seconds of day of the last epoch
+      TimeSystem lastSystem;        ///< time system of the last epoch
+      double lastXp, lastYp;        ///< polar motion at the last epoch
+      double lastUT1mUTC;           ///< UT1-UTC at the last epoch
+      bool lastReduced;             ///< reduced flag at the last epoch
+      Rotation last;                ///< the last result
+
+   }; // end class EarthRotationCache
+
+}  // end namespace gpstk
+
+#endif // CLASS_EARTHROTATIONCACHE_INCLUDE
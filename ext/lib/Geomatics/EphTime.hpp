@@ -122,6 +122,12 @@ namespace gpstk
          system = sys;
       }
 
+      /// @return the TimeSystem
+      TimeSystem getTimeSystem(void) const throw()
+      {
+         return system;
+      }
+
       /// set to value of full MJD
       /// @param mjd long double MJD
       void setMJD(long double mjd) throw()
@@ -0,0 +1,551 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+
+/// @file NetworkTides.cpp
+/// Implement class NetworkTides, which computes the solid Earth, pole, ocean
+/// loading and atmospheric loading displacements of many sites at many epochs.
+
+//------------------------------------------------------------------------------------
+// system includes
+#include <atomic>
+#include <cmath>
+#include <future>
+#include <memory>
+// GPSTk
+#include "GNSSconstants.hpp"
+#include "ThreadPool.hpp"
+// geomatics
+#include "NetworkTides.hpp"
+#include "SolidEarthTides.hpp"
+#include "SolarPosition.hpp"
+#include "SunEarthSatGeometry.hpp"
+
+//------------------------------------------------------------------------------------
+using namespace std;
+
+namespace gpstk
+{
+   //---------------------------------------------------------------------------------
+   // Coefficients of the frequency dependence of the Love and Shida numbers, from
+   // computeSolidEarthTides(): multipliers of s,h,p,N',ps then dR(ip),dR(op),
+   // dT(ip),dT(op) in mm.
+   // Step 2a IERS(1996) eq. (15) pg 63. diurnal band
+   static const double step2diurnalData[9*31] = {
+     -3., 0., 2., 0., 0.,-0.01,-0.01,  0.0,  0.0,
+     -3., 2., 0., 0., 0.,-0.01,-0.01,  0.0,  0.0,
+     -2., 0., 1.,-1., 0.,-0.02,-0.01,  0.0,  0.0,
+     -2., 0., 1., 0., 0.,-0.08, 0.00, 0.01, 0.01,
+     -2., 2.,-1., 0., 0.,-0.02,-0.01,  0.0,  0.0,
+     -1., 0., 0.,-1., 0.,-0.10, 0.00, 0.00, 0.00,
+     -1., 0., 0., 0., 0.,-0.51, 0.00,-0.02, 0.03,
+     -1., 2., 0., 0., 0., 0.01,  0.0,  0.0,  0.0,
+      0.,-2., 1., 0., 0., 0.01,  0.0,  0.0,  0.0,
+      0., 0.,-1., 0., 0., 0.02, 0.01,  0.0,  0.0,
+      0., 0., 1., 0., 0., 0.06, 0.00, 0.00, 0.00,
+      0., 0., 1., 1., 0., 0.01,  0.0,  0.0,  0.0,
+      0., 2.,-1., 0., 0., 0.01,  0.0,  0.0,  0.0,
+      1.,-3., 0., 0., 1.,-0.06, 0.00, 0.00, 0.00,
+      1.,-2., 0., 1., 0., 0.01,  0.0,  0.0,  0.0,
+      1.,-2., 0., 0., 0.,-1.23,-0.07, 0.06, 0.01,
+      1.,-1., 0., 0.,-1., 0.02,  0.0,  0.0,  0.0,
+      1.,-1., 0., 0., 1., 0.04,  0.0,  0.0,  0.0,
+      1., 0., 0.,-1., 0.,-0.22, 0.01, 0.01, 0.00,
+      1., 0., 0., 0., 0.,12.00,-0.78,-0.67,-0.03,
+      1., 0., 0., 1., 0., 1.73,-0.12,-0.10, 0.00,
+      1., 0., 0., 2., 0.,-0.04,  0.0,  0.0,  0.0,
+      1., 1., 0., 0.,-1.,-0.50,-0.01, 0.03, 0.00,
+      1., 1., 0., 0., 1., 0.01,  0.0,  0.0,  0.0,
+      1., 1., 0., 1.,-1.,-0.01,  0.0,  0.0,  0.0,
+      1., 2.,-2., 0., 0.,-0.01,  0.0,  0.0,  0.0,
+      1., 2., 0., 0., 0.,-0.11, 0.01, 0.01, 0.00,
+      2.,-2., 1., 0., 0.,-0.01,  0.0,  0.0,  0.0,
+      2., 0.,-1., 0., 0.,-0.02, 0.02,  0.0, 0.01,
+      3., 0., 0., 0., 0., 0.0,  0.01,  0.0, 0.01,
+      3., 0., 0., 1., 0., 0.0,  0.01,  0.0,  0.0 };
+
+   // Step 2b IERS(1996) eq. (16) pg 64. long period band
+   static const double step2longData[9*5] = {
+      0, 0, 0, 1, 0,  0.47, 0.23, 0.16, 0.07,
+      0, 2, 0, 0, 0, -0.20,-0.12,-0.11,-0.05,
+      1, 0,-1, 0, 0, -0.11,-0.08,-0.09,-0.04,
+      2, 0, 0, 0, 0, -0.13,-0.11,-0.15,-0.07,
+      2, 0, 0, 1, 0, -0.05,-0.05,-0.06,-0.03 };
+
+   //---------------------------------------------------------------------------------
+   NetworkTides::NetworkTides(IERSConvention conv)
+      : iers(conv), emrat(81.30056), serat(332946.050894783285912),
+        ocean(0), atm(0), nder(0)
+   {
+   }
+
+   //---------------------------------------------------------------------------------
+   unsigned NetworkTides::addSite(const string& name, const Position& pos,
+                                  const string& oceanLabel, const string& atmLabel)
+   {
+      try {
+         Site S;
+         S.name = name;
+         S.oceanLabel = (oceanLabel.empty() ? name : oceanLabel);
+         S.atmLabel = (atmLabel.empty() ? name : atmLabel);
+
+         // as computeSolidEarthTides()
+         Position P(pos);
+         double Rx(P.radius());
+         S.rx[0] = P.X()/Rx; S.rx[1] = P.Y()/Rx; S.rx[2] = P.Z()/Rx;
+
+         double lat(P.getGeocentricLatitude()*DEG_TO_RAD);
+         double lon(P.getLongitude()*DEG_TO_RAD);
+         S.sinlat = ::sin(lat);
+         S.coslat = ::cos(lat);
+         S.sinlon = ::sin(lon);
+         S.coslon = ::cos(lon);
+         S.sin2lat = ::sin(2*lat);
+         S.cos2lat = ::cos(2*lat);
+         S.sin2lon = ::sin(2*lon);
+         S.cos2lon = ::cos(2*lon);
+
+         S.north[0] = -S.sinlat*S.coslon;
+         S.north[1] = -S.sinlat*S.sinlon;
+         S.north[2] = S.coslat;
+         S.east[0] = -S.sinlon;
+         S.east[1] = S.coslon;
+         S.east[2] = 0.0;
+         S.up[0] = S.coslat*S.coslon;
+         S.up[1] = S.coslat*S.sinlon;
+         S.up[2] = S.sinlat;
+
+         // nominal degree 2 Love and Shida numbers
+         double poly = (3.0*S.sinlat*S.sinlat-1.0)/2.0;
+         if(iers == IERSConvention::IERS1996) {
+            S.Love = 0.6026 - 0.0006*poly;
+            S.Shida = 0.0831 + 0.0002*poly;
+         }
+         else {            // 2003 or 2010
+            S.Love = 0.6078 - 0.0006*poly;
+            S.Shida = 0.0847 + 0.0002*poly;
+         }
+
+         // as computePolarTides()
+         double theta = (90.0-P.getGeocentricLatitude())*DEG_TO_RAD;
+         S.cos2th = ::cos(2*theta);
+         S.costh = ::cos(theta);
+         S.sin2th = ::sin(2*theta);
+
+         // loading displacements are NEU in the geodetic frame
+         Matrix<double> R(NorthEastUp(P));
+         for(int i=0; i<3; i++)
+            for(int k=0; k<3; k++)
+               S.NEU[i][k] = R(i,k);
+
+         sites.push_back(S);
+         return sites.size()-1;
+      }
+      catch(Exception& e) { GPSTK_RETHROW(e); }
+   }
+
+   //---------------------------------------------------------------------------------
+   void NetworkTides::setEpochs(SolarSystem& ss, const vector<EphTime>& times)
+   {
+      try {
+         emrat = ss.EarthToMoonMassRatio();
+         serat = ss.SunToEarthMassRatio();
+
+         epochs.resize(times.size());
+         for(size_t j=0; j<times.size(); j++) {
+            EpochData& ep(epochs[j]);
+            ep.time = times[j];
+            ep.Sun = ss.SolarPosition(times[j]);
+            ep.Moon = ss.LunarPosition(times[j]);
+
+            EphTime ttag(times[j]);
+            ttag.convertSystemTo(TimeSystem::UTC);
+            const EarthOrientation eo = ss.getEOP(ttag.dMJD());
+            ep.xp = eo.xp;
+            ep.yp = eo.yp;
+            ep.UT1mUTC = eo.UT1mUTC;
+         }
+      }
+      catch(Exception& e) { GPSTK_RETHROW(e); }
+   }
+
+   //---------------------------------------------------------------------------------
+   void NetworkTides::setEpochs(const vector<EphTime>& times)
+   {
+      double AR;
+      epochs.resize(times.size());
+      for(size_t j=0; j<times.size(); j++) {
+         EpochData& ep(epochs[j]);
+         ep.time = times[j];
+         ep.Sun = SolarPosition(times[j], AR);
+         ep.Moon = LunarPosition(times[j], AR);
+         ep.xp = ep.yp = ep.UT1mUTC = 0.0;
+      }
+   }
+
+   //---------------------------------------------------------------------------------
+   void NetworkTides::compute(unsigned models, vector<double>& table,
+                              unsigned nthreads)
+   {
+      try {
+         const size_t nsite(sites.size()), nepoch(epochs.size());
+         table.assign(3*nsite*nepoch, 0.0);
+         if(nsite == 0 || nepoch == 0) return;
+
+         // ocean loading admittances, at the middle epoch
+         if(models & OceanLoading) {
+            if(!ocean) GPSTK_THROW(Exception("Ocean loading store is not set"));
+            vector<double> re, im;
+            const EphTime& tmid(epochs[nepoch/2].time);
+            for(size_t i=0; i<nsite; i++) {
+               ocean->computeAdmittance(sites[i].oceanLabel, tmid, re, im);
+               if(i == 0) {
+                  nder = re.size()/3;
+                  oceanRe.resize(3*nder*nsite);
+                  oceanIm.resize(3*nder*nsite);
+               }
+               copy(re.begin(), re.end(), oceanRe.begin()+3*nder*i);
+               copy(im.begin(), im.end(), oceanIm.begin()+3*nder*i);
+            }
+         }
+
+         // atmospheric loading coefficients, mm -> m
+         if(models & AtmLoading) {
+            if(!atm) GPSTK_THROW(Exception("Atmospheric loading store is not set"));
+            atmCoeff.resize(12*nsite);
+            for(size_t i=0; i<nsite; i++) {
+               const vector<double>& coeff(atm->getCoefficients(sites[i].atmLabel));
+               for(int k=0; k<12; k++)
+                  atmCoeff[12*i+k] = coeff[k]/1000.0;
+            }
+         }
+
+         // serial
+         if(nthreads == 1 || nepoch == 1) {
+            vector<double> work;
+            for(size_t j=0; j<nepoch; j++)
+               computeEpoch(j, models, work, &table[0]);
+            return;
+         }
+
+         // parallel over epochs; each epoch writes its own elements of table
+         if(nthreads == 0) nthreads = ThreadPool::defaultThreads();
+         if(nthreads > nepoch) nthreads = nepoch;
+         ThreadPool pool(nthreads);
+         atomic<size_t> next(0);
+         double *ptable(&table[0]);
+
+         auto work = [&]() {
+            vector<double> scratch;
+            size_t j;
+            while((j = next++) < nepoch)
+               computeEpoch(j, models, scratch, ptable);
+         };
+
+         vector< future<void> > results;
+         for(unsigned t=0; t<nthreads; t++)
+            results.push_back(pool.submit(work));
+         // wait for all, then rethrow the first exception, if any
+         for(unsigned t=0; t<nthreads; t++)
+            results[t].wait();
+         for(unsigned t=0; t<nthreads; t++)
+            results[t].get();
+      }
+      catch(Exception& e) { GPSTK_RETHROW(e); }
+   }
+
+   //---------------------------------------------------------------------------------
+   // The solid tide terms of computeSolidEarthTides() that depend on the difference
+   // of site and body longitudes are expanded with the angle addition formulas, so
+   // that the sums over Sun and Moon, and over the 31 + 5 frequency dependent
+   // terms, are done once per epoch; the site loop then has no trigonometry.
+   void NetworkTides::computeEpoch(unsigned j, unsigned models,
+                                   vector<double>& work, double *table) const
+   {
+      int i,k;
+      const size_t nsite(sites.size()), nepoch(epochs.size());
+      const EpochData& ep(epochs[j]);
+
+      // -------------------------------------------------------------------------
+      // solid Earth tide; cf. computeSolidEarthTides()
+      static const double REarth=6378136.55;
+      double sunUnit[3]={0.,0.,0.}, moonUnit[3]={0.,0.,0.};
+      double sunFactor(0.), moonFactor(0.), REoRS(0.), REoRM(0.);
+      double Dc(0.),Ds(0.),Ec(0.),Es(0.),Fc(0.),Fs(0.);  // sums over Sun and Moon
+      double A5s(0.),A5c(0.),A6s(0.),A6c(0.);            // sums of step 2a
+      double A7s(0.),A7c(0.),A8s(0.),A8c(0.);
+      double Br(0.),Bn(0.);                              // sums of step 2b
+      if(models & SolidTide) {
+         const double RSun(ep.Sun.radius()), RMoon(ep.Moon.radius());
+         sunUnit[0] = ep.Sun.X()/RSun;
+         sunUnit[1] = ep.Sun.Y()/RSun;
+         sunUnit[2] = ep.Sun.Z()/RSun;
+         moonUnit[0] = ep.Moon.X()/RMoon;
+         moonUnit[1] = ep.Moon.Y()/RMoon;
+         moonUnit[2] = ep.Moon.Z()/RMoon;
+         REoRS = REarth/RSun;
+         sunFactor = REarth*REoRS*REoRS*REoRS*serat;
+         REoRM = REarth/RMoon;
+         moonFactor = REarth*REoRM*REoRM*REoRM/emrat;
+
+         const double latSun(ep.Sun.getGeocentricLatitude()*DEG_TO_RAD);
+         const double lonSun(ep.Sun.getLongitude()*DEG_TO_RAD);
+         const double latMoon(ep.Moon.getGeocentricLatitude()*DEG_TO_RAD);
+         const double lonMoon(ep.Moon.getLongitude()*DEG_TO_RAD);
+         const double sinlonS(::sin(lonSun)), coslonS(::cos(lonSun));
+         const double sinlonM(::sin(lonMoon)), coslonM(::cos(lonMoon));
+         const double sin2lonS(::sin(2*lonSun)), cos2lonS(::cos(2*lonSun));
+         const double sin2lonM(::sin(2*lonMoon)), cos2lonM(::cos(2*lonMoon));
+         const double coslatS(::cos(latSun)), coslatM(::cos(latMoon));
+
+         // diurnal, eq. 13: factor*sin(2lat) at lon
+         double fS(sunFactor*::sin(2*latSun)), fM(moonFactor*::sin(2*latMoon));
+         Dc = fS*coslonS + fM*coslonM;
+         Ds = fS*sinlonS + fM*sinlonM;
+         // semidiurnal, eq. 12 and 14: factor*cos^2(lat) at 2lon
+         fS = sunFactor*coslatS*coslatS;
+         fM = moonFactor*coslatM*coslatM;
+         Ec = fS*cos2lonS + fM*cos2lonM;
+         Es = fS*sin2lonS + fM*sin2lonM;
+         // latitude dependence of diurnal, eq. 11: factor*cos(lat)sin(lat) at lon
+         fS = sunFactor*coslatS*::sin(latSun);
+         fM = moonFactor*coslatM*::sin(latMoon);
+         Fc = fS*coslonS + fM*coslonM;
+         Fs = fS*sinlonS + fM*sinlonM;
+
+         // standard arguments for step 2
+         EphTime TT(ep.time);
+         TT.convertSystemTo(TimeSystem::TT);
+         double T,fhr,fmjd = TT.dMJD();
+         T = (fmjd-51544.0)/36525.0;            // MJD of J2000 is 51544.0
+         fhr = (fmjd-int(fmjd))*24.0;
+         double s,tau,pr,h,p,zns,ps;
+         {
+            double T2 = T*T;
+            double T3 = T2*T;
+            double T4 = T3*T;
+            s = 218.31664563 + 481267.88194*T - 0.0014663889*T2 + 0.00000185139*T3;
+            tau = fhr*15. + 280.4606184 + 36000.7700536*T + 0.00038793*T2
+                                                          - 0.0000000258*T3;
+            tau = tau - s;
+            pr = 1.396971278*T + 0.000308889*T2 + 0.000000021*T3 + 0.000000007*T4;
+            s = s + pr;
+            h = 280.46645 + 36000.7697489*T + 0.00030322222*T2 + 0.000000020*T3
+                                                               - 0.00000000654*T4;
+            p = 83.35324312 + 4069.01363525*T - 0.01032172222*T2 - 0.0000124991*T3
+                                                              + 0.00000005263*T4;
+            zns = 234.95544499 + 1934.13626197*T - 0.00207561111*T2
+                                    - 0.00000213944*T3 + 0.00000001650*T4;
+            ps = 282.93734098 + 1.71945766667*T + 0.00045688889*T2
+                                    - 0.00000001778*T3 - 0.00000000334*T4;
+            s   = fmod(s,  360.0);
+            tau = fmod(tau,360.0);
+            h   = fmod(h,  360.0);
+            p   = fmod(p,  360.0);
+            zns = fmod(zns,360.0);
+            ps  = fmod(ps, 360.0);
+         }
+
+         // step 2a: sum the coefficients times sin,cos(thetaf); the site longitude
+         // is added below
+         double thetaf,ctf,stf;
+         for(i=0; i<31; i++) {
+            const double *d(&step2diurnalData[9*i]);
+            thetaf = (tau + d[0]*s + d[1]*h + d[2]*p + d[3]*zns + d[4]*ps)
+                                                                     * DEG_TO_RAD;
+            ctf = ::cos(thetaf);
+            stf = ::sin(thetaf);
+            A5s += d[5]*stf; A5c += d[5]*ctf;
+            A6s += d[6]*stf; A6c += d[6]*ctf;
+            A7s += d[7]*stf; A7c += d[7]*ctf;
+            A8s += d[8]*stf; A8c += d[8]*ctf;
+         }
+
+         // step 2b: independent of longitude
+         for(i=0; i<5; i++) {
+            const double *d(&step2longData[9*i]);
+            thetaf = (d[0]*s + d[1]*h + d[2]*p + d[3]*zns + d[4]*ps) * DEG_TO_RAD;
+            ctf = ::cos(thetaf);
+            stf = ::sin(thetaf);
+            Br += d[5]*ctf + d[7]*stf;
+            Bn += d[6]*ctf + d[8]*stf;
+         }
+      }
+
+      // -------------------------------------------------------------------------
+      // pole tide; cf. computePolarTides()
+      double m1(0.0), m2(0.0), upcoef(0.0);
+      if(models & PoleTide)
+         computePolarTideWobble(ep.time, ep.xp, ep.yp, iers, m1, m2, upcoef);
+
+      // -------------------------------------------------------------------------
+      // ocean loading; cos and sin of the arguments of the derived tides
+      double *carg(0), *sarg(0);
+      if(models & OceanLoading) {
+         double Dood[6], freqDood[6];
+         OceanLoadTides::DoodsonArguments(ep.time, Dood, freqDood);
+         vector<double> arg;
+         OceanLoadTides::derivedTideArguments(Dood, arg);
+         work.resize(2*nder);
+         carg = &work[0];
+         sarg = &work[nder];
+         for(k=0; k<(int)nder; k++) {
+            carg[k] = ::cos(arg[k]*DEG_TO_RAD);
+            sarg[k] = ::sin(arg[k]*DEG_TO_RAD);
+         }
+      }
+
+      // -------------------------------------------------------------------------
+      // atmospheric loading; cf. AtmLoadTides::computeDisplacement()
+      double atmArg[4]={0.,0.,0.,0.};
+      if(models & AtmLoading) {
+         EphTime ttag(ep.time);
+         ttag.convertSystemTo(TimeSystem::UTC);
+         ttag += ep.UT1mUTC;
+         double dayfr(ttag.secOfDay()/86400.0);
+         atmArg[0] = ::cos(2*PI*dayfr);
+         atmArg[1] = ::sin(2*PI*dayfr);
+         atmArg[2] = ::cos(4*PI*dayfr);
+         atmArg[3] = ::sin(4*PI*dayfr);
+      }
+
+      // -------------------------------------------------------------------------
+      // loop over sites
+      for(size_t n=0; n<nsite; n++) {
+         const Site& S(sites[n]);
+         double disp[3] = { 0.0, 0.0, 0.0 };
+
+         if(models & SolidTide) {
+            // step 1a and 1b, eq. 8 and 9, degree 2 and 3
+            const double sunDOTrx = sunUnit[0]*S.rx[0] + sunUnit[1]*S.rx[1]
+                                  + sunUnit[2]*S.rx[2];
+            const double moonDOTrx = moonUnit[0]*S.rx[0] + moonUnit[1]*S.rx[1]
+                                   + moonUnit[2]*S.rx[2];
+            const double sd2(sunDOTrx*sunDOTrx), md2(moonDOTrx*moonDOTrx);
+            // coefficients of rx, sunUnit and moonUnit
+            double crx, csun, cmoon;
+            csun = sunFactor*(3.0*S.Shida*sunDOTrx
+                              + REoRS*0.015*(7.5*sd2-1.5));
+            cmoon = moonFactor*(3.0*S.Shida*moonDOTrx
+                                + REoRM*0.015*(7.5*md2-1.5));
+            crx = sunFactor*(S.Love*(1.5*sd2-0.5)
+                             + REoRS*0.292*(2.5*sd2-1.5)*sunDOTrx)
+                - csun*sunDOTrx
+                + moonFactor*(S.Love*(1.5*md2-0.5)
+                              + REoRM*0.292*(2.5*md2-1.5)*moonDOTrx)
+                - cmoon*moonDOTrx;
+
+            // the angle differences with the site longitude
+            // X1,Y1 = sum factor*sin(2lat)*sin,cos(lon-lonBody)
+            const double X1(S.sinlon*Dc - S.coslon*Ds);
+            const double Y1(S.coslon*Dc + S.sinlon*Ds);
+            // X2,Y2 = sum factor*cos^2(lat)*sin,cos(2(lon-lonBody))
+            const double X2(S.sin2lon*Ec - S.cos2lon*Es);
+            const double Y2(S.cos2lon*Ec + S.sin2lon*Es);
+            // X3,Y3 = sum factor*cos(lat)*sin(lat)*sin,cos(lon-lonBody)
+            const double X3(S.sinlon*Fc - S.coslon*Fs);
+            const double Y3(S.coslon*Fc + S.sinlon*Fs);
+            // step 2a sums at thetaf+lon
+            const double P(S.coslon*(A5s+A6c) + S.sinlon*(A5c-A6s));
+            const double Q(S.coslon*(A7s+A8c) + S.sinlon*(A7c-A8s));
+            const double R(S.coslon*(A7c-A8s) - S.sinlon*(A7s+A8c));
+
+            const double sl(S.sinlat), cl(S.coslat);
+            // step 1c, 1d (eq 13, 14) and step 2 (mm) radial components
+            double cr = 0.75*0.0025*S.sin2lat*X1 + 0.75*0.0022*cl*cl*X2;
+            double cu = (P*2*sl*cl + Br*(3*sl*sl-1)/2)/1000.0;
+            // steps 1c,1d,1e,1f and 2
+            double cn = 1.5*0.0007*S.cos2lat*X1           // 1c
+                      - 0.75*0.0007*S.sin2lat*X2          // 1d
+                      - 3.0*0.0012*sl*sl*Y3               // 1e
+                      - 1.5*0.0024*sl*cl*Y2               // 1f
+                      + (Q*(cl*cl-sl*sl) + Bn*2*sl*cl)/1000.0;
+            double ce = 1.5*0.0007*sl*Y1                  // 1c
+                      + 1.5*0.0007*cl*Y2                  // 1d
+                      + 3.0*0.0012*sl*S.cos2lat*X3        // 1e
+                      - 1.5*0.0024*sl*sl*cl*X2            // 1f
+                      + R*sl/1000.0;
+
+            for(k=0; k<3; k++)
+               disp[k] += (crx+cr)*S.rx[k] + csun*sunUnit[k] + cmoon*moonUnit[k]
+                        + cn*S.north[k] + ce*S.east[k] + cu*S.up[k];
+         }
+
+         if(models & PoleTide) {
+            const double mc(m1*S.coslon + m2*S.sinlon);
+            const double pn(0.009*S.cos2th*mc);
+            const double pe(0.009*S.costh*(m1*S.sinlon - m2*S.coslon));
+            const double pu(-upcoef*S.sin2th*mc);
+            for(k=0; k<3; k++)
+               disp[k] += pn*S.north[k] + pe*S.east[k] + pu*S.up[k];
+         }
+
+         // loading, in the geodetic NEU frame
+         double neu[3] = { 0.0, 0.0, 0.0 };
+         if(models & OceanLoading) {
+            const double *re(&oceanRe[3*nder*n]), *im(&oceanIm[3*nder*n]);
+            for(int c=0; c<3; c++) {
+               double sum(0.0);
+               for(k=0; k<(int)nder; k++)
+                  sum += re[c*nder+k]*carg[k] - im[c*nder+k]*sarg[k];
+               neu[c] += sum;
+            }
+         }
+
+         if(models & AtmLoading) {
+            // coefficients are RAD, NS, EW
+            const double *c(&atmCoeff[12*n]);
+            neu[2] += c[0]*atmArg[0] + c[1]*atmArg[1] + c[2]*atmArg[2] + c[3]*atmArg[3];
+            neu[0] += c[4]*atmArg[0] + c[5]*atmArg[1] + c[6]*atmArg[2] + c[7]*atmArg[3];
+            neu[1] += c[8]*atmArg[0] + c[9]*atmArg[1] + c[10]*atmArg[2]
+                                                      + c[11]*atmArg[3];
+         }
+
+         if(models & (OceanLoading | AtmLoading)) {
+            for(k=0; k<3; k++)
+               disp[k] += S.NEU[0][k]*neu[0] + S.NEU[1][k]*neu[1] + S.NEU[2][k]*neu[2];
+         }
+
+         double *out(&table[(n*nepoch+j)*3]);
+         out[0] = disp[0];
+         out[1] = disp[1];
+         out[2] = disp[2];
+      }
+   }
+
+}  // end namespace gpstk
@@ -0,0 +1,230 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+
+/// @file NetworkTides.hpp
+/// Include file defining the NetworkTides class, which computes the solid Earth,
+/// pole, ocean loading and atmospheric loading displacements of many sites at
+/// many epochs, sharing the per-epoch work among the sites.
+
+#ifndef CLASS_NETWORKTIDES_INCLUDE
+#define CLASS_NETWORKTIDES_INCLUDE
+
+//------------------------------------------------------------------------------------
+// system includes
+#include <string>
+#include <vector>
+// GPSTk
+#include "Exception.hpp"
+#include "Position.hpp"
+// geomatics
+#include "EphTime.hpp"
+#include "IERSConvention.hpp"
+#include "SolarSystem.hpp"
+#include "OceanLoadTides.hpp"
+#include "AtmLoadTides.hpp"
+
+//------------------------------------------------------------------------------------
+namespace gpstk {
+
+   /// class NetworkTides computes the displacements of a network of sites due to
+   /// the solid Earth tides (computeSolidEarthTides()), the pole tide
+   /// (computePolarTides()), ocean loading (OceanLoadTides::computeDisplacement())
+   /// and atmospheric loading (AtmLoadTides::computeDisplacement()), at many epochs.
+   /// The results are those of the single site functions, but everything that
+   /// depends only on time - Sun and Moon positions, EOPs, the astronomical
+   /// arguments of the tides - is computed once per epoch, and the sums over sites
+   /// are simple loops with no trigonometry; the site-dependent parts are computed
+   /// once, by addSite(). The ocean loading admittances, which vary with time only
+   /// through the tidal frequencies, are computed once per site in compute().
+   /// Epochs may be computed in parallel threads.
+   /// The output is a single table of ECEF XYZ displacements in meters, site-major:
+   /// the displacement of site i at epoch j is table[(i*numberOfEpochs()+j)*3+k].
+   /// Example:
+   /// <pre>
+   ///    NetworkTides nt(IERSConvention::IERS2010);
+   ///    for(each site) nt.addSite(name, position);
+   ///    nt.setOceanLoading(oceanStore);           // initialized OceanLoadTides
+   ///    nt.setEpochs(solarSystem, times);         // initialized SolarSystem
+   ///    vector<double> table;
+   ///    nt.compute(NetworkTides::AllTides, table, 0);
+   /// </pre>
+   class NetworkTides
+   {
+   public:
+      /// Tide models, bits of the models argument of compute()
+      enum Model {
+         SolidTide = 1,       ///< solid Earth tide, computeSolidEarthTides()
+         PoleTide = 2,        ///< pole tide, computePolarTides()
+         OceanLoading = 4,    ///< ocean loading, OceanLoadTides
+         AtmLoading = 8,      ///< atmospheric loading, AtmLoadTides
+         AllTides = 15        ///< all of the above
+      };
+
+      /// Inputs at each epoch
+      struct EpochData {
+         EphTime time;        ///< epoch; time system must be defined
+         Position Sun;        ///< ECEF position of the Sun at time, meters
+         Position Moon;       ///< ECEF position of the Moon at time, meters
+         double xp, yp;       ///< polar motion angles, arcsec
+         double UT1mUTC;      ///< UT1 - UTC, seconds
+      };
+
+      /// Constructor.
+      /// @param iers IERS convention of the solid Earth and pole tides.
+      NetworkTides(IERSConvention iers=IERSConvention::IERS2010);
+
+      /// Set the mass ratios used by the solid Earth tides; the defaults are the
+      /// DE405 values, as in computeSolidEarthTides(). setEpochs(SolarSystem&,...)
+      /// sets them from the ephemeris.
+      /// @param EMRAT Earth-to-Moon mass ratio
+      /// @param SERAT Sun-to-Earth mass ratio
+      void setMassRatios(double EMRAT, double SERAT) throw()
+         { emrat = EMRAT; serat = SERAT; }
+
+      /// Add a site to the network.
+      /// @param name  label of the site
+      /// @param pos   nominal position of the site, fixed to the solid Earth
+      /// @param oceanLabel  label of the site in the OceanLoadTides; if empty, name
+      /// @param atmLabel    label of the site in the AtmLoadTides; if empty, name
+      /// @return the index of the site in the output table
+      /// @throw Exception if the position cannot be converted
+      unsigned addSite(const std::string& name, const Position& pos,
+                       const std::string& oceanLabel=std::string(),
+                       const std::string& atmLabel=std::string());
+
+      /// Set the ocean loading store; it must have been initialized with the
+      /// oceanLabel of all sites, and must exist during compute().
+      void setOceanLoading(OceanLoadTides& olt) throw()
+         { ocean = &olt; }
+
+      /// Set the atmospheric loading store; it must have been initialized with the
+      /// atmLabel of all sites, and must exist during compute().
+      void setAtmLoading(AtmLoadTides& atl) throw()
+         { atm = &atl; }
+
+      /// Set the epochs, computing the Sun and Moon positions and the EOPs from the
+      /// SolarSystem, as do SolarSystem::computeSolidEarthTides() and
+      /// SolarSystem::computePolarTides(); also set the mass ratios.
+      /// @param ss    SolarSystem, initialized with both ephemeris and EOPs
+      /// @param times epochs of interest, with time system defined
+      /// @throw Exception if the ephemeris or EOPs are not available
+      void setEpochs(SolarSystem& ss, const std::vector<EphTime>& times);
+
+      /// Set the epochs, computing the Sun and Moon positions with the simple
+      /// algorithms of SolarPosition.hpp, with zero polar motion and UT1-UTC.
+      /// @param times epochs of interest, with time system defined
+      void setEpochs(const std::vector<EphTime>& times);
+
+      /// Set the epochs and all their inputs.
+      /// @param data inputs at each epoch
+      void setEpochs(const std::vector<EpochData>& data)
+         { epochs = data; }
+
+      /// @return the number of sites
+      unsigned numberOfSites(void) const throw()
+         { return sites.size(); }
+
+      /// @return the number of epochs
+      unsigned numberOfEpochs(void) const throw()
+         { return epochs.size(); }
+
+      /// @return the label of site i
+      const std::string& siteName(unsigned i) const
+         { return sites.at(i).name; }
+
+      /// @return the inputs at epoch j
+      const EpochData& epochData(unsigned j) const
+         { return epochs.at(j); }
+
+      /// Compute the sum of the selected displacements of all sites at all epochs.
+      /// @param models OR of Model bits selecting the tides to include
+      /// @param table  output displacements, ECEF XYZ in meters, of size
+      ///               3*numberOfSites()*numberOfEpochs(); the displacement of
+      ///               site i at epoch j is table[(i*numberOfEpochs()+j)*3+k]
+      /// @param nthreads number of threads; 0 means ThreadPool::defaultThreads()
+      /// @throw Exception if a loading model is selected but its store is not set
+      ///                  or is missing a site, or if a time conversion fails
+      void compute(unsigned models, std::vector<double>& table,
+                   unsigned nthreads=1);
+
+   private:
+      /// site-dependent quantities
+      struct Site {
+         std::string name;          ///< label of the site
+         std::string oceanLabel;    ///< label in the OceanLoadTides
+         std::string atmLabel;      ///< label in the AtmLoadTides
+         double rx[3];              ///< unit vector to the site
+         double north[3];           ///< geocentric north unit vector
+         double east[3];            ///< east unit vector
+         double up[3];              ///< geocentric up unit vector
+         double sinlat, coslat;     ///< sin, cos of geocentric latitude
+         double sin2lat, cos2lat;   ///< sin, cos of twice geocentric latitude
+         double sinlon, coslon;     ///< sin, cos of longitude
+         double sin2lon, cos2lon;   ///< sin, cos of twice longitude
+         double Love, Shida;        ///< nominal degree 2 Love and Shida numbers
+         double cos2th, costh;      ///< cos of (twice) geocentric colatitude
+         double sin2th;             ///< sin of twice geocentric colatitude
+         double NEU[3][3];          ///< geodetic NorthEastUp() rotation
+      };
+
+      /// Compute all the sites at epoch j; called by compute().
+      /// @param work scratch space, reused between calls
+      void computeEpoch(unsigned j, unsigned models, std::vector<double>& work,
+                        double *table) const;
+
+      IERSConvention iers;             ///< IERS convention
+      double emrat;                    ///< Earth-to-Moon mass ratio
+      double serat;                    ///< Sun-to-Earth mass ratio
+      OceanLoadTides *ocean;           ///< ocean loading store, or null
+      AtmLoadTides *atm;               ///< atmospheric loading store, or null
+      std::vector<Site> sites;         ///< the sites
+      std::vector<EpochData> epochs;   ///< the epochs
+
+      // loading coefficients, set by compute()
+      unsigned nder;                   ///< number of derived ocean tides
+      std::vector<double> oceanRe;     ///< admittances, 3*nder per site, NEU
+      std::vector<double> oceanIm;     ///< admittances, 3*nder per site, NEU
+      std::vector<double> atmCoeff;    ///< 12 per site in meters, cf. AtmLoadTides
+
+   }; // end class NetworkTides
+
+}  // end namespace gpstk
+
+#endif   // CLASS_NETWORKTIDES_INCLUDE
+// nothing below this
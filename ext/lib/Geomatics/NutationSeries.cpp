@@ -0,0 +1,452 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+
+
+/// @file NutationSeries.cpp
+/// Implement class NutationSeries, which evaluates the IERS 2003 and 2010 nutation
+/// series, and the IERS 2010 series for the CIP coordinates X,Y, at many epochs.
+
+//------------------------------------------------------------------------------------
+// system includes
+#include <cmath>
+#include <vector>
+// geomatics
+#include "NutationSeries.hpp"
+#include "EarthOrientation.hpp"
+
+//------------------------------------------------------------------------------------
+using namespace std;
+
+namespace gpstk
+{
+   //---------------------------------------------------------------------------------
+   // Tables - internal use only. Terms are stored in the reverse of their order in
+   // the data files, smallest first, so the sums are formed as in EarthOrientation.
+
+   // Multipliers of the fundamental arguments of all the terms of a series, stored
+   // sparsely: term i has multipliers mult[k] of argument arg[k],
+   // k = first[i] to first[i+1]-1.
+   struct ArgumentTable
+   {
+      vector<int> first;
+      vector<int> arg;
+      vector<double> mult;
+
+      int size(void) const throw()
+         { return int(first.size())-1; }
+
+      // add the nonzero multipliers of one term
+      void addTerm(const int *n, const int *which, int nfa)
+      {
+         if(first.empty()) first.push_back(0);
+         for(int k=0; k<nfa; k++) {
+            if(n[k] == 0) continue;
+            arg.push_back(which[k]);
+            mult.push_back(double(n[k]));
+         }
+         first.push_back(int(arg.size()));
+      }
+   };
+
+   // Nutation series IERS2003 (IAU 2000A), lunar-solar then planetary terms.
+   // Fundamental arguments 0-4 are the lunar-solar l,lp,F,D,Om, and 5-17 the
+   // planetary l,F,D,Om,LMe,LV,LE,LMa,LJ,LS,LU,LN,Pa (cf. nutationArguments()).
+   // Coefficients have units 0.1 microarcsec and 0.1 microarcsec/century.
+   struct NutationTable
+   {
+      static const int NFA = 18;
+      ArgumentTable args;
+      vector<double> sp,spt,cp;     // longitude sin, T*sin, cos coefficients
+      vector<double> ce,cet,se;     // obliquity cos, T*cos, sin coefficients
+
+      NutationTable(void)
+      {
+         // include huge static arrays of coefficients
+         #include "IERS2003NutationData.hpp"
+
+         int i,n[13];
+         static const int LSargs[5] = {0,1,2,3,4};
+         static const int Pargs[13] = {5,6,7,8,9,10,11,12,13,14,15,16,17};
+
+         for(i=NLS-1; i>=0; --i) {
+            n[0] = LSCoeff[i].nl; n[1] = LSCoeff[i].nlp; n[2] = LSCoeff[i].nf;
+            n[3] = LSCoeff[i].nd; n[4] = LSCoeff[i].nom;
+            args.addTerm(n, LSargs, 5);
+            sp.push_back(LSCoeff[i].sp);
+            spt.push_back(LSCoeff[i].spt);
+            cp.push_back(LSCoeff[i].cp);
+            ce.push_back(LSCoeff[i].ce);
+            cet.push_back(LSCoeff[i].cet);
+            se.push_back(LSCoeff[i].se);
+         }
+
+         for(i=NP-1; i>=0; --i) {
+            n[0] = PCoeff[i].nl;  n[1] = PCoeff[i].nf;   n[2] = PCoeff[i].nd;
+            n[3] = PCoeff[i].nom; n[4] = PCoeff[i].nme;  n[5] = PCoeff[i].nve;
+            n[6] = PCoeff[i].nea; n[7] = PCoeff[i].nma;  n[8] = PCoeff[i].nju;
+            n[9] = PCoeff[i].nsa; n[10] = PCoeff[i].nur; n[11] = PCoeff[i].nne;
+            n[12] = PCoeff[i].npa;
+            args.addTerm(n, Pargs, 13);
+            sp.push_back(PCoeff[i].sp); spt.push_back(0.0); cp.push_back(PCoeff[i].cp);
+            ce.push_back(PCoeff[i].ce); cet.push_back(0.0); se.push_back(PCoeff[i].se);
+         }
+      }
+   };
+
+   // CIP X,Y series IERS2010, planetary then lunar-solar frequencies, all using
+   // the fundamental arguments 0-13 L,Lp,F,D,Om,LMe,LV,LE,LMa,LJ,LS,LU,LN,Pa.
+   // The amplitudes of frequency i are coef[p][xy][sc][i], for the p-th power of T,
+   // X(xy=0) or Y(1), and sin(sc=0) or cos(1); only powers p < npow[i] are nonzero.
+   // Amplitudes are in microarcseconds; the polynomial part is in arcseconds.
+   struct XYTable
+   {
+      static const int NFA = 14;
+      static const int NPOW = 5;
+      ArgumentTable args;
+      vector<int> npow;
+      vector<double> coef[NPOW][2][2];
+      double poly[2][NPOW+1];
+
+      XYTable(void)
+      {
+         // include data arrays : defines MAXPT
+         #include "IERS2010CIOSeriesData.hpp"
+
+         int i,j,k,p,ifreq;
+         static const int which[14] = {0,1,2,3,4,5,6,7,8,9,10,11,12,13};
+
+         for(i=0; i<2; i++) for(j=0; j<=MAXPT; j++)
+            poly[i][j] = XYcoeff[i][j];
+
+         // frequency ifreq has amplitudes amp[i-1], i=iamp[ifreq]..iamp[ifreq+1]-1
+         // (..NAmp for the last); the j-th of these has power japt[j] of T,
+         // goes to X or Y by jaxy[j], and multiplies sin or cos by jasc[j].
+         int ilast(NAmp),jlast;
+         for(k=NFALS+NFAP-1; k >= 0; k--) {
+            if(k >= NFALS) {
+               ifreq = k-NFALS;
+               args.addTerm(nFAplanetary[ifreq], which, 14);
+            }
+            else
+               args.addTerm(nFAlunarsolar[k], which, 5);
+
+            for(p=0; p<NPOW; p++) for(i=0; i<2; i++) for(j=0; j<2; j++)
+               coef[p][i][j].push_back(0.0);
+            npow.push_back(0);
+
+            jlast = iamp[k];
+            for(i=ilast; i >= jlast; i--) {
+               j = i - jlast;
+               p = japt[j];
+               coef[p][jaxy[j]][jasc[j]].back() = amp[i-1];
+               if(p+1 > npow.back()) npow.back() = p+1;
+            }
+            ilast = jlast - 1;
+         }
+      }
+   };
+
+   // the tables, built once at first use (thread-safe)
+   static const NutationTable& nutationTable(void)
+   {
+      static const NutationTable table;
+      return table;
+   }
+
+   static const XYTable& xyTable(void)
+   {
+      static const XYTable table;
+      return table;
+   }
+
+   //---------------------------------------------------------------------------------
+   // Kernels - internal use only. Each loops over the nb <= blockSize epochs of a
+   // block; the loops have no branches or calls so that they vectorize.
+
+   // Constants of the sin/cos kernel: argument reduction by pi/2 in two parts
+   // (Cody-Waite; the first part has 33 bits so k*PIO2_1 is exact), and the
+   // minimax polynomials on [-pi/4,pi/4] of fdlibm's __kernel_sin and __kernel_cos.
+   static const double TWO_OVER_PI = 6.36619772367581382433e-01;
+   static const double PIO2_1  = 1.57079632673412561417e+00;
+   static const double PIO2_1T = 6.07710050650619224932e-11;
+   // adding and subtracting 1.5*2^52 rounds to the nearest integer
+   static const double ROUNDER = 6755399441055744.0;
+   static const double S1 = -1.66666666666666324348e-01,
+                       S2 =  8.33333333332248946124e-03,
+                       S3 = -1.98412698298579493134e-04,
+                       S4 =  2.75573137070700676789e-06,
+                       S5 = -2.50507602534068634195e-08,
+                       S6 =  1.58969099521155010221e-10;
+   static const double C1 =  4.16666666666666019037e-02,
+                       C2 = -1.38888888888741095749e-03,
+                       C3 =  2.48015872894767294178e-05,
+                       C4 = -2.75573143513906633035e-07,
+                       C5 =  2.08757232129817482790e-09,
+                       C6 = -1.13596475577881948265e-11;
+
+   // s,c = sin,cos(x) for n values
+   static inline void sinCosKernel(const double *x, int n, double *s, double *c)
+      throw()
+   {
+      for(int j=0; j<n; j++) {
+         // x = k*pi/2 + r, |r| <= pi/4
+         double k((x[j]*TWO_OVER_PI + ROUNDER) - ROUNDER);
+         double r((x[j] - k*PIO2_1) - k*PIO2_1T);
+         double z(r*r);
+         double sr(r + r*z*(S1+z*(S2+z*(S3+z*(S4+z*(S5+z*S6))))));
+         double cr(1.0 - 0.5*z + z*z*(C1+z*(C2+z*(C3+z*(C4+z*(C5+z*C6))))));
+         // quadrant q = k mod 4 : sin,cos = (sr,cr) (cr,-sr) (-sr,-cr) (-cr,sr)
+         int q(int(k) & 3);
+         double ss((q & 1) ? cr : sr);
+         double cc((q & 1) ? sr : cr);
+         s[j] = (q & 2) ? -ss : ss;
+         c[j] = ((q+1) & 2) ? -cc : cc;
+      }
+   }
+
+   // form the argument a of term i of table args, given the fundamental arguments
+   // fa[NFA][blockSize], for nb epochs
+   static inline void termArgument(const ArgumentTable& args, int i,
+                                   const double fa[][NutationSeries::blockSize],
+                                   int nb, double *a)
+      throw()
+   {
+      int j,k;
+      for(j=0; j<nb; j++) a[j] = 0.0;
+      for(k=args.first[i]; k<args.first[i+1]; ++k) {
+         const double m(args.mult[k]), *f(fa[args.arg[k]]);
+         for(j=0; j<nb; j++) a[j] += m * f[j];
+      }
+   }
+
+   // fundamental arguments of the IAU 2000A nutation, in radians, in the order of
+   // NutationTable, for nb epochs; cf. EarthOrientation for the lunar-solar and
+   // sofa nut00a for the MHB2000 values.
+   static void nutationArguments(const double *T, int nb,
+                                 double fa[][NutationSeries::blockSize])
+      throw()
+   {
+      static const double ARCSEC_TO_RAD(EarthOrientation::ARCSEC_TO_RAD);
+      static const double ARCSEC_PER_CIRCLE(EarthOrientation::ARCSEC_PER_CIRCLE);
+      static const double TWOPI(EarthOrientation::TWOPI);
+
+      for(int j=0; j<nb; j++) {
+         const double t(T[j]);
+         // lunar-solar
+         fa[0][j] = EarthOrientation::L(t);  // mean anomaly of the moon
+         // mean anomaly of the sun MHB2000 value
+         fa[1][j] = ::fmod(  1287104.79305
+                      + t*(129596581.0481
+                      + t*(       -0.5532
+                      + t*(        0.000136
+                      + t*(       -0.00001149)))), ARCSEC_PER_CIRCLE) * ARCSEC_TO_RAD;
+         // mean longitude of moon minus Omega MHB2000
+         fa[2][j] = ::fmod(    335779.526232
+                      + t*(1739527262.8478
+                      + t*(       -12.7512
+                      + t*(        -0.001037
+                      + t*(         0.00000417)))), ARCSEC_PER_CIRCLE) * ARCSEC_TO_RAD;
+         // mean elongation moon from sun MHB2000
+         fa[3][j] = ::fmod(   1072260.70369
+                      + t*(1602961601.2090
+                      + t*(        -6.3706
+                      + t*(         0.006593
+                      + t*(        -0.00003169)))), ARCSEC_PER_CIRCLE) * ARCSEC_TO_RAD;
+         // mean longitude of lunar ascending node
+         fa[4][j] = EarthOrientation::Omega2003(t);
+
+         // planetary; NB MHB2000 values of l,F,D,Om; follow SOFA
+         fa[5][j] = ::fmod(2.35555598 + 8328.6914269554 * t, TWOPI);
+         fa[6][j] = ::fmod(1.627905234 + 8433.466158131 * t, TWOPI);
+         fa[7][j] = ::fmod(5.198466741 + 7771.3771468121 * t, TWOPI);
+         fa[8][j] = ::fmod(2.18243920 - 33.757045 * t, TWOPI);
+         fa[9][j] = EarthOrientation::LMe(t);   // mean longitude Mercury
+         fa[10][j] = EarthOrientation::LV(t);   // mean longitude of Venus
+         fa[11][j] = EarthOrientation::LE(t);   // mean longitude of Earth
+         fa[12][j] = EarthOrientation::LMa(t);  // mean longitude Mars
+         fa[13][j] = EarthOrientation::LJ(t);   // mean longitude Jupiter
+         fa[14][j] = EarthOrientation::LS(t);   // mean longitude Saturn
+         fa[15][j] = EarthOrientation::LU(t);   // mean longitude Uranus
+         // mean longitude Neptune MHB2000
+         fa[16][j] = ::fmod(5.321159000 + 3.8127774000 * t, TWOPI);
+         fa[17][j] = EarthOrientation::Pa(t);   // general precession in longitude
+      }
+   }
+
+   // fundamental arguments of the XY series, in the order of XYTable
+   static void xyArguments(const double *T, int nb,
+                           double fa[][NutationSeries::blockSize])
+      throw()
+   {
+      for(int j=0; j<nb; j++) {
+         const double t(T[j]);
+         fa[0][j] = EarthOrientation::L(t);
+         fa[1][j] = EarthOrientation::Lp(t);
+         fa[2][j] = EarthOrientation::F(t);
+         fa[3][j] = EarthOrientation::D(t);
+         fa[4][j] = EarthOrientation::Omega2003(t);
+         fa[5][j] = EarthOrientation::LMe(t);
+         fa[6][j] = EarthOrientation::LV(t);
+         fa[7][j] = EarthOrientation::LE(t);
+         fa[8][j] = EarthOrientation::LMa(t);
+         fa[9][j] = EarthOrientation::LJ(t);
+         fa[10][j] = EarthOrientation::LS(t);
+         fa[11][j] = EarthOrientation::LU(t);
+         fa[12][j] = EarthOrientation::LN(t);
+         fa[13][j] = EarthOrientation::Pa(t);
+      }
+   }
+
+   //---------------------------------------------------------------------------------
+   void NutationSeries::NutationAngles2003(const double *T, int n,
+                                           double *deps, double *dpsi)
+      throw()
+   {
+      // sin and cos coefficients have units 0.1 microarcsec = 1e-7as
+      static const double COEFF_TO_RAD(EarthOrientation::ARCSEC_TO_RAD*1.0e-7);
+
+      const NutationTable& tab(nutationTable());
+      const int nterms(tab.args.size());
+      double fa[NutationTable::NFA][blockSize];
+      double a[blockSize],s[blockSize],c[blockSize];
+      double de[blockSize],dp[blockSize];
+
+      for(int j0=0; j0<n; j0+=blockSize) {
+         const int nb(n-j0 < blockSize ? n-j0 : blockSize);
+         const double *t(T+j0);
+         int i,j;
+
+         nutationArguments(t, nb, fa);
+         for(j=0; j<nb; j++) de[j] = dp[j] = 0.0;
+
+         for(i=0; i<nterms; i++) {
+            termArgument(tab.args, i, fa, nb, a);
+            sinCosKernel(a, nb, s, c);
+            const double sp(tab.sp[i]), spt(tab.spt[i]), cp(tab.cp[i]);
+            const double ce(tab.ce[i]), cet(tab.cet[i]), se(tab.se[i]);
+            for(j=0; j<nb; j++) {
+               de[j] += (ce + cet * t[j]) * c[j] + se * s[j];
+               dp[j] += (sp + spt * t[j]) * s[j] + cp * c[j];
+            }
+         }
+
+         // convert 0.1microarcsec to radians
+         for(j=0; j<nb; j++) {
+            deps[j0+j] = de[j] * COEFF_TO_RAD;
+            dpsi[j0+j] = dp[j] * COEFF_TO_RAD;
+         }
+      }
+   }
+
+   //---------------------------------------------------------------------------------
+   // IAU 2000A with P03 adjustments. cf. sofa nut06a.c
+   void NutationSeries::NutationAngles2010(const double *T, int n,
+                                           double *deps, double *dpsi)
+      throw()
+   {
+      NutationAngles2003(T, n, deps, dpsi);
+      for(int j=0; j<n; j++) {
+         double fj2(-2.7774e-6 * T[j]);
+         dpsi[j] *= (1.0+0.4697e-6 + fj2);
+         deps[j] *= (1.0+fj2);
+      }
+   }
+
+   //---------------------------------------------------------------------------------
+   // Reference IERS(2010) Section 5.5.4
+   void NutationSeries::XYCIO(const double *T, int n, double *X, double *Y)
+      throw()
+   {
+      static const double ARCSEC_TO_RAD(EarthOrientation::ARCSEC_TO_RAD);
+
+      const XYTable& tab(xyTable());
+      const int nfreq(tab.args.size());
+      double fa[XYTable::NFA][blockSize];
+      double powsT[XYTable::NPOW][blockSize];
+      double a[blockSize],s[blockSize],c[blockSize];
+      double xs[blockSize],ys[blockSize];
+
+      for(int j0=0; j0<n; j0+=blockSize) {
+         const int nb(n-j0 < blockSize ? n-j0 : blockSize);
+         const double *t(T+j0);
+         int i,j,p;
+
+         xyArguments(t, nb, fa);
+         for(j=0; j<nb; j++) {
+            powsT[0][j] = 1.0;
+            for(p=1; p<XYTable::NPOW; p++) powsT[p][j] = powsT[p-1][j] * t[j];
+            xs[j] = ys[j] = 0.0;
+         }
+
+         for(i=0; i<nfreq; i++) {
+            termArgument(tab.args, i, fa, nb, a);
+            sinCosKernel(a, nb, s, c);
+            for(p=0; p<tab.npow[i]; p++) {
+               const double xsin(tab.coef[p][0][0][i]), xcos(tab.coef[p][0][1][i]);
+               const double ysin(tab.coef[p][1][0][i]), ycos(tab.coef[p][1][1][i]);
+               const double *tp(powsT[p]);
+               for(j=0; j<nb; j++) {
+                  xs[j] += (xsin * s[j] + xcos * c[j]) * tp[j];
+                  ys[j] += (ysin * s[j] + ycos * c[j]) * tp[j];
+               }
+            }
+         }
+
+         // add the polynomial
+         for(j=0; j<nb; j++) {
+            double xp(0.0),yp(0.0),tp(powsT[XYTable::NPOW-1][j]*t[j]);
+            for(p=XYTable::NPOW; p>=0; p--) {
+               xp += tab.poly[0][p] * tp;
+               yp += tab.poly[1][p] * tp;
+               if(p > 0) tp = powsT[p-1][j];
+            }
+            X[j0+j] = (xp + xs[j]*1.e-6) * ARCSEC_TO_RAD;
+            Y[j0+j] = (yp + ys[j]*1.e-6) * ARCSEC_TO_RAD;
+         }
+      }
+   }
+
+   //---------------------------------------------------------------------------------
+   void NutationSeries::SinCos(const double *x, int n, double *s, double *c)
+      throw()
+   {
+      sinCosKernel(x, n, s, c);
+   }
+
+}  // end namespace gpstk
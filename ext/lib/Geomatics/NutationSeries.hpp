@@ -0,0 +1,124 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+
+
+/// @file NutationSeries.hpp
+/// Include file defining the NutationSeries class, which evaluates the IERS 2003
+/// and 2010 nutation series, and the IERS 2010 series for the CIP coordinates X,Y,
+/// at many epochs at once.
+
+#ifndef CLASS_NUTATIONSERIES_INCLUDE
+#define CLASS_NUTATIONSERIES_INCLUDE
+
+//------------------------------------------------------------------------------------
+namespace gpstk {
+
+   /// class NutationSeries evaluates the long trigonometric series of the IERS
+   /// conventions - the IAU 2000A nutation (1365 terms), used by IERS2003 and
+   /// with P03 adjustments by IERS2010, and the IERS2010 series for the coordinates
+   /// X,Y of the CIP (1309 frequencies) - for a batch of epochs.
+   /// The coefficients of EarthOrientation (IERS2003NutationData.hpp and
+   /// IERS2010CIOSeriesData.hpp) are copied once, at first use, into tables with
+   /// one array per coefficient (structure of arrays), with the multipliers of the
+   /// fundamental arguments stored sparsely. The epochs are processed in blocks of
+   /// blockSize: for each term the arguments, their sines and cosines, and the
+   /// sums are computed for the whole block in simple loops over the epochs,
+   /// which the compiler vectorizes; the sine and cosine are computed by SinCos(),
+   /// a branch-free polynomial kernel, rather than by the math library.
+   /// EarthOrientation uses these functions, with one epoch, for its own nutation
+   /// and XY series, so results are identical to it; they agree with SOFA to
+   /// better than 1.e-15 radians.
+   /// All functions are static and thread-safe.
+   /// Example:
+   /// <pre>
+   ///    std::vector<double> T(n),deps(n),dpsi(n);
+   ///    for(i=0; i<n; i++) T[i] = EarthOrientation::CoordTransTime(times[i]);
+   ///    NutationSeries::NutationAngles2010(&T[0], n, &deps[0], &dpsi[0]);
+   /// </pre>
+   class NutationSeries
+   {
+   public:
+      /// number of epochs processed together
+      static const int blockSize = 32;
+
+      /// Nutation of the obliquity (deps) and of the longitude (dpsi), IERS 2003
+      /// or IAU 2000A model, at n epochs.
+      /// @param T     array of n coordinate transformation times
+      ///              (EarthOrientation::CoordTransTime())
+      /// @param n     number of epochs
+      /// @param deps  array of length n, output nutation of the obliquity, radians
+      /// @param dpsi  array of length n, output nutation of the longitude, radians
+      static void NutationAngles2003(const double *T, int n,
+                                     double *deps, double *dpsi)
+         throw();
+
+      /// Nutation of the obliquity (deps) and of the longitude (dpsi), IERS 2010,
+      /// which is IAU 2000A with P03 adjustments, at n epochs.
+      /// @param T     array of n coordinate transformation times
+      /// @param n     number of epochs
+      /// @param deps  array of length n, output nutation of the obliquity, radians
+      /// @param dpsi  array of length n, output nutation of the longitude, radians
+      static void NutationAngles2010(const double *T, int n,
+                                     double *deps, double *dpsi)
+         throw();
+
+      /// Coordinates X,Y of the CIP from the series based on IAU 2006 precession
+      /// and IAU 2000A nutation (IERS 2010), at n epochs. cf. sofa xy06
+      /// @param T  array of n coordinate transformation times
+      /// @param n  number of epochs
+      /// @param X  array of length n, output X coordinate of the CIP, radians
+      /// @param Y  array of length n, output Y coordinate of the CIP, radians
+      static void XYCIO(const double *T, int n, double *X, double *Y)
+         throw();
+
+      /// Sine and cosine of n angles, as computed by the series kernels.
+      /// Accurate to about 1 ulp for |x| < 1.e5 radians; larger arguments are not
+      /// reduced correctly.
+      /// @param x  array of n angles in radians
+      /// @param n  number of angles
+      /// @param s  array of length n, output sin(x)
+      /// @param c  array of length n, output cos(x)
+      static void SinCos(const double *x, int n, double *s, double *c)
+         throw();
+
+   }; // end class NutationSeries
+
+}  // end namespace gpstk
+
+#endif // CLASS_NUTATIONSERIES_INCLUDE
@@ -127,6 +127,35 @@ public:
    ///                if there is corruption in the static arrays, or .
    Triple computeDisplacement(std::string site, EphTime t);
 
+   /// Compute the complex admittance of the given site at each of the 342 derived
+   /// tides, i.e. computeDisplacement() with the astronomical arguments removed.
+   /// The displacement at times near t is then the sum over derived tides j of
+   /// re[j]*cos(arg[j]) - im[j]*sin(arg[j]), where arg is the output of
+   /// derivedTideArguments(); this lets many epochs share one spline fit.
+   /// @param site  string Input name of the site; must be the same as previously
+   ///              successfully passed to initializeSites().
+   /// @param t     EphTime Input time at which the tidal frequencies are found.
+   /// @param re    vector<double> Output real parts, North, East then Up, each
+   ///              342 long, in meters.
+   /// @param im    vector<double> Output imaginary parts, same layout as re.
+   /// @throw Exception if the site has not been initialized.
+   void computeAdmittance(std::string site, EphTime t,
+                          std::vector<double>& re, std::vector<double>& im);
+
+   /// Compute the Doodson arguments (degrees) and their frequencies (cycles/day)
+   /// at the given time.
+   /// @param t         EphTime Input time of interest.
+   /// @param Dood      array of 6 Doodson arguments at time t in degrees
+   /// @param freqDood  array of 6 Doodson frequencies at time in cycles/day
+   /// @throw Exception if the time system is unknown.
+   static void DoodsonArguments(EphTime t, double Dood[6], double freqDood[6]);
+
+   /// Compute the astronomical arguments of the 342 derived tides, in degrees,
+   /// from the Doodson arguments; cf. computeAdmittance().
+   /// @param Dood      array of 6 Doodson arguments in degrees
+   /// @param arg       vector<double> Output arguments of the 342 derived tides
+   static void derivedTideArguments(const double Dood[6], std::vector<double>& arg);
+
    /// Return the recorded latitude, longitude and ht(=0) for the given site.
    /// Return value of (0.0,0.0,0.0) probably means the position was not found.
    Triple getPosition(std::string site) throw()
@@ -161,6 +190,15 @@ private:
    /// Number of derived tides computed by deriveTides()
    static const int NDER;
 
+   /// Doodson numbers of the standard (Schwiderski) tides
+   static const NVector SchInd[];
+
+   /// Doodson numbers of the derived tides
+   static const NVector DerInd[];
+
+   /// Amplitudes of the derived tides in the tide generating potential
+   static const double DerAmp[];
+
    /// Derive the 342 tides from the standard 11 tides using cubic spline
    /// interpolation. Called by computeDisplacements()
    /// @param SchTides  array of 11 NVectors (int[6]) with for standard tides
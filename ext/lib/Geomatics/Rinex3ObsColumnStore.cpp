@@ -0,0 +1,380 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/// @file Rinex3ObsColumnStore.cpp  Store RINEX obs data by column: one contiguous
+/// array of data, LLI and SSI for each satellite/obs type, indexed by epoch.
+
+//------------------------------------------------------------------------------------
+// system includes
+#include <cmath>
+#include <algorithm>
+
+// GPSTk
+#include "StringUtils.hpp"
+#include "TimeString.hpp"        // printTime
+#include "stl_helpers.hpp"       // vectorindex
+#include "Rinex3ObsHeader.hpp"
+#include "Rinex3ObsData.hpp"
+
+// geomatics
+#include "Rinex3ObsColumnStore.hpp"
+#include "GSatID.hpp"            // for SatPass
+
+using namespace std;
+
+namespace gpstk
+{
+
+//------------------------------------------------------------------------------------
+const double Rinex3ObsColumnStore::dttol(0.001);
+
+//------------------------------------------------------------------------------------
+Rinex3ObsColumnStore::SatIterator::SatIterator(const Rinex3ObsColumnStore& in_store,
+                                               const vector<int>& in_cols)
+   : store(in_store), cols(in_cols), n(0)
+{
+   findData();
+}
+
+//------------------------------------------------------------------------------------
+Rinex3ObsColumnStore::SatIterator& Rinex3ObsColumnStore::SatIterator::operator++(void)
+{
+   if(n < store.times.size()) {
+      n++;
+      findData();
+   }
+   return *this;
+}
+
+//------------------------------------------------------------------------------------
+void Rinex3ObsColumnStore::SatIterator::findData(void)
+{
+   for( ; n < store.times.size(); n++) {
+      for(unsigned int i=0; i<cols.size(); i++)
+         if(cols[i] >= 0 && store.columns[cols[i]].data[n] != 0.0)
+            return;
+   }
+}
+
+//------------------------------------------------------------------------------------
+unsigned short Rinex3ObsColumnStore::SatIterator::flag(void) const
+{
+   // NB so one missing obs makes the sat/epoch bad, as in Rinex3ObsFileLoader
+   for(unsigned int i=0; i<cols.size(); i++)
+      if(cols[i] >= 0 && ::fabs(store.columns[cols[i]].data[n]) < 1.e-8)
+         return SatPass::BAD;
+   return SatPass::OK;
+}
+
+//------------------------------------------------------------------------------------
+void Rinex3ObsColumnStore::SatIterator::getData(vector<double>& data,
+                                                vector<unsigned short>& lli,
+                                                vector<unsigned short>& ssi) const
+{
+   data.resize(cols.size());
+   lli.resize(cols.size());
+   ssi.resize(cols.size());
+   for(unsigned int i=0; i<cols.size(); i++) {
+      if(cols[i] < 0) {
+         data[i] = 0.0;
+         lli[i] = ssi[i] = 0;
+      }
+      else {
+         const Column& c(store.columns[cols[i]]);
+         data[i] = c.data[n];
+         lli[i] = c.lli[n];
+         ssi[i] = c.ssi[n];
+      }
+   }
+}
+
+//------------------------------------------------------------------------------------
+void Rinex3ObsColumnStore::clear(void)
+{
+   times.clear();
+   clockOffsets.clear();
+   columns.clear();
+   sysObsTypes.clear();
+   satColumns.clear();
+   mcv.reset();
+   dt = 0.0;
+}
+
+//------------------------------------------------------------------------------------
+int Rinex3ObsColumnStore::addColumn(const RinexSatID& sat, const string& srot)
+{
+   columns.push_back(Column());
+   Column& c(columns.back());
+   c.sat = sat;
+   c.srot = srot;
+   c.data.resize(times.size(), 0.0);
+   c.lli.resize(times.size(), 0);
+   c.ssi.resize(times.size(), 0);
+   return columns.size()-1;
+}
+
+//------------------------------------------------------------------------------------
+// Read the (remaining) data in a stream, appending it to the store
+// param[in,out] strm stream to read
+// return number of epochs added to the store
+int Rinex3ObsColumnStore::load(Rinex3ObsStream& strm)
+{
+try {
+   unsigned int i,k;
+   const double currVer(Rinex3ObsBase::currentVersion);
+
+   if(!strm.headerRead) strm >> strm.header;
+
+   // translate the obs types of each system in the header into indexes in
+   // sysObsTypes, adding new ones (and their columns)
+   map<char, vector<int> > typeIndex;
+   map<string,vector<RinexObsID> >::const_iterator kt;
+   for(kt = strm.header.mapObsTypes.begin();
+       kt != strm.header.mapObsTypes.end(); ++kt) {
+      if(kt->first.empty()) continue;
+      const char sys(kt->first[0]);
+      vector<string>& ots(sysObsTypes[sys]);
+      vector<int>& ind(typeIndex[sys]);
+      for(i=0; i<kt->second.size(); i++) {
+         string srot(kt->first + kt->second[i].asString(currVer));
+         int j(vectorindex(ots,srot));
+         if(j == -1) {
+            ots.push_back(srot);
+            j = ots.size()-1;
+            map<RinexSatID, vector<int> >::iterator sit;
+            for(sit = satColumns.begin(); sit != satColumns.end(); ++sit)
+               if(sit->first.systemChar() == sys)
+                  sit->second.push_back(addColumn(sit->first, srot));
+         }
+         ind.push_back(j);
+      }
+   }
+
+   int nadd(0);
+   Rinex3ObsData rod;
+   while(1) {
+      strm >> rod;
+      if(strm.eof() || !strm.good()) break;
+
+      // skip aux header, etc
+      if(rod.epochFlag != 0 && rod.epochFlag != 1) continue;
+
+      if(times.size() > 0) {
+         double delt(rod.time - times.back());
+         if(delt < dttol) {
+            Exception e("Epoch out of time order at "
+               + printTime(rod.time,"%04Y/%02m/%02d %02H:%02M:%02S"));
+            GPSTK_THROW(e);
+         }
+         mcv.add(delt);
+      }
+
+      // add the epoch, with zero data in every column
+      times.push_back(rod.time);
+      clockOffsets.push_back(rod.clockOffset);
+      const unsigned int n(times.size()-1);
+      for(k=0; k<columns.size(); k++) {
+         columns[k].data.push_back(0.0);
+         columns[k].lli.push_back(0);
+         columns[k].ssi.push_back(0);
+      }
+      nadd++;
+
+      // fill in the data
+      Rinex3ObsData::DataMap::const_iterator it;
+      for(it=rod.obs.begin(); it != rod.obs.end(); ++it) {
+         const RinexSatID& sat(it->first);
+         const char sys(sat.systemChar());
+         map<char, vector<int> >::const_iterator tt(typeIndex.find(sys));
+         if(tt == typeIndex.end()) continue;
+
+         map<RinexSatID, vector<int> >::iterator sit(satColumns.find(sat));
+         if(sit == satColumns.end()) {                   // add the sat
+            const vector<string>& ots(sysObsTypes[sys]);
+            vector<int> v(ots.size());
+            for(k=0; k<ots.size(); k++) v[k] = addColumn(sat, ots[k]);
+            sit = satColumns.insert(make_pair(sat,v)).first;
+         }
+
+         for(i=0; i<it->second.size() && i<tt->second.size(); i++) {
+            Column& c(columns[sit->second[tt->second[i]]]);
+            c.data[n] = it->second[i].data;
+            c.lli[n] = it->second[i].lli;
+            c.ssi[n] = it->second[i].ssi;
+         }
+      }
+   }
+
+   dt = mcv.bestDT();
+
+   return nadd;
+}
+catch(Exception& e) { GPSTK_RETHROW(e); }
+}
+
+//------------------------------------------------------------------------------------
+vector<RinexSatID> Rinex3ObsColumnStore::getSats(void) const
+{
+   vector<RinexSatID> sats;
+   map<RinexSatID, vector<int> >::const_iterator sit;
+   for(sit = satColumns.begin(); sit != satColumns.end(); ++sit)
+      sats.push_back(sit->first);
+   return sats;
+}
+
+//------------------------------------------------------------------------------------
+vector<string> Rinex3ObsColumnStore::getObsTypes(char sys) const
+{
+   map<char, vector<string> >::const_iterator it(sysObsTypes.find(sys));
+   if(it == sysObsTypes.end()) return vector<string>();
+   return it->second;
+}
+
+//------------------------------------------------------------------------------------
+int Rinex3ObsColumnStore::column(const RinexSatID& sat, const string& srot) const
+{
+   map<RinexSatID, vector<int> >::const_iterator sit(satColumns.find(sat));
+   if(sit == satColumns.end()) return -1;
+   map<char, vector<string> >::const_iterator it(sysObsTypes.find(sat.systemChar()));
+   if(it == sysObsTypes.end()) return -1;
+   int j(vectorindex(it->second,srot));
+   return (j == -1 ? -1 : sit->second[j]);
+}
+
+//------------------------------------------------------------------------------------
+// Write the store to a list of SatPass objects
+// return >=0 number of passes created, -4 no data,
+//    -5 obstypes not provided for all systems
+int Rinex3ObsColumnStore::WriteSatPassList(
+                                    const map<char, vector<string> >& sysSPOT,
+                                    const map<char, vector<int> >& indexOT,
+                                    vector<SatPass>& SPList) const
+{
+try {
+   if(times.size() == 0) return -4;
+
+   unsigned int i;
+   int npass(0);
+   map<GSatID,unsigned int> indexForSat;
+   map<GSatID,unsigned int>::const_iterator satit;
+   map<char,vector<string> >::const_iterator obsit;
+   map<char, vector<int> >::const_iterator jt;
+
+   // an iterator for each sat in a wanted system, in satellite order
+   vector<GSatID> sats;
+   vector<const vector<string>*> satOT;
+   vector<SatIterator> iters;
+   map<RinexSatID, vector<int> >::const_iterator sit;
+   for(sit = satColumns.begin(); sit != satColumns.end(); ++sit) {
+      const char sys(sit->first.systemChar());
+      jt = indexOT.find(sys);
+      if(jt == indexOT.end())             // skip unwanted system
+         continue;
+      obsit = sysSPOT.find(sys);
+      if(obsit == sysSPOT.end())          // sysSPOT not found for system sys
+         return -5;
+
+      vector<int> cols(jt->second.size(),-1);
+      for(i=0; i<jt->second.size(); i++) {
+         int ind(jt->second[i]);
+         if(ind >= 0 && ind < int(sit->second.size()))
+            cols[i] = sit->second[ind];
+      }
+      sats.push_back(GSatID(sit->first));
+      satOT.push_back(&obsit->second);
+      iters.push_back(SatIterator(*this,cols));
+   }
+
+   // add to existing SPList
+   if(SPList.size() > 0) {
+      // sort existing list on time - this probably already done
+      std::sort(SPList.begin(),SPList.end());
+
+      // fill index array using SPList - later ones overwrite earlier ones
+      for(i=0; i<SPList.size(); i++)
+         indexForSat[SPList[i].getSat()] = i;
+   }
+
+   vector<double> data;
+   vector<unsigned short> ssi, lli;
+
+   // loop over epochs, then satellites, as the loader does
+   for(unsigned int n=0; n<times.size(); n++) {
+      for(unsigned int ns=0; ns<iters.size(); ns++) {
+         SatIterator& iter(iters[ns]);
+         if(!iter.valid() || iter.epoch() != n) continue;
+
+         const GSatID& sat(sats[ns]);
+         iter.getData(data,lli,ssi);
+         unsigned short flag(iter.flag());
+         ++iter;
+
+         // find the current SatPass for this sat
+         satit = indexForSat.find(sat);
+         if(satit == indexForSat.end()) {       // create a new one
+            SatPass newSP(sat,dt,*satOT[ns]);
+            SPList.push_back(newSP);
+            npass++;
+            indexForSat[sat] = SPList.size()-1;
+            satit = indexForSat.find(sat);
+         }
+
+         // add the data to the SatPass
+         int j;
+         do {
+            j = SPList[satit->second].addData(
+                  times[n], *satOT[ns], data, lli, ssi, flag);
+
+            if(j == -1) {        // there was a gap - break into two passes
+               SatPass newSP(sat,dt,*satOT[ns]);
+               SPList.push_back(newSP);
+               npass++;
+               indexForSat[sat] = SPList.size()-1;
+               satit = indexForSat.find(sat);
+            }
+
+         } while(j == -1);       // will iterate only once, if there is a gap
+      }
+   }
+
+   return npass;
+}
+catch(Exception& e) { GPSTK_RETHROW(e); }
+}
+
+}  // end namespace
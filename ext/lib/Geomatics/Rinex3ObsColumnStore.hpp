@@ -0,0 +1,246 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/// @file Rinex3ObsColumnStore.hpp  Store RINEX obs data by column: one contiguous
+/// array of data, LLI and SSI for each satellite/obs type, indexed by epoch.
+
+#ifndef GPSTK_RINEX3_OBS_COLUMN_STORE_INCLUDE
+#define GPSTK_RINEX3_OBS_COLUMN_STORE_INCLUDE
+
+//------------------------------------------------------------------------------------
+// system includes
+#include <string>
+#include <vector>
+#include <map>
+#include <cmath>
+#include <iomanip>
+
+// GPSTk
+#include "Exception.hpp"
+#include "CommonTime.hpp"
+#include "RinexSatID.hpp"
+#include "MostCommonValue.hpp"
+#include "Rinex3ObsStream.hpp"
+
+// gpstk-geomatics
+#include "SatPass.hpp"
+
+namespace gpstk {
+
+//--------------------------------------------------------------------------------
+/// Column-wise (structure of arrays) store of RINEX obs data, an alternative to the
+/// vector<Rinex3ObsData> of Rinex3ObsFileLoader. Rather than a map of vectors for
+/// every epoch, the store keeps one array of data (double) and two arrays of LLI and
+/// SSI (unsigned char) for each satellite and obs type, each array indexed by epoch
+/// (0 to numEpochs()-1) and parallel to getTimes(). Missing data are zero, as in
+/// RINEX. Code that processes one satellite/obs type at a time (cycle slips, stats)
+/// can then run over contiguous memory.
+/// The operation of the class is as follows.
+/// 1. Declare an object and load() one or more (congruent, time-ordered) files
+///    [the obs types of each system are the union of those in the headers]
+/// 2. Find the column of a satellite/obs type with column(sat,"GL1C"), and access
+///    the arrays with data(col), LLI(col) and SSI(col)
+/// 3. Iterate over the epochs of one satellite with a SatIterator, which provides
+///    the data in the form taken by SatPass::addData(), or
+/// 4. Write the whole store to a list of SatPass with WriteSatPassList()
+class Rinex3ObsColumnStore
+{
+public:
+
+   /// Iterate over the epochs at which one satellite has data in any of a given
+   /// list of columns. The list of columns is parallel to the obs types of a SatPass
+   /// (-1 for an obs type not in the store) and getData() fills the arrays passed to
+   /// SatPass::addData(). E.g.
+   ///   for(SatIterator it(store,cols); it.valid(); ++it) {
+   ///      it.getData(data,lli,ssi);
+   ///      sp.addData(it.time(), obstypes, data, lli, ssi, it.flag());
+   ///   }
+   class SatIterator
+   {
+   public:
+      /// constructor; positions the iterator at the first epoch with data
+      /// @param[in] store the column store to iterate over; must outlive the iterator
+      /// @param[in] cols column indexes, -1 for obs types not in the store
+      SatIterator(const Rinex3ObsColumnStore& store, const std::vector<int>& cols);
+
+      /// @return true unless the iterator has passed the last epoch
+      inline bool valid(void) const { return (n < store.times.size()); }
+
+      /// advance to the next epoch with data
+      SatIterator& operator++(void);
+
+      /// @return current epoch index into the store
+      inline unsigned int epoch(void) const { return n; }
+      /// @return current epoch time
+      inline const CommonTime& time(void) const { return store.times[n]; }
+
+      /// @return SatPass::OK, or SatPass::BAD if any of the obs types are missing
+      unsigned short flag(void) const;
+
+      /// get the data at the current epoch, parallel to the list of columns
+      /// @param[out] data data values, zero if missing
+      /// @param[out] lli LLI values
+      /// @param[out] ssi SSI values
+      void getData(std::vector<double>& data, std::vector<unsigned short>& lli,
+                   std::vector<unsigned short>& ssi) const;
+
+   private:
+      /// find the first epoch at or after n with data
+      void findData(void);
+
+      const Rinex3ObsColumnStore& store;  ///< store being iterated
+      std::vector<int> cols;              ///< columns (-1 missing) for this sat
+      unsigned int n;                     ///< current epoch
+   }; // end class SatIterator
+
+   /// empty constructor
+   Rinex3ObsColumnStore(void) { clear(); }
+
+   /// clear all data
+   void clear(void);
+
+   /// Read the (remaining) data in a stream, appending it to the store, after
+   /// reading the header if the stream has not done so yet. Only epochs with flag
+   /// 0 or 1 are stored; epochs must be in time order.
+   /// Satellites and obs types not yet in the store are added, with zero data at
+   /// all earlier epochs; each satellite has a column for every obs type of its
+   /// system.
+   /// @param[in,out] strm stream to read, opened with the caller's choice of
+   ///    exception mask; exceptions from the stream are passed on.
+   /// @return number of epochs added to the store
+   /// @throw Exception if an epoch is out of time order
+   int load(Rinex3ObsStream& strm);
+
+   /// @return number of epochs in the store
+   inline unsigned int numEpochs(void) const { return times.size(); }
+
+   /// @return times of all epochs, parallel to each column
+   inline const std::vector<CommonTime>& getTimes(void) const { return times; }
+
+   /// @return receiver clock offsets of all epochs, parallel to each column
+   inline const std::vector<double>& getClockOffsets(void) const
+      { return clockOffsets; }
+
+   /// @return the most common time step between epochs, or 0 if unknown
+   inline double getDT(void) const { return dt; }
+
+   /// @return list of all satellites in the store
+   std::vector<RinexSatID> getSats(void) const;
+
+   /// @param[in] sys system character, e.g. 'G'
+   /// @return list of the 4-char obs types (e.g. GC1C) stored for system sys
+   std::vector<std::string> getObsTypes(char sys) const;
+
+   /// @return number of columns in the store
+   inline unsigned int numColumns(void) const { return columns.size(); }
+
+   /// find the column for a satellite and obs type
+   /// @param[in] sat satellite
+   /// @param[in] srot 4-char obs type, e.g. GC1C
+   /// @return index of the column, or -1 if not found
+   int column(const RinexSatID& sat, const std::string& srot) const;
+
+   /// @return satellite of a column
+   inline const RinexSatID& columnSat(unsigned int col) const
+      { return columns[col].sat; }
+   /// @return 4-char obs type of a column
+   inline const std::string& columnObsType(unsigned int col) const
+      { return columns[col].srot; }
+
+   /// @return data array of a column, numEpochs() long
+   inline const double *data(unsigned int col) const
+      { return columns[col].data.data(); }
+   /// @return LLI array of a column, numEpochs() long
+   inline const unsigned char *LLI(unsigned int col) const
+      { return columns[col].lli.data(); }
+   /// @return SSI array of a column, numEpochs() long
+   inline const unsigned char *SSI(unsigned int col) const
+      { return columns[col].ssi.data(); }
+
+   /// Write the store to a list of SatPass objects; this is the column store
+   /// version of Rinex3ObsFileLoader::WriteSatPassList(), taking the same arguments,
+   /// except that the indexes are into getObsTypes(sys). Epochs at which a
+   /// satellite has none of the obs types are skipped.
+   /// @param[in] obstypes map of <sys,vector<ObsID>> for SatPass (2or3-char obsID)
+   /// @param[in] indexOT map<char,vector<int>> with key=system char,
+   ///    value=vector parallel to obstypes with elements equal to
+   ///    {index in getObsTypes(sys) for each obstype, or -1 if not in store}
+   /// @param[in,out] SPList vector of SatPass to which data store is written
+   /// @return >=0 number of passes created, -4 no data,
+   ///    -5 obstypes not provided for all systems
+   int WriteSatPassList(const std::map<char, std::vector<std::string> >& obstypes,
+                        const std::map<char, std::vector<int> >& indexOT,
+                        std::vector<SatPass>& SPList) const;
+
+private:
+   /// one satellite/obs type
+   struct Column
+   {
+      RinexSatID sat;                  ///< satellite
+      std::string srot;                ///< 4-char obs type
+      std::vector<double> data;        ///< data for each epoch
+      std::vector<unsigned char> lli;  ///< LLI for each epoch
+      std::vector<unsigned char> ssi;  ///< SSI for each epoch
+   };
+
+   /// add a column with zero data at every epoch
+   /// @return index of the new column
+   int addColumn(const RinexSatID& sat, const std::string& srot);
+
+   /// dttol tolerance in comparing times
+   static const double dttol;
+
+   std::vector<CommonTime> times;      ///< time of each epoch
+   std::vector<double> clockOffsets;   ///< receiver clock offset at each epoch
+   std::vector<Column> columns;        ///< all the data
+
+   /// obs types (4-char) for each system
+   std::map<char, std::vector<std::string> > sysObsTypes;
+
+   /// column indexes for each satellite, parallel to sysObsTypes[sys]; a satellite
+   /// has a column for every obs type of its system
+   std::map<RinexSatID, std::vector<int> > satColumns;
+
+   MostCommonValue mcv;                ///< estimator of the time step
+   double dt;                          ///< time step, cf. getDT()
+
+}; // end class Rinex3ObsColumnStore
+
+} // end namespace gpstk
+
+#endif      // GPSTK_RINEX3_OBS_COLUMN_STORE_INCLUDE
@@ -42,6 +42,9 @@
 //------------------------------------------------------------------------------------
 // system includes
 #include <iostream>
+#include <cstring>
+#include <memory>
+#include <future>
 
 // GPSTk
 #include "Exception.hpp"
@@ -52,6 +55,8 @@
 #include "Rinex3ObsData.hpp"
 #include "Rinex3ObsStream.hpp"
 #include "MostCommonValue.hpp"
+#include "MappedFile.hpp"
+#include "ThreadPool.hpp"
 
 // geomatics
 #include "Rinex3ObsFileLoader.hpp"
@@ -66,6 +71,133 @@ namespace gpstk
 //------------------------------------------------------------------------------------
 const double Rinex3ObsFileLoader::dttol(0.001);
 
+//------------------------------------------------------------------------------------
+// A contiguous run of data records in one RINEX 3 file, parsed by one thread
+namespace {
+struct ObsChunk
+{
+   size_t offset;                   // file offset of the first epoch line
+   unsigned int lineNumber;         // line number preceding offset
+   int nrecs;                       // number of records, -1 means read to EOF
+   vector<Rinex3ObsData> data;      // the records read
+   string errmsg;                   // if not empty, reading stopped on this error
+};
+}
+
+//------------------------------------------------------------------------------------
+// Split the data section of a RINEX 3 obs file into (at most) nchunks runs of
+// whole records. Records are located by reading epoch lines and skipping the
+// number of lines given in each; the scan stops at anything unexpected, which
+// is then left to the last chunk so that the parser reports it, in order.
+// param[in] mf the mapped file
+// param[in] pos offset of the first data record (end of header)
+// param[in] line the line number of the last header line
+// param[in] nchunks the number of chunks wanted
+// param[out] chunks the chunks, the last reading to EOF
+static void findChunks(const MappedFile& mf, size_t pos, unsigned int line,
+                       int nchunks, vector< shared_ptr<ObsChunk> >& chunks)
+{
+   const char *data(mf.data()), *end(mf.data()+mf.size());
+   vector<size_t> recpos;
+   vector<unsigned int> recline;
+
+   while(pos < mf.size()) {
+      const char *beg(data+pos), *nl;
+      nl = static_cast<const char*>(memchr(beg, '\n', end-beg));
+      size_t len((nl ? nl : end) - beg);
+      if(len < 35 || beg[0] != '>' || beg[1] != ' ') break;
+      long nsv(StringUtils::asInt(beg+32, 3));
+      if(nsv < 0) break;
+
+      recpos.push_back(pos);
+      recline.push_back(line);
+      // skip the epoch line and the nsv lines following
+      for(long n=0; n<=nsv && pos < mf.size(); n++) {
+         nl = static_cast<const char*>(memchr(data+pos, '\n', mf.size()-pos));
+         pos = (nl ? nl-data+1 : mf.size());
+         line++;
+      }
+   }
+
+   chunks.clear();
+   size_t nrec(recpos.size()), nch(nchunks);
+   if(nch > nrec) nch = nrec;
+   if(nch == 0) nch = 1;
+   for(size_t i=0; i<nch; i++) {
+      size_t first(i*nrec/nch), last((i+1)*nrec/nch);
+      shared_ptr<ObsChunk> chunk(new ObsChunk);
+      chunk->offset = (nrec > 0 ? recpos[first] : pos);
+      chunk->lineNumber = (nrec > 0 ? recline[first] : line);
+      chunk->nrecs = (i == nch-1 ? -1 : int(last-first));
+      chunks.push_back(chunk);
+   }
+}
+
+//------------------------------------------------------------------------------------
+// Parse the records of one chunk, using a stream of its own, exactly as the
+// serial loop in loadFiles() would read them.
+// param[in] filename RINEX 3 obs file name
+// param[in] roh the header already read from the file
+// param[in] ts the time system of the file, as set when reading the header
+// param[in,out] chunk to be read
+static void readChunk(const string& filename, const Rinex3ObsHeader& roh,
+                      const TimeSystem& ts, ObsChunk& chunk)
+{
+   Rinex3ObsStream strm(filename.c_str());
+   if(!strm.is_open()) {
+      chunk.errmsg = string("could not reopen file");
+      return;
+   }
+   strm.exceptions(fstream::failbit);
+   strm.header = roh;
+   strm.headerRead = true;
+   strm.timesystem = ts;
+   strm.memoryMapped = true;
+   strm.seekg(chunk.offset);
+   strm.lineNumber = chunk.lineNumber;
+
+   Rinex3ObsData rod;
+   for(int n=0; chunk.nrecs < 0 || n < chunk.nrecs; n++) {
+      try {
+         strm >> rod;
+      }
+      catch(Exception& e) {
+         chunk.errmsg = e.getText(0);
+         break;
+      }
+      if(strm.eof() || !strm.good()) break;
+      chunk.data.push_back(rod);
+   }
+   strm.close();
+}
+
+//------------------------------------------------------------------------------------
+// Get the next record parsed by the thread pool, in file order, waiting for the
+// chunk to be finished if necessary; memory is released as chunks are used up.
+// return false at the end of the data, and then errmsg is set if a chunk failed
+static bool nextChunkRecord(vector< shared_ptr<ObsChunk> >& chunks,
+                            vector< future<void> >& futures,
+                            size_t& ichunk, size_t& irec,
+                            Rinex3ObsData& rod, string& errmsg)
+{
+   while(ichunk < chunks.size()) {
+      if(irec == 0) futures[ichunk].get();            // rethrows std exceptions
+      ObsChunk& chunk(*chunks[ichunk]);
+      if(irec < chunk.data.size()) {
+         rod = chunk.data[irec++];
+         return true;
+      }
+      vector<Rinex3ObsData>().swap(chunk.data);
+      if(!chunk.errmsg.empty()) {
+         errmsg = chunk.errmsg;
+         return false;
+      }
+      ichunk++;
+      irec = 0;
+   }
+   return false;
+}
+
 //------------------------------------------------------------------------------------
 // Read the files already defined
 // param[out] errmsg an error/warning message, blank for success
@@ -97,6 +229,10 @@ try {
    // setTimeSystem sets the method for internal variable m_timeSystem
    prevtime.setTimeSystem(TimeSystem::Any);
 
+   // threads for parsing RINEX 3 data records, cf. setThreads()
+   unique_ptr<ThreadPool> pool;
+   if(nthreads != 1) pool.reset(new ThreadPool(nthreads > 0 ? nthreads : 0));
+
    // read the files
    // initialize number read counter to zero
    int nread(0);
@@ -206,18 +342,51 @@ try {
             break;
          }
 
+         // start parsing the data in parallel --------------------
+         // the chunks are consumed in order by the epoch loop below
+         vector< shared_ptr<ObsChunk> > chunks;
+         vector< future<void> > futures;
+         size_t ichunk(0), irec(0);
+         string chunkerr;
+         // compressed files can only be decoded serially
+         if(pool && roh.version >= 3 && !strm.isCompressed()) {
+            try {
+               MappedFile mf(filename);
+               findChunks(mf, static_cast<size_t>(strm.tellg()), strm.lineNumber,
+                          4*pool->size(), chunks);
+            }
+            catch(Exception&) { chunks.clear(); }      // read serially instead
+
+            for(i=0; i<chunks.size(); i++) {
+               shared_ptr<ObsChunk> chunk(chunks[i]);
+               TimeSystem ts(strm.timesystem);
+               futures.push_back(pool->submit([filename, roh, ts, chunk]()
+                                       { readChunk(filename, roh, ts, *chunk); }));
+            }
+         }
+
          // loop over epochs --------------------------------------
          // while(1) always true, so only breaks out of loop with a break statement
          while(1) {
-            try {
-               strm >> rod;
-               rod.time.setTimeSystem(TimeSystem::Any);
+            if(chunks.size() > 0) {
+               if(!nextChunkRecord(chunks, futures, ichunk, irec, rod, chunkerr)) {
+                  if(!chunkerr.empty())
+                     oss << "Error - failed to read data in file " << filename
+                        << " with exception " << chunkerr << endl;
+                  break;
+               }
             }
-            catch(Exception& e) {
-               oss << "Error - failed to read data in file " << filename
-                  << " with exception " << e.getText(0) << endl;
-               break;
+            else {
+               try {
+                  strm >> rod;
+               }
+               catch(Exception& e) {
+                  oss << "Error - failed to read data in file " << filename
+                     << " with exception " << e.getText(0) << endl;
+                  break;
+               }
             }
+            rod.time.setTimeSystem(TimeSystem::Any);
 
             // EOF or error
             if(strm.eof() || !strm.good()) break;
@@ -84,6 +84,7 @@ private:
    std::vector<std::string> filenames;    ///< input RINEX obs file names
    int nepochsToRead;                     ///< number of epochs to read (default:all)
    bool saveData;                         ///< if true save the data (F)
+   int nthreads;                          ///< threads parsing RINEX 3 data (1)
    std::string timefmt;                   ///< format for time tags in output
    // editing
    double dtdec;                          ///< decimate to this time step
@@ -128,6 +129,7 @@ private:
    {
       saveData = false;
       nepochsToRead = -1;
+      nthreads = 1;
       timefmt = std::string("%04Y/%02m/%02d %02H:%02M:%02S");
       reset();
    }
@@ -251,6 +253,18 @@ public:
    /// @param[in] format (cf. gpstk::Epoch::printf) for time output in dumps
    inline void setTimeFormat(std::string fmt) { timefmt = fmt; }
 
+   /// set the number of threads used to parse the data records of RINEX 3 files.
+   /// With more than one thread, each file is split at epoch boundaries into
+   /// chunks that are parsed concurrently (memory-mapped), then selected, counted
+   /// and saved in file order, so the output is identical to a serial load.
+   /// NB the whole file is parsed even if nEpochsToRead() or setStopTime() would
+   /// end the load early. RINEX 2 files are always read serially.
+   /// @param[in] n number of threads; 1 (default) for serial, <=0 for one per core
+   inline void setThreads(int n) { nthreads = n; }
+   /// access the number of threads
+   /// @return number of threads set by setThreads()
+   inline int getThreads(void) const { return nthreads; }
+
    /// satellites to be excluded; this may be SatID = (-1, system);
    /// @param[in] sat satellite to be excluded [do not exclude system this way]
    inline void excludeSat(SatID sat) { exSats.push_back(sat); }
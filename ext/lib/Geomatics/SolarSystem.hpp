@@ -178,19 +178,18 @@ public:
    int initializeWithBinaryFile(std::string filename)
    {
       int iret = SolarSystemEphemeris::initializeWithBinaryFile(filename);
+      checkConvention();
+      return iret;
+   }
 
-      // if not defined, set IERS convention to the default; otherwise test it.
-      if(iersconv == IERSConvention::Unknown) {
-         if(EphNumber() == 403)
-            iersconv = IERSConvention::IERS1996;
-         else if(EphNumber() == 405)
-            iersconv = IERSConvention::IERS2010;         // the default
-         else
-            LOG(ERROR) << "Unknown ephemeris number " << EphNumber();
-      }
-      else
-         testIERSvsEphemeris(iersconv, EphNumber());
-
+   /// Overloaded function to map the ephemeris file into memory, with the same
+   /// check of the IERS convention as initializeWithBinaryFile().
+   /// Cf. SolarSystemEphemeris::initializeWithMappedFile(std::string filename).
+   /// @throw Exception
+   int initializeWithMappedFile(std::string filename)
+   {
+      int iret = SolarSystemEphemeris::initializeWithMappedFile(filename);
+      checkConvention();
       return iret;
    }
 
@@ -406,6 +405,23 @@ private:
          }
    }
 
+   /// Set the IERS convention from the ephemeris number if it is not yet defined;
+   /// otherwise test it against the ephemeris and warn if they are inconsistent.
+   void checkConvention(void)
+   {
+      // if not defined, set IERS convention to the default; otherwise test it.
+      if(iersconv == IERSConvention::Unknown) {
+         if(EphNumber() == 403)
+            iersconv = IERSConvention::IERS1996;
+         else if(EphNumber() == 405)
+            iersconv = IERSConvention::IERS2010;         // the default
+         else
+            LOG(ERROR) << "Unknown ephemeris number " << EphNumber();
+      }
+      else
+         testIERSvsEphemeris(iersconv, EphNumber());
+   }
+
 }; // end class SolarSystem
 
 }  // end namespace gpstk
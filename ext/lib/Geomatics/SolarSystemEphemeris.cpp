@@ -656,6 +656,7 @@ try {
    //cout << "Reporting in SolarSystemEphemeris is "
    //   << ConfigureLOG::ToString(ConfigureLOG::ReportingLevel()) << endl;
 
+   mapped.close();
    readBinaryHeader(filename);
    iret = readBinaryData(false);    // false: don't store data in map
    if(iret == 0) {
@@ -674,6 +675,62 @@ catch(exception& e) { Exception E("std except: "+string(e.what())); GPSTK_THROW(
 catch(...) { Exception e("Unknown exception"); GPSTK_THROW(e); }
 }
 
+//------------------------------------------------------------------------------------
+int SolarSystemEphemeris::initializeWithMappedFile(string filename)
+{
+try {
+   int i;
+
+   // read the header with the stream, note where the data begins, and release it
+   mapped.close();
+   fileposMap.clear();
+   coefficients.clear();
+   readBinaryHeader(filename);
+   long headerSize = istrm.tellg();
+   istrm.clear();
+   istrm.close();
+   if(EphemerisNumber == -1) return -4;
+
+   // map the file; records are Ncoeff doubles, starting right after the header
+   mapped.open(filename);
+   long recSize = Ncoeff*sizeof(double);
+   if(Ncoeff < 2 || headerSize < 0 || headerSize % sizeof(double) != 0
+         || long(mapped.size()) < headerSize + recSize) {
+      mapped.close();
+      Exception e("No data records found in binary file " + filename);
+      GPSTK_THROW(e);
+   }
+   mappedData = reinterpret_cast<const double *>(mapped.data() + headerSize);
+   mappedRecords = (long(mapped.size()) - headerSize)/recSize;
+   mappedStartJD = mappedData[0];
+   mappedSpan = mappedData[1] - mappedData[0];
+
+   // records must be contiguous and of equal span for the offset computation
+   for(i=1; i<mappedRecords; i++) {
+      const double *prev = mappedData + (i-1)*Ncoeff;
+      const double *rec = mappedData + i*Ncoeff;
+      if(rec[0] != prev[1] || rec[1]-rec[0] != mappedSpan) {
+         ostringstream oss;
+         oss << "ERROR: found gap or irregular record in data at " << i+1
+            << fixed << setprecision(6) << " : prev end = " << prev[1]
+            << ", new beg = " << rec[0] << ", new end = " << rec[1];
+         mapped.close();
+         Exception e(oss.str());
+         GPSTK_THROW(e);
+      }
+   }
+
+   EphemerisNumber = int(constants["DENUM"]);
+   LOG(DEBUG) << "initialize mapped " << mappedRecords << " records, sets"
+      << " EphemerisNumber " << EphemerisNumber;
+
+   return 0;
+}
+catch(Exception& e) { GPSTK_RETHROW(e); }
+catch(exception& e) { Exception E("std except: "+string(e.what())); GPSTK_THROW(E); }
+catch(...) { Exception e("Unknown exception"); GPSTK_THROW(e); }
+}
+
 //------------------------------------------------------------------------------------
 // get an inertial position of one body relative to another.
 void SolarSystemEphemeris::RelativeInertialPositionVelocity(const double MJD,
@@ -690,6 +747,13 @@ try {
    // trivial; return
    if(target == center) return;
 
+   // mapped file: use the const computation
+   if(isMapped()) {
+      static_cast<const SolarSystemEphemeris&>(*this).
+         RelativeInertialPositionVelocity(MJD, target, center, pv, kilometers);
+      return;
+   }
+
    // get the right record from the file
    double JD(MJD + MJD_TO_JD);
    iret = seekToJD(JD);
@@ -718,9 +782,53 @@ try {
       }
    }
 
+   RelativePositionVelocity(MJD, target, center, &coefficients[0], pv, kilometers);
+}
+catch(Exception& e) { GPSTK_RETHROW(e); }
+catch(exception& e) { Exception E("std except: "+string(e.what())); GPSTK_THROW(E); }
+catch(...) { Exception e("Unknown exception"); GPSTK_THROW(e); }
+}
+
+//------------------------------------------------------------------------------------
+// get an inertial position of one body relative to another, from the mapped file.
+void SolarSystemEphemeris::RelativeInertialPositionVelocity(const double MJD,
+                                                SolarSystemEphemeris::Planet target,
+                                                SolarSystemEphemeris::Planet center,
+                                                double pv[6], bool kilometers) const
+{
+try {
+   for(int i=0; i<6; i++) pv[i] = 0.0;
+   if(target == center) return;
+
+   if(!isMapped()) {
+      Exception e(string("Ephemeris not initialized with a mapped file"));
+      GPSTK_THROW(e);
+   }
+
+   const double *coef = mappedRecord(MJD + MJD_TO_JD);
+   RelativePositionVelocity(MJD, target, center, coef, pv, kilometers);
+}
+catch(Exception& e) { GPSTK_RETHROW(e); }
+catch(exception& e) { Exception E("std except: "+string(e.what())); GPSTK_THROW(E); }
+catch(...) { Exception e("Unknown exception"); GPSTK_THROW(e); }
+}
+
+//------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------
+// private
+void SolarSystemEphemeris::RelativePositionVelocity(const double MJD,
+                                                SolarSystemEphemeris::Planet target,
+                                                SolarSystemEphemeris::Planet center,
+                                                const double *coef, double pv[6],
+                                                bool kilometers) const
+{
+try {
+   int i;
+
    // compute Nutations or Librations
    if(target == idNutations || target == idLibrations) {
-      InertialPositionVelocity(MJD, target==idNutations ? NUTATIONS : LIBRATIONS, pv);
+      InertialPositionVelocity(MJD, target==idNutations ? NUTATIONS : LIBRATIONS,
+                               coef, pv);
       return;
    }
 
@@ -744,18 +852,18 @@ try {
 
    // special cases of Earth OR Moon, but not both:
    if((target==idEarth && center!=idMoon) || (center==idEarth && target!=idMoon)) {
-      Eratio = 1.0/(1.0 + constants["EMRAT"]);
-      InertialPositionVelocity(MJD, MOON, pvmoon);
+      Eratio = 1.0/(1.0 + constEMRAT);
+      InertialPositionVelocity(MJD, MOON, coef, pvmoon);
    }
    if((target==idMoon && center!=idEarth) || (center==idMoon && target!=idEarth)) {
-      Mratio = constants["EMRAT"]/(1.0 + constants["EMRAT"]);
-      InertialPositionVelocity(MJD, EMBARY, pvembary);
+      Mratio = constEMRAT/(1.0 + constEMRAT);
+      InertialPositionVelocity(MJD, EMBARY, coef, pvembary);
    }
 
    // compute states for target and center
    double pvtarget[6],pvcenter[6];
-   InertialPositionVelocity(MJD, TARGET, pvtarget);
-   InertialPositionVelocity(MJD, CENTER, pvcenter);
+   InertialPositionVelocity(MJD, TARGET, coef, pvtarget);
+   InertialPositionVelocity(MJD, CENTER, coef, pvcenter);
 
    // handle the Earth/Moon special cases
    // convert from E-M barycenter to Earth
@@ -773,8 +881,7 @@ try {
    for(i=0; i<6; i++) pv[i] = pvtarget[i] - pvcenter[i];
    
    if(!kilometers) {
-      double AU = constants["AU"];
-      for(i=0; i<6; i++) pv[i] /= AU;
+      for(i=0; i<6; i++) pv[i] /= constAU;
    }
 }
 catch(Exception& e) { GPSTK_RETHROW(e); }
@@ -938,6 +1045,10 @@ try {
    for(i=0; i < (400-Nconst)*sizeof(double); i++)
       readBinary(buffer,1);
 
+   // keep copies of the constants used in the computation
+   constAU = constants["AU"];
+   constEMRAT = constants["EMRAT"];
+
    // ----------------------------------------------------------------
    // test the header
    if(denum == constants["DENUM"]) {
@@ -1087,10 +1198,41 @@ catch(exception& e) { Exception E("std except: "+string(e.what())); GPSTK_THROW(
 catch(...) { Exception e("Unknown exception"); GPSTK_THROW(e); }
 }
 
+//------------------------------------------------------------------------------------
+// private
+const double *SolarSystemEphemeris::mappedRecord(double JD) const
+{
+try {
+   if(!isMapped() || mappedRecords <= 0) {
+      Exception e(string("Ephemeris not initialized with a mapped file"));
+      GPSTK_THROW(e);
+   }
+
+   if(JD < mappedStartJD || JD > mappedData[(mappedRecords-1)*Ncoeff+1]) {
+      Exception e(string("Requested time is ")
+               + (JD < mappedStartJD ? string("before") : string("after"))
+               + string(" the range spanned by the ephemeris."));
+      GPSTK_THROW(e);
+   }
+
+   // compute the index, then allow for roundoff at the record boundaries
+   long n = long((JD - mappedStartJD)/mappedSpan);
+   if(n >= mappedRecords) n = mappedRecords-1;
+   if(n > 0 && JD < mappedData[n*Ncoeff]) n--;
+   if(n < mappedRecords-1 && JD > mappedData[n*Ncoeff+1]) n++;
+
+   return mappedData + n*Ncoeff;
+}
+catch(Exception& e) { GPSTK_RETHROW(e); }
+catch(exception& e) { Exception E("std except: "+string(e.what())); GPSTK_THROW(E); }
+catch(...) { Exception e("Unknown exception"); GPSTK_THROW(e); }
+}
+
 //------------------------------------------------------------------------------------
 // private
 void SolarSystemEphemeris::InertialPositionVelocity(const double MJD,
-                                  SolarSystemEphemeris::computeID which, double PV[6])
+                                  SolarSystemEphemeris::computeID which,
+                                  const double *coef, double PV[6]) const
 {
 try {
    int i,j,i0,ncomp,offset;
@@ -1098,11 +1240,11 @@ try {
    for(i=0; i<6; i++) PV[i]=0.0;
    if(which == NONE) return;
 
-   // coefficients[0,1] give span of JD's in which coefficients[2,...] are applicable
-   // coefficients[0,1] are even days JDs - 2452xxx.5 => secOfDay() for these == 0.
+   // coef[0,1] give span of JD's in which coef[2,...] are applicable
+   // coef[0,1] are even days JDs - 2452xxx.5 => secOfDay() for these == 0.
    double T,Tbeg,Tspan,Tspan0;
-   Tbeg = coefficients[0];
-   Tspan0 = Tspan = coefficients[1] - coefficients[0];
+   Tbeg = coef[0];
+   Tspan0 = Tspan = coef[1] - coef[0];
    i0 = c_offset[which]-1;                      // index of first coefficient in array
    ncomp = (which == NUTATIONS ? 2 : 3);        // number of components returned
 
@@ -1110,7 +1252,7 @@ try {
    if(c_nsets[which] > 1) {
       Tspan /= double(c_nsets[which]);
       for(j=c_nsets[which]; j>0; j--) {
-         Tbeg = coefficients[0] + double(j-1)*Tspan;
+         Tbeg = coef[0] + double(j-1)*Tspan;
          if(MJD > Tbeg-MJD_TO_JD) {    // == with j==1 is the default
             i0 += (j-1)*ncomp*c_ncoeff[which];
             break;
@@ -1140,9 +1282,9 @@ try {
       // compute P and V
       // done above PV[i] = PV[i+3] = 0.0;
       for(j=N-1; j>-1; j--)                              // POS
-         PV[i] += coefficients[i0+j+i*N] * C[j];
+         PV[i] += coef[i0+j+i*N] * C[j];
       for(j=N-1; j>0; j--) // j>0 b/c U[0]=0             // VEL
-         PV[i+ncomp] += coefficients[i0+j+i*N] * U[j];
+         PV[i+ncomp] += coef[i0+j+i*N] * U[j];
 
       // convert velocity to 'per day'
       PV[i+ncomp] *= 2*double(c_nsets[which])/Tspan0;
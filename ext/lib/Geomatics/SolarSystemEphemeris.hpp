@@ -60,6 +60,7 @@
 // GPSTk
 #include "Exception.hpp"
 #include "TimeConstants.hpp"
+#include "MappedFile.hpp"
 
 namespace gpstk {
 
@@ -87,6 +88,9 @@ namespace gpstk {
 /// once, passing it the name of the binary file, then calling
 /// RelativeInertialPositionVelocity() any number of times, passing it the time and
 /// Planet of interest.
+/// Alternatively initializeWithMappedFile(file) maps the binary file into memory;
+/// then the const RelativeInertialPositionVelocity() may be called from many
+/// threads at once, e.g. for Sun and Moon positions in tide and attitude models.
 /// Time for this class is always Barycentric Dynamic Time (TDB), always as MJD.
 class SolarSystemEphemeris {
 public:
@@ -113,7 +117,8 @@ public:
 
    /// Constructor. Set EphemerisNumber to -1 to indicate that nothing has been
    /// read yet.
-   SolarSystemEphemeris(void) throw() : EphemerisNumber(-1) {};
+   SolarSystemEphemeris(void) throw()
+      : EphemerisNumber(-1), mappedData(0), mappedRecords(0) {};
 
    //------------------------------------------------------------------
    // reading and writing ASCII (JPL) files
@@ -200,6 +205,22 @@ public:
    /// @throw Exception if a gap in time is found between consecutive records.
    int initializeWithBinaryFile(std::string filename);
 
+   /// Map the given binary file into memory, read the header and prepare for
+   /// computing positions and velocities directly from the mapped data records.
+   /// The records are found by computed offset rather than through a stream, so
+   /// nothing is modified during evaluation and the const version of
+   /// RelativeInertialPositionVelocity() may be called by many threads at once.
+   /// @param filename  name of binary file to be mapped.
+   /// @return 0 success,
+   ///        -4 header could not be read.
+   /// @throw Exception if the file cannot be mapped or contains no data records,
+   ///        or if a gap in time or a change of record span is found.
+   int initializeWithMappedFile(std::string filename);
+
+   /// @return true if the object was initialized with initializeWithMappedFile().
+   bool isMapped(void) const throw()
+      { return mapped.isOpen(); }
+
    //------------------------------------------------------------------
    // utilizing the ephemeris
 
@@ -234,6 +255,15 @@ public:
    void RelativeInertialPositionVelocity(const double MJD,
                                          Planet target, Planet center, double PV[6], bool kilometers = true);
 
+   /// Const version of RelativeInertialPositionVelocity(), which computes from
+   /// the mapped file and therefore is safe to call concurrently; see
+   /// initializeWithMappedFile(). Parameters are the same as the non-const
+   /// version, which forwards to this one when the file is mapped.
+   /// @throw Exception if the ephemeris was not initialized with
+   /// initializeWithMappedFile(), or if the time is outside the ephemeris.
+   void RelativeInertialPositionVelocity(const double MJD,
+                                         Planet target, Planet center, double PV[6], bool kilometers = true) const;
+
    /// Return the value of 1 AU (Astronomical Unit) in km. If the file header has not
    /// been read, return -1.0.
    /// @return the value of 1 AU in km;
@@ -326,6 +356,14 @@ private:
    /// -3 or -4 => initializeWithBinaryFile() has not been called, or reading failed.
    int seekToJD(double JD);
 
+   /// Find the mapped data record whose time limits include the given time.
+   /// The record index is computed from the start time and span of the records,
+   /// which initializeWithMappedFile() has verified to be regular.
+   /// @param JD the time (Julian Date) of interest
+   /// @return pointer to the Ncoeff doubles of the record
+   /// @throw Exception if the time is outside the range of the records.
+   const double *mappedRecord(double JD) const;
+
    //------------------------------------------------------------------
    // define here for use in next function
    /// These are indexes used in the actual computation, and correspond to indexes
@@ -350,8 +388,7 @@ private:
    };
 
    /// Compute inertial position and velocity of given body at given time, relative
-   /// to the solar system barycenter, using the current coefficient array.
-   /// NB caller MUST call seekToJD(time) BEFORE calling this.
+   /// to the solar system barycenter, using the given coefficient record.
    /// On successful return, PV[0-2] contains the three position components, in km,
    /// and PV[3-5] the velocity components in km/day (for regular bodies), relative
    /// to the solar system barycenter, except for the moon, which is relative to
@@ -360,9 +397,18 @@ private:
    /// are the three euler angles.
    /// @param  MJD    time (Modified Julian Date) of interest (system TDB).
    /// @param  which  computeID of the body of interest.
+   /// @param  coef   data record (Ncoeff doubles) containing MJD, e.g. coefficients
+   ///                 after seekToJD(), or the result of mappedRecord().
    /// @param  PV     double(6) array containing the inertial position and velocity
    ///                 relative to the solar system barycenter.
-   void InertialPositionVelocity(const double MJD, computeID which, double PV[6]);
+   void InertialPositionVelocity(const double MJD, computeID which,
+                                 const double *coef, double PV[6]) const;
+
+   /// Compute the relative position and velocity of target and center, as in
+   /// RelativeInertialPositionVelocity(), using the given data record.
+   void RelativePositionVelocity(const double MJD, Planet target, Planet center,
+                                 const double *coef, double pv[6],
+                                 bool kilometers) const;
 
    //------------------------------------------------------------------
    // member data
@@ -391,6 +437,8 @@ private:
    int c_offset[13];     ///< starting index in the coefficients array for each planet
    int c_ncoeff[13];     ///< number of coefficients per component for each planet
    int c_nsets[13];      ///< number of sets of coefficients for each planet
+   double constAU;       ///< constants["AU"], copied for use in const functions
+   double constEMRAT;    ///< constants["EMRAT"], copied for use in const functions
 
    /// Hash of labels and values of constants read from the header.
    /// This is taken directly from the JPL documentation:
@@ -436,6 +484,14 @@ private:
    /// uses it.
    std::vector<double> coefficients;
 
+   /// The binary file mapped by initializeWithMappedFile(); not open otherwise.
+   MappedFile mapped;
+
+   const double *mappedData;  ///< first data record in the mapped file
+   long mappedRecords;        ///< number of data records in the mapped file
+   double mappedStartJD;      ///< JD of the start of the first mapped record
+   double mappedSpan;         ///< number of days covered by each mapped record
+
 }; // end class SolarSystemEphemeris
 
 }  // end namespace gpstk
@@ -591,27 +591,20 @@ namespace gpstk
    }  // end computeSolidEarthTides()
 
    //---------------------------------------------------------------------------------
-   /// Compute the site displacement due to rotational deformation due to polar motion
-   /// for the given Position (assumed to fixed to the solid Earth) at the given time,
-   /// given the polar motion angles at time (cf.EarthOrientation).
-   /// Return a Triple containing the site displacement in WGS84 ECEF XYZ coordinates
-   /// with units meters.
-   /// Reference (1996) IERS Technical Note 21 (IERS), ch. 7 page 67.
-   /// Reference (2003) IERS Technical Note 32 (IERS), ch. 7 page 83-84.
-   /// Reference (2010) IERS Technical Note 36 (IERS), ch. 7 page 114-116.
-   /// param site                Nominal position of the site of interest.
-   /// param ttag                Time of interest.
-   /// param iers IERSConvention IERS convention to use
-   /// param xp double           Polar motion angle in arcsec (cf. EarthOrientation)
-   /// param yp double           Polar motion angle in arcsec (cf. EarthOrientation)
-   /// return disp Triple disp   Displacement vector, ECEF XYZ meters.
-   Triple computePolarTides(const Position site, const EphTime ttag,
-                            const double xp, const double yp,
-                            const IERSConvention iers)
+   // Compute the wobble variables m1, m2 (arcsec) of the pole tide, i.e. the polar
+   // motion less the mean pole of the IERS convention, and the coefficient of the
+   // radial displacement; the part of computePolarTides() that depends only on time.
+   // param ttag                Time of interest.
+   // param xp,yp double        Polar motion angles in arcsec (cf. EarthOrientation)
+   // param iers IERSConvention IERS convention to use
+   // param m1,m2 double        Output wobble variables in arcsec
+   // param upcoef double       Output coefficient of the Up component
+   void computePolarTideWobble(const EphTime ttag,
+                               const double xp, const double yp,
+                               const IERSConvention iers,
+                               double& m1, double& m2, double& upcoef)
    {
    try {
-      double m1, m2, upcoef;
-
       if(iers == IERSConvention::IERS1996) {    // 1996
          m1 = xp;                   // arcsec
          m2 = yp;                   // arcsec
@@ -645,6 +638,32 @@ namespace gpstk
          m1 = (xp - xmean);          // arcsec
          m2 = -(yp - ymean);         // arcsec
       }
+   }
+   catch(Exception& e) { GPSTK_RETHROW(e); }
+   }
+
+   //---------------------------------------------------------------------------------
+   /// Compute the site displacement due to rotational deformation due to polar motion
+   /// for the given Position (assumed to fixed to the solid Earth) at the given time,
+   /// given the polar motion angles at time (cf.EarthOrientation).
+   /// Return a Triple containing the site displacement in WGS84 ECEF XYZ coordinates
+   /// with units meters.
+   /// Reference (1996) IERS Technical Note 21 (IERS), ch. 7 page 67.
+   /// Reference (2003) IERS Technical Note 32 (IERS), ch. 7 page 83-84.
+   /// Reference (2010) IERS Technical Note 36 (IERS), ch. 7 page 114-116.
+   /// param site                Nominal position of the site of interest.
+   /// param ttag                Time of interest.
+   /// param iers IERSConvention IERS convention to use
+   /// param xp double           Polar motion angle in arcsec (cf. EarthOrientation)
+   /// param yp double           Polar motion angle in arcsec (cf. EarthOrientation)
+   /// return disp Triple disp   Displacement vector, ECEF XYZ meters.
+   Triple computePolarTides(const Position site, const EphTime ttag,
+                            const double xp, const double yp,
+                            const IERSConvention iers)
+   {
+   try {
+      double m1, m2, upcoef;
+      computePolarTideWobble(ttag, xp, yp, iers, m1, m2, upcoef);
       LOG(DEBUG7) << " poletide means " << iers
          << fixed << setprecision(15) << " " << m1 << " " << m2;
 
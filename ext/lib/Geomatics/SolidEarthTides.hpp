@@ -108,6 +108,25 @@ namespace gpstk
                             const double xp, const double yp,
                             const IERSConvention iers=IERSConvention::IERS2010);
 
+   //---------------------------------------------------------------------------------
+   /// Compute the wobble variables m1, m2 of the pole tide, i.e. the polar motion
+   /// less the mean pole of the given IERS convention, and the coefficient of the
+   /// Up component. These depend only on time; the pole tide displacement in NEU is
+   /// (0.009*cos(2*theta)*(m1*coslon + m2*sinlon),
+   ///  0.009*cos(theta)*(m1*sinlon - m2*coslon),
+   ///  -upcoef*sin(2*theta)*(m1*coslon + m2*sinlon)),
+   /// where theta is the geocentric colatitude; cf. computePolarTides().
+   /// @param EphTime time   Time of interest.
+   /// @param double xp,yp   Polar motion angles in arcsec (cf. EarthOrientation)
+   /// @param IERSConvention IERS convention to use
+   /// @param double m1,m2   Output wobble variables in arcsec
+   /// @param double upcoef  Output coefficient of the Up component
+   /// @throw Exception
+   void computePolarTideWobble(const EphTime time,
+                               const double xp, const double yp,
+                               const IERSConvention iers,
+                               double& m1, double& m2, double& upcoef);
+
 }  // end namespace gpstk
 
 #endif // SOLID_EARTH_TIDES_INCLUDE
@@ -0,0 +1,171 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/// @file NEDUtil_T.cpp  Test that the array overload of
+/// NEDUtil::convertToNED agrees with the Triple overload.
+
+#include <iostream>
+#include <cmath>
+#include <vector>
+
+#include "NEDUtil.hpp"
+#include "TestUtil.hpp"
+
+using namespace std;
+using namespace gpstk;
+
+class NEDUtil_T
+{
+public:
+   NEDUtil_T();
+   /// Convert the test vectors as an array and one Triple at a time
+   unsigned batchTest();
+   /// Convert the test vectors with the output array the same as the input
+   unsigned inPlaceTest();
+
+private:
+   /// Reference latitudes and longitudes (radians)
+   vector<double> refLat, refLon;
+   /// ECEF XYZ vectors to convert, as contiguous triples
+   vector<double> xyz;
+};
+
+
+NEDUtil_T ::
+NEDUtil_T()
+{
+   const double DEG = M_PI/180.0;
+      // equator, mid latitudes both hemispheres, near the poles
+   const double lat[] = {   0.0, 30.2, -33.9, 51.5, 89.9, -89.9 };
+   const double lon[] = {   0.0, -97.7, 151.2, -0.1, 45.0, -135.0 };
+   for(unsigned i=0; i<6; i++)
+   {
+      refLat.push_back(lat[i]*DEG);
+      refLon.push_back(lon[i]*DEG);
+   }
+      // station positions, satellite positions and line-of-sight vectors
+   const double v[] = {
+      -740289.9, -5457071.7,  3207245.6,
+      -4646510.0,  2553180.0, -3534370.0,
+      15524471.2, -16649826.2, 13512272.4,
+      -22679349.0,   2618561.5, 13450230.3,
+         1.0,         0.0,         0.0,
+         0.0,         0.0,        -1.0,
+      1234.5,     -6789.0,       42.0,
+         0.0,         0.0,         0.0 };
+   xyz.assign(v, v + sizeof(v)/sizeof(v[0]));
+}
+
+
+unsigned NEDUtil_T ::
+batchTest()
+{
+   TUDEF("NEDUtil", "convertToNED(const double*,double*,size_t)");
+
+   const size_t n = xyz.size()/3;
+   vector<double> ned(xyz.size());
+   for(size_t r=0; r<refLat.size(); r++)
+   {
+      NEDUtil util(refLat[r], refLon[r]);
+      util.convertToNED(&xyz[0], &ned[0], n);
+      for(size_t i=0; i<n; i++)
+      {
+         Triple exp = util.convertToNED(Triple(xyz[3*i], xyz[3*i+1],
+                                               xyz[3*i+2]));
+         for(size_t j=0; j<3; j++)
+            TUASSERTFEPS(exp[j], ned[3*i+j], 1.e-6);
+      }
+   }
+
+      // after moving the reference point
+   NEDUtil util(refLat[0], refLon[0]);
+   util.updatePosition(refLat[3], refLon[3]);
+   util.convertToNED(&xyz[0], &ned[0], n);
+   for(size_t i=0; i<n; i++)
+   {
+      Triple exp = util.convertToNED(Triple(xyz[3*i], xyz[3*i+1],
+                                            xyz[3*i+2]));
+      for(size_t j=0; j<3; j++)
+         TUASSERTFEPS(exp[j], ned[3*i+j], 1.e-6);
+   }
+
+      // no vectors leaves the output alone
+   ned.assign(ned.size(), -1.0);
+   util.convertToNED(&xyz[0], &ned[0], 0);
+   TUASSERTFE(-1.0, ned[0]);
+
+   TURETURN();
+}
+
+
+unsigned NEDUtil_T ::
+inPlaceTest()
+{
+   TUDEF("NEDUtil", "convertToNED(const double*,double*,size_t)");
+
+   const size_t n = xyz.size()/3;
+   for(size_t r=0; r<refLat.size(); r++)
+   {
+      NEDUtil util(refLat[r], refLon[r]);
+      vector<double> buf(xyz);
+      util.convertToNED(&buf[0], &buf[0], n);
+      for(size_t i=0; i<n; i++)
+      {
+         Triple exp = util.convertToNED(Triple(xyz[3*i], xyz[3*i+1],
+                                               xyz[3*i+2]));
+         for(size_t j=0; j<3; j++)
+            TUASSERTFEPS(exp[j], buf[3*i+j], 1.e-6);
+      }
+   }
+
+   TURETURN();
+}
+
+
+int main()
+{
+   unsigned errorTotal = 0;
+   NEDUtil_T testClass;
+
+   errorTotal += testClass.batchTest();
+   errorTotal += testClass.inPlaceTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal;
+}
@@ -0,0 +1,209 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+
+/// @file EarthRotationCache_T.cpp  Test that the interpolated ECEF-to-inertial
+/// transformation agrees with EarthOrientation to the requested accuracy.
+
+#include <iostream>
+#include <cmath>
+#include <string>
+
+#include "EarthRotationCache.hpp"
+#include "TestUtil.hpp"
+
+using namespace std;
+using namespace gpstk;
+
+class EarthRotationCache_T
+{
+public:
+   /// Compare with EarthOrientation::ECEFtoInertial for each convention
+   unsigned accuracyTest();
+   /// Check the per-epoch memo, the inverse, and the size of the cache
+   unsigned cacheTest();
+   /// Check the errors: conventions and accuracy
+   unsigned errorTest();
+
+private:
+   /// largest difference of the elements of M and R
+   static double maxDiff(const Matrix<double>& M,
+                         const EarthRotationCache::Rotation& R);
+};
+
+
+double EarthRotationCache_T ::
+maxDiff(const Matrix<double>& M, const EarthRotationCache::Rotation& R)
+{
+   double d(0.0);
+   for(int i=0; i<3; i++)
+      for(int j=0; j<3; j++)
+         d = max(d, ::fabs(M(i,j) - R(i,j)));
+   return d;
+}
+
+
+unsigned EarthRotationCache_T ::
+accuracyTest()
+{
+   TUDEF("EarthRotationCache", "ECEFtoInertial");
+   const IERSConvention convs[3] = { IERSConvention::IERS1996,
+                                     IERSConvention::IERS2003,
+                                     IERSConvention::IERS2010 };
+   const double accs[2] = { 1.e-9, 1.e-11 };
+
+   for(int c=0; c<3; c++) {
+      EarthOrientation eo;
+      eo.convention = convs[c];
+      eo.xp = 0.123;
+      eo.yp = 0.345;
+      eo.UT1mUTC = -0.2345;
+      for(int a=0; a<2; a++) {
+         EarthRotationCache erc(convs[c], accs[a]);
+         double worst(0.0), worstNPB(0.0);
+            // irregular epochs over 2000-2025, at irregular seconds of day
+         for(int n=0; n<150; n++) {
+            EphTime t(51544.0 + 9131.0*((n*7919)%1000)/1000.0 + n*0.0123,
+                      n%2 ? TimeSystem::UTC : TimeSystem::TT);
+            bool reduced(convs[c] == IERSConvention::IERS1996 && n%3 == 0);
+            worst = max(worst, maxDiff(eo.ECEFtoInertial(t, reduced),
+                                       erc.ECEFtoInertial(eo, t, reduced)));
+               // for 1996 and 2003 the NPB matrix is N*P; for 2010 it is
+               // based on the CIO and has no public equivalent
+            if(convs[c] != IERSConvention::IERS2010)
+               worstNPB = max(worstNPB, maxDiff(eo.NutationMatrix(t) *
+                                                eo.PrecessionMatrix(t),
+                                                erc.NPBMatrix(t)));
+         }
+         TUASSERT(worst < accs[a]);
+         TUASSERT(worstNPB < accs[a]);
+      }
+   }
+
+   TURETURN();
+}
+
+
+unsigned EarthRotationCache_T ::
+cacheTest()
+{
+   TUDEF("EarthRotationCache", "ECEFtoInertial");
+   EarthOrientation eo;
+   eo.convention = IERSConvention::IERS2010;
+   eo.xp = 0.05;
+   eo.yp = 0.4;
+   eo.UT1mUTC = 0.3;
+   EarthRotationCache erc(IERSConvention::IERS2010);
+   EphTime t(57000.25, TimeSystem::UTC);
+
+      // the same epoch and EOPs gives the same result
+   EarthRotationCache::Rotation R1 = erc.ECEFtoInertial(eo, t);
+   EarthRotationCache::Rotation R2 = erc.ECEFtoInertial(eo, t);
+   bool same(true);
+   for(int i=0; i<3; i++)
+      for(int j=0; j<3; j++)
+         if(R1(i,j) != R2(i,j)) same = false;
+   TUASSERT(same);
+
+      // new EOPs at the same epoch are not taken from the memo
+   EarthOrientation eo2(eo);
+   eo2.UT1mUTC += 0.001;
+   R2 = erc.ECEFtoInertial(eo2, t);
+   TUASSERT(maxDiff(eo2.ECEFtoInertial(t), R2) < 1.e-10);
+   TUASSERT(maxDiff(R1.asMatrix(), R2) > 1.e-9);
+
+      // inverse
+   TUCSM("InertialtoECEF");
+   EarthRotationCache::Rotation Ri = erc.InertialtoECEF(eo, t);
+   double v[3] = { 1000.0, -2000.0, 6000.0 }, w[3];
+   R1.rotate(v, w);
+   Ri.rotate(w, w);
+   TUASSERTFEPS(v[0], w[0], 1.e-6);
+   TUASSERTFEPS(v[1], w[1], 1.e-6);
+   TUASSERTFEPS(v[2], w[2], 1.e-6);
+
+      // a long arc does not grow the cache beyond its limit
+   TUCSM("size");
+   for(int n=0; n<4000; n++)
+      erc.NPBMatrix(EphTime(51544.0 + n*0.5, TimeSystem::TT));
+   TUASSERT(erc.size() <= EarthRotationCache::maxNodes);
+   TUASSERT(erc.size() > 0);
+   erc.clear();
+   TUASSERTE(unsigned, 0, erc.size());
+
+   TURETURN();
+}
+
+
+unsigned EarthRotationCache_T ::
+errorTest()
+{
+   TUDEF("EarthRotationCache", "EarthRotationCache");
+   TUTHROW(EarthRotationCache(IERSConvention::Unknown));
+   TUTHROW(EarthRotationCache(IERSConvention::IERS2010, 0.0));
+
+   TUCSM("setAccuracy");
+   EarthRotationCache erc(IERSConvention::IERS2003);
+   erc.setAccuracy(1.e-30);
+   TUASSERTE(double, EarthRotationCache::minStep, erc.gridStep());
+   erc.setAccuracy(1.0);
+   TUASSERTE(double, EarthRotationCache::maxStep, erc.gridStep());
+   TUTHROW(erc.setAccuracy(-1.0));
+
+   TUCSM("ECEFtoInertial");
+   EarthOrientation eo;
+   eo.convention = IERSConvention::IERS2010;
+   TUTHROW(erc.ECEFtoInertial(eo, EphTime(57000.0, TimeSystem::UTC)));
+
+   TURETURN();
+}
+
+
+int main()
+{
+   unsigned errorTotal = 0;
+   EarthRotationCache_T testClass;
+
+   errorTotal += testClass.accuracyTest();
+   errorTotal += testClass.cacheTest();
+   errorTotal += testClass.errorTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal;
+}
@@ -0,0 +1,335 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+
+/// @file NetworkTides_T.cpp  Test that the batch site displacements of
+/// NetworkTides agree with the single site functions.
+
+#include <iostream>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "NetworkTides.hpp"
+#include "SolidEarthTides.hpp"
+#include "SolarPosition.hpp"
+#include "SunEarthSatGeometry.hpp"
+#include "StringUtils.hpp"
+#include "build_config.h"
+#include "TestUtil.hpp"
+
+using namespace std;
+using namespace gpstk;
+
+class NetworkTides_T
+{
+public:
+   NetworkTides_T();
+
+   /// Compare solid Earth and pole tides with the single site functions
+   unsigned solidPoleTest();
+   /// Compare ocean and atmospheric loading with OceanLoadTides and AtmLoadTides
+   unsigned loadingTest();
+   /// Compare the threaded result with the serial one
+   unsigned threadTest();
+   /// Check the errors: missing stores and sites
+   unsigned errorTest();
+
+private:
+   /// largest difference of the displacement of site i at epoch j from d
+   static double maxDiff(const vector<double>& table, unsigned nepoch,
+                         unsigned i, unsigned j, const Triple& d);
+
+   /// rotate the NEU displacement d at pos to ECEF XYZ
+   static Triple toXYZ(Position pos, const Triple& d);
+
+   string dataPath;
+   vector<Position> positions;         ///< test sites
+   vector<NetworkTides::EpochData> epochs;
+};
+
+
+NetworkTides_T ::
+NetworkTides_T()
+{
+   dataPath = getPathData() + getFileSep();
+
+      // Onsala, Reykjavik, then the equator, the southern hemisphere and a pole
+   positions.push_back(Position(3370658.5419, 711877.1496, 5349786.9542));
+   positions.push_back(Position(2587384.0, -1043033.5, 5716564.1));
+   positions.push_back(Position(6378137.0, 0.0, 0.0));
+   positions.push_back(Position(-2353614.1, 4641385.4, -3676976.5));
+   positions.push_back(Position(10.0, -20.0, 6356752.3));
+
+      // irregular epochs over two days, with EOPs
+   double AR;
+   for(int n=0; n<40; n++) {
+      NetworkTides::EpochData ep;
+      ep.time = EphTime(55197.0 + n*0.0513 + 0.0001*((n*7919)%100),
+                        TimeSystem::UTC);
+      ep.Sun = SolarPosition(ep.time, AR);
+      ep.Moon = LunarPosition(ep.time, AR);
+      ep.xp = 0.05 + 0.001*n;
+      ep.yp = 0.30 - 0.002*n;
+      ep.UT1mUTC = 0.11 - 0.0003*n;
+      epochs.push_back(ep);
+   }
+}
+
+
+double NetworkTides_T ::
+maxDiff(const vector<double>& table, unsigned nepoch,
+        unsigned i, unsigned j, const Triple& d)
+{
+   double diff(0.0);
+   for(int k=0; k<3; k++)
+      diff = max(diff, ::fabs(table[(i*nepoch+j)*3+k] - d[k]));
+   return diff;
+}
+
+
+Triple NetworkTides_T ::
+toXYZ(Position pos, const Triple& d)
+{
+   Matrix<double> R(NorthEastUp(pos));
+   Triple xyz;
+   for(int k=0; k<3; k++)
+      xyz[k] = R(0,k)*d[0] + R(1,k)*d[1] + R(2,k)*d[2];
+   return xyz;
+}
+
+
+unsigned NetworkTides_T ::
+solidPoleTest()
+{
+   TUDEF("NetworkTides", "compute");
+   const IERSConvention convs[3] = { IERSConvention::IERS1996,
+                                     IERSConvention::IERS2003,
+                                     IERSConvention::IERS2010 };
+   const double EMRAT(81.300585), SERAT(332946.048630181234330);
+
+   for(int c=0; c<3; c++) {
+      NetworkTides nt(convs[c]);
+      nt.setMassRatios(EMRAT, SERAT);
+      for(unsigned i=0; i<positions.size(); i++)
+         TUASSERTE(unsigned, i, nt.addSite(StringUtils::asString(i), positions[i]));
+      nt.setEpochs(epochs);
+      TUASSERTE(unsigned, positions.size(), nt.numberOfSites());
+      TUASSERTE(unsigned, epochs.size(), nt.numberOfEpochs());
+
+      vector<double> solid, pole, both;
+      nt.compute(NetworkTides::SolidTide, solid);
+      nt.compute(NetworkTides::PoleTide, pole);
+      nt.compute(NetworkTides::SolidTide | NetworkTides::PoleTide, both);
+      TUASSERTE(size_t, 3*positions.size()*epochs.size(), solid.size());
+
+      double worstSolid(0.0), worstPole(0.0), worstBoth(0.0);
+      for(unsigned i=0; i<positions.size(); i++) {
+         for(unsigned j=0; j<epochs.size(); j++) {
+            const NetworkTides::EpochData& ep(epochs[j]);
+            Triple ds = computeSolidEarthTides(positions[i], ep.time, ep.Sun,
+                                               ep.Moon, EMRAT, SERAT, convs[c]);
+            Triple dp = computePolarTides(positions[i], ep.time, ep.xp, ep.yp,
+                                         convs[c]);
+            worstSolid = max(worstSolid, maxDiff(solid, epochs.size(), i, j, ds));
+            worstPole = max(worstPole, maxDiff(pole, epochs.size(), i, j, dp));
+            worstBoth = max(worstBoth, maxDiff(both, epochs.size(), i, j, ds+dp));
+         }
+      }
+      TUASSERT(worstSolid < 1.e-12);
+      TUASSERT(worstPole < 1.e-12);
+      TUASSERT(worstBoth < 1.e-12);
+   }
+
+      // setEpochs(times) uses SolarPosition.hpp and zero EOPs
+   TUCSM("setEpochs");
+   NetworkTides nt;
+   vector<EphTime> times;
+   for(unsigned j=0; j<epochs.size(); j++)
+      times.push_back(epochs[j].time);
+   nt.setEpochs(times);
+   TUASSERTE(unsigned, epochs.size(), nt.numberOfEpochs());
+   double worst(0.0);
+   for(unsigned j=0; j<epochs.size(); j++) {
+      const NetworkTides::EpochData& ep(nt.epochData(j));
+      worst = max(worst, range(ep.Sun, epochs[j].Sun));
+      worst = max(worst, range(ep.Moon, epochs[j].Moon));
+      worst = max(worst, ::fabs(ep.xp) + ::fabs(ep.yp) + ::fabs(ep.UT1mUTC));
+   }
+   TUASSERTE(double, 0.0, worst);
+
+   TURETURN();
+}
+
+
+unsigned NetworkTides_T ::
+loadingTest()
+{
+   TUDEF("NetworkTides", "compute");
+
+   OceanLoadTides olt;
+   vector<string> names;
+   names.push_back("ONSALA");
+   names.push_back("REYKJAVIK");
+   TUASSERTE(int, 2, olt.initializeSites(names, dataPath + "testocean.blq"));
+
+   AtmLoadTides atl;
+   names.clear();
+   names.push_back("onsa");
+   names.push_back("reyk");
+   TUASSERTE(int, 2, atl.initializeSites(names, dataPath + "testatm.atl"));
+
+   NetworkTides nt;
+   nt.addSite("ONSA", positions[0], "ONSALA", "onsa");
+   nt.addSite("REYK", positions[1], "REYKJAVIK", "reyk");
+   nt.setOceanLoading(olt);
+   nt.setAtmLoading(atl);
+   nt.setEpochs(epochs);
+
+   vector<double> ocean, atm, both;
+   nt.compute(NetworkTides::OceanLoading, ocean);
+   nt.compute(NetworkTides::AtmLoading, atm);
+   nt.compute(NetworkTides::OceanLoading | NetworkTides::AtmLoading, both);
+
+   const string oceanLabels[2] = { "ONSALA", "REYKJAVIK" };
+   const string atmLabels[2] = { "onsa", "reyk" };
+   double worstOcean(0.0), worstAtm(0.0), worstBoth(0.0), largest(0.0);
+   for(unsigned i=0; i<2; i++) {
+      for(unsigned j=0; j<epochs.size(); j++) {
+         const NetworkTides::EpochData& ep(epochs[j]);
+         Triple dOcean = toXYZ(positions[i],
+                               olt.computeDisplacement(oceanLabels[i], ep.time));
+         Triple dAtm = toXYZ(positions[i],
+                             atl.computeDisplacement(atmLabels[i], ep.time,
+                                                     ep.UT1mUTC));
+         largest = max(largest, dOcean.mag());
+         worstOcean = max(worstOcean, maxDiff(ocean, epochs.size(), i, j, dOcean));
+         worstAtm = max(worstAtm, maxDiff(atm, epochs.size(), i, j, dAtm));
+         worstBoth = max(worstBoth, maxDiff(both, epochs.size(), i, j,
+                                            dOcean+dAtm));
+      }
+   }
+      // the ocean admittances are computed at the middle epoch only
+   TUASSERT(largest > 1.e-3);
+   TUASSERT(worstOcean < 1.e-9);
+   TUASSERT(worstAtm < 1.e-12);
+   TUASSERT(worstBoth < 1.e-9);
+
+   TURETURN();
+}
+
+
+unsigned NetworkTides_T ::
+threadTest()
+{
+   TUDEF("NetworkTides", "compute");
+
+   OceanLoadTides olt;
+   vector<string> names(1, "ONSALA");
+   olt.initializeSites(names, dataPath + "testocean.blq");
+   AtmLoadTides atl;
+   names.assign(1, "onsa");
+   atl.initializeSites(names, dataPath + "testatm.atl");
+
+   NetworkTides nt;
+   for(unsigned i=0; i<positions.size(); i++)
+      nt.addSite(StringUtils::asString(i), positions[i], "ONSALA", "onsa");
+   nt.setOceanLoading(olt);
+   nt.setAtmLoading(atl);
+   nt.setEpochs(epochs);
+
+   vector<double> serial, threaded;
+   nt.compute(NetworkTides::AllTides, serial, 1);
+   const unsigned nthreads[3] = { 2, 3, 0 };
+   for(int n=0; n<3; n++) {
+      nt.compute(NetworkTides::AllTides, threaded, nthreads[n]);
+      TUASSERT(serial == threaded);
+   }
+
+   TURETURN();
+}
+
+
+unsigned NetworkTides_T ::
+errorTest()
+{
+   TUDEF("NetworkTides", "compute");
+
+   NetworkTides nt;
+   nt.addSite("ONSA", positions[0], "ONSALA", "onsa");
+   nt.setEpochs(epochs);
+   vector<double> table;
+   TUTHROW(nt.compute(NetworkTides::OceanLoading, table));
+   TUTHROW(nt.compute(NetworkTides::AtmLoading, table));
+
+      // stores without the site
+   OceanLoadTides olt;
+   vector<string> names(1, "REYKJAVIK");
+   olt.initializeSites(names, dataPath + "testocean.blq");
+   AtmLoadTides atl;
+   names.assign(1, "reyk");
+   atl.initializeSites(names, dataPath + "testatm.atl");
+   nt.setOceanLoading(olt);
+   nt.setAtmLoading(atl);
+   TUTHROW(nt.compute(NetworkTides::OceanLoading, table));
+   TUTHROW(nt.compute(NetworkTides::AtmLoading, table));
+
+      // no epochs is not an error
+   NetworkTides empty;
+   empty.addSite("ONSA", positions[0]);
+   empty.compute(NetworkTides::AllTides, table);
+   TUASSERTE(size_t, 0, table.size());
+
+   TURETURN();
+}
+
+
+int main()
+{
+   unsigned errorTotal = 0;
+   NetworkTides_T testClass;
+
+   errorTotal += testClass.solidPoleTest();
+   errorTotal += testClass.loadingTest();
+   errorTotal += testClass.threadTest();
+   errorTotal += testClass.errorTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal;
+}
@@ -0,0 +1,174 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+
+
+/// @file NutationSeries_T.cpp  Test the batch IERS nutation and XY series against
+/// SOFA, against the EarthOrientation_SOFA reference output, and against
+/// evaluation one epoch at a time.
+
+#include <iostream>
+#include <cmath>
+#include <vector>
+
+#include "NutationSeries.hpp"
+#include "TestUtil.hpp"
+
+using namespace std;
+using namespace gpstk;
+
+class NutationSeries_T
+{
+public:
+   /// Compare the sin/cos kernel with the math library
+   unsigned sinCosTest();
+   /// Compare with SOFA and with the reference output of test_EO_SOFA
+   unsigned sofaTest();
+   /// Compare a long arc of epochs with evaluation one epoch at a time
+   unsigned batchTest();
+};
+
+
+unsigned NutationSeries_T ::
+sinCosTest()
+{
+   TUDEF("NutationSeries", "SinCos");
+   const int n(100003);
+   vector<double> x(n),s(n),c(n);
+      // the arguments of the series are within a few hundred radians
+   for(int i=0; i<n; i++)
+      x[i] = -1000.0 + 2000.0*i/(n-1) + 1.e-7*(i%7);
+   NutationSeries::SinCos(&x[0], n, &s[0], &c[0]);
+
+   double es(0.0), ec(0.0);
+   for(int i=0; i<n; i++) {
+      es = max(es, ::fabs(s[i] - ::sin(x[i])));
+      ec = max(ec, ::fabs(c[i] - ::cos(x[i])));
+   }
+   TUASSERT(es < 5.e-16);
+   TUASSERT(ec < 5.e-16);
+
+   TURETURN();
+}
+
+
+unsigned NutationSeries_T ::
+sofaTest()
+{
+   TUDEF("NutationSeries", "NutationAngles2003");
+   double T, deps, dpsi, X, Y;
+
+      // SOFA test program t_sofa_c, 2400000.5+53736.0 TT, T = 0.06 exactly
+   T = 0.06;
+   NutationSeries::NutationAngles2003(&T, 1, &deps, &dpsi);
+   TUASSERTFEPS(dpsi, -0.9630909107115518431e-5, 1.e-15);     // iauNut00a
+   TUASSERTFEPS(deps,  0.4063239174001678710e-4, 1.e-15);
+
+   TUCSM("NutationAngles2010");
+   NutationSeries::NutationAngles2010(&T, 1, &deps, &dpsi);
+   TUASSERTFEPS(dpsi, -0.9630912025820308797e-5, 1.e-15);     // iauNut06a
+   TUASSERTFEPS(deps,  0.4063238496887249798e-4, 1.e-15);
+
+   TUCSM("XYCIO");
+   NutationSeries::XYCIO(&T, 1, &X, &Y);
+   TUASSERTFEPS(X, 0.5791308486706010975e-3, 1.e-15);          // iauXy06
+   TUASSERTFEPS(Y, 0.4020579816732958141e-4, 1.e-15);
+
+      // data/EarthOrientation_SOFA.exp, 2007/4/5 12h UTC, printed to 1.e-15
+   T = 0.072580445022435;
+   TUCSM("NutationAngles2003");
+   NutationSeries::NutationAngles2003(&T, 1, &deps, &dpsi);
+   TUASSERTFEPS(dpsi, 0.000017716904827, 1.e-15);
+   TUASSERTFEPS(deps, 0.000045012350955, 1.e-15);
+
+   TUCSM("XYCIO");
+   NutationSeries::XYCIO(&T, 1, &X, &Y);
+   TUASSERTFEPS(X, 0.000712263881101, 1.e-15);
+   TUASSERTFEPS(Y, 0.000044386344069, 1.e-15);
+
+   TURETURN();
+}
+
+
+unsigned NutationSeries_T ::
+batchTest()
+{
+   TUDEF("NutationSeries", "NutationAngles2010");
+      // 1900 to 2100 at irregular steps; not a multiple of blockSize
+   const int n(3*NutationSeries::blockSize + 7);
+   vector<double> T(n), deps(n), dpsi(n), X(n), Y(n);
+   for(int i=0; i<n; i++)
+      T[i] = -1.0 + 2.0*((i*7919)%n)/n + 1.e-6*i;
+
+   NutationSeries::NutationAngles2010(&T[0], n, &deps[0], &dpsi[0]);
+   NutationSeries::XYCIO(&T[0], n, &X[0], &Y[0]);
+
+   double worst(0.0), worstXY(0.0);
+   for(int i=0; i<n; i++) {
+      double de, dp, x, y;
+      NutationSeries::NutationAngles2010(&T[i], 1, &de, &dp);
+      NutationSeries::XYCIO(&T[i], 1, &x, &y);
+      worst = max(worst, max(::fabs(de-deps[i]), ::fabs(dp-dpsi[i])));
+      worstXY = max(worstXY, max(::fabs(x-X[i]), ::fabs(y-Y[i])));
+   }
+   TUASSERT(worst < 1.e-18);
+   TUCSM("XYCIO");
+   TUASSERT(worstXY < 1.e-18);
+
+      // nothing to do
+   TUCSM("NutationAngles2003");
+   NutationSeries::NutationAngles2003(&T[0], 0, &deps[0], &dpsi[0]);
+   TUPASS("n=0");
+
+   TURETURN();
+}
+
+
+int main()
+{
+   unsigned errorTotal = 0;
+   NutationSeries_T testClass;
+
+   errorTotal += testClass.sinCosTest();
+   errorTotal += testClass.sofaTest();
+   errorTotal += testClass.batchTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal;
+}
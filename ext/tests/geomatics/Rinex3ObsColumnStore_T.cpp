@@ -0,0 +1,257 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/// @file Rinex3ObsColumnStore_T.cpp  Test the column-wise RINEX obs data store
+/// against the data read directly and against Rinex3ObsFileLoader.
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <map>
+
+#include "Rinex3ObsColumnStore.hpp"
+#include "Rinex3ObsFileLoader.hpp"
+#include "build_config.h"
+#include "TestUtil.hpp"
+
+using namespace std;
+using namespace gpstk;
+
+class Rinex3ObsColumnStore_T
+{
+public:
+   Rinex3ObsColumnStore_T()
+   {
+      dataPath = getPathData() + getFileSep();
+   }
+
+   /// Compare every datum in the store with the file read record by record
+   unsigned loadTest();
+   /// Compare WriteSatPassList with that of Rinex3ObsFileLoader
+   unsigned satPassTest();
+   /// Check loading several (RINEX 2) files, and files out of time order
+   unsigned appendTest();
+
+private:
+   /// compare the store with the records of a file
+   void compareFile(TestUtil& testFramework, const Rinex3ObsColumnStore& store,
+                    const string& file, unsigned int firstEpoch);
+
+   string dataPath;
+};
+
+
+void Rinex3ObsColumnStore_T ::
+compareFile(TestUtil& testFramework, const Rinex3ObsColumnStore& store,
+            const string& file, unsigned int firstEpoch)
+{
+   Rinex3ObsStream strm(file.c_str());
+   Rinex3ObsData rod;
+   unsigned int n(firstEpoch), nbad(0);
+   strm >> strm.header;
+   while(strm >> rod) {
+      if(rod.epochFlag != 0 && rod.epochFlag != 1) continue;
+      if(n >= store.numEpochs() || store.getTimes()[n] != rod.time ||
+         store.getClockOffsets()[n] != rod.clockOffset) {
+         nbad++;
+         break;
+      }
+      Rinex3ObsData::DataMap::const_iterator it;
+      for(it=rod.obs.begin(); it != rod.obs.end(); ++it) {
+         string sys(1,it->first.systemChar());
+         const vector<RinexObsID>& types(strm.header.mapObsTypes[sys]);
+         for(unsigned int i=0; i<it->second.size(); i++) {
+            int col(store.column(it->first,
+                        sys + types[i].asString(Rinex3ObsBase::currentVersion)));
+            if(col < 0 || store.data(col)[n] != it->second[i].data ||
+               store.LLI(col)[n] != it->second[i].lli ||
+               store.SSI(col)[n] != it->second[i].ssi)
+               nbad++;
+         }
+      }
+      n++;
+   }
+   TUASSERTE(unsigned int, 0, nbad);
+   TUASSERT(n > firstEpoch);
+}
+
+
+unsigned Rinex3ObsColumnStore_T ::
+loadTest()
+{
+   TUDEF("Rinex3ObsColumnStore", "load");
+   string file(dataPath + "test_input_rinex3_76193040.14o");
+   Rinex3ObsColumnStore store;
+   Rinex3ObsStream strm(file.c_str());
+   int nadd(store.load(strm));
+   TUASSERTE(int, nadd, store.numEpochs());
+   TUASSERT(nadd > 10);
+   TUASSERTFE(15.0, store.getDT());
+   compareFile(testFramework, store, file, 0);
+
+      // every satellite has a column for every obs type of its system
+   vector<RinexSatID> sats(store.getSats());
+   vector<string> ots(store.getObsTypes('G'));
+   TUASSERTE(unsigned int, 8, ots.size());
+   TUASSERTE(unsigned int, sats.size()*ots.size(), store.numColumns());
+   int col(store.column(sats[0],"GL1C"));
+   TUASSERT(col >= 0);
+   TUASSERTE(RinexSatID, sats[0], store.columnSat(col));
+   TUASSERTE(string, "GL1C", store.columnObsType(col));
+   TUASSERTE(int, -1, store.column(sats[0],"GL9X"));
+   TUASSERTE(int, -1, store.column(RinexSatID("R01"),"GL1C"));
+   TUASSERT(store.getObsTypes('E').empty());
+
+      // iterator visits exactly the epochs with data
+   vector<int> cols(1,col);
+   unsigned int nwith(0), nvisit(0);
+   for(unsigned int n=0; n<store.numEpochs(); n++)
+      if(store.data(col)[n] != 0.0) nwith++;
+   vector<double> data;
+   vector<unsigned short> lli, ssi;
+   for(Rinex3ObsColumnStore::SatIterator it(store,cols); it.valid(); ++it) {
+      it.getData(data,lli,ssi);
+      TUASSERT(data[0] != 0.0);
+      TUASSERTE(CommonTime, store.getTimes()[it.epoch()], it.time());
+      TUASSERTE(unsigned short, SatPass::OK, it.flag());
+      nvisit++;
+   }
+   TUASSERTE(unsigned int, nwith, nvisit);
+   TURETURN();
+}
+
+
+unsigned Rinex3ObsColumnStore_T ::
+satPassTest()
+{
+   TUDEF("Rinex3ObsColumnStore", "WriteSatPassList");
+   string file(dataPath + "test_input_rinex3_76193040.14o");
+   const char *ids[] = { "GC1C", "GL1C", "GC2W", "GL2W" };
+   const char *spids[] = { "C1", "L1", "P2", "L2" };
+
+   map<char, vector<string> > sysSPOT;
+   map<char, vector<int> > indexLoad, indexStore;
+
+   Rinex3ObsFileLoader rofl(file);
+   for(int i=0; i<4; i++) rofl.loadObsID(ids[i]);
+   rofl.saveTheData(true);
+   string errmsg, msg;
+   rofl.loadFiles(errmsg, msg);
+
+   Rinex3ObsColumnStore store;
+   Rinex3ObsStream strm(file.c_str());
+   store.load(strm);
+   vector<string> ots(store.getObsTypes('G'));
+
+   for(int i=0; i<4; i++) {
+      sysSPOT['G'].push_back(spids[i]);
+      indexLoad['G'].push_back(vectorindex(rofl.getWantedObsTypes(),string(ids[i])));
+      indexStore['G'].push_back(vectorindex(ots,string(ids[i])));
+   }
+
+   vector<SatPass> lpass, spass;
+   int nl(rofl.WriteSatPassList(sysSPOT, indexLoad, lpass));
+   int ns(store.WriteSatPassList(sysSPOT, indexStore, spass));
+   TUASSERT(nl > 0);
+   TUASSERTE(int, nl, ns);
+   TUASSERTE(size_t, lpass.size(), spass.size());
+   for(unsigned int i=0; i<lpass.size() && i<spass.size(); i++) {
+      TUASSERTE(RinexSatID, lpass[i].getSat(), spass[i].getSat());
+      TUASSERTE(unsigned int, lpass[i].size(), spass[i].size());
+      if(lpass[i].size() != spass[i].size()) continue;
+      unsigned int nbad(0);
+      for(unsigned int j=0; j<lpass[i].size(); j++) {
+         if(lpass[i].time(j) != spass[i].time(j) ||
+            lpass[i].getFlag(j) != spass[i].getFlag(j))
+            nbad++;
+         for(int k=0; k<4; k++)
+            if(lpass[i].data(j,spids[k]) != spass[i].data(j,spids[k]) ||
+               lpass[i].LLI(j,spids[k]) != spass[i].LLI(j,spids[k]) ||
+               lpass[i].SSI(j,spids[k]) != spass[i].SSI(j,spids[k]))
+               nbad++;
+      }
+      TUASSERTE(unsigned int, 0, nbad);
+   }
+
+      // bad input
+   map<char, vector<string> > noSPOT;
+   TUASSERTE(int, -5, store.WriteSatPassList(noSPOT, indexStore, spass));
+   Rinex3ObsColumnStore empty;
+   TUASSERTE(int, -4, empty.WriteSatPassList(sysSPOT, indexStore, spass));
+   TURETURN();
+}
+
+
+unsigned Rinex3ObsColumnStore_T ::
+appendTest()
+{
+   TUDEF("Rinex3ObsColumnStore", "load");
+   string file1(dataPath + "arlm200a.15o");
+   string file2(dataPath + "arlm200b.15o");
+   Rinex3ObsColumnStore store;
+   Rinex3ObsStream strm1(file1.c_str()), strm2(file2.c_str());
+   int n1(store.load(strm1));
+   int n2(store.load(strm2));
+   TUASSERTE(int, n1+n2, store.numEpochs());
+   compareFile(testFramework, store, file1, 0);
+   compareFile(testFramework, store, file2, n1);
+      // reloading the first file is out of time order
+   Rinex3ObsStream strm3(file1.c_str());
+   TUTHROW(store.load(strm3));
+
+   store.clear();
+   TUASSERTE(unsigned int, 0, store.numEpochs());
+   TUASSERTE(unsigned int, 0, store.numColumns());
+   TURETURN();
+}
+
+
+int main()
+{
+   unsigned errorTotal = 0;
+   Rinex3ObsColumnStore_T testClass;
+
+   errorTotal += testClass.loadTest();
+   errorTotal += testClass.satPassTest();
+   errorTotal += testClass.appendTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal;
+}
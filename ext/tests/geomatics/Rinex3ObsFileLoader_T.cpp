@@ -0,0 +1,217 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/// @file Rinex3ObsFileLoader_T.cpp  Test that loading RINEX obs files with several
+/// threads gives exactly the same results as the serial load.
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <map>
+
+#include "Rinex3ObsFileLoader.hpp"
+#include "build_config.h"
+#include "TestUtil.hpp"
+
+using namespace std;
+using namespace gpstk;
+
+class Rinex3ObsFileLoader_T
+{
+public:
+   Rinex3ObsFileLoader_T()
+   {
+      dataPath = getPathData() + getFileSep();
+   }
+
+   /// Compare loads of 76193040.14o with 1, 2, 3 and 8 threads
+   unsigned parallelTest();
+   /// Compare loads limited by epoch count, time and decimation
+   unsigned editTest();
+   /// Compare loads of files that fail part way through, or are RINEX 2
+   unsigned errorTest();
+
+private:
+   /// configure a loader, load it and compare with the serial result
+   void compareLoad(TestUtil& testFramework, const vector<string>& files,
+                    int nthreads, int nepochs=-1, double dtdec=-1.0);
+
+   string dataPath;
+};
+
+
+void Rinex3ObsFileLoader_T ::
+compareLoad(TestUtil& testFramework, const vector<string>& files,
+            int nthreads, int nepochs, double dtdec)
+{
+   Rinex3ObsFileLoader serial(files), parallel(files);
+   Rinex3ObsFileLoader *loaders[2] = { &serial, &parallel };
+   string errmsg[2], msg[2];
+   int nread[2];
+   for(int k=0; k<2; k++) {
+      loaders[k]->loadObsID("GC1*");
+      loaders[k]->loadObsID("GL1*");
+      loaders[k]->loadObsID("GC2*");
+      loaders[k]->loadObsID("GL2*");
+      loaders[k]->loadObsID("RC1*");
+      loaders[k]->loadObsID("EL5*");
+      loaders[k]->saveTheData(true);
+      loaders[k]->nEpochsToRead(nepochs);
+      if(dtdec > 0.0) loaders[k]->setDecimation(dtdec);
+   }
+   parallel.setThreads(nthreads);
+   TUASSERTE(int, nthreads, parallel.getThreads());
+   for(int k=0; k<2; k++)
+      nread[k] = loaders[k]->loadFiles(errmsg[k], msg[k]);
+
+   TUASSERTE(int, nread[0], nread[1]);
+   TUASSERTE(string, errmsg[0], errmsg[1]);
+   TUASSERTE(string, msg[0], msg[1]);
+   TUASSERT(serial.getWantedObsTypes() == parallel.getWantedObsTypes());
+   TUASSERT(serial.getWantedSatObsCountMap() ==
+            parallel.getWantedSatObsCountMap());
+   TUASSERT(serial.getTotalObsCounts() == parallel.getTotalObsCounts());
+   TUASSERTE(CommonTime, serial.getDataBeginTime(), parallel.getDataBeginTime());
+   TUASSERTE(CommonTime, serial.getDataEndTime(), parallel.getDataEndTime());
+   TUASSERTFE(serial.getDT(), parallel.getDT());
+   TUASSERTE(int, serial.getStoreSize(), parallel.getStoreSize());
+   if(serial.getStoreSize() != parallel.getStoreSize())
+      return;
+
+   const vector<Rinex3ObsData>& s(serial.getStore()), p(parallel.getStore());
+   bool same(true);
+   for(unsigned i=0; i<s.size(); i++) {
+      if(s[i].time != p[i].time || s[i].epochFlag != p[i].epochFlag ||
+         s[i].numSVs != p[i].numSVs || s[i].clockOffset != p[i].clockOffset ||
+         s[i].obs.size() != p[i].obs.size()) {
+         same = false;
+         break;
+      }
+      Rinex3ObsData::DataMap::const_iterator sit, pit;
+      for(sit = s[i].obs.begin(), pit = p[i].obs.begin();
+          same && sit != s[i].obs.end(); ++sit, ++pit) {
+         if(sit->first != pit->first || sit->second.size() != pit->second.size())
+            same = false;
+         for(unsigned j=0; same && j<sit->second.size(); j++) {
+            if(sit->second[j].data != pit->second[j].data ||
+               sit->second[j].lli != pit->second[j].lli ||
+               sit->second[j].ssi != pit->second[j].ssi)
+               same = false;
+         }
+      }
+      if(!same) {
+         testFramework.assert(false, "store differs at epoch " +
+                              StringUtils::asString(i), __LINE__);
+         return;
+      }
+   }
+   testFramework.assert(true, "stores match", __LINE__);
+}
+
+
+unsigned Rinex3ObsFileLoader_T ::
+parallelTest()
+{
+   TUDEF("Rinex3ObsFileLoader", "loadFiles");
+   vector<string> files(1, dataPath + "test_input_rinex3_76193040.14o");
+   compareLoad(testFramework, files, 1);
+   compareLoad(testFramework, files, 2);
+   compareLoad(testFramework, files, 3);
+   compareLoad(testFramework, files, 8);
+   compareLoad(testFramework, files, 0);
+      // several files, continuing each other
+   files.push_back(dataPath + "test_input_rinex3_obs_RinexObsFile.15o");
+   compareLoad(testFramework, files, 4);
+
+      // make sure there is data to compare
+   Rinex3ObsFileLoader rofl(files[0]);
+   string errmsg, msg;
+   rofl.loadObsID("GC1*");
+   rofl.saveTheData(true);
+   rofl.setThreads(3);
+   TUASSERTE(int, 1, rofl.loadFiles(errmsg, msg));
+   TUASSERT(rofl.getStoreSize() > 10);
+   TURETURN();
+}
+
+
+unsigned Rinex3ObsFileLoader_T ::
+editTest()
+{
+   TUDEF("Rinex3ObsFileLoader", "loadFiles");
+   vector<string> files(1, dataPath + "test_input_rinex3_76193040.14o");
+   compareLoad(testFramework, files, 4, 7);
+   compareLoad(testFramework, files, 4, 1);
+   compareLoad(testFramework, files, 3, -1, 120.0);
+   TURETURN();
+}
+
+
+unsigned Rinex3ObsFileLoader_T ::
+errorTest()
+{
+   TUDEF("Rinex3ObsFileLoader", "loadFiles");
+   const char *names[] = { "test_input_rinex3_obs_BadEpochFlag.15o",
+                           "test_input_rinex3_obs_BadLineSize.15o",
+                           "test_input_rinex3_obs_InvalidLineLength.15o",
+                           "test_input_rinex3_obs_InvalidTimeFormat.15o",
+                           "test_input_rinex3_obs_NotObs.15o",
+                           "arlm200a.15o" };
+   for(unsigned i=0; i<sizeof(names)/sizeof(names[0]); i++) {
+      vector<string> files(1, dataPath + names[i]);
+      compareLoad(testFramework, files, 2);
+      compareLoad(testFramework, files, 5);
+   }
+   TURETURN();
+}
+
+
+int main()
+{
+   unsigned errorTotal = 0;
+   Rinex3ObsFileLoader_T testClass;
+
+   errorTotal += testClass.parallelTest();
+   errorTotal += testClass.editTest();
+   errorTotal += testClass.errorTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal;
+}
@@ -0,0 +1,322 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+
+/// @file SolarSystemEphemeris_T.cpp  Test that the memory-mapped ephemeris gives
+/// exactly the results of the stream-based ephemeris, also from many threads.
+
+#include <iostream>
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <thread>
+
+#include "SolarSystemEphemeris.hpp"
+#include "build_config.h"
+#include "TestUtil.hpp"
+
+using namespace std;
+using namespace gpstk;
+
+class SolarSystemEphemeris_T
+{
+public:
+   SolarSystemEphemeris_T()
+   {
+      headerFile = getPathSrc() + getFileSep() + "ext" + getFileSep() + "apps"
+         + getFileSep() + "geomatics" + getFileSep() + "JPLeph" + getFileSep()
+         + "JPL" + getFileSep() + "header.403";
+      tempPath = getPathTestTemp() + getFileSep();
+   }
+
+   /// Compare mapped and stream results for all pairs of bodies
+   unsigned mappedTest();
+   /// Compare mapped results computed by several threads
+   unsigned threadTest();
+   /// Check the errors: out of range, not mapped, and gaps in the data
+   unsigned errorTest();
+
+      /// first JD and span of the synthetic records
+   static const double startJD, span;
+      /// number of synthetic records
+   static const int nrec = 12;
+
+private:
+   /// Write a synthetic JPL ASCII data file with the layout of header.403,
+   /// nrec records each of length span starting at startJD, but with a gap
+   /// before record number gapRec if gapRec > 0, then convert it to binary.
+   void writeEphemeris(const string& binFile, int gapRec=0);
+
+   string headerFile, tempPath;
+};
+
+const double SolarSystemEphemeris_T::startJD = 2450000.5;
+const double SolarSystemEphemeris_T::span = 32.0;
+
+
+void SolarSystemEphemeris_T ::
+writeEphemeris(const string& binFile, int gapRec)
+{
+   const int Ncoeff = 1018;
+   string asciiFile = binFile + ".asc";
+   ofstream ofs(asciiFile.c_str());
+   unsigned seed = 12345;
+   double beg = startJD;
+   char buf[40];
+   for(int n=0; n<nrec; n++) {
+      if(gapRec > 0 && n == gapRec) beg += span;
+      ofs << n+1 << " " << Ncoeff << "\n";
+      for(int i=0; i<Ncoeff+2; i+=3) {
+         for(int j=i; j<i+3; j++) {
+            double d;
+            if(j == 0) d = beg;
+            else if(j == 1) d = beg + span;
+            else if(j >= Ncoeff) d = 0.0;
+            else {
+                  // deterministic values of varied magnitude
+               seed = seed*1103515245u + 12345u;
+               d = (double((seed >> 8) & 0xffff) / 32768.0 - 1.0)
+                  * (j%7 < 3 ? 1.e8 : 1.e-3);
+            }
+            sprintf(buf, "%26.18E", d);
+            char *e = strchr(buf, 'E');
+            if(e) *e = 'D';
+            ofs << buf;
+         }
+         ofs << "\n";
+      }
+      beg += span;
+   }
+   ofs.close();
+
+   SolarSystemEphemeris eph;
+   eph.readASCIIheader(headerFile);
+   eph.readASCIIdata(asciiFile);
+   eph.writeBinaryFile(binFile);
+   remove(asciiFile.c_str());
+}
+
+
+unsigned SolarSystemEphemeris_T ::
+mappedTest()
+{
+   TUDEF("SolarSystemEphemeris", "initializeWithMappedFile");
+   string binFile = tempPath + "SolarSystemEphemeris_T_mapped.bin";
+   writeEphemeris(binFile);
+
+   SolarSystemEphemeris streamEph, mappedEph;
+   TUASSERTE(int, 0, streamEph.initializeWithBinaryFile(binFile));
+   TUASSERTE(int, 0, mappedEph.initializeWithMappedFile(binFile));
+   TUASSERT(mappedEph.isMapped());
+   TUASSERT(!streamEph.isMapped());
+   TUASSERTE(int, 403, mappedEph.EphNumber());
+
+   TUCSM("RelativeInertialPositionVelocity");
+   const SolarSystemEphemeris& constEph(mappedEph);
+   double pvs[6], pvm[6], pvc[6];
+   bool same = true;
+      // times in random order, so that the stream version reads many records
+   for(int k=0; k<200 && same; k++) {
+      double JD = startJD + (k%2 ? (nrec*span)*((k*7919)%997)/997.0
+                                 : span*((k*31)%nrec + 0.5));
+      double MJD = JD - MJD_TO_JD;
+      for(int t=1; t<=15; t++) {
+         for(int c=0; c<=13; c++) {
+            SolarSystemEphemeris::Planet target = SolarSystemEphemeris::Planet(t);
+            SolarSystemEphemeris::Planet center = SolarSystemEphemeris::Planet(c);
+            bool km = (k%3 != 0);
+            streamEph.RelativeInertialPositionVelocity(MJD, target, center, pvs, km);
+            mappedEph.RelativeInertialPositionVelocity(MJD, target, center, pvm, km);
+            constEph.RelativeInertialPositionVelocity(MJD, target, center, pvc, km);
+            for(int i=0; i<6; i++) {
+               if(pvs[i] != pvm[i] || pvs[i] != pvc[i]) {
+                  same = false;
+                  cout << "Mismatch at JD " << JD << " target " << t
+                       << " center " << c << " component " << i << ": "
+                       << pvs[i] << " " << pvm[i] << " " << pvc[i] << endl;
+               }
+            }
+         }
+      }
+   }
+   TUASSERT(same);
+
+      // at a boundary the mapped ephemeris uses the record that begins there,
+      // as does the stream after a fresh seek; the stream's current record is
+      // the first one after initialization, so skip its end point
+   same = true;
+   for(int j=0; j<=nrec; j++) {
+      if(j == 1) continue;
+      SolarSystemEphemeris freshEph;
+      freshEph.initializeWithBinaryFile(binFile);
+      double MJD = startJD + j*span - MJD_TO_JD;
+      freshEph.RelativeInertialPositionVelocity(MJD, SolarSystemEphemeris::idMoon,
+                                    SolarSystemEphemeris::idSun, pvs);
+      constEph.RelativeInertialPositionVelocity(MJD, SolarSystemEphemeris::idMoon,
+                                    SolarSystemEphemeris::idSun, pvc);
+      for(int i=0; i<6; i++)
+         if(pvs[i] != pvc[i]) same = false;
+   }
+   TUASSERT(same);
+
+   remove(binFile.c_str());
+   TURETURN();
+}
+
+
+unsigned SolarSystemEphemeris_T ::
+threadTest()
+{
+   TUDEF("SolarSystemEphemeris", "RelativeInertialPositionVelocity");
+   string binFile = tempPath + "SolarSystemEphemeris_T_thread.bin";
+   writeEphemeris(binFile);
+
+   SolarSystemEphemeris streamEph, mappedEph;
+   streamEph.initializeWithBinaryFile(binFile);
+   mappedEph.initializeWithMappedFile(binFile);
+   const SolarSystemEphemeris& constEph(mappedEph);
+
+      // Sun and Moon relative to Earth at many times, from the stream
+   const int ntimes = 2000;
+   vector<double> times(ntimes), expect(ntimes*12);
+   for(int k=0; k<ntimes; k++) {
+      times[k] = startJD - MJD_TO_JD
+               + (nrec*span)*(((k*7919)%ntimes) + 0.5)/ntimes;
+      streamEph.RelativeInertialPositionVelocity(times[k],
+            SolarSystemEphemeris::idSun, SolarSystemEphemeris::idEarth,
+            &expect[12*k]);
+      streamEph.RelativeInertialPositionVelocity(times[k],
+            SolarSystemEphemeris::idMoon, SolarSystemEphemeris::idEarth,
+            &expect[12*k+6]);
+   }
+
+      // the same from several threads sharing the const mapped ephemeris
+   const int nthreads = 8;
+   vector<double> result(ntimes*12, 0.0);
+   vector<thread> workers;
+   for(int n=0; n<nthreads; n++) {
+      workers.push_back(thread([&,n]() {
+         for(int k=n; k<ntimes; k+=nthreads) {
+            constEph.RelativeInertialPositionVelocity(times[k],
+                  SolarSystemEphemeris::idSun, SolarSystemEphemeris::idEarth,
+                  &result[12*k]);
+            constEph.RelativeInertialPositionVelocity(times[k],
+                  SolarSystemEphemeris::idMoon, SolarSystemEphemeris::idEarth,
+                  &result[12*k+6]);
+         }
+      }));
+   }
+   for(int n=0; n<nthreads; n++)
+      workers[n].join();
+
+   TUASSERT(result == expect);
+
+   remove(binFile.c_str());
+   TURETURN();
+}
+
+
+unsigned SolarSystemEphemeris_T ::
+errorTest()
+{
+   TUDEF("SolarSystemEphemeris", "RelativeInertialPositionVelocity");
+   string binFile = tempPath + "SolarSystemEphemeris_T_error.bin";
+   writeEphemeris(binFile);
+
+   double pv[6];
+   SolarSystemEphemeris mappedEph;
+   mappedEph.initializeWithMappedFile(binFile);
+   const SolarSystemEphemeris& constEph(mappedEph);
+   double firstMJD = startJD - MJD_TO_JD, lastMJD = firstMJD + nrec*span;
+   TUTHROW(constEph.RelativeInertialPositionVelocity(firstMJD - 0.001,
+            SolarSystemEphemeris::idSun, SolarSystemEphemeris::idEarth, pv));
+   TUTHROW(constEph.RelativeInertialPositionVelocity(lastMJD + 0.001,
+            SolarSystemEphemeris::idSun, SolarSystemEphemeris::idEarth, pv));
+   try {
+      constEph.RelativeInertialPositionVelocity(lastMJD,
+            SolarSystemEphemeris::idSun, SolarSystemEphemeris::idEarth, pv);
+      TUPASS("end of the last record");
+   }
+   catch(Exception& e) {
+      TUFAIL("end of the last record: " + e.what());
+   }
+
+      // the const version requires the mapped file
+   SolarSystemEphemeris streamEph;
+   streamEph.initializeWithBinaryFile(binFile);
+   const SolarSystemEphemeris& constStream(streamEph);
+   TUTHROW(constStream.RelativeInertialPositionVelocity(firstMJD + 1.0,
+            SolarSystemEphemeris::idSun, SolarSystemEphemeris::idEarth, pv));
+   SolarSystemEphemeris emptyEph;
+   TUTHROW(static_cast<const SolarSystemEphemeris&>(emptyEph).
+           RelativeInertialPositionVelocity(firstMJD + 1.0,
+            SolarSystemEphemeris::idSun, SolarSystemEphemeris::idEarth, pv));
+   remove(binFile.c_str());
+
+      // a gap in the data cannot be addressed by offset
+   TUCSM("initializeWithMappedFile");
+   string gapFile = tempPath + "SolarSystemEphemeris_T_gap.bin";
+   writeEphemeris(gapFile, 5);
+   SolarSystemEphemeris gapEph;
+   TUTHROW(gapEph.initializeWithMappedFile(gapFile));
+   TUASSERT(!gapEph.isMapped());
+   remove(gapFile.c_str());
+
+      // missing file
+   SolarSystemEphemeris missingEph;
+   TUTHROW(missingEph.initializeWithMappedFile(tempPath + "no_such_file.bin"));
+
+   TURETURN();
+}
+
+
+int main()
+{
+   unsigned errorTotal = 0;
+   SolarSystemEphemeris_T testClass;
+
+   errorTotal += testClass.mappedTest();
+   errorTotal += testClass.threadTest();
+   errorTotal += testClass.errorTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal;
+}
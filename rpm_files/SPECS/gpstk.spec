@@ -14,6 +14,7 @@ BuildRequires: cmake
 BuildRequires: gcc
 BuildRequires: gcc-c++
 BuildRequires: ncurses-devel
+BuildRequires: zlib-devel
 
 %description
 The GPS Toolkit (GPSTk) is an open-source (LGPL) project sponsored by